@@ -6,13 +6,14 @@
 
 // Конструкторы
 BoardGame::BoardGame() 
-    : name(""), description(""), minPlayers(1), maxPlayers(1), edition("") {
+    : name(""), description(""), minPlayers(1), maxPlayers(1), edition(""),
+      ratingSum(0), ratingHistogram() {
 }
 
 BoardGame::BoardGame(const std::string& name, const std::string& description, 
                      int minPlayers, int maxPlayers, const std::string& edition)
     : name(name), description(description), minPlayers(minPlayers), 
-      maxPlayers(maxPlayers), edition(edition) {
+      maxPlayers(maxPlayers), edition(edition), ratingSum(0), ratingHistogram() {
 }
 
 // Деструктор
@@ -20,11 +21,11 @@ BoardGame::~BoardGame() {
 }
 
 // Геттеры
-std::string BoardGame::getName() const {
+const std::string& BoardGame::getName() const {
     return name;
 }
 
-std::string BoardGame::getDescription() const {
+const std::string& BoardGame::getDescription() const {
     return description;
 }
 
@@ -36,15 +37,15 @@ int BoardGame::getMaxPlayers() const {
     return maxPlayers;
 }
 
-std::string BoardGame::getEdition() const {
+const std::string& BoardGame::getEdition() const {
     return edition;
 }
 
-std::map<std::string, int> BoardGame::getRatings() const {
+const std::map<std::string, int>& BoardGame::getRatings() const {
     return ratings;
 }
 
-std::map<std::string, std::string> BoardGame::getFeatures() const {
+const std::map<std::string, std::string>& BoardGame::getFeatures() const {
     return features;
 }
 
@@ -82,6 +83,8 @@ bool BoardGame::addRating(const std::string& playerId, int rating) {
     }
     
     ratings[playerId] = rating;
+    ratingSum += rating;
+    ++ratingHistogram[rating - 1];
     return true;
 }
 
@@ -92,17 +95,23 @@ bool BoardGame::updateRating(const std::string& playerId, int rating) {
     }
     
  
-    if (ratings.find(playerId) == ratings.end()) {
+    auto it = ratings.find(playerId);
+    if (it == ratings.end()) {
         return false;
     }
     
-    ratings[playerId] = rating;
+    ratingSum += rating - it->second;
+    --ratingHistogram[it->second - 1];
+    ++ratingHistogram[rating - 1];
+    it->second = rating;
     return true;
 }
 
 bool BoardGame::removeRating(const std::string& playerId) {
     auto it = ratings.find(playerId);
     if (it != ratings.end()) {
+        ratingSum -= it->second;
+        --ratingHistogram[it->second - 1];
         ratings.erase(it);
         return true;
     }
@@ -114,12 +123,51 @@ double BoardGame::getAverageRating() const {
         return 0.0;
     }
     
-    int sum = 0;
-    for (const auto& pair : ratings) {
-        sum += pair.second;
+    // Сумма поддерживается при добавлении/изменении/удалении оценок
+    return static_cast<double>(ratingSum) / ratings.size();
+}
+
+double BoardGame::getMedianRating() const {
+    size_t count = ratings.size();
+    if (count == 0) {
+        return 0.0;
     }
     
-    return static_cast<double>(sum) / ratings.size();
+    // Медиана по гистограмме: оценки на позициях (count-1)/2 и count/2
+    size_t lowPos = (count - 1) / 2;
+    size_t highPos = count / 2;
+    int low = 0;
+    int high = 0;
+    size_t seen = 0;
+    for (int r = 1; r <= 5; ++r) {
+        seen += ratingHistogram[r - 1];
+        if (low == 0 && seen > lowPos) {
+            low = r;
+        }
+        if (seen > highPos) {
+            high = r;
+            break;
+        }
+    }
+    
+    return (low + high) / 2.0;
+}
+
+int BoardGame::getModeRating() const {
+    // При равной частоте выбираем большую оценку
+    int mode = 0;
+    int bestCount = 0;
+    for (int r = 1; r <= 5; ++r) {
+        if (ratingHistogram[r - 1] > 0 && ratingHistogram[r - 1] >= bestCount) {
+            bestCount = ratingHistogram[r - 1];
+            mode = r;
+        }
+    }
+    return mode;
+}
+
+const std::array<int, 5>& BoardGame::getRatingDistribution() const {
+    return ratingHistogram;
 }
 
 // Операции с признаками
@@ -152,12 +200,13 @@ bool BoardGame::removeFeature(const std::string& featureName) {
     return false;
 }
 
-std::string BoardGame::getFeature(const std::string& featureName) const {
+const std::string& BoardGame::getFeature(const std::string& featureName) const {
+    static const std::string empty;
     auto it = features.find(featureName);
     if (it != features.end()) {
         return it->second;
     }
-    return "";
+    return empty;
 }
 
 bool BoardGame::hasFeature(const std::string& featureName) const {
@@ -4,6 +4,7 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <array>
 #include <iostream>
 
 class BoardGame {
@@ -15,6 +16,8 @@ private:
     int maxPlayers;                     
     std::string edition;                 
     std::map<std::string, std::string> features; 
+    long long ratingSum;                  // сумма оценок
+    std::array<int, 5> ratingHistogram;   // количество оценок 1-5
 
 public:
 
@@ -26,13 +29,14 @@ public:
     ~BoardGame();
     
 
-    std::string getName() const;
-    std::string getDescription() const;
+    // Возврат по const ссылке - без копирования строк и словарей
+    const std::string& getName() const;
+    const std::string& getDescription() const;
     int getMinPlayers() const;
     int getMaxPlayers() const;
-    std::string getEdition() const;
-    std::map<std::string, int> getRatings() const;
-    std::map<std::string, std::string> getFeatures() const;
+    const std::string& getEdition() const;
+    const std::map<std::string, int>& getRatings() const;
+    const std::map<std::string, std::string>& getFeatures() const;
     
 
     void setName(const std::string& name);
@@ -46,12 +50,15 @@ public:
     bool updateRating(const std::string& playerId, int rating);
     bool removeRating(const std::string& playerId);
     double getAverageRating() const;
+    double getMedianRating() const;
+    int getModeRating() const;
+    const std::array<int, 5>& getRatingDistribution() const;
     
 
     bool addFeature(const std::string& featureName, const std::string& featureValue);
     bool updateFeature(const std::string& featureName, const std::string& featureValue);
     bool removeFeature(const std::string& featureName);
-    std::string getFeature(const std::string& featureName) const;
+    const std::string& getFeature(const std::string& featureName) const;
     bool hasFeature(const std::string& featureName) const;
     
  
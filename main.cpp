@@ -125,6 +125,15 @@ int main() {
     std::cout << "Есть ли у " << game3.getName() << " признак 'Тип': " 
               << (game3.hasFeature("Тип") ? "Да" : "Нет") << std::endl;
     
+    std::cout << "\n7. Тестирование статистики оценок:" << std::endl;
+    std::cout << "Медиана " << game3.getName() << ": " << game3.getMedianRating() << std::endl;
+    std::cout << "Мода " << game3.getName() << ": " << game3.getModeRating() << std::endl;
+    std::cout << "Распределение оценок " << game3.getName() << ":";
+    for (int r = 1; r <= 5; ++r) {
+        std::cout << " " << r << "->" << game3.getRatingDistribution()[r - 1];
+    }
+    std::cout << std::endl;
+    
     std::cout << "\n=== Тестирование завершено ===" << std::endl;
     
     return 0;
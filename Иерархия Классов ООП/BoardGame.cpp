@@ -1,223 +1,492 @@
-#include "BoardGame.h"
-#include <algorithm>
-#include <numeric>
-#include <iomanip>
-#include <cmath>
-
-int BoardGame::totalGamesCreated = 0;
-
-BoardGame::BoardGame() 
-    : name(""), description(""), minPlayers(1), maxPlayers(1), edition("") {
-    ++totalGamesCreated;
-}
-
-BoardGame::BoardGame(const std::string& name, const std::string& description, 
-                     int minPlayers, int maxPlayers, const std::string& edition)
-    : name(name), description(description), minPlayers(minPlayers), 
-      maxPlayers(maxPlayers), edition(edition) {
-    ++totalGamesCreated;
-}
-
-BoardGame::~BoardGame() {
-}
-
-std::string BoardGame::getName() const {
-    return name;
-}
-
-std::string BoardGame::getDescription() const {
-    return description;
-}
-
-int BoardGame::getMinPlayers() const {
-    return minPlayers;
-}
-
-int BoardGame::getMaxPlayers() const {
-    return maxPlayers;
-}
-
-std::string BoardGame::getEdition() const {
-    return edition;
-}
-
-const std::map<std::string, int>& BoardGame::getRatings() const {
-    return ratings;
-}
-
-const std::map<std::string, std::string>& BoardGame::getFeatures() const {
-    return features;
-}
-void BoardGame::setName(const std::string& name) {
-    this->name = name;
-}
-
-void BoardGame::setDescription(const std::string& description) {
-    this->description = description;
-}
-
-void BoardGame::setMinPlayers(int minPlayers) {
-    this->minPlayers = minPlayers;
-}
-
-void BoardGame::setMaxPlayers(int maxPlayers) {
-    this->maxPlayers = maxPlayers;
-}
-
-void BoardGame::setEdition(const std::string& edition) {
-    this->edition = edition;
-}
-
-bool BoardGame::addRating(const std::string& playerId, int rating) {
-    // проверяем корректность оценки
-    if (rating < 1 || rating > 5) {
-        return false;
-    }
-    
-    // игрок может оценить игру только один раз
-    if (ratings.find(playerId) != ratings.end()) {
-        return false;
-    }
-    
-    ratings[playerId] = rating;
-    return true;
-}
-
-bool BoardGame::updateRating(const std::string& playerId, int rating) {
-    if (rating < 1 || rating > 5) {
-        return false;
-    }
-    
-    if (ratings.find(playerId) == ratings.end()) {
-        return false;
-    }
-    
-    ratings[playerId] = rating;
-    return true;
-}
-
-bool BoardGame::removeRating(const std::string& playerId) {
-    auto it = ratings.find(playerId);
-    if (it != ratings.end()) {
-        ratings.erase(it);
-        return true;
-    }
-    return false;
-}
-
-double BoardGame::getAverageRating() const {
-    if (ratings.empty()) {
-        return 0.0;
-    }
-    
-    // вычисляем среднее арифметическое всех оценок
-    int sum = 0;
-    for (const auto& pair : ratings) {
-        sum += pair.second;
-    }
-    
-    return static_cast<double>(sum) / ratings.size();
-}
-
-bool BoardGame::addFeature(const std::string& featureName, const std::string& featureValue) {
-    if (features.find(featureName) != features.end()) {
-        return false; 
-    }
-    
-    features[featureName] = featureValue;
-    return true;  
-}
-
-bool BoardGame::updateFeature(const std::string& featureName, const std::string& featureValue) {
-    if (features.find(featureName) == features.end()) {
-        return false;
-    }
-    
-    features[featureName] = featureValue;
-    return true;  
-}
-
-bool BoardGame::removeFeature(const std::string& featureName) {
-    auto it = features.find(featureName);
-    if (it != features.end()) {
-        features.erase(it);
-        return true;
-    }
-    return false;
-}
-
-std::string BoardGame::getFeature(const std::string& featureName) const {
-    auto it = features.find(featureName);
-    if (it != features.end()) {
-        return it->second;
-    }
-    return "";
-}
-
-bool BoardGame::hasFeature(const std::string& featureName) const {
-    return features.find(featureName) != features.end();
-}
-
-bool BoardGame::operator<(const BoardGame& other) const {
-    return this->getAverageRating() < other.getAverageRating();
-}
-
-bool BoardGame::operator==(const BoardGame& other) const {
-    return std::abs(this->getAverageRating() - other.getAverageRating()) < 0.001;
-}
-
-bool BoardGame::operator<=(const BoardGame& other) const {
-    return *this < other || *this == other;
-}
-
-bool BoardGame::operator>(const BoardGame& other) const {
-    return !(*this <= other);
-}
-
-bool BoardGame::operator>=(const BoardGame& other) const {
-    return *this > other || *this == other;
-}
-
-BoardGame::operator bool() const {
-    // игра валидна, если у неё есть название
-    return !name.empty();
-}
-
-size_t BoardGame::getRatingsCount() const {
-    return ratings.size();
-}
-
-int BoardGame::getTotalGamesCreated() {
-    return totalGamesCreated;
-}
-void BoardGame::printInfo() const {
-    std::cout << "=== " << name << " ===" << std::endl;
-    std::cout << "Описание: " << description << std::endl;
-    std::cout << "Игроки: " << minPlayers << "-" << maxPlayers << std::endl;
-    std::cout << "Издание: " << edition << std::endl;
-    std::cout << "Средняя оценка: " << std::fixed << std::setprecision(2) 
-              << getAverageRating() << std::endl;
-    std::cout << "Количество оценок: " << ratings.size() << std::endl;
-}
-
-void BoardGame::printRatings() const {
-    std::cout << "Оценки для игры \"" << name << "\":" << std::endl;
-    if (ratings.empty()) {
-        std::cout << "  Оценок пока нет." << std::endl;
-    } else {
-        for (const auto& pair : ratings) {
-            std::cout << "  " << pair.first << ": " << pair.second << std::endl;
-        }
-    }
-}
-
-void BoardGame::printFeatures() const {
-    std::cout << "Признаки игры \"" << name << "\":" << std::endl;
-    if (features.empty()) {
-        std::cout << "  Признаков пока нет." << std::endl;
-    } else {
-        for (const auto& pair : features) {
-            std::cout << "  " << pair.first << ": " << pair.second << std::endl;
-        }
-    }
-}
+#include "BoardGame.h"
+#include <algorithm>
+#include <numeric>
+#include <iomanip>
+#include <cmath>
+
+std::atomic<int> BoardGame::totalGamesCreated(0);
+std::atomic<uint64_t> BoardGame::globalVersion(0);
+std::array<std::atomic<uint64_t>, BoardGame::FEATURE_VERSION_SLOTS> BoardGame::featureVersions;
+std::array<std::atomic<uint64_t>, BoardGame::RATING_VERSION_BUCKETS> BoardGame::ratingVersions;
+std::atomic<uint64_t> BoardGame::ratingChanges(0);
+
+namespace {
+
+// память строки в куче (короткие строки хранятся внутри объекта и в куче не лежат)
+size_t heapBytes(const std::string& str) {
+    const char* data = str.data();
+    const char* self = reinterpret_cast<const char*>(&str);
+    bool inlineBuffer = data >= self && data < self + sizeof(std::string);
+    return inlineBuffer ? 0 : str.capacity() + 1;
+}
+
+// корзина счетчика версий для среднего рейтинга: четверть балла
+int ratingBucket(double average) {
+    int bucket = static_cast<int>(std::floor(average * 4.0));
+    return std::max(0, std::min(bucket, BoardGame::RATING_VERSION_BUCKETS - 1));
+}
+
+size_t featureSlot(std::string_view featureName) {
+    return std::hash<std::string_view>()(featureName) % BoardGame::FEATURE_VERSION_SLOTS;
+}
+
+}
+
+BoardGame::BoardGame() 
+    : name(""), description(""), minPlayers(1), maxPlayers(1), edition(""),
+      ratingSum(0), ratingHistogram(), version(0), changeLog(nullptr), changeHandle(0) {
+    ++totalGamesCreated;
+}
+
+BoardGame::BoardGame(const std::string& name, const std::string& description, 
+                     int minPlayers, int maxPlayers, const std::string& edition)
+    : name(name), description(description), minPlayers(minPlayers), 
+      maxPlayers(maxPlayers), edition(edition), ratingSum(0), ratingHistogram(), version(0),
+      changeLog(nullptr), changeHandle(0) {
+    ++totalGamesCreated;
+}
+
+BoardGame::BoardGame(const BoardGame& other)
+    : name(other.name), description(other.description), ratings(other.ratings), minPlayers(other.minPlayers),
+      maxPlayers(other.maxPlayers), edition(other.edition), features(other.features), ratingSum(other.ratingSum),
+      ratingHistogram(other.ratingHistogram), version(other.version), changeLog(nullptr), changeHandle(0) {
+}
+
+// Присваивание меняет игру целиком, но она остается в своей базе
+BoardGame& BoardGame::operator=(const BoardGame& other) {
+    if (this != &other) {
+        name = other.name;
+        description = other.description;
+        ratings = other.ratings;
+        minPlayers = other.minPlayers;
+        maxPlayers = other.maxPlayers;
+        edition = other.edition;
+        features = other.features;
+        ratingSum = other.ratingSum;
+        ratingHistogram = other.ratingHistogram;
+        touch();
+    }
+    return *this;
+}
+
+BoardGame::~BoardGame() {
+}
+
+const std::string& BoardGame::getName() const {
+    return name;
+}
+
+const std::string& BoardGame::getDescription() const {
+    return description;
+}
+
+int BoardGame::getMinPlayers() const {
+    return minPlayers;
+}
+
+int BoardGame::getMaxPlayers() const {
+    return maxPlayers;
+}
+
+const std::string& BoardGame::getEdition() const {
+    return edition;
+}
+
+const FlatMap<SymbolId, int>& BoardGame::getRatings() const {
+    return ratings;
+}
+
+const FlatMap<std::string, std::string>& BoardGame::getFeatures() const {
+    return features;
+}
+void BoardGame::setName(const std::string& name) {
+    this->name = name;
+    touch();
+}
+
+void BoardGame::setDescription(const std::string& description) {
+    this->description = description;
+    touch();
+}
+
+void BoardGame::setMinPlayers(int minPlayers) {
+    this->minPlayers = minPlayers;
+    touchFeature("minPlayers");
+}
+
+void BoardGame::setMaxPlayers(int maxPlayers) {
+    this->maxPlayers = maxPlayers;
+    touchFeature("maxPlayers");
+}
+
+void BoardGame::setEdition(const std::string& edition) {
+    this->edition = edition;
+    touch();
+}
+
+bool BoardGame::addRating(const std::string& playerId, int rating) {
+    // проверяем корректность оценки
+    if (rating < 1 || rating > 5) {
+        return false;
+    }
+    
+    // игрок может оценить игру только один раз
+    double previousAverage = getAverageRating();
+    if (!ratings.insert(SymbolTable::players().intern(playerId), rating)) {
+        return false;
+    }
+    
+    ratingSum += rating;
+    ++ratingHistogram[rating - 1];
+    touchRating(previousAverage);
+    return true;
+}
+
+bool BoardGame::updateRating(std::string_view playerId, int rating) {
+    if (rating < 1 || rating > 5) {
+        return false;
+    }
+    
+    auto it = ratings.find(SymbolTable::players().find(playerId));
+    if (it == ratings.end()) {
+        return false;
+    }
+    
+    // переносим оценку между корзинами гистограммы
+    double previousAverage = getAverageRating();
+    ratingSum += rating - it->second;
+    --ratingHistogram[it->second - 1];
+    ++ratingHistogram[rating - 1];
+    it->second = rating;
+    touchRating(previousAverage);
+    return true;
+}
+
+bool BoardGame::removeRating(std::string_view playerId) {
+    auto it = ratings.find(SymbolTable::players().find(playerId));
+    if (it != ratings.end()) {
+        double previousAverage = getAverageRating();
+        ratingSum -= it->second;
+        --ratingHistogram[it->second - 1];
+        ratings.erase(it);
+        touchRating(previousAverage);
+        return true;
+    }
+    return false;
+}
+
+double BoardGame::getAverageRating() const {
+    if (ratings.empty()) {
+        return 0.0;
+    }
+    
+    // сумма поддерживается инкрементально, пересчет не нужен
+    return static_cast<double>(ratingSum) / ratings.size();
+}
+
+double BoardGame::getMedianRating() const {
+    size_t count = ratings.size();
+    if (count == 0) {
+        return 0.0;
+    }
+    
+    // ищем по гистограмме оценки на позициях (count-1)/2 и count/2
+    size_t lowPos = (count - 1) / 2;
+    size_t highPos = count / 2;
+    int low = 0;
+    int high = 0;
+    size_t seen = 0;
+    for (int r = 1; r <= 5; ++r) {
+        seen += ratingHistogram[r - 1];
+        if (low == 0 && seen > lowPos) {
+            low = r;
+        }
+        if (seen > highPos) {
+            high = r;
+            break;
+        }
+    }
+    
+    return (low + high) / 2.0;
+}
+
+int BoardGame::getModeRating() const {
+    // при равной частоте выбираем большую оценку
+    int mode = 0;
+    int bestCount = 0;
+    for (int r = 1; r <= 5; ++r) {
+        if (ratingHistogram[r - 1] > 0 && ratingHistogram[r - 1] >= bestCount) {
+            bestCount = ratingHistogram[r - 1];
+            mode = r;
+        }
+    }
+    return mode;
+}
+
+int BoardGame::getRatingFrequency(int rating) const {
+    if (rating < 1 || rating > 5) {
+        return 0;
+    }
+    return ratingHistogram[rating - 1];
+}
+
+const std::array<int, 5>& BoardGame::getRatingDistribution() const {
+    return ratingHistogram;
+}
+
+bool BoardGame::addFeature(const std::string& featureName, const std::string& featureValue) {
+    if (!features.insert(featureName, featureValue)) {
+        return false;
+    }
+    touchFeature(featureName);
+    return true;
+}
+
+bool BoardGame::updateFeature(std::string_view featureName, const std::string& featureValue) {
+    auto it = features.find(featureName);
+    if (it == features.end()) {
+        return false;
+    }
+    
+    it->second = featureValue;
+    touchFeature(featureName);
+    return true;  
+}
+
+bool BoardGame::removeFeature(std::string_view featureName) {
+    auto it = features.find(featureName);
+    if (it != features.end()) {
+        features.erase(it);
+        touchFeature(featureName);
+        return true;
+    }
+    return false;
+}
+
+const std::string& BoardGame::getFeature(std::string_view featureName) const {
+    static const std::string empty;
+    auto it = features.find(featureName);
+    if (it != features.end()) {
+        return it->second;
+    }
+    return empty;
+}
+
+bool BoardGame::hasFeature(std::string_view featureName) const {
+    return features.find(featureName) != features.end();
+}
+
+bool BoardGame::operator<(const BoardGame& other) const {
+    return this->getAverageRating() < other.getAverageRating();
+}
+
+bool BoardGame::operator==(const BoardGame& other) const {
+    return std::abs(this->getAverageRating() - other.getAverageRating()) < 0.001;
+}
+
+bool BoardGame::operator<=(const BoardGame& other) const {
+    return *this < other || *this == other;
+}
+
+bool BoardGame::operator>(const BoardGame& other) const {
+    return !(*this <= other);
+}
+
+bool BoardGame::operator>=(const BoardGame& other) const {
+    return *this > other || *this == other;
+}
+
+BoardGame::operator bool() const {
+    // игра валидна, если у неё есть название
+    return !name.empty();
+}
+
+size_t BoardGame::getRatingsCount() const {
+    return ratings.size();
+}
+
+size_t BoardGame::getMemoryUsage() const {
+    // сам объект + динамическая память строк и плоских словарей
+    size_t bytes = sizeof(BoardGame);
+    bytes += heapBytes(name) + heapBytes(description) + heapBytes(edition);
+    bytes += ratings.capacityBytes() + features.capacityBytes();
+    for (const auto& pair : features) {
+        bytes += heapBytes(pair.first) + heapBytes(pair.second);
+    }
+    return bytes;
+}
+
+int BoardGame::getTotalGamesCreated() {
+    return totalGamesCreated.load();
+}
+
+uint64_t BoardGame::getVersion() const {
+    return version;
+}
+
+uint64_t BoardGame::getGlobalVersion() {
+    return globalVersion.load(std::memory_order_relaxed);
+}
+
+uint64_t BoardGame::getFeatureVersion(std::string_view featureName) {
+    return featureVersions[featureSlot(featureName)].load(std::memory_order_relaxed);
+}
+
+uint64_t BoardGame::getRatingVersion(double threshold) {
+    return ratingVersions[ratingBucket(threshold)].load(std::memory_order_relaxed);
+}
+
+uint64_t BoardGame::getRatingChangeCount() {
+    return ratingChanges.load(std::memory_order_relaxed);
+}
+
+void BoardGame::attachChangeLog(GameChangeLog* log, SymbolId handle) {
+    changeLog = log;
+    changeHandle = handle;
+}
+
+void BoardGame::touch() {
+    ++version;
+    globalVersion.fetch_add(1, std::memory_order_relaxed);
+    if (changeLog) {
+        changeLog->record(changeHandle);
+    }
+}
+
+void GameChangeLog::record(SymbolId handle) {
+    ++version;
+    if (handle >= marked.size()) {
+        marked.resize(handle + static_cast<size_t>(1), false);
+    }
+    if (!marked[handle]) {
+        marked[handle] = true;
+        changed.push_back(handle);
+    }
+}
+
+void GameChangeLog::clear() {
+    for (SymbolId handle : changed) {
+        marked[handle] = false;
+    }
+    changed.clear();
+}
+
+void BoardGame::touchFeature(std::string_view featureName) {
+    featureVersions[featureSlot(featureName)].fetch_add(1, std::memory_order_relaxed);
+    touch();
+}
+
+// Порог t пересечен, только если он между старым и новым средним, поэтому достаточно
+// отметить корзины этого промежутка
+void BoardGame::touchRating(double previousAverage) {
+    double average = getAverageRating();
+    int first = ratingBucket(std::min(previousAverage, average));
+    int last = ratingBucket(std::max(previousAverage, average));
+    for (int bucket = first; bucket <= last; ++bucket) {
+        ratingVersions[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+    ratingChanges.fetch_add(1, std::memory_order_relaxed);
+    touch();
+}
+void BoardGame::printInfo() const {
+    std::cout << "=== " << name << " ===" << std::endl;
+    std::cout << "Описание: " << description << std::endl;
+    std::cout << "Игроки: " << minPlayers << "-" << maxPlayers << std::endl;
+    std::cout << "Издание: " << edition << std::endl;
+    std::cout << "Средняя оценка: " << std::fixed << std::setprecision(2) 
+              << getAverageRating() << std::endl;
+    std::cout << "Количество оценок: " << ratings.size() << std::endl;
+}
+
+void BoardGame::printRatings() const {
+    std::cout << "Оценки для игры \"" << name << "\":" << std::endl;
+    if (ratings.empty()) {
+        std::cout << "  Оценок пока нет." << std::endl;
+    } else {
+        for (const auto& pair : ratings) {
+            std::cout << "  " << SymbolTable::players().name(pair.first) << ": " << pair.second << std::endl;
+        }
+    }
+}
+
+void BoardGame::printFeatures() const {
+    std::cout << "Признаки игры \"" << name << "\":" << std::endl;
+    if (features.empty()) {
+        std::cout << "  Признаков пока нет." << std::endl;
+    } else {
+        for (const auto& pair : features) {
+            std::cout << "  " << pair.first << ": " << pair.second << std::endl;
+        }
+    }
+}
+
+void BoardGame::runTests() {
+    std::cout << "\n=== Тестирование класса BoardGame ===" << std::endl;
+    
+    BoardGame game("Каркассон", "Тайлы", 2, 6, "Big Box");
+    game.addRating("p1", 5);
+    game.addRating("p2", 4);
+    game.addRating("p3", 5);
+    game.addRating("p4", 2);
+    
+    std::cout << "Тест 1 - Средняя оценка: ";
+    if (game.getAverageRating() == 4.0) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED (ожидалось 4.0, получено " << game.getAverageRating() << ")" << std::endl;
+    }
+    
+    std::cout << "Тест 2 - Медиана и мода: ";
+    if (game.getMedianRating() == 4.5 && game.getModeRating() == 5) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED (медиана " << game.getMedianRating()
+                  << ", мода " << game.getModeRating() << ")" << std::endl;
+    }
+    
+    game.updateRating("p1", 2);
+    game.removeRating("p3");
+    
+    std::cout << "Тест 3 - Агрегаты после изменения и удаления: ";
+    if (game.getRatingsCount() == 3 && game.getAverageRating() == 8.0 / 3 &&
+        game.getMedianRating() == 2.0 && game.getModeRating() == 2 &&
+        game.getRatingFrequency(2) == 2 && game.getRatingFrequency(5) == 0) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    bool invalid = game.updateRating("p2", 6) || game.addRating("p2", 3) || game.removeRating("p3");
+    
+    std::cout << "Тест 4 - Некорректные операции не меняют агрегаты: ";
+    const std::array<int, 5>& distribution = game.getRatingDistribution();
+    if (!invalid && distribution[1] == 2 && distribution[3] == 1 && game.getAverageRating() == 8.0 / 3) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    game.addFeature("Жанр", "Семейная");
+    game.addFeature("Время", "40");
+    game.updateFeature("Время", "45");
+    
+    std::cout << "Тест 5 - Признаки в плоском хранилище: ";
+    const FlatMap<std::string, std::string>& features = game.getFeatures();
+    if (!game.addFeature("Жанр", "Стратегия") && game.getFeature("Время") == "45" &&
+        features.size() == 2 && features.begin()->first == "Время" && !game.hasFeature("Тип")) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    BoardGame empty;
+    
+    std::cout << "Тест 6 - Игра без оценок: ";
+    if (empty.getAverageRating() == 0.0 && empty.getMedianRating() == 0.0 && empty.getModeRating() == 0) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    std::cout << "=== Тестирование BoardGame завершено ===\n" << std::endl;
+}
@@ -1,78 +1,141 @@
-#ifndef BOARDGAME_H
-#define BOARDGAME_H
-
-#include <string>
-#include <map>
-#include <vector>
-#include <iostream>
-
-class BoardGame {
-private:
-    std::string name;                   
-    std::string description;           
-    std::map<std::string, int> ratings; // игрок -> оценка (1-5)
-    int minPlayers;                      
-    int maxPlayers;                     
-    std::string edition;                 
-    std::map<std::string, std::string> features; // дополнительные характеристики
-    
-    static int totalGamesCreated; // счетчик созданных игр 
-
-public:
-
-    BoardGame();
-    BoardGame(const std::string& name, const std::string& description, 
-              int minPlayers, int maxPlayers, const std::string& edition);
-    
-
-    ~BoardGame();
-    
-
-    std::string getName() const;
-    std::string getDescription() const;
-    int getMinPlayers() const;
-    int getMaxPlayers() const;
-    std::string getEdition() const;
-    
-    const std::map<std::string, int>& getRatings() const;
-    const std::map<std::string, std::string>& getFeatures() const;
-    
-    // сеттеры
-    void setName(const std::string& name);
-    void setDescription(const std::string& description);
-    void setMinPlayers(int minPlayers);
-    void setMaxPlayers(int maxPlayers);
-    void setEdition(const std::string& edition);
-    
-    // работа с оценками
-    bool addRating(const std::string& playerId, int rating);
-    bool updateRating(const std::string& playerId, int rating);
-    bool removeRating(const std::string& playerId);
-    double getAverageRating() const;
-    
-    // работа с признаками
-    bool addFeature(const std::string& featureName, const std::string& featureValue);
-    bool updateFeature(const std::string& featureName, const std::string& featureValue);
-    bool removeFeature(const std::string& featureName);
-    std::string getFeature(const std::string& featureName) const;
-    bool hasFeature(const std::string& featureName) const;
-    
- 
-    // операторы сравнения (по среднему рейтингу)
-    bool operator<(const BoardGame& other) const;
-    bool operator==(const BoardGame& other) const;
-    bool operator<=(const BoardGame& other) const;
-    bool operator>(const BoardGame& other) const;
-    bool operator>=(const BoardGame& other) const;
-    
-    explicit operator bool() const; // проверка валидности
-    size_t getRatingsCount() const;
-    static int getTotalGamesCreated();
-
-    // вывод информации
-    void printInfo() const;
-    void printRatings() const;
-    void printFeatures() const;
-};
-
-#endif
+#ifndef BOARDGAME_H
+#define BOARDGAME_H
+
+#include <string>
+#include <string_view>
+#include <map>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <iostream>
+#include "SymbolTable.h"
+#include "FlatMap.h"
+
+// Измененные игры одной базы (см. GameDatabase): игра, добавленная в базу, отмечает здесь свои изменения,
+// поэтому база пересобирает кеши и копирует при публикации только свои измененные игры
+struct GameChangeLog {
+    uint64_t version = 0;           // число изменений игр базы
+    std::vector<SymbolId> changed;  // номера игр, измененных после clear (каждый один раз)
+    std::vector<bool> marked;       // номер -> уже есть в changed
+    
+    void record(SymbolId handle);
+    void clear();
+};
+
+class BoardGame {
+public:
+    static const size_t FEATURE_VERSION_SLOTS = 64; // счетчиков версий признаков (название -> счетчик по хешу)
+    static const int RATING_VERSION_BUCKETS = 21;   // счетчиков версий рейтинга: средний рейтинг 0..5 с шагом 0.25
+
+private:
+    std::string name;                   
+    std::string description;           
+    FlatMap<SymbolId, int> ratings; // игрок (номер в SymbolTable::players()) -> оценка (1-5)
+    int minPlayers;                      
+    int maxPlayers;                     
+    std::string edition;                 
+    FlatMap<std::string, std::string> features; // дополнительные характеристики
+    
+    // агрегаты оценок, поддерживаются в addRating/updateRating/removeRating
+    long long ratingSum; // сумма всех оценок
+    std::array<int, 5> ratingHistogram; // количество оценок 1..5
+    
+    uint64_t version; // растет при каждом изменении игры
+    GameChangeLog* changeLog; // журнал базы, в которой игра (nullptr - не в базе); у копии не наследуется
+    SymbolId changeHandle;    // номер игры в этом журнале
+    
+    // счетчики общие для всех игр; атомарные, потому что игры разных шардов меняются параллельно
+    static std::atomic<int> totalGamesCreated; // счетчик созданных игр 
+    static std::atomic<uint64_t> globalVersion; // число изменений всех игр (для устаревания кешей и статистики)
+    
+    // версии для кеша результатов запросов (см. QueryCache), тоже общие для всех игр
+    static std::array<std::atomic<uint64_t>, FEATURE_VERSION_SLOTS> featureVersions; // изменения признака с названием из слота
+    static std::array<std::atomic<uint64_t>, RATING_VERSION_BUCKETS> ratingVersions; // средний рейтинг игры прошел через корзину
+    static std::atomic<uint64_t> ratingChanges; // число изменений оценок всех игр
+    
+    void touch(); // отметить изменение игры
+    void touchFeature(std::string_view featureName); // то же для изменения признака
+    void touchRating(double previousAverage); // то же для изменения оценок (средний рейтинг до изменения)
+
+public:
+
+    BoardGame();
+    BoardGame(const std::string& name, const std::string& description, 
+              int minPlayers, int maxPlayers, const std::string& edition);
+    BoardGame(const BoardGame& other); // копия не привязана к базе оригинала
+    BoardGame& operator=(const BoardGame& other);
+    
+
+    ~BoardGame();
+    
+
+    // строки возвращаются по ссылке, без копирования
+    const std::string& getName() const;
+    const std::string& getDescription() const;
+    int getMinPlayers() const;
+    int getMaxPlayers() const;
+    const std::string& getEdition() const;
+    
+    const FlatMap<SymbolId, int>& getRatings() const; // ключ - номер игрока
+    const FlatMap<std::string, std::string>& getFeatures() const;
+    
+    // сеттеры
+    void setName(const std::string& name); // GameDatabase продолжит искать игру по прежнему названию
+    void setDescription(const std::string& description);
+    void setMinPlayers(int minPlayers);
+    void setMaxPlayers(int maxPlayers);
+    void setEdition(const std::string& edition);
+    
+    // работа с оценками
+    bool addRating(const std::string& playerId, int rating);
+    bool updateRating(std::string_view playerId, int rating);
+    bool removeRating(std::string_view playerId);
+    double getAverageRating() const; // O(1) по агрегатам
+    double getMedianRating() const; // медиана по гистограмме
+    int getModeRating() const; // самая частая оценка (0, если оценок нет)
+    int getRatingFrequency(int rating) const; // сколько раз поставлена оценка
+    const std::array<int, 5>& getRatingDistribution() const; // гистограмма 1..5
+    
+    // работа с признаками
+    bool addFeature(const std::string& featureName, const std::string& featureValue);
+    bool updateFeature(std::string_view featureName, const std::string& featureValue);
+    bool removeFeature(std::string_view featureName);
+    const std::string& getFeature(std::string_view featureName) const; // пустая строка, если признака нет
+    bool hasFeature(std::string_view featureName) const;
+    
+ 
+    // операторы сравнения (по среднему рейтингу)
+    bool operator<(const BoardGame& other) const;
+    bool operator==(const BoardGame& other) const;
+    bool operator<=(const BoardGame& other) const;
+    bool operator>(const BoardGame& other) const;
+    bool operator>=(const BoardGame& other) const;
+    
+    explicit operator bool() const; // проверка валидности
+    size_t getRatingsCount() const;
+    size_t getMemoryUsage() const; // примерный объем памяти игры в байтах
+    static int getTotalGamesCreated();
+    uint64_t getVersion() const;
+    static uint64_t getGlobalVersion();
+    
+    // отмечать изменения игры в журнале базы под номером handle (nullptr - перестать); вызывает GameDatabase
+    void attachChangeLog(GameChangeLog* log, SymbolId handle);
+    
+    // версия признака: растет при добавлении, изменении и удалении признака с таким названием у любой игры
+    // (minPlayers и maxPlayers - при изменении числа игроков); счетчик может быть общим у нескольких названий
+    static uint64_t getFeatureVersion(std::string_view featureName);
+    
+    // версия порога: растет, когда средний рейтинг какой-либо игры мог пересечь threshold
+    static uint64_t getRatingVersion(double threshold);
+    
+    // число изменений оценок всех игр (добавление, изменение и удаление оценки)
+    static uint64_t getRatingChangeCount();
+
+    // вывод информации
+    void printInfo() const;
+    void printRatings() const;
+    void printFeatures() const;
+    static void runTests();
+};
+
+#endif
@@ -0,0 +1,885 @@
+#include "BulkImporter.h"
+#include "ParallelScan.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cctype>
+
+namespace {
+
+const size_t LINES_PER_PART = 1024; // строк в одной части параллельного разбора
+
+typedef std::vector<std::pair<std::string, std::string>> Pairs;
+
+// Строка файла для разбора
+struct Line {
+    std::string_view text;
+    size_t number;
+};
+
+bool parseInt(std::string_view text, int& value) {
+    const char* last = text.data() + text.size();
+    std::from_chars_result result = std::from_chars(text.data(), last, value);
+    return !text.empty() && result.ec == std::errc() && result.ptr == last;
+}
+
+bool parseNumber(std::string_view text, double& value) {
+    const char* last = text.data() + text.size();
+    std::from_chars_result result = std::from_chars(text.data(), last, value);
+    return !text.empty() && result.ec == std::errc() && result.ptr == last && std::isfinite(value);
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.remove_suffix(1);
+    return text;
+}
+
+// === CSV ===
+
+// Поля строки CSV; значение в кавычках может содержать запятые, "" внутри - одна кавычка
+bool splitCsv(std::string_view line, std::vector<std::string>& fields, std::string& reason) {
+    fields.clear();
+    size_t i = 0;
+    while (true) {
+        std::string field;
+        if (i < line.size() && line[i] == '"') {
+            ++i;
+            while (true) {
+                if (i >= line.size()) {
+                    reason = "незакрытая кавычка";
+                    return false;
+                }
+                if (line[i] == '"') {
+                    if (i + 1 < line.size() && line[i + 1] == '"') {
+                        field += '"';
+                        i += 2;
+                        continue;
+                    }
+                    ++i;
+                    break;
+                }
+                field += line[i++];
+            }
+            if (i < line.size() && line[i] != ',') {
+                reason = "символы после закрывающей кавычки";
+                return false;
+            }
+        } else {
+            size_t comma = line.find(',', i);
+            size_t end = comma == std::string_view::npos ? line.size() : comma;
+            field.assign(trim(line.substr(i, end - i)));
+            i = end;
+        }
+        fields.push_back(std::move(field));
+        if (i >= line.size()) {
+            return true;
+        }
+        ++i;  // запятая
+    }
+}
+
+// Список "ключ=значение;ключ=значение" (пустая строка - пустой список)
+bool splitPairs(std::string_view text, Pairs& pairs, std::string& reason) {
+    pairs.clear();
+    text = trim(text);
+    while (!text.empty()) {
+        size_t semicolon = text.find(';');
+        std::string_view item = trim(text.substr(0, semicolon));
+        text = semicolon == std::string_view::npos ? std::string_view() : text.substr(semicolon + 1);
+        if (item.empty()) {
+            continue;
+        }
+        size_t equals = item.find('=');
+        if (equals == std::string_view::npos || trim(item.substr(0, equals)).empty()) {
+            reason = "ожидалось ключ=значение: " + std::string(item);
+            return false;
+        }
+        pairs.emplace_back(std::string(trim(item.substr(0, equals))), std::string(trim(item.substr(equals + 1))));
+    }
+    return true;
+}
+
+// === JSON ===
+
+// Значение JSON; массивы не поддерживаются
+struct JsonValue {
+    enum Type { STRING, NUMBER, OBJECT, LITERAL };  // LITERAL - true, false, null
+    Type type = LITERAL;
+    std::string text;
+    double number = 0.0;
+    std::vector<std::pair<std::string, JsonValue>> members;
+};
+
+class JsonParser {
+private:
+    std::string_view text;
+    size_t pos;
+    std::string& reason;
+
+    bool failWith(const std::string& message) {
+        reason = message + " (позиция " + std::to_string(pos + 1) + ")";
+        return false;
+    }
+
+    void skipSpace() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r' || text[pos] == '\n')) {
+            ++pos;
+        }
+    }
+
+    static void appendUtf8(std::string& out, uint32_t code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    bool parseHex(uint32_t& code) {
+        if (text.size() - pos < 4) {
+            return failWith("неполная последовательность \\u");
+        }
+        code = 0;
+        for (int k = 0; k < 4; ++k) {
+            char c = text[pos++];
+            code <<= 4;
+            if (c >= '0' && c <= '9') code |= static_cast<uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f') code |= static_cast<uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') code |= static_cast<uint32_t>(c - 'A' + 10);
+            else return failWith("неверная последовательность \\u");
+        }
+        return true;
+    }
+
+    bool parseString(std::string& out) {
+        ++pos;  // открывающая кавычка
+        while (pos < text.size()) {
+            char c = text[pos++];
+            if (c == '"') {
+                return true;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos >= text.size()) {
+                break;
+            }
+            char escaped = text[pos++];
+            switch (escaped) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                uint32_t code = 0;
+                if (!parseHex(code)) return false;
+                // суррогатная пара - один символ за пределами BMP
+                if (code >= 0xD800 && code < 0xDC00 && text.substr(pos, 2) == "\\u") {
+                    pos += 2;
+                    uint32_t low = 0;
+                    if (!parseHex(low)) return false;
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+                appendUtf8(out, code);
+                break;
+            }
+            default:
+                return failWith("неизвестная последовательность \\" + std::string(1, escaped));
+            }
+        }
+        return failWith("незакрытая строка");
+    }
+
+    bool parseValue(JsonValue& value, int depth) {
+        skipSpace();
+        if (pos >= text.size()) {
+            return failWith("ожидалось значение");
+        }
+        char c = text[pos];
+        if (c == '"') {
+            value.type = JsonValue::STRING;
+            return parseString(value.text);
+        }
+        if (c == '{') {
+            value.type = JsonValue::OBJECT;
+            return parseObject(value.members, depth + 1);
+        }
+        if (c == '[') {
+            return failWith("массивы не поддерживаются");
+        }
+        size_t start = pos;
+        while (pos < text.size() && text[pos] != ',' && text[pos] != '}' && text[pos] != ' ' && text[pos] != '\t' &&
+               text[pos] != '\r') {
+            ++pos;
+        }
+        std::string_view token = text.substr(start, pos - start);
+        if (token == "true" || token == "false" || token == "null") {
+            value.type = JsonValue::LITERAL;
+            value.text.assign(token);
+            return true;
+        }
+        value.type = JsonValue::NUMBER;
+        if (!parseNumber(token, value.number)) {
+            pos = start;
+            return failWith("неверное значение " + std::string(token));
+        }
+        return true;
+    }
+
+public:
+    JsonParser(std::string_view text, std::string& reason) : text(text), pos(0), reason(reason) {}
+
+    bool parseObject(std::vector<std::pair<std::string, JsonValue>>& members, int depth) {
+        if (depth > 8) {
+            return failWith("слишком глубокая вложенность");
+        }
+        skipSpace();
+        if (pos >= text.size() || text[pos] != '{') {
+            return failWith("ожидался объект");
+        }
+        ++pos;
+        skipSpace();
+        if (pos < text.size() && text[pos] == '}') {
+            ++pos;
+            return true;
+        }
+        while (true) {
+            skipSpace();
+            if (pos >= text.size() || text[pos] != '"') {
+                return failWith("ожидался ключ");
+            }
+            std::string key;
+            if (!parseString(key)) return false;
+            skipSpace();
+            if (pos >= text.size() || text[pos] != ':') {
+                return failWith("ожидалось двоеточие");
+            }
+            ++pos;
+            members.emplace_back(std::move(key), JsonValue());
+            if (!parseValue(members.back().second, depth)) return false;
+            skipSpace();
+            if (pos < text.size() && text[pos] == ',') {
+                ++pos;
+                continue;
+            }
+            if (pos < text.size() && text[pos] == '}') {
+                ++pos;
+                return true;
+            }
+            return failWith("ожидалась запятая или }");
+        }
+    }
+
+    // Вся строка - один объект
+    bool parseLine(std::vector<std::pair<std::string, JsonValue>>& members) {
+        if (!parseObject(members, 0)) return false;
+        skipSpace();
+        return pos == text.size() || failWith("лишние символы после объекта");
+    }
+};
+
+// Поля объекта JSON по ключам
+class JsonRow {
+private:
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+public:
+    bool parse(std::string_view line, std::string& reason) {
+        JsonParser parser(line, reason);
+        return parser.parseLine(members);
+    }
+
+    const JsonValue* find(std::string_view key) const {
+        for (const auto& member : members) {
+            if (member.first == key) return &member.second;
+        }
+        return nullptr;
+    }
+
+    // строка по ключу; отсутствующий ключ и null - пустая строка
+    bool getString(std::string_view key, std::string& value, std::string& reason) const {
+        const JsonValue* found = find(key);
+        if (!found || (found->type == JsonValue::LITERAL && found->text == "null")) {
+            value.clear();
+            return true;
+        }
+        if (found->type != JsonValue::STRING) {
+            reason = "поле " + std::string(key) + " должно быть строкой";
+            return false;
+        }
+        value = found->text;
+        return true;
+    }
+
+    bool getInt(std::string_view key, int& value, std::string& reason) const {
+        const JsonValue* found = find(key);
+        if (!found || found->type != JsonValue::NUMBER || found->number != std::floor(found->number) ||
+            std::fabs(found->number) > 1e9) {
+            reason = "поле " + std::string(key) + " должно быть целым числом";
+            return false;
+        }
+        value = static_cast<int>(found->number);
+        return true;
+    }
+
+    // вложенный объект как список пар; числа - в текстовом виде
+    bool getPairs(std::string_view key, Pairs& pairs, bool numbers, std::string& reason) const {
+        pairs.clear();
+        const JsonValue* found = find(key);
+        if (!found) {
+            return true;
+        }
+        if (found->type != JsonValue::OBJECT) {
+            reason = "поле " + std::string(key) + " должно быть объектом";
+            return false;
+        }
+        for (const auto& member : found->members) {
+            JsonValue::Type expected = numbers ? JsonValue::NUMBER : JsonValue::STRING;
+            if (member.second.type != expected) {
+                reason = "значение " + member.first + " в " + std::string(key) + (numbers ? " должно быть числом" : " должно быть строкой");
+                return false;
+            }
+            pairs.emplace_back(member.first, numbers ? std::string() : member.second.text);
+            if (numbers) {
+                char buffer[32];
+                std::to_chars_result written = std::to_chars(buffer, buffer + sizeof(buffer), member.second.number);
+                pairs.back().second.assign(buffer, written.ptr);
+            }
+        }
+        return true;
+    }
+};
+
+// === Разбор записей ===
+
+BoardGame* parseGame(std::string_view line, ImportFormat format, std::string& reason) {
+    std::string name, description, edition;
+    int minPlayers = 0;
+    int maxPlayers = 0;
+    Pairs features;
+    if (format == ImportFormat::Csv) {
+        std::vector<std::string> fields;
+        if (!splitCsv(line, fields, reason)) return nullptr;
+        if (fields.size() < 5 || fields.size() > 6) {
+            reason = "ожидалось 5 или 6 полей, получено " + std::to_string(fields.size());
+            return nullptr;
+        }
+        name = fields[0];
+        description = fields[1];
+        edition = fields[4];
+        if (!parseInt(fields[2], minPlayers) || !parseInt(fields[3], maxPlayers)) {
+            reason = "число игроков должно быть целым";
+            return nullptr;
+        }
+        if (fields.size() == 6 && !splitPairs(fields[5], features, reason)) return nullptr;
+    } else {
+        JsonRow row;
+        if (!row.parse(line, reason) || !row.getString("name", name, reason) ||
+            !row.getString("description", description, reason) || !row.getString("edition", edition, reason) ||
+            !row.getInt("minPlayers", minPlayers, reason) || !row.getInt("maxPlayers", maxPlayers, reason) ||
+            !row.getPairs("features", features, false, reason)) {
+            return nullptr;
+        }
+    }
+
+    if (name.empty()) {
+        reason = "пустое название игры";
+        return nullptr;
+    }
+    if (minPlayers < 1 || maxPlayers < minPlayers) {
+        reason = "неверное число игроков " + std::to_string(minPlayers) + "-" + std::to_string(maxPlayers);
+        return nullptr;
+    }
+    BoardGame* game = new BoardGame(name, description, minPlayers, maxPlayers, edition);
+    for (const auto& feature : features) {
+        game->addFeature(feature.first, feature.second);
+    }
+    return game;
+}
+
+Player* parsePlayer(std::string_view line, ImportFormat format, std::string& reason) {
+    std::string id, name;
+    if (format == ImportFormat::Csv) {
+        std::vector<std::string> fields;
+        if (!splitCsv(line, fields, reason)) return nullptr;
+        if (fields.size() < 1 || fields.size() > 2) {
+            reason = "ожидалось 1 или 2 поля, получено " + std::to_string(fields.size());
+            return nullptr;
+        }
+        id = fields[0];
+        if (fields.size() == 2) name = fields[1];
+    } else {
+        JsonRow row;
+        if (!row.parse(line, reason) || !row.getString("id", id, reason) || !row.getString("name", name, reason)) {
+            return nullptr;
+        }
+    }
+
+    if (id.empty()) {
+        reason = "пустой ID игрока";
+        return nullptr;
+    }
+    return new Player(id, name);
+}
+
+Match* parseMatch(std::string_view line, ImportFormat format, std::string& reason) {
+    std::string id, game, date;
+    Pairs results;
+    if (format == ImportFormat::Csv) {
+        std::vector<std::string> fields;
+        if (!splitCsv(line, fields, reason)) return nullptr;
+        if (fields.size() != 4) {
+            reason = "ожидалось 4 поля, получено " + std::to_string(fields.size());
+            return nullptr;
+        }
+        id = fields[0];
+        game = fields[1];
+        date = fields[2];
+        if (!splitPairs(fields[3], results, reason)) return nullptr;
+    } else {
+        JsonRow row;
+        if (!row.parse(line, reason) || !row.getString("id", id, reason) || !row.getString("game", game, reason) ||
+            !row.getString("date", date, reason) || !row.getPairs("results", results, true, reason)) {
+            return nullptr;
+        }
+    }
+
+    if (id.empty() || game.empty()) {
+        reason = "пустой ID партии или название игры";
+        return nullptr;
+    }
+    Date day = Date::parse(date);
+    if (!day.isKnown()) {
+        reason = "дата должна быть в виде ГГГГ-ММ-ДД: " + date;
+        return nullptr;
+    }
+    if (results.empty()) {
+        reason = "нет результатов игроков";
+        return nullptr;
+    }
+
+    std::vector<double> values(results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (!parseNumber(results[i].second, values[i])) {
+            reason = "результат игрока " + results[i].first + " должен быть числом";
+            return nullptr;
+        }
+    }
+    Match* match = new Match(id, game, day);
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (!match->addPlayerResult(results[i].first, values[i])) {
+            reason = "игрок " + results[i].first + " указан дважды";
+            delete match;
+            return nullptr;
+        }
+    }
+    return match;
+}
+
+// Разобранная строка
+template <typename T>
+struct ParsedRow {
+    T* object;
+    size_t line;
+};
+
+// Итог разбора одной части строк
+template <typename T>
+struct ParsedPart {
+    std::vector<ParsedRow<T>> rows;
+    std::vector<RejectedRow> rejects;
+};
+
+// Читать поток частями и разбирать строки частей параллельно; insert добавляет разобранные объекты части
+// в базу по порядку строк и дописывает отклоненные в rejects
+template <typename T, typename Parse, typename Insert>
+void importRows(std::istream& in, ImportFormat format, const ImportOptions& options, ImportReport& report,
+                Parse parse, Insert insert) {
+    std::vector<char> buffer;
+    size_t lineNumber = 0;
+    bool skipHeader = format == ImportFormat::Csv && options.csvHeader;
+    size_t chunkBytes = std::max<size_t>(options.chunkBytes, 1);
+    bool finished = false;
+
+    while (!finished) {
+        size_t carried = buffer.size();
+        buffer.resize(carried + chunkBytes);
+        in.read(buffer.data() + carried, static_cast<std::streamsize>(chunkBytes));
+        buffer.resize(carried + static_cast<size_t>(in.gcount()));
+        finished = !in;
+
+        // часть - до последнего перевода строки; остаток переходит в следующую
+        size_t cut = buffer.size();
+        if (!finished) {
+            size_t newline = std::string_view(buffer.data(), buffer.size()).rfind('\n');
+            if (newline == std::string_view::npos) {
+                continue;  // строка длиннее части - дочитываем
+            }
+            cut = newline + 1;
+        }
+
+        std::vector<Line> lines;
+        std::string_view chunk(buffer.data(), cut);
+        while (!chunk.empty()) {
+            size_t newline = chunk.find('\n');
+            std::string_view text = chunk.substr(0, newline);
+            chunk = newline == std::string_view::npos ? std::string_view() : chunk.substr(newline + 1);
+            if (++lineNumber == 1 && text.substr(0, 3) == "\xEF\xBB\xBF") {
+                text.remove_prefix(3);  // метка UTF-8 из выгрузок табличных редакторов
+            }
+            text = trim(text);
+            if (text.empty()) {
+                continue;
+            }
+            if (skipHeader) {
+                skipHeader = false;
+                continue;
+            }
+            lines.push_back(Line{text, lineNumber});
+        }
+
+        size_t partCount = (lines.size() + LINES_PER_PART - 1) / LINES_PER_PART;
+        std::vector<ParsedPart<T>> parts(partCount);
+        ParallelScan::forEachChunk(partCount, [&](size_t part) {
+            size_t last = std::min(lines.size(), (part + 1) * LINES_PER_PART);
+            std::string reason;
+            for (size_t i = part * LINES_PER_PART; i < last; ++i) {
+                reason.clear();
+                T* object = parse(lines[i].text, format, reason);
+                if (object) {
+                    parts[part].rows.push_back(ParsedRow<T>{object, lines[i].number});
+                } else {
+                    parts[part].rejects.push_back(RejectedRow{lines[i].number, reason});
+                }
+            }
+        });
+
+        std::vector<ParsedRow<T>> rows;
+        std::vector<RejectedRow> rejects;
+        for (ParsedPart<T>& part : parts) {
+            rows.insert(rows.end(), part.rows.begin(), part.rows.end());
+            rejects.insert(rejects.end(), part.rejects.begin(), part.rejects.end());
+        }
+        report.rows += lines.size();
+        report.imported += insert(rows, rejects);
+
+        report.rejected += rejects.size();
+        std::sort(rejects.begin(), rejects.end(),
+                  [](const RejectedRow& a, const RejectedRow& b) { return a.line < b.line; });
+        for (RejectedRow& reject : rejects) {
+            if (report.rejects.size() >= options.maxRejects) break;
+            report.rejects.push_back(std::move(reject));
+        }
+
+        buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(cut));
+    }
+
+    report.ok = !in.bad();
+    if (!report.ok) {
+        report.error = "ошибка чтения";
+    }
+}
+
+}
+
+double ImportReport::rowsPerSecond() const {
+    return seconds > 0 ? rows / seconds : 0.0;
+}
+
+BulkImporter::BulkImporter(GameDatabase& db, const Options& options) : db(db), options(options) {}
+
+const BulkImporter::Options& BulkImporter::getOptions() const {
+    return options;
+}
+
+ImportReport BulkImporter::run(std::istream& in, ImportFormat format, Kind kind) const {
+    if (format == ImportFormat::Auto) {
+        format = ImportFormat::Csv;
+    }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    ImportReport report;
+
+    if (kind == Kind::Games) {
+        importRows<BoardGame>(in, format, options, report, parseGame,
+            [&](std::vector<ParsedRow<BoardGame>>& rows, std::vector<RejectedRow>& rejects) {
+                size_t added = 0;
+                for (const ParsedRow<BoardGame>& row : rows) {
+                    if (db.addGame(row.object)) {
+                        ++added;
+                    } else {
+                        rejects.push_back(RejectedRow{row.line, "игра " + row.object->getName() + " уже есть"});
+                        delete row.object;
+                    }
+                }
+                return added;
+            });
+    } else if (kind == Kind::Players) {
+        importRows<Player>(in, format, options, report, parsePlayer,
+            [&](std::vector<ParsedRow<Player>>& rows, std::vector<RejectedRow>& rejects) {
+                size_t added = 0;
+                for (const ParsedRow<Player>& row : rows) {
+                    if (db.addPlayer(row.object)) {
+                        ++added;
+                    } else {
+                        rejects.push_back(RejectedRow{row.line, "игрок " + row.object->getPlayerId() + " уже есть"});
+                        delete row.object;
+                    }
+                }
+                return added;
+            });
+    } else {
+        importRows<Match>(in, format, options, report, parseMatch,
+            [&](std::vector<ParsedRow<Match>>& rows, std::vector<RejectedRow>& rejects) {
+                std::vector<Match*> batch;
+                batch.reserve(rows.size());
+                for (const ParsedRow<Match>& row : rows) {
+                    batch.push_back(row.object);
+                }
+                std::vector<size_t> rejected;
+                size_t added = db.addMatches(batch, &rejected);
+                for (size_t index : rejected) {
+                    Match* match = batch[index];
+                    std::string reason = db.getGame(match->getGameName())
+                        ? "партия " + match->getMatchId() + " уже есть"
+                        : "нет игры " + match->getGameName();
+                    rejects.push_back(RejectedRow{rows[index].line, reason});
+                    delete match;
+                }
+                return added;
+            });
+    }
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+ImportReport BulkImporter::runFile(const std::string& path, Kind kind) const {
+    ImportFormat format = options.format;
+    if (format == ImportFormat::Auto) {
+        size_t dot = path.find_last_of('.');
+        std::string extension = dot == std::string::npos ? "" : path.substr(dot + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        format = (extension == "jsonl" || extension == "ndjson" || extension == "json") ? ImportFormat::JsonLines
+                                                                                         : ImportFormat::Csv;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        ImportReport report;
+        report.error = "не удалось открыть " + path;
+        return report;
+    }
+    return run(in, format, kind);
+}
+
+ImportReport BulkImporter::importGames(const std::string& path) const {
+    return runFile(path, Kind::Games);
+}
+
+ImportReport BulkImporter::importPlayers(const std::string& path) const {
+    return runFile(path, Kind::Players);
+}
+
+ImportReport BulkImporter::importMatches(const std::string& path) const {
+    return runFile(path, Kind::Matches);
+}
+
+ImportReport BulkImporter::importGames(std::istream& in, ImportFormat format) const {
+    return run(in, format, Kind::Games);
+}
+
+ImportReport BulkImporter::importPlayers(std::istream& in, ImportFormat format) const {
+    return run(in, format, Kind::Players);
+}
+
+ImportReport BulkImporter::importMatches(std::istream& in, ImportFormat format) const {
+    return run(in, format, Kind::Matches);
+}
+
+void BulkImporter::runTests() {
+    std::cout << "\n=== Тестирование класса BulkImporter ===" << std::endl;
+
+    // Тест 1: CSV - кавычки, признаки, отклоненные строки не прерывают импорт
+    {
+        GameDatabase db;
+        BulkImporter importer(db);
+        std::istringstream games(
+            "name,description,min_players,max_players,edition,features\n"
+            "Импорт Каркассон,\"Тайлы, замки и \"\"поля\"\"\",2,5,Базовая,Жанр=Стратегия;Тема=Средневековье\n"
+            "Импорт Уно,Карты,2,10,\n"
+            "Импорт Сломанная,,три,4,\n"
+            "Импорт Уно,Повтор,2,10,\n");
+        std::istringstream players("id,name\r\nimport_ira,Ирина\r\n\r\nimport_oleg,Олег\r\n,Без ID\r\n");
+        std::istringstream matches(
+            "id,game,date,results\n"
+            "import_m1,Импорт Каркассон,2024-05-01,import_ira=80;import_oleg=65\n"
+            "import_m2,Импорт Уно,2024-05-02,import_oleg=1\n"
+            "import_m3,Импорт Нет,2024-05-03,import_ira=1\n"
+            "import_m1,Импорт Уно,2024-05-04,import_ira=1\n"
+            "import_m4,Импорт Уно,05.05.2024,import_ira=1\n"
+            "import_m5,Импорт Уно,2024-05-05,import_ira=много\n");
+
+        ImportReport gameReport = importer.importGames(games, ImportFormat::Csv);
+        ImportReport playerReport = importer.importPlayers(players, ImportFormat::Csv);
+        ImportReport matchReport = importer.importMatches(matches, ImportFormat::Csv);
+        const BoardGame* carcassonne = db.getGame("Импорт Каркассон");
+
+        std::cout << "Тест 1 - Импорт CSV: ";
+        if (gameReport.ok && gameReport.rows == 4 && gameReport.imported == 2 && gameReport.rejected == 2 &&
+            gameReport.rejects[0].line == 4 && gameReport.rejects[1].line == 5 &&
+            carcassonne && carcassonne->getDescription() == "Тайлы, замки и \"поля\"" &&
+            carcassonne->getFeature("Тема") == "Средневековье" &&
+            playerReport.rows == 3 && playerReport.imported == 2 && playerReport.rejects[0].line == 5 &&
+            matchReport.rows == 6 && matchReport.imported == 2 && matchReport.rejected == 4 &&
+            matchReport.rejects[0].line == 4 && matchReport.rejects[0].reason == "нет игры Импорт Нет" &&
+            matchReport.rejects[1].reason == "партия import_m1 уже есть" &&
+            db.getPlayer("import_ira")->getMatchHistory().size() == 1 &&
+            db.getPlayerRatingInGame("import_oleg", "Импорт Каркассон") == 65) {
+            std::cout << "PASSED" << std::endl;
+        } else {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+
+    // Тест 2: JSON Lines из файла (формат по расширению) - экранирование, вложенные объекты, ошибки разбора
+    {
+        const std::string path = "bulk_importer_test.jsonl";
+        {
+            std::ofstream out(path, std::ios::binary);
+            out << "{\"name\": \"Импорт \\\"Азул\\\"\", \"minPlayers\": 2, \"maxPlayers\": 4, "
+                   "\"features\": {\"\\u0416анр\": \"Абстрактная\"}, \"year\": 2017}\n"
+                << "{\"name\": \"Импорт Без числа\", \"minPlayers\": \"два\", \"maxPlayers\": 4}\n"
+                << "{\"name\": \"Импорт Оборванная\", \"minPlayers\": 2\n"
+                << "{\"name\": \"Импорт Массив\", \"minPlayers\": 2, \"maxPlayers\": 4, \"tags\": [1]}\n";
+        }
+        GameDatabase db;
+        BulkImporter importer(db);
+        ImportReport games = importer.importGames(path);
+        std::remove(path.c_str());
+
+        std::istringstream matches(
+            "{\"id\": \"import_j1\", \"game\": \"Импорт \\\"Азул\\\"\", \"date\": \"2024-06-01\", "
+            "\"results\": {\"import_ira\": 42.5, \"import_oleg\": 40}}\n"
+            "{\"id\": \"import_j2\", \"game\": \"Импорт \\\"Азул\\\"\", \"date\": \"2024-06-02\", \"results\": {\"import_ira\": \"x\"}}\n");
+        ImportReport matchReport = importer.importMatches(matches, ImportFormat::JsonLines);
+        const BoardGame* azul = db.getGame("Импорт \"Азул\"");
+        const Match* match = db.getMatch("import_j1");
+
+        std::cout << "Тест 2 - Импорт JSON Lines: ";
+        if (games.ok && games.rows == 4 && games.imported == 1 && games.rejected == 3 &&
+            azul && azul->getFeature("Жанр") == "Абстрактная" && azul->getMaxPlayers() == 4 &&
+            matchReport.imported == 1 && matchReport.rejected == 1 && matchReport.rejects[0].line == 2 &&
+            match && match->getPlayerResult("import_ira") == 42.5 && match->getPlayerCount() == 2 &&
+            !importer.importGames("bulk_importer_missing.csv").ok) {
+            std::cout << "PASSED" << std::endl;
+        } else {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+
+    // Тест 3: мелкие части и пул потоков дают ту же базу, что addMatch построчно
+    {
+        ParallelScan::setWorkerCount(3);
+        const int matchCount = 5000;
+        std::ostringstream csv;
+        csv << "id,game,date,results\n";
+        for (int m = 0; m < matchCount; ++m) {
+            csv << "import_bulk_" << m << ",Импорт Игра " << m % 7 << ",2024-07-" << (10 + m % 20)
+                << ",import_bulk_player_" << m % 13 << "=" << m % 10 << ";import_bulk_player_" << (m % 13 + 1 + m % 5) % 13
+                << "=" << m % 6 << "\n";
+            if (m % 1000 == 500) {
+                csv << "import_bulk_bad_" << m << ",Импорт Игра 1,2024-07-01\n";
+            }
+        }
+
+        GameDatabase bulk;
+        GameDatabase single;
+        for (int g = 0; g < 7; ++g) {
+            bulk.addGame(new BoardGame("Импорт Игра " + std::to_string(g), "", 2, 4, ""));
+            single.addGame(new BoardGame("Импорт Игра " + std::to_string(g), "", 2, 4, ""));
+        }
+        for (int p = 0; p < 13; ++p) {
+            bulk.addPlayer(new Player("import_bulk_player_" + std::to_string(p)));
+            single.addPlayer(new Player("import_bulk_player_" + std::to_string(p)));
+        }
+
+        Options options;
+        options.chunkBytes = 4096;
+        options.maxRejects = 3;
+        std::istringstream in(csv.str());
+        ImportReport report = BulkImporter(bulk, options).importMatches(in, ImportFormat::Csv);
+
+        std::string line;
+        std::istringstream again(csv.str());
+        std::getline(again, line);
+        while (std::getline(again, line)) {
+            std::string reason;
+            Match* match = parseMatch(line, ImportFormat::Csv, reason);
+            if (match && !single.addMatch(match)) delete match;
+        }
+
+        bool same = bulk.getAllMatches().size() == single.getAllMatches().size();
+        for (size_t i = 0; same && i < bulk.getAllMatches().size(); ++i) {
+            same = bulk.getAllMatches()[i]->getMatchId() == single.getAllMatches()[i]->getMatchId();
+        }
+        for (int p = 0; same && p < 13; ++p) {
+            std::string id = "import_bulk_player_" + std::to_string(p);
+            same = bulk.getPlayer(id)->getMatchHistory() == single.getPlayer(id)->getMatchHistory() &&
+                   bulk.getPlayerRatingInGame(id, "Импорт Игра 3") == single.getPlayerRatingInGame(id, "Импорт Игра 3") &&
+                   bulk.getPlayerGames(id) == single.getPlayerGames(id) &&
+                   bulk.matchesOfPlayer(id).size() == single.matchesOfPlayer(id).size();
+            for (int g = 0; same && g < 7; ++g) {
+                std::string game = "Импорт Игра " + std::to_string(g);
+                const SkillRating* bulkSkill = bulk.getSkillRating(id, game);
+                const SkillRating* singleSkill = single.getSkillRating(id, game);
+                same = bulk.getLeaderboard(game)->rankOf(id) == single.getLeaderboard(game)->rankOf(id) &&
+                       bulk.getLeaderboard(game)->scoreOf(id) == single.getLeaderboard(game)->scoreOf(id) &&
+                       bulkSkill && singleSkill && bulkSkill->rating == singleSkill->rating &&
+                       bulkSkill->matches == singleSkill->matches;
+            }
+        }
+        for (int g = 0; same && g < 7; ++g) {
+            std::string game = "Импорт Игра " + std::to_string(g);
+            MatchRange bulkWeek = bulk.getMatchesBetween(Date(2024, 7, 12), Date(2024, 7, 18), game);
+            MatchRange singleWeek = single.getMatchesBetween(Date(2024, 7, 12), Date(2024, 7, 18), game);
+            same = bulkWeek.size() == singleWeek.size() && 
+                   bulk.getMatchesByGame(game).size() == single.getMatchesByGame(game).size();
+            for (size_t i = 0; same && i < bulkWeek.size(); ++i) {
+                same = bulkWeek[i]->getMatchId() == singleWeek[i]->getMatchId();
+            }
+        }
+        ParallelScan::setWorkerCount(0);
+
+        std::cout << "Тест 3 - Части и пакетное добавление: ";
+        if (report.ok && report.rows == matchCount + 5 && report.imported == matchCount && report.rejected == 5 &&
+            report.rejects.size() == 3 && report.rejects[0].line == 503 && same) {
+            std::cout << "PASSED" << std::endl;
+        } else {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+
+    std::cout << "=== Тестирование BulkImporter завершено ===\n" << std::endl;
+}
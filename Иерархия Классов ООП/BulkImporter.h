@@ -0,0 +1,89 @@
+#ifndef BULK_IMPORTER_H
+#define BULK_IMPORTER_H
+
+#include "GameDatabase.h"
+#include <istream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// Формат файла выгрузки
+enum class ImportFormat {
+    Auto,       // по расширению файла: .jsonl, .ndjson, .json - JsonLines, остальные - Csv
+    Csv,        // поля через запятую, значения с запятыми и кавычками - в двойных кавычках ("" внутри - кавычка)
+    JsonLines   // по объекту JSON в строке
+};
+
+// Настройки импорта (см. BulkImporter)
+struct ImportOptions {
+    ImportFormat format = ImportFormat::Auto;
+    size_t chunkBytes = 4 << 20;   // сколько байт читается и разбирается за раз
+    bool csvHeader = true;         // первая строка CSV - заголовок, а не данные
+    size_t maxRejects = 100;       // сколько отклоненных строк сохранить в отчете (считаются все)
+};
+
+// Отклоненная строка файла
+struct RejectedRow {
+    size_t line;         // номер строки в файле, с 1
+    std::string reason;
+};
+
+// Итог импорта
+struct ImportReport {
+    bool ok = false;               // файл прочитан до конца (отклоненные строки ошибкой не считаются)
+    std::string error;
+    size_t rows = 0;               // строк с данными (без заголовка и пустых)
+    size_t imported = 0;
+    size_t rejected = 0;
+    double seconds = 0.0;
+    std::vector<RejectedRow> rejects;  // первые maxRejects отклоненных по порядку строк
+
+    double rowsPerSecond() const;
+};
+
+// Потоковый импорт выгрузок игр, игроков и партий в GameDatabase
+// Файл читается частями по chunkBytes (по границам строк), строки части разбираются параллельно
+// пулом ParallelScan, затем разобранные объекты добавляются в базу пачкой по порядку строк
+// (партии - GameDatabase::addMatches); память под весь файл не нужна
+// Строка с ошибкой разбора или отклоненная базой (нет игры, повторный ID) попадает в отчет, импорт продолжается
+//
+// Поля CSV (строка - одна запись, переводы строк внутри значений не поддерживаются):
+//   игры:    name,description,min_players,max_players,edition,features   (features - "ключ=значение;...")
+//   игроки:  id,name
+//   партии:  id,game,date,results                                         (results - "игрок=результат;...")
+// Поля JSON Lines - те же с ключами name, description, minPlayers, maxPlayers, edition, features (объект);
+// id, name; id, game, date, results (объект игрок -> число); прочие ключи пропускаются
+// Импорт выполняет поток-писатель базы
+class BulkImporter {
+public:
+    typedef ImportOptions Options;
+
+private:
+    GameDatabase& db;
+    Options options;
+
+    enum class Kind { Games, Players, Matches };
+
+    ImportReport run(std::istream& in, ImportFormat format, Kind kind) const;
+    ImportReport runFile(const std::string& path, Kind kind) const;
+
+public:
+    explicit BulkImporter(GameDatabase& db, const Options& options = Options());
+
+    const Options& getOptions() const;
+
+    // Импорт из файла; формат - options.format или по расширению
+    ImportReport importGames(const std::string& path) const;
+    ImportReport importPlayers(const std::string& path) const;
+    ImportReport importMatches(const std::string& path) const;
+
+    // Импорт из потока в заданном формате (Auto - Csv)
+    ImportReport importGames(std::istream& in, ImportFormat format) const;
+    ImportReport importPlayers(std::istream& in, ImportFormat format) const;
+    ImportReport importMatches(std::istream& in, ImportFormat format) const;
+
+    static void runTests();
+};
+
+#endif
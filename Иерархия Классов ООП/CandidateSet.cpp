@@ -0,0 +1,235 @@
+#include "CandidateSet.h"
+#include <algorithm>
+#include <iostream>
+
+CandidateSet::CandidateSet(size_t universe)
+    : universe(universe), dense(false), cardinality(0) {}
+
+size_t CandidateSet::sparseLimit() const {
+    // 4 байта на номер против universe/8 байт на битовую карту
+    return universe / 32;
+}
+
+void CandidateSet::toDense() {
+    if (dense) return;
+    words.assign((universe + 63) / 64, 0);
+    for (uint32_t id : ids) {
+        words[id / 64] |= uint64_t(1) << (id % 64);
+    }
+    std::vector<uint32_t>().swap(ids);
+    dense = true;
+}
+
+void CandidateSet::toSparse() {
+    if (!dense) return;
+    std::vector<uint32_t> result;
+    result.reserve(cardinality);
+    forEach([&result](uint32_t id) { result.push_back(id); });
+    ids.swap(result);
+    std::vector<uint64_t>().swap(words);
+    dense = false;
+}
+
+void CandidateSet::add(uint32_t id) {
+    if (id >= universe) {
+        universe = id + static_cast<size_t>(1);
+        if (dense) {
+            words.resize((universe + 63) / 64, 0);
+        }
+    }
+
+    if (!dense) {
+        if (ids.empty() || ids.back() < id) {
+            ids.push_back(id);
+            ++cardinality;
+            if (ids.size() > sparseLimit()) {
+                toDense();
+            }
+            return;
+        }
+        if (ids.back() == id) return;
+        // номер не по порядку - проще перейти на битовую карту
+        toDense();
+    }
+
+    uint64_t mask = uint64_t(1) << (id % 64);
+    if (!(words[id / 64] & mask)) {
+        words[id / 64] |= mask;
+        ++cardinality;
+    }
+}
+
+bool CandidateSet::contains(uint32_t id) const {
+    if (id >= universe) return false;
+    if (dense) {
+        return (words[id / 64] >> (id % 64)) & 1;
+    }
+    return std::binary_search(ids.begin(), ids.end(), id);
+}
+
+size_t CandidateSet::count() const {
+    return cardinality;
+}
+
+bool CandidateSet::empty() const {
+    return cardinality == 0;
+}
+
+size_t CandidateSet::universeSize() const {
+    return universe;
+}
+
+bool CandidateSet::isDense() const {
+    return dense;
+}
+
+void CandidateSet::intersectWith(const CandidateSet& other) {
+    if (dense && other.dense) {
+        // побитовое И по словам, лишние слова обнуляются
+        size_t common = std::min(words.size(), other.words.size());
+        cardinality = 0;
+        for (size_t w = 0; w < common; ++w) {
+            words[w] &= other.words[w];
+            cardinality += __builtin_popcountll(words[w]);
+        }
+        std::fill(words.begin() + common, words.end(), 0);
+    } else if (!dense) {
+        // массив номеров фильтруется проверкой по другому множеству
+        size_t kept = 0;
+        for (uint32_t id : ids) {
+            if (other.contains(id)) {
+                ids[kept++] = id;
+            }
+        }
+        ids.resize(kept);
+        cardinality = kept;
+    } else {
+        // плотное И разреженное: результат не больше разреженного
+        std::vector<uint32_t> result;
+        result.reserve(other.ids.size());
+        for (uint32_t id : other.ids) {
+            if (contains(id)) {
+                result.push_back(id);
+            }
+        }
+        std::vector<uint64_t>().swap(words);
+        ids.swap(result);
+        cardinality = ids.size();
+        dense = false;
+    }
+    optimize();
+}
+
+void CandidateSet::intersectWithBits(const std::vector<uint64_t>& bits) {
+    if (dense) {
+        cardinality = 0;
+        for (size_t w = 0; w < words.size(); ++w) {
+            words[w] &= w < bits.size() ? bits[w] : 0;
+            cardinality += __builtin_popcountll(words[w]);
+        }
+    } else {
+        size_t kept = 0;
+        for (uint32_t id : ids) {
+            if (id / 64 < bits.size() && ((bits[id / 64] >> (id % 64)) & 1)) {
+                ids[kept++] = id;
+            }
+        }
+        ids.resize(kept);
+        cardinality = kept;
+    }
+    optimize();
+}
+
+void CandidateSet::optimize() {
+    if (dense && cardinality <= sparseLimit()) {
+        toSparse();
+    } else if (!dense && cardinality > sparseLimit()) {
+        toDense();
+    }
+}
+
+std::vector<uint32_t> CandidateSet::toVector() const {
+    std::vector<uint32_t> result;
+    result.reserve(cardinality);
+    forEach([&result](uint32_t id) { result.push_back(id); });
+    return result;
+}
+
+void CandidateSet::runTests() {
+    std::cout << "\n=== Тестирование класса CandidateSet ===" << std::endl;
+
+    CandidateSet small(1000);
+    small.add(3);
+    small.add(10);
+    small.add(700);
+
+    std::cout << "Тест 1 - Разреженное множество: ";
+    if (!small.isDense() && small.count() == 3 && small.contains(10) && !small.contains(11)) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    CandidateSet large(1000);
+    for (uint32_t id = 0; id < 1000; id += 2) {
+        large.add(id);
+    }
+
+    std::cout << "Тест 2 - Переход на битовую карту: ";
+    if (large.isDense() && large.count() == 500 && large.contains(998) && !large.contains(999)) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    CandidateSet thirds(1000);
+    for (uint32_t id = 0; id < 1000; id += 3) {
+        thirds.add(id);
+    }
+    CandidateSet both = large;
+    both.intersectWith(thirds);
+
+    std::cout << "Тест 3 - Пересечение битовых карт: ";
+    if (both.count() == 167 && both.contains(6) && !both.contains(4) && both.isDense()) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED (найдено " << both.count() << ")" << std::endl;
+    }
+
+    CandidateSet mixed = large;
+    mixed.intersectWith(small);
+    std::vector<uint32_t> mixedIds = mixed.toVector();
+
+    std::cout << "Тест 4 - Пересечение карты и массива: ";
+    if (!mixed.isDense() && mixedIds.size() == 2 && mixedIds[0] == 10 && mixedIds[1] == 700) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    CandidateSet unordered(100);
+    unordered.add(50);
+    unordered.add(5);
+    unordered.add(50);
+
+    std::cout << "Тест 5 - Добавление не по порядку: ";
+    if (unordered.count() == 2 && unordered.contains(5) && unordered.contains(50)) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // битовая карта короче множества: недостающие слова считаются нулевыми
+    CandidateSet masked = large;
+    masked.intersectWithBits(std::vector<uint64_t>{0xFFull, 0x1ull});
+    std::vector<uint32_t> maskedIds = masked.toVector();
+
+    std::cout << "Тест 6 - Пересечение с битовой картой: ";
+    if (masked.count() == 5 && maskedIds.front() == 0 && maskedIds.back() == 64) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    std::cout << "=== Тестирование CandidateSet завершено ===\n" << std::endl;
+}
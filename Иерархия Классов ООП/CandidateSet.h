@@ -0,0 +1,64 @@
+#ifndef CANDIDATE_SET_H
+#define CANDIDATE_SET_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// множество игр-кандидатов по номерам из SymbolTable::games()
+// два представления, как контейнеры в roaring bitmap:
+//  - разреженное: отсортированный массив номеров (когда найдено мало игр)
+//  - плотное: битовая карта на все пространство номеров
+// представление выбирается по размеру: массив выгоднее, пока в нем меньше universe/32 номеров
+// цепочка фильтров сужает множество пересечением (побитовое И)
+class CandidateSet {
+private:
+    size_t universe; // размер пространства номеров
+    bool dense;
+    std::vector<uint64_t> words; // плотное представление
+    std::vector<uint32_t> ids; // разреженное представление (по возрастанию)
+    size_t cardinality;
+
+    void toDense();
+    void toSparse();
+    size_t sparseLimit() const;
+
+public:
+    explicit CandidateSet(size_t universe = 0);
+
+    void add(uint32_t id); // быстрее всего - по возрастанию номеров
+    bool contains(uint32_t id) const;
+    size_t count() const;
+    bool empty() const;
+    size_t universeSize() const;
+    bool isDense() const;
+
+    void intersectWith(const CandidateSet& other); // this = this И other
+    void intersectWithBits(const std::vector<uint64_t>& bits); // И с битовой картой по номерам (бит id % 64 слова id / 64)
+    void optimize(); // выбрать представление по текущему размеру
+
+    // обход номеров по возрастанию
+    template <typename Visitor>
+    void forEach(Visitor visit) const {
+        if (!dense) {
+            for (uint32_t id : ids) {
+                visit(id);
+            }
+            return;
+        }
+        for (size_t w = 0; w < words.size(); ++w) {
+            uint64_t bits = words[w];
+            while (bits) {
+                unsigned bit = __builtin_ctzll(bits);
+                visit(static_cast<uint32_t>(w * 64 + bit));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    std::vector<uint32_t> toVector() const;
+
+    static void runTests();
+};
+
+#endif
@@ -0,0 +1,576 @@
+#include "CatalogColumns.h"
+#include "BoardGame.h"
+#include "SymbolTable.h"
+#include <algorithm>
+#include <limits>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CATALOG_COLUMNS_X86 1
+#endif
+
+CatalogColumns::SimdLevel CatalogColumns::forcedLevel = CatalogColumns::SimdLevel::AVX2;
+
+namespace {
+
+// ядра сканирования: столбец длиной words * 64, результат - words слов битовой карты
+
+void ratingAtLeastScalar(const double* values, size_t words, double threshold, uint64_t* out) {
+    for (size_t w = 0; w < words; ++w) {
+        const double* block = values + w * 64;
+        uint64_t bits = 0;
+        for (unsigned b = 0; b < 64; ++b) {
+            bits |= static_cast<uint64_t>(block[b] >= threshold) << b;
+        }
+        out[w] = bits;
+    }
+}
+
+void int32InRangeScalar(const int32_t* values, size_t words, int32_t low, int32_t high, uint64_t* out) {
+    for (size_t w = 0; w < words; ++w) {
+        const int32_t* block = values + w * 64;
+        uint64_t bits = 0;
+        for (unsigned b = 0; b < 64; ++b) {
+            bits |= static_cast<uint64_t>(block[b] >= low && block[b] <= high) << b;
+        }
+        out[w] = bits;
+    }
+}
+
+#ifdef CATALOG_COLUMNS_X86
+
+// сравнение дает маску в каждой полосе, movemask собирает старшие биты полос в число
+
+__attribute__((target("sse2")))
+void ratingAtLeastSse2(const double* values, size_t words, double threshold, uint64_t* out) {
+    const __m128d limit = _mm_set1_pd(threshold);
+    for (size_t w = 0; w < words; ++w) {
+        const double* block = values + w * 64;
+        uint64_t bits = 0;
+        for (unsigned b = 0; b < 64; b += 2) {
+            int mask = _mm_movemask_pd(_mm_cmpge_pd(_mm_loadu_pd(block + b), limit));
+            bits |= static_cast<uint64_t>(mask) << b;
+        }
+        out[w] = bits;
+    }
+}
+
+__attribute__((target("sse2")))
+void int32InRangeSse2(const int32_t* values, size_t words, int32_t low, int32_t high, uint64_t* out) {
+    const __m128i lowest = _mm_set1_epi32(low);
+    const __m128i highest = _mm_set1_epi32(high);
+    for (size_t w = 0; w < words; ++w) {
+        const int32_t* block = values + w * 64;
+        uint64_t bits = 0;
+        for (unsigned b = 0; b < 64; b += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + b));
+            __m128i outside = _mm_or_si128(_mm_cmpgt_epi32(lowest, v), _mm_cmpgt_epi32(v, highest));
+            int mask = ~_mm_movemask_ps(_mm_castsi128_ps(outside)) & 0xF;
+            bits |= static_cast<uint64_t>(mask) << b;
+        }
+        out[w] = bits;
+    }
+}
+
+__attribute__((target("avx2")))
+void ratingAtLeastAvx2(const double* values, size_t words, double threshold, uint64_t* out) {
+    const __m256d limit = _mm256_set1_pd(threshold);
+    for (size_t w = 0; w < words; ++w) {
+        const double* block = values + w * 64;
+        uint64_t bits = 0;
+        for (unsigned b = 0; b < 64; b += 4) {
+            int mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(block + b), limit, _CMP_GE_OQ));
+            bits |= static_cast<uint64_t>(mask) << b;
+        }
+        out[w] = bits;
+    }
+}
+
+__attribute__((target("avx2")))
+void int32InRangeAvx2(const int32_t* values, size_t words, int32_t low, int32_t high, uint64_t* out) {
+    const __m256i lowest = _mm256_set1_epi32(low);
+    const __m256i highest = _mm256_set1_epi32(high);
+    for (size_t w = 0; w < words; ++w) {
+        const int32_t* block = values + w * 64;
+        uint64_t bits = 0;
+        for (unsigned b = 0; b < 64; b += 8) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + b));
+            __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(lowest, v), _mm256_cmpgt_epi32(v, highest));
+            int mask = ~_mm256_movemask_ps(_mm256_castsi256_ps(outside)) & 0xFF;
+            bits |= static_cast<uint64_t>(mask) << b;
+        }
+        out[w] = bits;
+    }
+}
+
+#endif
+
+CatalogColumns::SimdLevel detectedLevel() {
+#ifdef CATALOG_COLUMNS_X86
+    static const CatalogColumns::SimdLevel level =
+        __builtin_cpu_supports("avx2") ? CatalogColumns::SimdLevel::AVX2 :
+        __builtin_cpu_supports("sse2") ? CatalogColumns::SimdLevel::SSE2 : CatalogColumns::SimdLevel::Scalar;
+    return level;
+#else
+    return CatalogColumns::SimdLevel::Scalar;
+#endif
+}
+
+void ratingAtLeast(const double* values, size_t words, double threshold, uint64_t* out) {
+#ifdef CATALOG_COLUMNS_X86
+    switch (CatalogColumns::activeLevel()) {
+        case CatalogColumns::SimdLevel::AVX2: ratingAtLeastAvx2(values, words, threshold, out); return;
+        case CatalogColumns::SimdLevel::SSE2: ratingAtLeastSse2(values, words, threshold, out); return;
+        default: break;
+    }
+#endif
+    ratingAtLeastScalar(values, words, threshold, out);
+}
+
+void int32InRange(const int32_t* values, size_t words, int32_t low, int32_t high, uint64_t* out) {
+#ifdef CATALOG_COLUMNS_X86
+    switch (CatalogColumns::activeLevel()) {
+        case CatalogColumns::SimdLevel::AVX2: int32InRangeAvx2(values, words, low, high, out); return;
+        case CatalogColumns::SimdLevel::SSE2: int32InRangeSse2(values, words, low, high, out); return;
+        default: break;
+    }
+#endif
+    int32InRangeScalar(values, words, low, high, out);
+}
+
+const size_t WORDS_PER_BLOCK = BlockColumn<int32_t>::BLOCK_ROWS / 64;
+
+// ядра работают по блокам столбца: блок - непрерывный участок строк, результат блока - свои слова карты
+void scanInRange(const BlockColumn<int32_t>& column, int32_t low, int32_t high, std::vector<uint64_t>& out) {
+    out.resize(column.size() / 64);
+    for (size_t b = 0; b < column.blockCount(); ++b) {
+        const std::vector<int32_t>& block = column.block(b);
+        int32InRange(block.data(), block.size() / 64, low, high, out.data() + b * WORDS_PER_BLOCK);
+    }
+}
+
+}
+
+CatalogColumns::FeatureColumn::FeatureColumn()
+    : dictionary(std::make_shared<FeatureDictionary>()), ownDictionary(true) {}
+
+CatalogColumns::FeatureColumn::FeatureColumn(const FeatureColumn& other)
+    : dictionary(other.dictionary), ownDictionary(false), codes(other.codes) {
+    other.ownDictionary = false;
+}
+
+CatalogColumns::FeatureColumn& CatalogColumns::FeatureColumn::operator=(const FeatureColumn& other) {
+    if (this != &other) {
+        dictionary = other.dictionary;
+        ownDictionary = false;
+        other.ownDictionary = false;
+        codes = other.codes;
+    }
+    return *this;
+}
+
+int32_t CatalogColumns::FeatureColumn::encode(const std::string& value) {
+    auto code = dictionary->codes.find(value);
+    if (code != dictionary->codes.end()) {
+        return code->second;
+    }
+    if (!ownDictionary) {
+        dictionary = std::make_shared<FeatureDictionary>(*dictionary);
+        ownDictionary = true;
+    }
+    dictionary->values.push_back(value);
+    int32_t added = static_cast<int32_t>(dictionary->values.size());
+    dictionary->codes.emplace(value, added);
+    return added;
+}
+
+CatalogColumns::CatalogColumns()
+    : rows(0), present(std::make_shared<std::vector<uint64_t>>()),
+      nameOrder(std::make_shared<const std::vector<uint32_t>>()) {}
+
+void CatalogColumns::build(const std::vector<BoardGame*>& gamesByHandle, const GameMap* gamesByName) {
+    rows = (gamesByHandle.size() + 63) / 64 * 64;
+    present = std::make_shared<std::vector<uint64_t>>(rows / 64, 0);
+    averageRating.assign(rows, std::numeric_limits<double>::quiet_NaN());
+    ratingCount.assign(rows, 0);
+    minPlayers.assign(rows, 0);
+    maxPlayers.assign(rows, 0);
+    nameRank.assign(rows, 0);
+    features.clear();
+    std::vector<uint32_t> order;
+
+    for (size_t id = 0; id < gamesByHandle.size(); ++id) {
+        const BoardGame* game = gamesByHandle[id];
+        if (!game) continue;
+
+        (*present)[id / 64] |= uint64_t(1) << (id % 64);
+        fillRow(static_cast<uint32_t>(id), *game);
+        order.push_back(static_cast<uint32_t>(id));
+    }
+
+    // названия сравниваются один раз при сборке, дальше порядок по названию - сравнение чисел
+    if (gamesByName && gamesByName->size() == order.size()) {
+        order.clear();
+        for (const auto& entry : *gamesByName) {
+            order.push_back(SymbolTable::games().find(entry.first));
+        }
+    } else {
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return gamesByHandle[a]->getName() < gamesByHandle[b]->getName();
+        });
+    }
+    for (size_t rank = 0; rank < order.size(); ++rank) {
+        nameRank.set(order[rank], static_cast<uint32_t>(rank));
+    }
+    nameOrder = std::make_shared<const std::vector<uint32_t>>(std::move(order));
+}
+
+void CatalogColumns::fillRow(uint32_t id, const BoardGame& game) {
+    averageRating.set(id, game.getAverageRating());
+    ratingCount.set(id, static_cast<uint32_t>(game.getRatingsCount()));
+    minPlayers.set(id, game.getMinPlayers());
+    maxPlayers.set(id, game.getMaxPlayers());
+
+    for (const auto& feature : game.getFeatures()) {
+        auto column = features.find(feature.first);
+        if (column == features.end()) {
+            column = features.emplace(feature.first, FeatureColumn()).first;
+            column->second.codes.assign(rows, 0);
+        }
+        column->second.codes.set(id, column->second.encode(feature.second));
+    }
+}
+
+void CatalogColumns::setPresent(uint32_t id, bool inCatalog) {
+    uint64_t bit = uint64_t(1) << (id % 64);
+    uint64_t word = (*present)[id / 64];
+    if (((word & bit) != 0) == inCatalog) return;
+    if (present.use_count() > 1) {
+        present = std::make_shared<std::vector<uint64_t>>(*present);
+    }
+    (*present)[id / 64] = inCatalog ? (word | bit) : (word & ~bit);
+}
+
+// строка очищается и заполняется заново: так же, как ее заполнила бы сборка
+// set не копирует блок, если значение в строке не меняется, поэтому у копии снимка копируются
+// только блоки строк, где правка что-то изменила
+void CatalogColumns::updateRows(const std::vector<BoardGame*>& gamesByHandle, const std::vector<SymbolId>& changed) {
+    for (SymbolId id : changed) {
+        if (id >= rows) continue;
+        const BoardGame* game = id < gamesByHandle.size() ? gamesByHandle[id] : nullptr;
+        setPresent(id, game != nullptr);
+        if (game) {
+            for (auto& column : features) {
+                if (!game->hasFeature(column.first)) {
+                    column.second.codes.set(id, 0);
+                }
+            }
+            fillRow(id, *game);
+        } else {
+            averageRating.set(id, std::numeric_limits<double>::quiet_NaN());
+            ratingCount.set(id, 0);
+            minPlayers.set(id, 0);
+            maxPlayers.set(id, 0);
+            for (auto& column : features) {
+                column.second.codes.set(id, 0);
+            }
+        }
+    }
+}
+
+size_t CatalogColumns::rowCount() const {
+    return rows;
+}
+
+size_t CatalogColumns::wordCount() const {
+    return rows / 64;
+}
+
+const std::vector<uint64_t>& CatalogColumns::presentRows() const {
+    return *present;
+}
+
+double CatalogColumns::averageRatingAt(uint32_t id) const {
+    return averageRating[id];
+}
+
+uint32_t CatalogColumns::ratingCountAt(uint32_t id) const {
+    return ratingCount[id];
+}
+
+int32_t CatalogColumns::minPlayersAt(uint32_t id) const {
+    return minPlayers[id];
+}
+
+int32_t CatalogColumns::maxPlayersAt(uint32_t id) const {
+    return maxPlayers[id];
+}
+
+uint32_t CatalogColumns::nameRankAt(uint32_t id) const {
+    return nameRank[id];
+}
+
+uint32_t CatalogColumns::namePosition(std::string_view name) const {
+    // номера игр совпадают с номерами в SymbolTable::games(), названия берутся оттуда
+    auto position = std::lower_bound(nameOrder->begin(), nameOrder->end(), name, [](uint32_t id, std::string_view key) {
+        return SymbolTable::games().name(id) < key;
+    });
+    return static_cast<uint32_t>(position - nameOrder->begin());
+}
+
+const std::vector<uint32_t>& CatalogColumns::idsByName() const {
+    return *nameOrder;
+}
+
+const BlockColumn<int32_t>* CatalogColumns::featureCodes(std::string_view featureName) const {
+    auto column = features.find(featureName);
+    return column == features.end() ? nullptr : &column->second.codes;
+}
+
+const std::vector<std::string>* CatalogColumns::featureValues(std::string_view featureName) const {
+    auto column = features.find(featureName);
+    return column == features.end() ? nullptr : &column->second.dictionary->values;
+}
+
+std::vector<std::string> CatalogColumns::featureNames() const {
+    std::vector<std::string> names;
+    names.reserve(features.size());
+    for (const auto& column : features) {
+        names.push_back(column.first);
+    }
+    return names;
+}
+
+void CatalogColumns::scanRatingAtLeast(double minRating, std::vector<uint64_t>& out) const {
+    // пустые строки - NaN, сравнение с ними ложно, маска присутствия не нужна
+    out.resize(wordCount());
+    for (size_t b = 0; b < averageRating.blockCount(); ++b) {
+        const std::vector<double>& block = averageRating.block(b);
+        ratingAtLeast(block.data(), block.size() / 64, minRating, out.data() + b * WORDS_PER_BLOCK);
+    }
+}
+
+void CatalogColumns::scanMinPlayers(int32_t low, int32_t high, std::vector<uint64_t>& out) const {
+    scanInRange(minPlayers, low, high, out);
+    for (size_t w = 0; w < out.size(); ++w) {
+        out[w] &= (*present)[w];
+    }
+}
+
+void CatalogColumns::scanMaxPlayers(int32_t low, int32_t high, std::vector<uint64_t>& out) const {
+    scanInRange(maxPlayers, low, high, out);
+    for (size_t w = 0; w < out.size(); ++w) {
+        out[w] &= (*present)[w];
+    }
+}
+
+void CatalogColumns::scanFeatureEquals(std::string_view featureName, std::string_view value,
+                                       std::vector<uint64_t>& out) const {
+    auto column = features.find(featureName);
+    if (column == features.end()) {
+        out.assign(wordCount(), 0);
+        return;
+    }
+    const std::unordered_map<std::string, int32_t>& dictionary = column->second.dictionary->codes;
+    auto code = dictionary.find(std::string(value));
+    if (code == dictionary.end()) {
+        out.assign(wordCount(), 0);
+        return;
+    }
+
+    // код значения >= 1, у пустых строк и игр без признака код 0
+    scanInRange(column->second.codes, code->second, code->second, out);
+}
+
+CatalogColumns::SimdLevel CatalogColumns::activeLevel() {
+    return std::min(detectedLevel(), forcedLevel);
+}
+
+void CatalogColumns::limitLevel(SimdLevel level) {
+    forcedLevel = level;
+}
+
+const char* CatalogColumns::levelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::SSE2: return "SSE2";
+        default: return "скалярный";
+    }
+}
+
+void CatalogColumns::runTests() {
+    std::cout << "\n=== Тестирование класса CatalogColumns ===" << std::endl;
+
+    // 150 игр с пропусками номеров: три неполных слова битовой карты
+    const char* genres[] = {"Стратегия", "Семейная", "Кооператив"};
+    std::vector<BoardGame*> games(150, nullptr);
+    for (size_t id = 0; id < games.size(); ++id) {
+        if (id % 7 == 3) continue;
+        BoardGame* game = new BoardGame("Столбцы " + std::to_string(id), "", 1 + id % 4, 2 + id % 5, "");
+        if (id % 5 != 0) {
+            game->addRating("p1", 1 + id % 5);
+            game->addRating("p2", 1 + (id / 3) % 5);
+        }
+        if (id % 2 == 0) {
+            game->addFeature("Жанр", genres[id % 3]);
+        }
+        games[id] = game;
+    }
+
+    CatalogColumns columns;
+    columns.build(games);
+
+    std::cout << "Тест 1 - Столбцы по номерам игр: ";
+    if (columns.rowCount() == 192 && columns.wordCount() == 3 && columns.minPlayersAt(5) == 2 &&
+        columns.maxPlayersAt(5) == 2 && columns.ratingCountAt(5) == 0 && columns.ratingCountAt(6) == 2 &&
+        columns.averageRatingAt(6) == games[6]->getAverageRating() && columns.averageRatingAt(3) != columns.averageRatingAt(3) &&
+        columns.nameRankAt(100) == columns.nameRankAt(1) + 1 && columns.featureValues("Жанр")->size() == 3 &&
+        (*columns.featureValues("Жанр"))[(*columns.featureCodes("Жанр"))[4] - 1] == "Семейная") {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // каждый доступный набор инструкций должен совпасть с проверкой по самим играм
+    auto expected = [&](auto condition) {
+        std::vector<uint64_t> bits(columns.wordCount(), 0);
+        for (size_t id = 0; id < games.size(); ++id) {
+            if (games[id] && condition(*games[id])) {
+                bits[id / 64] |= uint64_t(1) << (id % 64);
+            }
+        }
+        return bits;
+    };
+    std::vector<uint64_t> highRated = expected([](const BoardGame& g) { return g.getAverageRating() >= 3.5; });
+    std::vector<uint64_t> threePlayers = expected([](const BoardGame& g) {
+        return g.getMinPlayers() <= 3 && g.getMaxPlayers() >= 3;
+    });
+    std::vector<uint64_t> family = expected([](const BoardGame& g) { return g.getFeature("Жанр") == "Семейная"; });
+
+    SimdLevel levels[] = {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2};
+    for (SimdLevel level : levels) {
+        if (level > detectedLevel()) continue;
+        limitLevel(level);
+
+        std::vector<uint64_t> rating;
+        std::vector<uint64_t> low;
+        std::vector<uint64_t> high;
+        std::vector<uint64_t> genre;
+        columns.scanRatingAtLeast(3.5, rating);
+        columns.scanMinPlayers(std::numeric_limits<int32_t>::min(), 3, low);
+        columns.scanMaxPlayers(3, std::numeric_limits<int32_t>::max(), high);
+        columns.scanFeatureEquals("Жанр", "Семейная", genre);
+        for (size_t w = 0; w < low.size(); ++w) {
+            low[w] &= high[w];
+        }
+
+        std::cout << "Тест 2 - Сканирование (" << levelName(level) << "): ";
+        if (rating == highRated && low == threePlayers && genre == family) {
+            std::cout << "PASSED" << std::endl;
+        } else {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+    limitLevel(SimdLevel::AVX2);
+
+    std::vector<uint64_t> missingValue;
+    std::vector<uint64_t> missingFeature;
+    columns.scanFeatureEquals("Жанр", "Вечериночная", missingValue);
+    columns.scanFeatureEquals("Время", "30", missingFeature);
+
+    std::cout << "Тест 3 - Отсутствующие признак и значение: ";
+    if (missingValue == std::vector<uint64_t>(3, 0) && missingFeature == std::vector<uint64_t>(3, 0)) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // правка игр и обновление их строк дают те же столбцы, что и новая сборка
+    games[6]->addRating("p3", 5);
+    games[8]->setMinPlayers(3);
+    games[8]->updateFeature("Жанр", "Семейная");
+    games[9]->addFeature("Время", "30");
+    games[12]->removeFeature("Жанр");
+    columns.updateRows(games, {6, 8, 9, 12});
+    CatalogColumns rebuilt;
+    rebuilt.build(games);
+
+    std::vector<uint64_t> updatedRating, rebuiltRating, updatedGenre, rebuiltGenre, updatedTime, rebuiltTime;
+    columns.scanRatingAtLeast(3.5, updatedRating);
+    rebuilt.scanRatingAtLeast(3.5, rebuiltRating);
+    columns.scanFeatureEquals("Жанр", "Семейная", updatedGenre);
+    rebuilt.scanFeatureEquals("Жанр", "Семейная", rebuiltGenre);
+    columns.scanFeatureEquals("Время", "30", updatedTime);
+    rebuilt.scanFeatureEquals("Время", "30", rebuiltTime);
+
+    std::cout << "Тест 3а - Обновление строк измененных игр: ";
+    if (updatedRating == rebuiltRating && updatedGenre == rebuiltGenre && updatedTime == rebuiltTime &&
+        columns.ratingCountAt(6) == 3 && columns.minPlayersAt(8) == 3 && (*columns.featureCodes("Жанр"))[12] == 0 &&
+        columns.presentRows() == rebuilt.presentRows()) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    for (BoardGame* game : games) {
+        delete game;
+    }
+
+    // копия снимка делит блоки с оригиналом: правка строки копирует только ее блок, оригинал не меняется
+    std::vector<BoardGame*> wide(2500, nullptr);
+    for (size_t id = 0; id < wide.size(); ++id) {
+        wide[id] = new BoardGame("Блоки " + std::to_string(id), "", 2, 4, "");
+        wide[id]->addFeature("Жанр", genres[id % 3]);
+    }
+    CatalogColumns original;
+    original.build(wide);
+    CatalogColumns copy(original);
+    wide[1500]->setMinPlayers(3);
+    wide[1500]->updateFeature("Жанр", "Дуэль");
+    copy.updateRows(wide, {1500});
+
+    std::cout << "Тест 3б - Копия снимка копирует только измененные блоки: ";
+    if (copy.minPlayersAt(1500) == 3 && original.minPlayersAt(1500) == 2 &&
+        copy.minPlayers.block(0).data() == original.minPlayers.block(0).data() &&
+        copy.minPlayers.block(1).data() != original.minPlayers.block(1).data() &&
+        copy.maxPlayers.block(1).data() == original.maxPlayers.block(1).data() &&
+        copy.featureValues("Жанр")->size() == 4 && original.featureValues("Жанр")->size() == 3 &&
+        (*original.featureValues("Жанр"))[(*original.featureCodes("Жанр"))[1500] - 1] == "Стратегия" &&
+        &copy.presentRows() == &original.presentRows() && &copy.idsByName() == &original.idsByName()) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    for (BoardGame* game : wide) {
+        delete game;
+    }
+
+    // строки снимка - номера из SymbolTable::games(), по ним же ищутся названия
+    std::vector<BoardGame*> byHandle;
+    for (const char* name : {"Позиция Б", "Позиция Г", "Позиция А"}) {
+        SymbolId handle = SymbolTable::games().intern(name);
+        if (handle >= byHandle.size()) {
+            byHandle.resize(handle + static_cast<size_t>(1), nullptr);
+        }
+        byHandle[handle] = new BoardGame(name, "", 2, 4, "");
+    }
+    CatalogColumns named;
+    named.build(byHandle);
+
+    std::cout << "Тест 4 - Место названия в алфавитном порядке: ";
+    if (named.nameRankAt(SymbolTable::games().find("Позиция А")) == 0 &&
+        named.nameRankAt(SymbolTable::games().find("Позиция Г")) == 2 &&
+        named.namePosition("Позиция В") == 2 && named.namePosition("Позиция Б") == 1 && named.namePosition("Я") == 3) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    for (BoardGame* game : byHandle) {
+        delete game;
+    }
+
+    std::cout << "=== Тестирование CatalogColumns завершено ===\n" << std::endl;
+}
@@ -0,0 +1,166 @@
+#ifndef CATALOG_COLUMNS_H
+#define CATALOG_COLUMNS_H
+
+#include "Filter.h"
+#include "SymbolTable.h"
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+class BoardGame;
+
+// столбец по блокам из BLOCK_ROWS строк: копия столбца делит блоки с оригиналом,
+// а запись сначала копирует свой блок, если он общий, - правка одной строки копирует один блок
+template <typename T>
+class BlockColumn {
+public:
+    static constexpr size_t BLOCK_ROWS = 1024; // кратно 64: блок - целые слова битовой карты
+
+private:
+    std::vector<std::shared_ptr<std::vector<T>>> blocks;
+    mutable std::vector<bool> own; // блок не делится с копиями (копирование снимает отметку у обеих сторон)
+    size_t rows = 0;
+
+    void share(const BlockColumn& other) {
+        blocks = other.blocks;
+        rows = other.rows;
+        own.assign(blocks.size(), false);
+        other.own.assign(other.blocks.size(), false);
+    }
+
+public:
+    BlockColumn() = default;
+    BlockColumn(const BlockColumn& other) { share(other); }
+    BlockColumn(BlockColumn&&) = default;
+    BlockColumn& operator=(const BlockColumn& other) {
+        if (this != &other) share(other);
+        return *this;
+    }
+    BlockColumn& operator=(BlockColumn&&) = default;
+
+    void assign(size_t count, const T& value) {
+        rows = count;
+        blocks.clear();
+        for (size_t first = 0; first < count; first += BLOCK_ROWS) {
+            blocks.push_back(std::make_shared<std::vector<T>>(std::min(BLOCK_ROWS, count - first), value));
+        }
+        own.assign(blocks.size(), true);
+    }
+
+    void set(size_t row, const T& value) {
+        size_t b = row / BLOCK_ROWS;
+        if (!own[b]) {
+            if ((*blocks[b])[row % BLOCK_ROWS] == value) return; // не копировать блок ради той же записи
+            blocks[b] = std::make_shared<std::vector<T>>(*blocks[b]);
+            own[b] = true;
+        }
+        (*blocks[b])[row % BLOCK_ROWS] = value;
+    }
+
+    const T& operator[](size_t row) const { return (*blocks[row / BLOCK_ROWS])[row % BLOCK_ROWS]; }
+    size_t size() const { return rows; }
+    size_t blockCount() const { return blocks.size(); }
+    const std::vector<T>& block(size_t b) const { return *blocks[b]; } // строки b * BLOCK_ROWS, ...
+};
+
+// столбцовый снимок каталога для быстрого сканирования (structure of arrays)
+// строка i - игра с номером i из SymbolTable::games(); значения лежат подряд в отдельных массивах,
+// поэтому проверка условия идет по непрерывной памяти без перехода по указателям на игры
+// признаки закодированы словарем: значение -> код (1, 2, ...), 0 - признака у игры нет
+// сканирование возвращает битовую карту (бит i - условие выполнено для игры i),
+// векторные ядра: AVX2 и SSE2 (выбираются по процессору), иначе скалярный цикл
+// снимок не следит за играми: после изменения игр их строки обновляет updateRows,
+// после добавления или удаления игр снимок нужно собрать заново
+class CatalogColumns {
+    friend class SnapshotFile; // сохраняет и восстанавливает массивы снимка без пересборки
+
+public:
+    enum class SimdLevel { Scalar, SSE2, AVX2 };
+
+private:
+    // словарь признака: общий у копий снимка, пока в него не добавлено новое значение
+    struct FeatureDictionary {
+        std::unordered_map<std::string, int32_t> codes; // значение -> код
+        std::vector<std::string> values; // код - 1 -> значение
+    };
+
+    // признак: словарь значений и коды по строкам
+    struct FeatureColumn {
+        std::shared_ptr<FeatureDictionary> dictionary;
+        mutable bool ownDictionary; // как BlockColumn::own для словаря
+        BlockColumn<int32_t> codes;
+
+        FeatureColumn();
+        FeatureColumn(const FeatureColumn& other);
+        FeatureColumn& operator=(const FeatureColumn& other);
+        int32_t encode(const std::string& value); // код значения; новое значение добавляется в словарь
+    };
+
+    // копия снимка (конструктор копирования) делит с оригиналом блоки столбцов, словари и порядок названий:
+    // updateRows на копии копирует только блоки измененных строк, оригинал при этом не меняется
+    size_t rows; // число строк, округлено вверх до 64 (хвост заполнен пустыми строками)
+    std::shared_ptr<std::vector<uint64_t>> present; // бит i - игра с номером i есть в каталоге
+    BlockColumn<double> averageRating; // пустая строка - NaN, не проходит ни одно сравнение
+    BlockColumn<uint32_t> ratingCount;
+    BlockColumn<int32_t> minPlayers;
+    BlockColumn<int32_t> maxPlayers;
+    BlockColumn<uint32_t> nameRank; // место названия в алфавитном порядке каталога
+    std::shared_ptr<const std::vector<uint32_t>> nameOrder; // номера игр в алфавитном порядке
+    std::map<std::string, FeatureColumn, std::less<>> features;
+
+    static SimdLevel forcedLevel; // ограничение уровня (для тестов и замеров)
+
+    void fillRow(uint32_t id, const BoardGame& game); // значения игры в строке id (строка пуста)
+    void setPresent(uint32_t id, bool inCatalog); // битовая карта копируется, только если бит меняется
+
+public:
+    CatalogColumns();
+
+    // собрать снимок по каталогу (номер игры -> игра, nullptr пропускается)
+    // gamesByName - тот же каталог, упорядоченный по названию: если передан, названия не сортируются заново
+    void build(const std::vector<BoardGame*>& gamesByHandle, const GameMap* gamesByName = nullptr);
+
+    // перезаписать строки измененных игр того же каталога (состав игр и названия - как при сборке)
+    // значения, которые больше не встречаются, остаются в словаре без строк
+    void updateRows(const std::vector<BoardGame*>& gamesByHandle, const std::vector<SymbolId>& changed);
+
+    size_t rowCount() const; // кратно 64
+    size_t wordCount() const; // слов в битовой карте результата
+    const std::vector<uint64_t>& presentRows() const;
+
+    // чтение отдельных значений (номер должен быть меньше rowCount)
+    double averageRatingAt(uint32_t id) const;
+    uint32_t ratingCountAt(uint32_t id) const;
+    int32_t minPlayersAt(uint32_t id) const;
+    int32_t maxPlayersAt(uint32_t id) const;
+    uint32_t nameRankAt(uint32_t id) const;
+    uint32_t namePosition(std::string_view name) const; // сколько игр каталога с названием меньше name
+    const std::vector<uint32_t>& idsByName() const; // номера игр каталога в алфавитном порядке
+    
+    // закодированный признак: коды по строкам и словарь (код c -> values[c - 1]); nullptr, если признака нет ни у одной игры
+    const BlockColumn<int32_t>* featureCodes(std::string_view featureName) const;
+    const std::vector<std::string>* featureValues(std::string_view featureName) const;
+    std::vector<std::string> featureNames() const; // по алфавиту
+
+    // сканирование столбцов: out получает wordCount() слов; строки без игры всегда 0
+    void scanRatingAtLeast(double minRating, std::vector<uint64_t>& out) const;
+    void scanMinPlayers(int32_t low, int32_t high, std::vector<uint64_t>& out) const; // low <= minPlayers <= high
+    void scanMaxPlayers(int32_t low, int32_t high, std::vector<uint64_t>& out) const;
+    void scanFeatureEquals(std::string_view featureName, std::string_view value, std::vector<uint64_t>& out) const;
+
+    // используемый набор инструкций: лучший из доступных процессору, но не выше заданного
+    static SimdLevel activeLevel();
+    static void limitLevel(SimdLevel level);
+    static const char* levelName(SimdLevel level);
+
+    static void runTests();
+};
+
+#endif
@@ -0,0 +1,304 @@
+#include "CatalogQuery.h"
+#include "BoardGame.h"
+#include "CatalogStats.h"
+#include "CatalogColumns.h"
+#include "SymbolTable.h"
+#include <algorithm>
+#include <cstring>
+#include <charconv>
+
+namespace {
+
+// Позиция игры в выдаче по рейтингу
+// Название представлено местом в алфавитном порядке, удвоенным: игра каталога с местом r - 2r + 1,
+// название из курсора, которого уже нет в каталоге, - 2 * (число меньших названий), то есть между соседями
+struct RankedGame {
+    double rating;
+    uint64_t namePosition;
+    SymbolId id;
+};
+
+// Порядок выдачи: рейтинг по убыванию, при равенстве - название по возрастанию
+bool rankedBefore(const RankedGame& a, const RankedGame& b) {
+    if (a.rating != b.rating) {
+        return a.rating > b.rating;
+    }
+    return a.namePosition < b.namePosition;
+}
+
+// Курсор: 16 шестнадцатеричных цифр двоичного представления рейтинга, затем название
+std::string encodeCursor(double rating, const std::string& name) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &rating, sizeof(bits));
+    
+    std::string cursor(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        cursor[i] = "0123456789abcdef"[bits & 0xF];
+        bits >>= 4;
+    }
+    return cursor + name;
+}
+
+bool decodeCursor(const std::string& cursor, double& rating, std::string& name) {
+    if (cursor.size() < 16) {
+        return false;
+    }
+    
+    uint64_t bits = 0;
+    for (int i = 0; i < 16; ++i) {
+        char c = cursor[i];
+        int digit = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : -1;
+        if (digit < 0) {
+            return false;
+        }
+        bits = (bits << 4) | static_cast<uint64_t>(digit);
+    }
+    
+    std::memcpy(&rating, &bits, sizeof(rating));
+    if (rating != rating) {
+        return false;  // NaN - не рейтинг
+    }
+    name = cursor.substr(16);
+    return true;
+}
+
+}
+
+CandidateSet CatalogQuery::allGames(const CatalogView& view) {
+    // состав - по столбцам: объекты игр могут быть еще не созданы
+    const std::vector<uint64_t>& present = view.columns->presentRows();
+    size_t universe = view.gamesByHandle->size();
+    CandidateSet result(universe);
+    for (size_t w = 0; w < present.size(); ++w) {
+        uint64_t bits = present[w];
+        while (bits) {
+            size_t id = w * 64 + __builtin_ctzll(bits);
+            if (id < universe) {
+                result.add(static_cast<uint32_t>(id));
+            }
+            bits &= bits - 1;
+        }
+    }
+    return result;
+}
+
+QueryPlan CatalogQuery::plan(const CatalogView& view, const std::vector<Filter*>& filters) {
+    return QueryPlan::build(filters, *view.stats, view.columns != nullptr);
+}
+
+CandidateSet CatalogQuery::select(const CatalogView& view, const std::vector<Filter*>& filters, QueryPlan* plan) {
+    QueryPlan chosen = CatalogQuery::plan(view, filters);
+    FilterContext context{view.gamesByHandle, view.columns};
+    
+    // Каждый фильтр сужает множество кандидатов; пустое множество дальше не фильтруем
+    CandidateSet candidates = allGames(view);
+    for (PlanStep& step : chosen.steps) {
+        if (candidates.empty()) {
+            break;
+        }
+        if (view.prepare && step.filter->readsGames(context, candidates)) {
+            (*view.prepare)(candidates);
+        }
+        candidates = step.filter->select(context, candidates);
+        step.executed = true;
+        step.actualOutput = candidates.count();
+    }
+    
+    if (plan) *plan = chosen;
+    return candidates;
+}
+
+size_t CatalogQuery::stream(const CatalogView& view, const std::vector<Filter*>& filters,
+                            const std::function<bool(uint32_t)>& visit) {
+    QueryPlan chosen = CatalogQuery::plan(view, filters);
+    FilterContext context{view.gamesByHandle, view.columns};
+    const std::vector<uint32_t>& byName = view.columns->idsByName();
+    size_t universe = view.gamesByHandle->size();
+    
+    // Фильтры, которым хватает столбцов, отбирают сразу по всему каталогу сканированием:
+    // множество - битовая карта каталога, от размера выдачи не зависит
+    // Остальные проверяют игры по одной - их работа идет по частям и прекращается с остановкой
+    CandidateSet scanned = allGames(view);
+    std::vector<const Filter*> perBlock;
+    for (const PlanStep& step : chosen.steps) {
+        if (!scanned.empty() && !step.filter->readsGames(context, scanned)) {
+            scanned = step.filter->select(context, scanned);
+        } else {
+            perBlock.push_back(step.filter);
+        }
+    }
+    
+    // Часть каталога в алфавитном порядке и она же по возрастанию номеров (так быстрее собрать множество)
+    std::vector<uint32_t> block;
+    std::vector<uint32_t> sorted;
+    block.reserve(STREAM_BLOCK);
+    sorted.reserve(STREAM_BLOCK);
+    size_t visited = 0;
+    for (size_t start = 0; start < byName.size() && !scanned.empty(); start += STREAM_BLOCK) {
+        block.clear();
+        for (size_t i = start; i < byName.size() && i < start + STREAM_BLOCK; ++i) {
+            if (byName[i] < universe && scanned.contains(byName[i])) {
+                block.push_back(byName[i]);
+            }
+        }
+        if (block.empty()) {
+            continue;
+        }
+        sorted.assign(block.begin(), block.end());
+        std::sort(sorted.begin(), sorted.end());
+        
+        CandidateSet candidates(universe);
+        for (uint32_t id : sorted) {
+            candidates.add(id);
+        }
+        for (const Filter* filter : perBlock) {
+            if (candidates.empty()) {
+                break;
+            }
+            if (view.prepare && filter->readsGames(context, candidates)) {
+                (*view.prepare)(candidates);
+            }
+            candidates = filter->select(context, candidates);
+        }
+        if (candidates.empty()) {
+            continue;
+        }
+        
+        // Объекты прошедших игр нужны получателю
+        if (view.prepare) {
+            (*view.prepare)(candidates);
+        }
+        for (uint32_t id : block) {
+            if (!candidates.contains(id)) {
+                continue;
+            }
+            ++visited;
+            if (!visit(id)) {
+                return visited;
+            }
+        }
+    }
+    return visited;
+}
+
+// Сортировка по упакованным ключам: значения полей читаются один раз (из столбцового снимка),
+// дальше сравниваются только числа
+std::vector<uint32_t> CatalogQuery::order(const CatalogView& view, const CandidateSet& candidates, const OrderBy& order) {
+    const CatalogColumns& columns = *view.columns;
+    const std::vector<uint32_t>& matchCounts = *view.matchCounts;
+    const uint64_t missing = UINT64_MAX;  // игры без значения признака - последними при любом направлении
+    
+    // Числовые признаки: значения словаря разбираются один раз, строка получает ключ по коду
+    std::vector<std::vector<uint64_t>> featureKeys(order.size());
+    std::vector<const BlockColumn<int32_t>*> featureCodes(order.size(), nullptr);
+    for (size_t k = 0; k < order.size(); ++k) {
+        if (order[k].field != SortField::Feature) continue;
+        featureKeys[k].push_back(missing);  // код 0 - признака нет
+        featureCodes[k] = columns.featureCodes(order[k].featureName);
+        const std::vector<std::string>* values = columns.featureValues(order[k].featureName);
+        if (!values) continue;
+        for (const std::string& value : *values) {
+            double number = 0.0;
+            std::from_chars_result parsed = std::from_chars(value.data(), value.data() + value.size(), number);
+            bool numeric = parsed.ec == std::errc() && parsed.ptr == value.data() + value.size() && number == number;
+            uint64_t key = PackedSortKeys::encodeDouble(number);
+            featureKeys[k].push_back(!numeric ? missing : order[k].descending ? PackedSortKeys::descending(key) : key);
+        }
+    }
+    
+    PackedSortKeys table(order.size() + 1);
+    table.reserve(candidates.count());
+    candidates.forEach([&](uint32_t id) {
+        uint64_t* row = table.addRow(id);
+        for (size_t k = 0; k < order.size(); ++k) {
+            uint64_t key = 0;
+            switch (order[k].field) {
+                case SortField::AverageRating:
+                    key = PackedSortKeys::encodeDouble(columns.averageRatingAt(id));
+                    break;
+                case SortField::RatingCount:
+                    key = PackedSortKeys::encodeInt(columns.ratingCountAt(id));
+                    break;
+                case SortField::Name:
+                    key = PackedSortKeys::encodeInt(columns.nameRankAt(id));
+                    break;
+                case SortField::MinPlayers:
+                    key = PackedSortKeys::encodeInt(columns.minPlayersAt(id));
+                    break;
+                case SortField::MaxPlayers:
+                    key = PackedSortKeys::encodeInt(columns.maxPlayersAt(id));
+                    break;
+                case SortField::MatchCount:
+                    key = PackedSortKeys::encodeInt(id < matchCounts.size() ? matchCounts[id] : 0);
+                    break;
+                case SortField::Feature:
+                    row[k] = featureKeys[k][featureCodes[k] ? (*featureCodes[k])[id] : 0];
+                    continue;  // направление уже учтено
+            }
+            row[k] = order[k].descending ? PackedSortKeys::descending(key) : key;
+        }
+        row[order.size()] = columns.nameRankAt(id);
+    });
+    table.sort();
+    
+    return table.sortedIds();
+}
+
+PageIds CatalogQuery::page(const CatalogView& view, const CandidateSet& candidates, size_t limit, const std::string& cursor) {
+    PageIds page;
+    page.hasMore = false;
+    if (limit == 0) {
+        return page;
+    }
+    
+    RankedGame after{0.0, 0, 0};
+    std::string afterName;
+    bool resume = !cursor.empty();
+    if (resume && !decodeCursor(cursor, after.rating, afterName)) {
+        return page;
+    }
+    
+    const CatalogColumns& columns = *view.columns;
+    if (resume) {
+        SymbolId handle = SymbolTable::games().find(afterName);
+        bool inCatalog = handle < view.gamesByHandle->size() && (columns.presentRows()[handle / 64] >> (handle % 64) & 1);
+        after.namePosition = inCatalog ? 2 * uint64_t(columns.nameRankAt(handle)) + 1
+                                       : 2 * uint64_t(columns.namePosition(afterName));
+    }
+    
+    // Ограниченная куча: на вершине худшая из лучших limit игр
+    // Рейтинг и место названия берутся из столбцов, к самим играм не обращаемся
+    std::vector<RankedGame> best;
+    best.reserve(std::min(limit, candidates.count()));
+    size_t remaining = 0;
+    candidates.forEach([&](uint32_t id) {
+        RankedGame ranked{columns.averageRatingAt(id), 2 * uint64_t(columns.nameRankAt(id)) + 1, id};
+        if (resume && !rankedBefore(after, ranked)) {
+            return;
+        }
+        ++remaining;
+        if (best.size() < limit) {
+            best.push_back(ranked);
+            std::push_heap(best.begin(), best.end(), rankedBefore);
+        } else if (rankedBefore(ranked, best.front())) {
+            std::pop_heap(best.begin(), best.end(), rankedBefore);
+            best.back() = ranked;
+            std::push_heap(best.begin(), best.end(), rankedBefore);
+        }
+    });
+    std::sort_heap(best.begin(), best.end(), rankedBefore);
+    
+    page.ids.reserve(best.size());
+    for (const RankedGame& ranked : best) {
+        page.ids.push_back(ranked.id);
+    }
+    if (remaining > limit) {
+        page.hasMore = true;
+        page.nextCursor = encodeCursor(best.back().rating, SymbolTable::games().name(best.back().id));
+    }
+    return page;
+}
+
+std::string CatalogQuery::cursorAfter(double rating, const std::string& name) {
+    return encodeCursor(rating, name);
+}
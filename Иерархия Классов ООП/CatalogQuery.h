@@ -0,0 +1,72 @@
+#ifndef CATALOG_QUERY_H
+#define CATALOG_QUERY_H
+
+#include "Filter.h"
+#include "CandidateSet.h"
+#include "QueryPlan.h"
+#include "OrderBy.h"
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+class BoardGame;
+class CatalogStats;
+class CatalogColumns;
+
+// данные каталога, по которым выполняется запрос: живая база, ее снимок (см. DatabaseSnapshot)
+// или файл снимка (см. SnapshotFile); все поля должны описывать один и тот же момент каталога
+// состав каталога - строки columns->presentRows(), объекты игр нужны только фильтрам, которые их читают
+struct CatalogView {
+    const std::vector<BoardGame*>* gamesByHandle; // номер игры -> игра (nullptr, если игры нет или она еще не создана)
+    const CatalogColumns* columns;                // точный столбцовый снимок этих игр
+    const CatalogStats* stats;                    // статистика для планировщика (может немного отставать)
+    const std::vector<uint32_t>* matchCounts;     // номер игры -> число партий (номера за концом - 0)
+    
+    // создать объекты игр множества перед отбором фильтром, которому они нужны (см. Filter::readsGames)
+    // nullptr - все игры каталога уже есть в gamesByHandle
+    const std::function<void(const CandidateSet&)>* prepare;
+};
+
+// номера игр одной страницы выдачи
+struct PageIds {
+    std::vector<uint32_t> ids;
+    std::string nextCursor;
+    bool hasMore;
+};
+
+// выполнение запросов над представлением каталога; результат - номера игр,
+// в объекты их переводит вызывающий (живая база - в свои игры, снимок - в свои копии)
+class CatalogQuery {
+public:
+    static const size_t STREAM_BLOCK = 256; // игр в одной части потокового выполнения
+    
+    // все игры представления
+    static CandidateSet allGames(const CatalogView& view);
+    
+    // план цепочки по статистике представления
+    static QueryPlan plan(const CatalogView& view, const std::vector<Filter*>& filters);
+    
+    // выполнение цепочки в порядке плана; если plan не nullptr, в него записывается выполненный план
+    static CandidateSet select(const CatalogView& view, const std::vector<Filter*>& filters, QueryPlan* plan);
+    
+    // потоковое выполнение цепочки: номера прошедших игр по алфавиту передаются visit, пока он возвращает true
+    // фильтры, которым хватает столбцов, отбирают сканированием всего каталога (битовая карта),
+    // остальные фильтры проверяют каталог частями по STREAM_BLOCK игр; результат не собирается,
+    // поэтому память не зависит от размера выдачи, а после остановки оставшиеся части не проверяются
+    // фильтры должны решать по каждой игре отдельно, как select по умолчанию; возвращает число переданных игр
+    static size_t stream(const CatalogView& view, const std::vector<Filter*>& filters,
+                         const std::function<bool(uint32_t)>& visit);
+    
+    // номера множества в заданном порядке (при равенстве всех ключей - по названию)
+    static std::vector<uint32_t> order(const CatalogView& view, const CandidateSet& candidates, const OrderBy& order);
+    
+    // limit лучших по рейтингу (при равенстве - по названию) после курсора; некорректный курсор - пустая страница
+    static PageIds page(const CatalogView& view, const CandidateSet& candidates, size_t limit, const std::string& cursor);
+    
+    // курсор, продолжающий выдачу после игры с таким рейтингом и названием (для слияния страниц нескольких каталогов)
+    static std::string cursorAfter(double rating, const std::string& name);
+};
+
+#endif
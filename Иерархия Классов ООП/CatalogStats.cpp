@@ -0,0 +1,232 @@
+#include "CatalogStats.h"
+#include "BoardGame.h"
+#include "SimilarityGraph.h"
+#include "CatalogColumns.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+CatalogStats::CatalogStats()
+    : gameCount(0), ratingBuckets(), playersSupported(), graph(nullptr), averageDegree(0.0) {}
+
+void CatalogStats::reset(const SimilarityGraph* graph) {
+    gameCount = 0;
+    ratingBuckets.fill(0);
+    playersSupported.fill(0);
+    minPlayersCount.clear();
+    maxPlayersCount.clear();
+    featureValues.clear();
+    this->graph = graph;
+}
+
+void CatalogStats::countGame(double averageRating, int minPlayers, int maxPlayers) {
+    ++gameCount;
+
+    int bucket = static_cast<int>(averageRating * 4);
+    ++ratingBuckets[std::min(std::max(bucket, 0), RATING_BUCKETS)];
+
+    ++minPlayersCount[minPlayers];
+    ++maxPlayersCount[maxPlayers];
+    int low = std::max(minPlayers, 1);
+    int high = std::min(maxPlayers, MAX_TRACKED_PLAYERS);
+    for (int n = low; n <= high; ++n) {
+        ++playersSupported[n];
+    }
+}
+
+void CatalogStats::build(const std::vector<BoardGame*>& gamesByHandle, const SimilarityGraph* graph) {
+    reset(graph);
+
+    for (BoardGame* game : gamesByHandle) {
+        if (!game) continue;
+        countGame(game->getAverageRating(), game->getMinPlayers(), game->getMaxPlayers());
+
+        for (const auto& feature : game->getFeatures()) {
+            auto byName = featureValues.find(feature.first);
+            if (byName == featureValues.end()) {
+                byName = featureValues.emplace(feature.first, std::map<std::string, size_t, std::less<>>()).first;
+            }
+            ++byName->second[feature.second];
+        }
+    }
+
+    averageDegree = (graph && gameCount > 0) ? 2.0 * graph->edgeCount() / gameCount : 0.0;
+}
+
+void CatalogStats::build(const CatalogColumns& columns, const SimilarityGraph* graph) {
+    reset(graph);
+
+    const std::vector<uint64_t>& present = columns.presentRows();
+    for (size_t w = 0; w < present.size(); ++w) {
+        uint64_t bits = present[w];
+        while (bits) {
+            uint32_t id = static_cast<uint32_t>(w * 64 + __builtin_ctzll(bits));
+            countGame(columns.averageRatingAt(id), columns.minPlayersAt(id), columns.maxPlayersAt(id));
+            bits &= bits - 1;
+        }
+    }
+
+    // признаки: число строк с каждым кодом словаря
+    for (const std::string& featureName : columns.featureNames()) {
+        const BlockColumn<int32_t>& codes = *columns.featureCodes(featureName);
+        const std::vector<std::string>& values = *columns.featureValues(featureName);
+        std::vector<size_t> perCode(values.size() + 1, 0);
+        for (size_t b = 0; b < codes.blockCount(); ++b) {
+            for (int32_t code : codes.block(b)) {
+                ++perCode[code];
+            }
+        }
+        std::map<std::string, size_t, std::less<>>& counts = featureValues[featureName];
+        for (size_t code = 1; code < perCode.size(); ++code) {
+            if (perCode[code] > 0) {
+                counts[values[code - 1]] = perCode[code];
+            }
+        }
+    }
+
+    averageDegree = (graph && gameCount > 0) ? 2.0 * graph->edgeCount() / gameCount : 0.0;
+}
+
+size_t CatalogStats::getGameCount() const {
+    return gameCount;
+}
+
+double CatalogStats::fraction(size_t count) const {
+    return gameCount == 0 ? 0.0 : static_cast<double>(count) / gameCount;
+}
+
+double CatalogStats::ratingAtLeast(double minRating) const {
+    if (minRating <= 0.0) {
+        return gameCount == 0 ? 0.0 : 1.0;
+    }
+    if (minRating > 5.0) {
+        return 0.0;
+    }
+
+    // корзины выше порога целиком, корзина с порогом - пропорционально (равномерно внутри)
+    int bucket = std::min(static_cast<int>(minRating * 4), RATING_BUCKETS);
+    double count = 0.0;
+    for (int b = bucket + 1; b <= RATING_BUCKETS; ++b) {
+        count += ratingBuckets[b];
+    }
+    double share = (bucket == RATING_BUCKETS) ? 1.0 : (bucket + 1) - minRating * 4;
+    count += ratingBuckets[bucket] * share;
+    return gameCount == 0 ? 0.0 : count / gameCount;
+}
+
+double CatalogStats::featureEquals(std::string_view featureName, std::string_view value) const {
+    auto byName = featureValues.find(featureName);
+    if (byName == featureValues.end()) {
+        return 0.0;
+    }
+    auto byValue = byName->second.find(value);
+    return byValue == byName->second.end() ? 0.0 : fraction(byValue->second);
+}
+
+double CatalogStats::supportsPlayers(int playerCount) const {
+    if (playerCount < 1) {
+        return 0.0;
+    }
+    return fraction(playersSupported[std::min(playerCount, MAX_TRACKED_PLAYERS)]);
+}
+
+double CatalogStats::minPlayersEquals(int playerCount) const {
+    auto it = minPlayersCount.find(playerCount);
+    return it == minPlayersCount.end() ? 0.0 : fraction(it->second);
+}
+
+double CatalogStats::maxPlayersEquals(int playerCount) const {
+    auto it = maxPlayersCount.find(playerCount);
+    return it == maxPlayersCount.end() ? 0.0 : fraction(it->second);
+}
+
+size_t CatalogStats::degree(SymbolId game) const {
+    return graph ? graph->degree(game) : 0;
+}
+
+double CatalogStats::getAverageDegree() const {
+    return averageDegree;
+}
+
+void CatalogStats::runTests() {
+    std::cout << "\n=== Тестирование класса CatalogStats ===" << std::endl;
+
+    BoardGame* g1 = new BoardGame("Стат А", "Описание", 2, 4, "1-е издание");
+    BoardGame* g2 = new BoardGame("Стат Б", "Описание", 1, 2, "1-е издание");
+    BoardGame* g3 = new BoardGame("Стат В", "Описание", 3, 6, "1-е издание");
+    BoardGame* g4 = new BoardGame("Стат Г", "Описание", 2, 2, "1-е издание");
+
+    g1->addRating("p1", 5);
+    g2->addRating("p1", 3);
+    g2->addRating("p2", 4);
+    g3->addRating("p1", 4);
+    g3->addRating("p2", 5);
+    g3->addRating("p3", 4);
+
+    g1->addFeature("Жанр", "Стратегия");
+    g2->addFeature("Жанр", "Семейная");
+    g3->addFeature("Жанр", "Стратегия");
+
+    SimilarityGraph graph;
+    graph.addEdge(0, 1);
+    graph.addEdge(0, 2);
+
+    std::vector<BoardGame*> games = {g1, nullptr, g2, g3, g4};
+    CatalogStats stats;
+    stats.build(games, &graph);
+
+    // средние: 5.0, 3.5, 4.33, 0 (без оценок)
+    std::cout << "Тест 1 - Доля игр по рейтингу: ";
+    if (stats.getGameCount() == 4 && std::fabs(stats.ratingAtLeast(4.0) - 0.5) < 1e-9 &&
+        std::fabs(stats.ratingAtLeast(5.0) - 0.25) < 1e-9 && stats.ratingAtLeast(0.0) == 1.0) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    std::cout << "Тест 2 - Частоты значений признаков: ";
+    if (stats.featureEquals("Жанр", "Стратегия") == 0.5 && stats.featureEquals("Жанр", "Семейная") == 0.25 &&
+        stats.featureEquals("Жанр", "Кооператив") == 0.0 && stats.featureEquals("Время", "30") == 0.0) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    std::cout << "Тест 3 - Число игроков: ";
+    if (stats.supportsPlayers(2) == 0.75 && stats.supportsPlayers(5) == 0.25 && stats.supportsPlayers(0) == 0.0 &&
+        stats.minPlayersEquals(2) == 0.5 && stats.maxPlayersEquals(6) == 0.25) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    std::cout << "Тест 4 - Степени в графе схожести: ";
+    if (stats.degree(0) == 2 && stats.degree(3) == 0 && stats.getAverageDegree() == 1.0) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // Тест 5: сборка по столбцовому снимку дает те же доли, что и по играм
+    CatalogColumns columns;
+    columns.build(games);
+    CatalogStats fromColumns;
+    fromColumns.build(columns, &graph);
+
+    std::cout << "Тест 5 - Сборка по столбцам: ";
+    if (fromColumns.getGameCount() == 4 && fromColumns.ratingAtLeast(4.0) == stats.ratingAtLeast(4.0) &&
+        fromColumns.featureEquals("Жанр", "Стратегия") == 0.5 && fromColumns.featureEquals("Жанр", "Семейная") == 0.25 &&
+        fromColumns.supportsPlayers(2) == 0.75 && fromColumns.maxPlayersEquals(6) == 0.25 &&
+        fromColumns.getAverageDegree() == 1.0) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    delete g1;
+    delete g2;
+    delete g3;
+    delete g4;
+
+    std::cout << "=== Тестирование CatalogStats завершено ===\n" << std::endl;
+}
@@ -0,0 +1,64 @@
+#ifndef CATALOG_STATS_H
+#define CATALOG_STATS_H
+
+#include "SymbolTable.h"
+#include <vector>
+#include <map>
+#include <array>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <cstddef>
+
+class BoardGame;
+class SimilarityGraph;
+class CatalogColumns;
+
+// легковесная статистика каталога для оценки фильтров (см. QueryPlan)
+// собирается одним проходом по играм; все доли приближенные:
+// средний рейтинг хранится гистограммой, признаки считаются независимыми
+class CatalogStats {
+public:
+    static constexpr int RATING_BUCKETS = 20; // корзины среднего рейтинга по 0.25 на [0, 5)
+    static constexpr int MAX_TRACKED_PLAYERS = 16; // большее число игроков оценивается как 16
+
+private:
+    size_t gameCount;
+    std::array<size_t, RATING_BUCKETS + 1> ratingBuckets; // последняя корзина - ровно 5.0
+    std::array<size_t, MAX_TRACKED_PLAYERS + 1> playersSupported; // N -> игр, где можно играть вN
+    std::map<int, size_t> minPlayersCount; // минимум игроков -> число игр
+    std::map<int, size_t> maxPlayersCount; // максимум игроков -> число игр
+    std::map<std::string, std::map<std::string, size_t, std::less<>>, std::less<>> featureValues; // признак -> значение -> число игр
+    const SimilarityGraph* graph;
+    double averageDegree;
+
+public:
+    CatalogStats();
+
+    // пересобрать по каталогу (номер игры -> игра, nullptr пропускается)
+    void build(const std::vector<BoardGame*>& gamesByHandle, const SimilarityGraph* graph);
+    // то же по готовому столбцовому снимку, без обращения к объектам игр
+    void build(const CatalogColumns& columns, const SimilarityGraph* graph);
+
+    size_t getGameCount() const;
+
+    // доли игр каталога (0..1)
+    double ratingAtLeast(double minRating) const; // средний рейтинг >= minRating
+    double featureEquals(std::string_view featureName, std::string_view value) const;
+    double supportsPlayers(int playerCount) const; // minPlayers <= N <= maxPlayers
+    double minPlayersEquals(int playerCount) const;
+    double maxPlayersEquals(int playerCount) const;
+
+    // граф схожести
+    size_t degree(SymbolId game) const;
+    double getAverageDegree() const;
+
+    static void runTests();
+
+private:
+    void reset(const SimilarityGraph* graph);
+    void countGame(double averageRating, int minPlayers, int maxPlayers);
+    double fraction(size_t count) const;
+};
+
+#endif
@@ -0,0 +1,327 @@
+#include "DatabaseSnapshot.h"
+#include "GameDatabase.h"
+#include "RatingFilter.h"
+#include "FeatureFilter.h"
+#include "SymbolTable.h"
+#include <iostream>
+#include <thread>
+#include <atomic>
+
+DatabaseSnapshot::DatabaseSnapshot()
+    : version(0), catalogVersion(0), gameVersion(0), statsGameVersion(0), matchCount(0) {}
+
+CatalogView DatabaseSnapshot::view() const {
+    return CatalogView{&games->byHandle, columns.get(), stats.get(), matchCounts.get(), nullptr};
+}
+
+std::vector<const BoardGame*> DatabaseSnapshot::gamesOf(const std::vector<uint32_t>& ids) const {
+    std::vector<const BoardGame*> result;
+    result.reserve(ids.size());
+    for (uint32_t id : ids) {
+        result.push_back(games->byHandle[id]);
+    }
+    return result;
+}
+
+size_t DatabaseSnapshot::shardOf(uint64_t key, size_t shards) {
+    // перемешивание (splitmix64), чтобы пары одного игрока расходились по частям
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ull;
+    key ^= key >> 27;
+    return static_cast<size_t>(key & (shards - 1));
+}
+
+uint64_t DatabaseSnapshot::getVersion() const {
+    return version;
+}
+
+size_t DatabaseSnapshot::getGameCount() const {
+    return games->count;
+}
+
+size_t DatabaseSnapshot::getMatchCount() const {
+    return matchCount;
+}
+
+const BoardGame* DatabaseSnapshot::getGame(std::string_view gameName) const {
+    SymbolId handle = SymbolTable::games().find(gameName);
+    return handle < games->byHandle.size() ? games->byHandle[handle] : nullptr;
+}
+
+std::vector<const BoardGame*> DatabaseSnapshot::findGames(const std::vector<Filter*>& filters, QueryPlan* plan) const {
+    if (filters.empty()) {
+        return std::vector<const BoardGame*>();
+    }
+    
+    CatalogView catalog = view();
+    return gamesOf(CatalogQuery::order(catalog, CatalogQuery::select(catalog, filters, plan), OrderBy{SortKey::byRating()}));
+}
+
+std::vector<const BoardGame*> DatabaseSnapshot::findGames(const std::vector<Filter*>& filters, const OrderBy& order) const {
+    if (filters.empty()) {
+        return std::vector<const BoardGame*>();
+    }
+    
+    CatalogView catalog = view();
+    return gamesOf(CatalogQuery::order(catalog, CatalogQuery::select(catalog, filters, nullptr), order));
+}
+
+SnapshotPage DatabaseSnapshot::findGames(const std::vector<Filter*>& filters, size_t limit, const std::string& cursor) const {
+    SnapshotPage page;
+    page.hasMore = false;
+    if (filters.empty() || limit == 0) {
+        return page;
+    }
+    
+    CatalogView catalog = view();
+    PageIds ids = CatalogQuery::page(catalog, CatalogQuery::select(catalog, filters, nullptr), limit, cursor);
+    page.games = gamesOf(ids.ids);
+    page.nextCursor = ids.nextCursor;
+    page.hasMore = ids.hasMore;
+    return page;
+}
+
+size_t DatabaseSnapshot::forEachGame(const std::vector<Filter*>& filters, const SnapshotGameVisitor& visit) const {
+    if (filters.empty()) {
+        return 0;
+    }
+    
+    return CatalogQuery::stream(view(), filters, [&](uint32_t id) { return visit(games->byHandle[id]); });
+}
+
+QueryPlan DatabaseSnapshot::planQuery(const std::vector<Filter*>& filters) const {
+    return CatalogQuery::plan(view(), filters);
+}
+
+bool DatabaseSnapshot::areSimilar(std::string_view game1, std::string_view game2) const {
+    return similarity->contains(SymbolTable::games().find(game1), SymbolTable::games().find(game2));
+}
+
+std::vector<std::string> DatabaseSnapshot::getSimilarGames(std::string_view gameName) const {
+    std::vector<std::string> result;
+    NeighborRange neighbors = similarity->neighbors(SymbolTable::games().find(gameName));
+    result.reserve(neighbors.size());
+    for (SymbolId neighbor : neighbors) {
+        result.push_back(SymbolTable::games().name(neighbor));
+    }
+    return result;
+}
+
+const SimilarityGraph* DatabaseSnapshot::getSimilarityData() const {
+    return similarity.get();
+}
+
+const PlayerGameStats* DatabaseSnapshot::getPlayerGameStats(std::string_view playerId, std::string_view gameName) const {
+    SymbolId player = SymbolTable::players().find(playerId);
+    SymbolId game = SymbolTable::games().find(gameName);
+    if (player == INVALID_SYMBOL || game == INVALID_SYMBOL) {
+        return nullptr;
+    }
+    
+    uint64_t key = playerGameKey(player, game);
+    const StatsShard& shard = *playerStats[shardOf(key, playerStats.size())];
+    auto it = shard.find(key);
+    return (it != shard.end()) ? &it->second : nullptr;
+}
+
+const CatalogStats& DatabaseSnapshot::getCatalogStats() const {
+    return *stats;
+}
+
+const CatalogColumns& DatabaseSnapshot::getCatalogColumns() const {
+    return *columns;
+}
+
+void DatabaseSnapshot::runTests() {
+    std::cout << "\n=== Тестирование класса DatabaseSnapshot ===" << std::endl;
+    
+    GameDatabase db;
+    BoardGame* azul = new BoardGame("Снимок Азул", "Плитки", 2, 4, "");
+    BoardGame* root = new BoardGame("Снимок Корни", "Война", 2, 4, "");
+    azul->addFeature("Жанр", "Семейная");
+    root->addFeature("Жанр", "Стратегия");
+    db.addGame(azul);
+    db.addGame(root);
+    db.addPlayer(new Player("snapshot_player", "Снимков"));
+    db.addRating("Снимок Азул", "snapshot_player", 4);
+    std::shared_ptr<const DatabaseSnapshot> first = db.publish();
+    
+    // Тест 1: изменения после публикации не видны в уже выданном снимке
+    db.addRating("Снимок Корни", "snapshot_player", 5);
+    db.addGame(new BoardGame("Снимок Каскадия", "Природа", 1, 4, ""));
+    db.removeGame("Снимок Азул");
+    std::shared_ptr<const DatabaseSnapshot> second = db.publish();
+    
+    RatingFilter anyGame(0.0);
+    std::vector<Filter*> all = {&anyGame};
+    std::vector<const BoardGame*> before = first->findGames(all);
+    std::vector<const BoardGame*> after = second->findGames(all);
+    std::vector<std::string> streamed;
+    second->forEachGame(all, [&](const BoardGame* game) {
+        streamed.push_back(game->getName());
+        return true;
+    });
+    bool isolated = before.size() == 2 && before[0]->getName() == "Снимок Азул" &&
+                    first->getGame("Снимок Корни")->getRatingsCount() == 0 && !first->getGame("Снимок Каскадия") &&
+                    after.size() == 2 && after[0]->getName() == "Снимок Корни" && !second->getGame("Снимок Азул") &&
+                    second->getVersion() == first->getVersion() + 1 && db.snapshot() == second &&
+                    streamed == std::vector<std::string>{"Снимок Каскадия", "Снимок Корни"};
+    
+    std::cout << "Тест 1 - Снимок не меняется после публикации: ";
+    if (isolated) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 2: новые партии не копируют игры и столбцы, статистика игрока появляется только в новой версии
+    Match* match = new Match("snapshot_match", "Снимок Корни", "2024-05-01");
+    match->addPlayerResult("snapshot_player", 3.0);
+    db.addMatch(match);
+    std::shared_ptr<const DatabaseSnapshot> third = db.publish();
+    
+    const PlayerGameStats* stats = third->getPlayerGameStats("snapshot_player", "Снимок Корни");
+    bool shared = third->getGame("Снимок Корни") == second->getGame("Снимок Корни") &&
+                  &third->getCatalogColumns() == &second->getCatalogColumns() &&
+                  !second->getPlayerGameStats("snapshot_player", "Снимок Корни") &&
+                  stats && stats->getCount() == 1 && third->getMatchCount() == 1;
+    size_t copiedShards = 0;
+    for (size_t shard = 0; shard < third->playerStats.size(); ++shard) {
+        copiedShards += third->playerStats[shard] != second->playerStats[shard] ? 1 : 0;
+    }
+    shared = shared && third->playerStats.size() == STATS_SHARDS && copiedShards == 1;
+    
+    std::cout << "Тест 2 - Публикация копирует только измененное: ";
+    if (shared) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 2а: описание и издание, измененные после публикации, попадают в следующий снимок
+    db.getGame("Снимок Корни")->setDescription("Война в лесу");
+    db.getGame("Снимок Корни")->setEdition("Второе");
+    std::shared_ptr<const DatabaseSnapshot> fourth = db.publish();
+    
+    const BoardGame* republished = fourth->getGame("Снимок Корни");
+    bool refreshed = republished && republished->getDescription() == "Война в лесу" && republished->getEdition() == "Второе" &&
+                     third->getGame("Снимок Корни")->getDescription() == "Война" &&
+                     fourth->getGame("Снимок Каскадия") == third->getGame("Снимок Каскадия");
+    
+    std::cout << "Тест 2а - Описание и издание в новом снимке: ";
+    if (refreshed) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 2б: изменения игр другой базы не пересобирают столбцы и не копируют игры этой базы
+    {
+        GameDatabase other;
+        BoardGame* foreign = new BoardGame("Снимок Чужая", "", 2, 4, "");
+        other.addGame(foreign);
+        other.addFeature("Снимок Чужая", "Жанр", "Семейная");
+        foreign->setDescription("Чужое описание");
+        std::shared_ptr<const DatabaseSnapshot> fifth = db.publish();
+        
+        std::cout << "Тест 2б - Чужие изменения не копируются: ";
+        if (&fifth->getCatalogColumns() == &fourth->getCatalogColumns() &&
+            &fifth->getCatalogStats() == &fourth->getCatalogStats() &&
+            fifth->getGame("Снимок Корни") == fourth->getGame("Снимок Корни")) {
+            std::cout << "PASSED" << std::endl;
+        } else {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+    
+    // Тест 2в: правка одной игры копирует в новой версии только блок ее строки в столбцах
+    {
+        GameDatabase wide;
+        for (int i = 0; i < 2000; ++i) {
+            BoardGame* game = new BoardGame("Снимок Блок " + std::to_string(i), "", 2, 4, "");
+            game->addFeature("Жанр", i % 2 ? "Семейная" : "Стратегия");
+            wide.addGame(game);
+        }
+        std::shared_ptr<const DatabaseSnapshot> before = wide.publish();
+        SymbolId edited = SymbolTable::games().find("Снимок Блок 1999");
+        SymbolId untouched = SymbolTable::games().find("Снимок Блок 0");
+        wide.updateFeature("Снимок Блок 1999", "Жанр", "Кооператив");
+        std::shared_ptr<const DatabaseSnapshot> after = wide.publish();
+        
+        const BlockColumn<int32_t>* oldCodes = before->getCatalogColumns().featureCodes("Жанр");
+        const BlockColumn<int32_t>* newCodes = after->getCatalogColumns().featureCodes("Жанр");
+        size_t editedBlock = edited / BlockColumn<int32_t>::BLOCK_ROWS;
+        size_t untouchedBlock = untouched / BlockColumn<int32_t>::BLOCK_ROWS;
+        std::cout << "Тест 2в - Столбцы копируются по блокам: ";
+        if (editedBlock != untouchedBlock &&
+            newCodes->block(untouchedBlock).data() == oldCodes->block(untouchedBlock).data() &&
+            newCodes->block(editedBlock).data() != oldCodes->block(editedBlock).data() &&
+            before->getGame("Снимок Блок 1999")->getFeature("Жанр") == "Семейная" &&
+            (*before->getCatalogColumns().featureValues("Жанр"))[(*oldCodes)[edited] - 1] == "Семейная" &&
+            (*after->getCatalogColumns().featureValues("Жанр"))[(*newCodes)[edited] - 1] == "Кооператив") {
+            std::cout << "PASSED" << std::endl;
+        } else {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+    
+    // Тест 3: снимок переживает базу, граф схожести и фильтры работают по копиям
+    std::shared_ptr<const DatabaseSnapshot> survivor;
+    {
+        GameDatabase temporary;
+        temporary.addGame(new BoardGame("Снимок Пандемия", "", 2, 4, ""));
+        temporary.addGame(new BoardGame("Снимок Ужас Аркхэма", "", 1, 8, ""));
+        temporary.addSimilarity("Снимок Пандемия", "Снимок Ужас Аркхэма");
+        survivor = temporary.publish();
+    }
+    std::vector<std::string> similar = survivor->getSimilarGames("Снимок Пандемия");
+    bool survived = survivor->getGameCount() == 2 && similar.size() == 1 && similar[0] == "Снимок Ужас Аркхэма" &&
+                    survivor->areSimilar("Снимок Ужас Аркхэма", "Снимок Пандемия");
+    
+    std::cout << "Тест 3 - Снимок независим от базы: ";
+    if (survived) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 4: читатели выполняют запросы, пока писатель добавляет игры и публикует версии
+    GameDatabase live;
+    std::atomic<bool> done(false);
+    std::atomic<int> inconsistent(0);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            uint64_t lastVersion = 0;
+            while (!done.load()) {
+                std::shared_ptr<const DatabaseSnapshot> view = live.snapshot();
+                std::vector<const BoardGame*> found = view->findGames(all);
+                if (found.size() != view->getGameCount() || view->getVersion() < lastVersion) {
+                    ++inconsistent;
+                }
+                lastVersion = view->getVersion();
+            }
+        });
+    }
+    for (int g = 0; g < 300; ++g) {
+        BoardGame* game = new BoardGame("Снимок поток " + std::to_string(g), "", 2, 4, "");
+        game->addRating("snapshot_player", 1 + g % 5);
+        live.addGame(game);
+        if (g % 10 == 9) {
+            live.publish();
+        }
+    }
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    
+    std::cout << "Тест 4 - Чтение снимков во время записи: ";
+    if (inconsistent == 0 && live.snapshot()->getGameCount() == 300) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    std::cout << "=== Тестирование DatabaseSnapshot завершено ===\n" << std::endl;
+}
@@ -0,0 +1,105 @@
+#ifndef DATABASE_SNAPSHOT_H
+#define DATABASE_SNAPSHOT_H
+
+#include "BoardGame.h"
+#include "Filter.h"
+#include "SimilarityGraph.h"
+#include "PlayerGameStats.h"
+#include "CatalogStats.h"
+#include "CatalogColumns.h"
+#include "CatalogQuery.h"
+#include "QueryPlan.h"
+#include "OrderBy.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+// Страница результатов поиска по снимку (см. GameDatabase::findGames с limit и cursor)
+struct SnapshotPage {
+    std::vector<const BoardGame*> games;
+    std::string nextCursor;
+    bool hasMore;
+};
+
+// Получатель потоковой выдачи снимка: false - остановить поиск
+typedef std::function<bool(const BoardGame*)> SnapshotGameVisitor;
+
+// Неизменяемая версия базы на момент публикации (см. GameDatabase::publish)
+// Читается из любого числа потоков без блокировок, пока писатель продолжает менять базу:
+// у снимка свои копии игр, графа схожести, столбцов каталога и статистики игроков
+// Части, не менявшиеся между публикациями, общие у соседних версий (shared_ptr),
+// поэтому публикация копирует только изменившееся; версия освобождается вместе с последней ссылкой на нее
+// Игры снимка только для чтения; фильтр схожести для запросов к снимку строится по его графу (getSimilarityData)
+class DatabaseSnapshot {
+    friend class GameDatabase;
+    
+public:
+    static const size_t STATS_SHARDS = 64; // наименьшее число частей статистики игроков (копируются только измененные)
+    
+private:
+    typedef std::unordered_map<uint64_t, PlayerGameStats> StatsShard; // ключ - playerGameKey
+    
+    static const size_t COPY_BLOCK = 1024; // копий игр в блоке (публикация копирует только блоки с изменениями)
+    typedef std::vector<std::shared_ptr<BoardGame>> CopyBlock;
+    
+    // Копии игр по номерам; общие у версий, пока игры не менялись
+    struct GameCopies {
+        std::vector<std::shared_ptr<CopyBlock>> blocks;  // владельцы копий, по COPY_BLOCK номеров
+        std::vector<BoardGame*> byHandle;                // те же копии для фильтров (nullptr - игры нет)
+        size_t count;
+    };
+    
+    uint64_t version;
+    uint64_t catalogVersion;    // версия состава каталога и связей в базе на момент публикации
+    uint64_t gameVersion;       // число изменений игр базы на момент публикации
+    uint64_t statsGameVersion;  // то же на момент сборки статистики каталога
+    size_t matchCount;
+    
+    std::shared_ptr<const GameCopies> games;
+    std::shared_ptr<const SimilarityGraph> similarity;
+    std::shared_ptr<const CatalogColumns> columns;
+    std::shared_ptr<const CatalogStats> stats;
+    std::shared_ptr<const std::vector<uint32_t>> matchCounts;
+    std::vector<std::shared_ptr<const StatsShard>> playerStats; // степень двойки частей, не меньше STATS_SHARDS
+    
+    DatabaseSnapshot();
+    
+    CatalogView view() const;
+    std::vector<const BoardGame*> gamesOf(const std::vector<uint32_t>& ids) const;
+    static size_t shardOf(uint64_t key, size_t shards); // shards - степень двойки
+    
+public:
+    uint64_t getVersion() const; // 1, 2, ... в порядке публикации
+    size_t getGameCount() const;
+    size_t getMatchCount() const;
+    
+    // Игра снимка по названию (nullptr, если ее не было в базе на момент публикации)
+    const BoardGame* getGame(std::string_view gameName) const;
+    
+    // Поиск с той же семантикой, что у GameDatabase::findGames
+    std::vector<const BoardGame*> findGames(const std::vector<Filter*>& filters, QueryPlan* plan = nullptr) const;
+    std::vector<const BoardGame*> findGames(const std::vector<Filter*>& filters, const OrderBy& order) const;
+    SnapshotPage findGames(const std::vector<Filter*>& filters, size_t limit, const std::string& cursor) const;
+    size_t forEachGame(const std::vector<Filter*>& filters, const SnapshotGameVisitor& visit) const;
+    QueryPlan planQuery(const std::vector<Filter*>& filters) const;
+    
+    // Схожесть игр
+    bool areSimilar(std::string_view game1, std::string_view game2) const;
+    std::vector<std::string> getSimilarGames(std::string_view gameName) const;
+    const SimilarityGraph* getSimilarityData() const;
+    
+    // Статистика игрока в игре (nullptr, если партий не было)
+    const PlayerGameStats* getPlayerGameStats(std::string_view playerId, std::string_view gameName) const;
+    
+    const CatalogStats& getCatalogStats() const;
+    const CatalogColumns& getCatalogColumns() const;
+    
+    static void runTests();
+};
+
+#endif
@@ -0,0 +1,154 @@
+#include "Date.h"
+#include <iostream>
+
+namespace {
+
+bool isLeap(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+int daysInMonth(int year, int month) {
+    static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return (month == 2 && isLeap(year)) ? 29 : days[month - 1];
+}
+
+// номер дня по григорианскому календарю без таблиц и циклов (алгоритм Г. Хиннанта, 400-летние эры)
+int32_t daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1; // год с марта
+    unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<int32_t>(dayOfEra) - 719468;
+}
+
+void civilFromDays(int32_t dayNumber, int& year, int& month, int& day) {
+    dayNumber += 719468;
+    int era = (dayNumber >= 0 ? dayNumber : dayNumber - 146096) / 146097;
+    unsigned dayOfEra = static_cast<unsigned>(dayNumber - era * 146097);
+    unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    unsigned shiftedMonth = (5 * dayOfYear + 2) / 153;
+    day = static_cast<int>(dayOfYear - (153 * shiftedMonth + 2) / 5 + 1);
+    month = static_cast<int>(shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9);
+    year = static_cast<int>(yearOfEra) + era * 400 + (month <= 2);
+}
+
+}
+
+Date::Date() : dayNumber(UNKNOWN) {}
+
+Date::Date(int year, int month, int day) : dayNumber(UNKNOWN) {
+    if (month >= 1 && month <= 12 && day >= 1 && day <= daysInMonth(year, month)) {
+        dayNumber = daysFromCivil(year, month, day);
+    }
+}
+
+Date Date::fromDayNumber(int32_t dayNumber) {
+    Date date;
+    date.dayNumber = dayNumber;
+    return date;
+}
+
+Date Date::parse(std::string_view text) {
+    if (text.size() != 10 || text[4] != '-' || text[7] != '-') {
+        return Date();
+    }
+    int value[3] = {0, 0, 0};
+    const size_t starts[3] = {0, 5, 8};
+    const size_t lengths[3] = {4, 2, 2};
+    for (int part = 0; part < 3; ++part) {
+        for (size_t i = starts[part]; i < starts[part] + lengths[part]; ++i) {
+            if (text[i] < '0' || text[i] > '9') {
+                return Date();
+            }
+            value[part] = value[part] * 10 + (text[i] - '0');
+        }
+    }
+    return Date(value[0], value[1], value[2]);
+}
+
+int Date::getYear() const {
+    if (!isKnown()) return 0;
+    int year, month, day;
+    civilFromDays(dayNumber, year, month, day);
+    return year;
+}
+
+int Date::getMonth() const {
+    if (!isKnown()) return 0;
+    int year, month, day;
+    civilFromDays(dayNumber, year, month, day);
+    return month;
+}
+
+int Date::getDay() const {
+    if (!isKnown()) return 0;
+    int year, month, day;
+    civilFromDays(dayNumber, year, month, day);
+    return day;
+}
+
+std::string Date::toString() const {
+    if (!isKnown()) {
+        return "";
+    }
+    int year, month, day;
+    civilFromDays(dayNumber, year, month, day);
+    char text[11] = {
+        char('0' + year / 1000 % 10), char('0' + year / 100 % 10), char('0' + year / 10 % 10), char('0' + year % 10), '-',
+        char('0' + month / 10), char('0' + month % 10), '-',
+        char('0' + day / 10), char('0' + day % 10), '\0'
+    };
+    return text;
+}
+
+Date Date::addDays(int32_t days) const {
+    return isKnown() ? fromDayNumber(dayNumber + days) : *this;
+}
+
+void Date::runTests() {
+    std::cout << "\n=== Тестирование класса Date ===" << std::endl;
+
+    // Тест 1: Разбор строки и обратное преобразование
+    Date date = Date::parse("2024-02-29");
+    std::cout << "Тест 1 - Разбор и вывод даты: ";
+    if (date.isKnown() && date.getYear() == 2024 && date.getMonth() == 2 && date.getDay() == 29 &&
+        date.toString() == "2024-02-29" && Date::parse("1970-01-01").getDayNumber() == 0 &&
+        Date(2000, 3, 1).getDayNumber() == 11017) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // Тест 2: Неверные строки дают неизвестную дату, она раньше любой известной
+    std::cout << "Тест 2 - Неизвестная дата: ";
+    if (!Date::parse("").isKnown() && !Date::parse("2023-02-29").isKnown() && !Date::parse("2024-13-01").isKnown() &&
+        !Date::parse("2024-1-15").isKnown() && !Date::parse("2024-01-1x").isKnown() && !Date(2024, 4, 31).isKnown() &&
+        Date().toString().empty() && Date() < Date::parse("0001-01-01") && !Date().addDays(5).isKnown()) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // Тест 3: Порядок дат совпадает с порядком строк ГГГГ-ММ-ДД, переход через месяцы и годы
+    bool ordered = true;
+    Date previous = Date::parse("1999-12-25");
+    std::string previousText = previous.toString();
+    for (int i = 1; i < 3000 && ordered; ++i) {
+        Date next = previous.addDays(1);
+        std::string nextText = next.toString();
+        ordered = next > previous && nextText > previousText && Date::parse(nextText) == next &&
+                  next.getDayNumber() == previous.getDayNumber() + 1;
+        previous = next;
+        previousText = nextText;
+    }
+    std::cout << "Тест 3 - Порядок и последовательность дней: ";
+    if (ordered && Date::parse("2001-01-01").addDays(-1).toString() == "2000-12-31") {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    std::cout << "=== Тестирование Date завершено ===\n" << std::endl;
+}
@@ -0,0 +1,46 @@
+#ifndef DATE_H
+#define DATE_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+// календарная дата, упакованная в номер дня (дней от 1970-01-01)
+// строка ГГГГ-ММ-ДД разбирается один раз; сравнение дат и поиск по диапазону - сравнение целых,
+// а не строк; неизвестная дата (пустая или неверная строка) меньше любой известной
+class Date {
+public:
+    static const int32_t UNKNOWN = INT32_MIN; // номер неизвестной даты
+
+private:
+    int32_t dayNumber;
+
+public:
+    Date(); // неизвестная дата
+    Date(int year, int month, int day); // неизвестная, если такого дня нет
+
+    static Date fromDayNumber(int32_t dayNumber);
+    static Date parse(std::string_view text); // ГГГГ-ММ-ДД; неизвестная, если строка не дата
+
+    bool isKnown() const { return dayNumber != UNKNOWN; }
+    int32_t getDayNumber() const { return dayNumber; }
+
+    // части даты (0 у неизвестной)
+    int getYear() const;
+    int getMonth() const;
+    int getDay() const;
+
+    std::string toString() const; // ГГГГ-ММ-ДД, пустая строка у неизвестной
+    Date addDays(int32_t days) const; // неизвестная остается неизвестной
+
+    bool operator==(const Date& other) const { return dayNumber == other.dayNumber; }
+    bool operator!=(const Date& other) const { return dayNumber != other.dayNumber; }
+    bool operator<(const Date& other) const { return dayNumber < other.dayNumber; }
+    bool operator<=(const Date& other) const { return dayNumber <= other.dayNumber; }
+    bool operator>(const Date& other) const { return dayNumber > other.dayNumber; }
+    bool operator>=(const Date& other) const { return dayNumber >= other.dayNumber; }
+
+    static void runTests();
+};
+
+#endif
@@ -1,170 +1,339 @@
-#include "FeatureFilter.h"
-#include <sstream>
-
-// Конструктор
-FeatureFilter::FeatureFilter(const std::map<std::string, std::string>& features) 
-    : requiredFeatures(features) {}
-
-// Деструктор
-FeatureFilter::~FeatureFilter() {}
-
-// Реализация фильтрации по признакам
-std::vector<BoardGame*> FeatureFilter::apply(const std::map<std::string, BoardGame*>& games) const {
-    std::vector<BoardGame*> result;
-    
-    for (const auto& pair : games) {
-        BoardGame* game = pair.second;
-        if (game && matchesAllFeatures(game)) {
-            result.push_back(game);
-        }
-    }
-    
-    return result;
-}
-
-// Проверка соответствия игры всем требуемым признакам
-// Логика: игра должна иметь ВСЕ признаки с точно такими значениями
-bool FeatureFilter::matchesAllFeatures(BoardGame* game) const {
-    for (const auto& required : requiredFeatures) {
-        const std::string& featureName = required.first;
-        const std::string& featureValue = required.second;
-        
-        // Специальная обработка универсальных признаков (число игроков)
-        if (featureName == "minPlayers") {
-            std::stringstream ss;
-            ss << game->getMinPlayers();
-            if (ss.str() != featureValue) {
-                return false;
-            }
-        } else if (featureName == "maxPlayers") {
-            std::stringstream ss;
-            ss << game->getMaxPlayers();
-            if (ss.str() != featureValue) {
-                return false;
-            }
-        } else if (featureName == "players") {
-            // Специальный признак: проверка диапазона игроков
-            // Формат значения: "N" - ищем игры, в которые может играть N игроков
-            int playerCount = std::stoi(featureValue);
-            if (playerCount < game->getMinPlayers() || playerCount > game->getMaxPlayers()) {
-                return false;
-            }
-        } else {
-            // Обычные пользовательские признаки
-            if (!game->hasFeature(featureName) || game->getFeature(featureName) != featureValue) {
-                return false;
-            }
-        }
-    }
-    
-    return true;  // Все признаки совпали
-}
-
-// Вывод информации о фильтре
-void FeatureFilter::printInfo() const {
-    std::cout << "FeatureFilter[требуемые признаки: ";
-    bool first = true;
-    for (const auto& feature : requiredFeatures) {
-        if (!first) std::cout << ", ";
-        std::cout << feature.first << "='" << feature.second << "'";
-        first = false;
-    }
-    std::cout << "]";
-}
-
-// Геттер
-std::map<std::string, std::string> FeatureFilter::getRequiredFeatures() const {
-    return requiredFeatures;
-}
-
-// Автоматические тесты
-void FeatureFilter::runTests() {
-    std::cout << "\n=== Тестирование класса FeatureFilter ===" << std::endl;
-    
-    // Создаем тестовые игры с разными признаками
-    BoardGame* g1 = new BoardGame("Шахматы", "Стратегия", 2, 2, "Классика");
-    g1->addFeature("Жанр", "Стратегия");
-    g1->addFeature("Сложность", "Высокая");
-    g1->addFeature("Время", "30");
-    
-    BoardGame* g2 = new BoardGame("Каркассон", "Тайлы", 2, 6, "Big Box");
-    g2->addFeature("Жанр", "Семейная");
-    g2->addFeature("Сложность", "Низкая");
-    g2->addFeature("Время", "40");
-    
-    BoardGame* g3 = new BoardGame("Колонизаторы", "Ресурсы", 3, 4, "5-е издание");
-    g3->addFeature("Жанр", "Стратегия");
-    g3->addFeature("Сложность", "Средняя");
-    g3->addFeature("Время", "90");
-    
-    std::map<std::string, BoardGame*> games;
-    games["Шахматы"] = g1;
-    games["Каркассон"] = g2;
-    games["Колонизаторы"] = g3;
-    
-    // Тест 1: Фильтр по одному признаку (Жанр = Стратегия)
-    std::map<std::string, std::string> filter1Features;
-    filter1Features["Жанр"] = "Стратегия";
-    FeatureFilter filter1(filter1Features);
-    
-    std::vector<BoardGame*> result1 = filter1.apply(games);
-    std::cout << "Тест 1 - Фильтр Жанр=Стратегия: ";
-    if (result1.size() == 2) {  // Шахматы и Колонизаторы
-        std::cout << "PASSED (найдено " << result1.size() << " игры)" << std::endl;
-    } else {
-        std::cout << "FAILED (ожидалось 2, найдено " << result1.size() << ")" << std::endl;
-    }
-    
-    // Тест 2: Фильтр по нескольким признакам (Жанр + Сложность)
-    std::map<std::string, std::string> filter2Features;
-    filter2Features["Жанр"] = "Стратегия";
-    filter2Features["Сложность"] = "Высокая";
-    FeatureFilter filter2(filter2Features);
-    
-    std::vector<BoardGame*> result2 = filter2.apply(games);
-    std::cout << "Тест 2 - Фильтр Жанр=Стратегия И Сложность=Высокая: ";
-    if (result2.size() == 1) {  // Только Шахматы
-        std::cout << "PASSED (найдено " << result2.size() << " игра)" << std::endl;
-    } else {
-        std::cout << "FAILED (ожидалось 1, найдено " << result2.size() << ")" << std::endl;
-    }
-    
-    // Тест 3: Фильтр по числу игроков (универсальный признак)
-    std::map<std::string, std::string> filter3Features;
-    filter3Features["players"] = "3";  // Игры, в которые можно играть втроем
-    FeatureFilter filter3(filter3Features);
-    
-    std::vector<BoardGame*> result3 = filter3.apply(games);
-    std::cout << "Тест 3 - Фильтр по числу игроков (3): ";
-    if (result3.size() == 2) {  // Каркассон (2-6) и Колонизаторы (3-4)
-        std::cout << "PASSED (найдено " << result3.size() << " игры)" << std::endl;
-    } else {
-        std::cout << "FAILED (ожидалось 2, найдено " << result3.size() << ")" << std::endl;
-    }
-    
-    // Тест 4: Фильтр с несуществующим значением
-    std::map<std::string, std::string> filter4Features;
-    filter4Features["Жанр"] = "Несуществующий";
-    FeatureFilter filter4(filter4Features);
-    
-    std::vector<BoardGame*> result4 = filter4.apply(games);
-    std::cout << "Тест 4 - Фильтр с несуществующим значением: ";
-    if (result4.empty()) {
-        std::cout << "PASSED (найдено 0 игр)" << std::endl;
-    } else {
-        std::cout << "FAILED" << std::endl;
-    }
-    
-    // Тест 5: Вывод информации
-    std::cout << "Тест 5 - Вывод информации: ";
-    filter2.printInfo();
-    std::cout << " - OK" << std::endl;
-    
-    // Очистка памяти
-    delete g1;
-    delete g2;
-    delete g3;
-    
-    std::cout << "=== Тестирование FeatureFilter завершено ===\n" << std::endl;
-}
-
+#include "FeatureFilter.h"
+#include "CatalogStats.h"
+#include "CatalogColumns.h"
+#include <charconv>
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// совпадает ли число с текстом в том виде, как его печатает поток вывода
+bool printsAs(int number, const std::string& text) {
+    char buffer[16];
+    std::to_chars_result printed = std::to_chars(buffer, buffer + sizeof(buffer), number);
+    return std::string_view(buffer, printed.ptr - buffer) == text;
+}
+
+// текст, который мог получиться при печати числа: без пробелов, знака + и ведущих нулей
+bool parsePrinted(const std::string& text, int& number) {
+    const char* first = text.data();
+    const char* last = first + text.size();
+    std::from_chars_result parsed = std::from_chars(first, last, number);
+    return parsed.ec == std::errc() && parsed.ptr == last && printsAs(number, text);
+}
+
+}
+
+// Конструктор
+FeatureFilter::FeatureFilter(const std::map<std::string, std::string>& features) 
+    : requiredFeatures(features) {}
+
+// Деструктор
+FeatureFilter::~FeatureFilter() {}
+
+// Реализация фильтрации по признакам
+std::vector<BoardGame*> FeatureFilter::apply(const GameMap& games) const {
+    // accepts - та же проверка всех признаков; большой каталог проверяется параллельно
+    return acceptAll(games);
+}
+
+// Проверка соответствия игры всем требуемым признакам
+// Логика: игра должна иметь ВСЕ признаки с точно такими значениями
+bool FeatureFilter::accepts(const BoardGame& game) const {
+    return matchesAllFeatures(&game);
+}
+
+bool FeatureFilter::matchesAllFeatures(const BoardGame* game) const {
+    for (const auto& required : requiredFeatures) {
+        const std::string& featureName = required.first;
+        const std::string& featureValue = required.second;
+        
+        // Специальная обработка универсальных признаков (число игроков)
+        if (featureName == "minPlayers") {
+            if (!printsAs(game->getMinPlayers(), featureValue)) {
+                return false;
+            }
+        } else if (featureName == "maxPlayers") {
+            if (!printsAs(game->getMaxPlayers(), featureValue)) {
+                return false;
+            }
+        } else if (featureName == "players") {
+            // Специальный признак: проверка диапазона игроков
+            // Формат значения: "N" - ищем игры, в которые может играть N игроков
+            int playerCount = std::stoi(featureValue);
+            if (playerCount < game->getMinPlayers() || playerCount > game->getMaxPlayers()) {
+                return false;
+            }
+        } else {
+            // Обычные пользовательские признаки
+            if (!game->hasFeature(featureName) || game->getFeature(featureName) != featureValue) {
+                return false;
+            }
+        }
+    }
+    
+    return true;  // Все признаки совпали
+}
+
+// Отбор по столбцовому снимку: каждое условие - сканирование своего столбца,
+// битовые карты условий пересекаются (число игроков - векторные ядра по minPlayers/maxPlayers)
+CandidateSet FeatureFilter::select(const FilterContext& context, const CandidateSet& candidates) const {
+    if (!context.columns || !candidates.isDense()) {
+        return Filter::select(context, candidates);
+    }
+    
+    const CatalogColumns& columns = *context.columns;
+    const int32_t lowest = std::numeric_limits<int32_t>::min();
+    const int32_t highest = std::numeric_limits<int32_t>::max();
+    std::vector<uint64_t> bits = columns.presentRows();
+    std::vector<uint64_t> condition;
+    
+    for (const auto& required : requiredFeatures) {
+        const std::string& featureName = required.first;
+        const std::string& featureValue = required.second;
+        
+        if (featureName == "minPlayers" || featureName == "maxPlayers") {
+            int playerCount = 0;
+            if (!parsePrinted(featureValue, playerCount)) {
+                condition.assign(columns.wordCount(), 0);
+            } else if (featureName == "minPlayers") {
+                columns.scanMinPlayers(playerCount, playerCount, condition);
+            } else {
+                columns.scanMaxPlayers(playerCount, playerCount, condition);
+            }
+        } else if (featureName == "players") {
+            // разбор как при проверке по одной игре (std::stoi)
+            int playerCount = std::stoi(featureValue);
+            std::vector<uint64_t> upper;
+            columns.scanMinPlayers(lowest, playerCount, condition);
+            columns.scanMaxPlayers(playerCount, highest, upper);
+            for (size_t w = 0; w < condition.size(); ++w) {
+                condition[w] &= upper[w];
+            }
+        } else {
+            columns.scanFeatureEquals(featureName, featureValue, condition);
+        }
+        
+        for (size_t w = 0; w < bits.size(); ++w) {
+            bits[w] &= condition[w];
+        }
+    }
+    
+    CandidateSet result = candidates;
+    result.intersectWithBits(bits);
+    return result;
+}
+
+bool FeatureFilter::readsGames(const FilterContext& context, const CandidateSet& candidates) const {
+    return !context.columns || !candidates.isDense();
+}
+
+// Оценка для планировщика: признаки считаются независимыми, доли перемножаются
+// Стоимость проверки: число игроков - сравнение чисел, обычный признак - бинарный поиск и сравнение строк
+FilterEstimate FeatureFilter::estimate(const CatalogStats& stats) const {
+    double cost = 0.0;
+    double selectivity = 1.0;
+    double scans = 0.0;  // сканирований столбцов при отборе по снимку
+    
+    for (const auto& required : requiredFeatures) {
+        const std::string& featureName = required.first;
+        const std::string& featureValue = required.second;
+        
+        if (featureName == "minPlayers" || featureName == "maxPlayers" || featureName == "players") {
+            int playerCount = 0;
+            const char* first = featureValue.data();
+            const char* last = first + featureValue.size();
+            bool parsed = std::from_chars(first, last, playerCount).ec == std::errc();
+            
+            cost += 1.0;
+            scans += featureName == "players" ? 2.0 : 1.0;
+            if (featureName == "players") {
+                selectivity *= parsed ? stats.supportsPlayers(playerCount) : 0.0;
+            } else {
+                double share = featureName == "minPlayers" ? stats.minPlayersEquals(playerCount)
+                                                           : stats.maxPlayersEquals(playerCount);
+                selectivity *= parsed ? share : 0.0;
+            }
+        } else {
+            cost += 2.0;
+            scans += 1.0;
+            selectivity *= stats.featureEquals(featureName, featureValue);
+        }
+    }
+    
+    double scanCost = FilterEstimate::COLUMN_SCAN_COST * std::max(scans, 1.0) * stats.getGameCount();
+    return FilterEstimate{0.0, std::max(cost, 1.0), selectivity, scanCost};
+}
+
+// Ключ - признаки по алфавиту, у названий и значений указана длина (значения могут содержать любые символы)
+std::string FeatureFilter::cacheKey() const {
+    std::string key = "features:";
+    for (const auto& required : requiredFeatures) {
+        key += std::to_string(required.first.size()) + ":" + required.first + "=" +
+               std::to_string(required.second.size()) + ":" + required.second + ";";
+    }
+    return key;
+}
+
+// Версии проверяемых признаков; players зависит от обеих границ числа игроков
+void FeatureFilter::cacheStamps(std::vector<uint64_t>& stamps) const {
+    for (const auto& required : requiredFeatures) {
+        if (required.first == "players") {
+            stamps.push_back(BoardGame::getFeatureVersion("minPlayers"));
+            stamps.push_back(BoardGame::getFeatureVersion("maxPlayers"));
+        } else {
+            stamps.push_back(BoardGame::getFeatureVersion(required.first));
+        }
+    }
+}
+
+// Вывод информации о фильтре
+void FeatureFilter::printInfo() const {
+    std::cout << "FeatureFilter[требуемые признаки: ";
+    bool first = true;
+    for (const auto& feature : requiredFeatures) {
+        if (!first) std::cout << ", ";
+        std::cout << feature.first << "='" << feature.second << "'";
+        first = false;
+    }
+    std::cout << "]";
+}
+
+// Геттер
+const std::map<std::string, std::string>& FeatureFilter::getRequiredFeatures() const {
+    return requiredFeatures;
+}
+
+// Автоматические тесты
+void FeatureFilter::runTests() {
+    std::cout << "\n=== Тестирование класса FeatureFilter ===" << std::endl;
+    
+    // Создаем тестовые игры с разными признаками
+    BoardGame* g1 = new BoardGame("Шахматы", "Стратегия", 2, 2, "Классика");
+    g1->addFeature("Жанр", "Стратегия");
+    g1->addFeature("Сложность", "Высокая");
+    g1->addFeature("Время", "30");
+    
+    BoardGame* g2 = new BoardGame("Каркассон", "Тайлы", 2, 6, "Big Box");
+    g2->addFeature("Жанр", "Семейная");
+    g2->addFeature("Сложность", "Низкая");
+    g2->addFeature("Время", "40");
+    
+    BoardGame* g3 = new BoardGame("Колонизаторы", "Ресурсы", 3, 4, "5-е издание");
+    g3->addFeature("Жанр", "Стратегия");
+    g3->addFeature("Сложность", "Средняя");
+    g3->addFeature("Время", "90");
+    
+    GameMap games;
+    games["Шахматы"] = g1;
+    games["Каркассон"] = g2;
+    games["Колонизаторы"] = g3;
+    
+    // Тест 1: Фильтр по одному признаку (Жанр = Стратегия)
+    std::map<std::string, std::string> filter1Features;
+    filter1Features["Жанр"] = "Стратегия";
+    FeatureFilter filter1(filter1Features);
+    
+    std::vector<BoardGame*> result1 = filter1.apply(games);
+    std::cout << "Тест 1 - Фильтр Жанр=Стратегия: ";
+    if (result1.size() == 2) {  // Шахматы и Колонизаторы
+        std::cout << "PASSED (найдено " << result1.size() << " игры)" << std::endl;
+    } else {
+        std::cout << "FAILED (ожидалось 2, найдено " << result1.size() << ")" << std::endl;
+    }
+    
+    // Тест 2: Фильтр по нескольким признакам (Жанр + Сложность)
+    std::map<std::string, std::string> filter2Features;
+    filter2Features["Жанр"] = "Стратегия";
+    filter2Features["Сложность"] = "Высокая";
+    FeatureFilter filter2(filter2Features);
+    
+    std::vector<BoardGame*> result2 = filter2.apply(games);
+    std::cout << "Тест 2 - Фильтр Жанр=Стратегия И Сложность=Высокая: ";
+    if (result2.size() == 1) {  // Только Шахматы
+        std::cout << "PASSED (найдено " << result2.size() << " игра)" << std::endl;
+    } else {
+        std::cout << "FAILED (ожидалось 1, найдено " << result2.size() << ")" << std::endl;
+    }
+    
+    // Тест 3: Фильтр по числу игроков (универсальный признак)
+    std::map<std::string, std::string> filter3Features;
+    filter3Features["players"] = "3";  // Игры, в которые можно играть втроем
+    FeatureFilter filter3(filter3Features);
+    
+    std::vector<BoardGame*> result3 = filter3.apply(games);
+    std::cout << "Тест 3 - Фильтр по числу игроков (3): ";
+    if (result3.size() == 2) {  // Каркассон (2-6) и Колонизаторы (3-4)
+        std::cout << "PASSED (найдено " << result3.size() << " игры)" << std::endl;
+    } else {
+        std::cout << "FAILED (ожидалось 2, найдено " << result3.size() << ")" << std::endl;
+    }
+    
+    // Тест 4: Фильтр с несуществующим значением
+    std::map<std::string, std::string> filter4Features;
+    filter4Features["Жанр"] = "Несуществующий";
+    FeatureFilter filter4(filter4Features);
+    
+    std::vector<BoardGame*> result4 = filter4.apply(games);
+    std::cout << "Тест 4 - Фильтр с несуществующим значением: ";
+    if (result4.empty()) {
+        std::cout << "PASSED (найдено 0 игр)" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 5: Вывод информации
+    std::cout << "Тест 5 - Вывод информации: ";
+    filter2.printInfo();
+    std::cout << " - OK" << std::endl;
+    
+    // Тест 6: Отбор по столбцовому снимку совпадает с проверкой по играм
+    std::vector<BoardGame*> byHandle = {g1, g2, g3};
+    CatalogColumns columns;
+    columns.build(byHandle);
+    FilterContext context{&byHandle, &columns};
+    CandidateSet everyone(byHandle.size());
+    for (uint32_t id = 0; id < byHandle.size(); ++id) {
+        everyone.add(id);
+    }
+    
+    std::map<std::string, std::string> filter6Features;
+    filter6Features["players"] = "3";
+    filter6Features["minPlayers"] = "2";
+    FeatureFilter filter6(filter6Features);
+    std::map<std::string, std::string> filter7Features;
+    filter7Features["minPlayers"] = "02";
+    FeatureFilter filter7(filter7Features);
+    
+    CandidateSet selected = filter6.select(context, everyone);
+    CandidateSet padded = filter7.select(context, everyone);
+    std::cout << "Тест 6 - Отбор по столбцам: ";
+    if (everyone.isDense() && selected.count() == 1 && selected.contains(1) &&
+        padded.empty() && !filter7.accepts(*g2)) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 7: Потоковый отбор - те же игры по порядку названий, остановка после первой
+    std::vector<BoardGame*> visited;
+    size_t visitedCount = filter1.forEachAccepted(games, [&](BoardGame* game) {
+        visited.push_back(game);
+        return true;
+    });
+    size_t firstOnly = filter1.forEachAccepted(games, [](BoardGame*) { return false; });
+    std::cout << "Тест 7 - Потоковый отбор: ";
+    if (visited == result1 && visitedCount == 2 && firstOnly == 1) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Очистка памяти
+    delete g1;
+    delete g2;
+    delete g3;
+    
+    std::cout << "=== Тестирование FeatureFilter завершено ===\n" << std::endl;
+}
+
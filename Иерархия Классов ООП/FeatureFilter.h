@@ -1,26 +1,32 @@
-#ifndef FEATURE_FILTER_H
-#define FEATURE_FILTER_H
-
-#include "Filter.h"
-#include "BoardGame.h"
-#include <iostream>
-
-// фильтр по признакам игры
-class FeatureFilter : public Filter {
-private:
-    std::map<std::string, std::string> requiredFeatures; // требуемые признаки
-    
-public:
-    explicit FeatureFilter(const std::map<std::string, std::string>& features);
-    virtual ~FeatureFilter();
-    virtual std::vector<BoardGame*> apply(const std::map<std::string, BoardGame*>& games) const override;
-    virtual void printInfo() const override;
-    std::map<std::string, std::string> getRequiredFeatures() const;
-    static void runTests();
-    
-private:
-    bool matchesAllFeatures(BoardGame* game) const; // проверка соответствия всем признакам
-};
-
-#endif
-
+#ifndef FEATURE_FILTER_H
+#define FEATURE_FILTER_H
+
+#include "Filter.h"
+#include "BoardGame.h"
+#include <iostream>
+
+// фильтр по признакам игры
+class FeatureFilter : public Filter {
+private:
+    std::map<std::string, std::string> requiredFeatures; // требуемые признаки
+    
+public:
+    explicit FeatureFilter(const std::map<std::string, std::string>& features);
+    virtual ~FeatureFilter();
+    virtual std::vector<BoardGame*> apply(const GameMap& games) const override;
+    virtual bool accepts(const BoardGame& game) const override;
+    virtual CandidateSet select(const FilterContext& context, const CandidateSet& candidates) const override;
+    virtual bool readsGames(const FilterContext& context, const CandidateSet& candidates) const override;
+    virtual FilterEstimate estimate(const CatalogStats& stats) const override;
+    virtual std::string cacheKey() const override;
+    virtual void cacheStamps(std::vector<uint64_t>& stamps) const override;
+    virtual void printInfo() const override;
+    const std::map<std::string, std::string>& getRequiredFeatures() const;
+    static void runTests();
+    
+private:
+    bool matchesAllFeatures(const BoardGame* game) const; // проверка соответствия всем признакам
+};
+
+#endif
+
@@ -1,19 +1,138 @@
-#ifndef FILTER_H
-#define FILTER_H
-
-#include <vector>
-#include <map>
-#include <string>
-
-class BoardGame;
-
-// абстрактный базовый класс для фильтров
-class Filter {
-public:
-    virtual ~Filter() {}
-    virtual std::vector<BoardGame*> apply(const std::map<std::string, BoardGame*>& games) const = 0;
-    virtual void printInfo() const = 0;
-};
-
-#endif
-
+#ifndef FILTER_H
+#define FILTER_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include <string_view>
+#include <functional>
+#include "CandidateSet.h"
+#include "ParallelScan.h"
+
+class BoardGame;
+class CatalogStats;
+class CatalogColumns;
+
+// каталог игр: название -> игра
+// ключ - представление названия из SymbolTable::games(): строка не копируется и не меняется вместе с игрой (setName);
+// сравнение string_view позволяет искать по std::string, string_view и литералам
+typedef std::map<std::string_view, BoardGame*> GameMap;
+
+// получатель потоковой выдачи: вызывается для каждой найденной игры, false - остановить поиск
+typedef std::function<bool(BoardGame*)> GameVisitor;
+
+// данные каталога, доступные фильтру при отборе по множеству кандидатов
+struct FilterContext {
+    const std::vector<BoardGame*>* gamesByHandle; // номер игры -> игра (nullptr, если игры нет в базе)
+    const CatalogColumns* columns;                // столбцовый снимок каталога (nullptr - только указатели)
+};
+
+// оценка фильтра для планировщика цепочки (см. QueryPlan)
+// единица стоимости - одна проверка кандидата через accepts с O(1) работы
+struct FilterEstimate {
+    double setupCost;        // работа, не зависящая от числа кандидатов
+    double costPerCandidate; // работа на одного кандидата
+    double selectivity;      // доля кандидатов, проходящих фильтр (0..1)
+    double scanCost;         // отбор сканированием столбцов по всему каталогу (< 0 - фильтр столбцы не использует)
+    
+    // одно сканирование столбца в пересчете на игру каталога (векторные ядра + пересечение битовых карт)
+    static constexpr double COLUMN_SCAN_COST = 0.02;
+};
+
+// абстрактный базовый класс для фильтров
+class Filter {
+public:
+    virtual ~Filter() {}
+    virtual std::vector<BoardGame*> apply(const GameMap& games) const = 0;
+    virtual bool accepts(const BoardGame& game) const = 0; // проверка одной игры
+    virtual void printInfo() const = 0;
+    
+    // отбор из множества кандидатов: результат - подмножество candidates
+    // по умолчанию проверяет каждого кандидата через accepts (большие множества - параллельно, см. ParallelScan)
+    virtual CandidateSet select(const FilterContext& context, const CandidateSet& candidates) const {
+        const std::vector<BoardGame*>& games = *context.gamesByHandle;
+        auto keep = [&](uint32_t id) { return id < games.size() && games[id] && accepts(*games[id]); };
+        CandidateSet result(candidates.universeSize());
+        if (ParallelScan::worthParallel(candidates.count())) {
+            for (uint32_t id : ParallelScan::select(candidates.toVector(), keep)) {
+                result.add(id);
+            }
+        } else {
+            candidates.forEach([&](uint32_t id) {
+                if (keep(id)) {
+                    result.add(id);
+                }
+            });
+        }
+        result.optimize();
+        return result;
+    }
+    
+    // нужны ли select объекты игр этих кандидатов (context.gamesByHandle) или хватает столбцов и номеров
+    // по умолчанию нужны: каждый кандидат проверяется через accepts
+    virtual bool readsGames(const FilterContext& context, const CandidateSet& candidates) const {
+        (void)context;
+        (void)candidates;
+        return true;
+    }
+    
+    // стоимость и избирательность по статистике каталога
+    // по умолчанию - проверка каждого кандидата, проходит половина
+    virtual FilterEstimate estimate(const CatalogStats& stats) const {
+        (void)stats;
+        return FilterEstimate{0.0, 1.0, 0.5, -1.0};
+    }
+    
+    // можно ли переставлять фильтр с соседями в цепочке (результат не зависит от порядка)
+    virtual bool isCommutative() const { return true; }
+    
+    // ключ для кеша результатов (см. QueryCache): одинаковый у фильтров, которые на одних данных отбирают одно и то же
+    // пустая строка - результаты цепочек с этим фильтром не кешируются (по умолчанию)
+    virtual std::string cacheKey() const { return std::string(); }
+    
+    // текущие версии данных, от которых зависит отбор (например, BoardGame::getFeatureVersion);
+    // запись кеша с этим фильтром действительна, пока версии те же
+    virtual void cacheStamps(std::vector<uint64_t>& stamps) const { (void)stamps; }
+    
+    // потоковый отбор: игры каталога, которые принимает accepts, по порядку названий передаются visit,
+    // пока он возвращает true; в отличие от apply, вектор результата не собирается
+    // возвращает число переданных игр
+    size_t forEachAccepted(const GameMap& games, const GameVisitor& visit) const {
+        size_t visited = 0;
+        for (const auto& pair : games) {
+            if (!pair.second || !accepts(*pair.second)) {
+                continue;
+            }
+            ++visited;
+            if (!visit(pair.second)) {
+                break;
+            }
+        }
+        return visited;
+    }
+    
+protected:
+    // игры каталога, которые принимает accepts, в порядке названий
+    // большой каталог проверяется по частям параллельно (см. ParallelScan), порядок тот же
+    std::vector<BoardGame*> acceptAll(const GameMap& games) const {
+        std::vector<BoardGame*> result;
+        if (!ParallelScan::worthParallel(games.size())) {
+            for (const auto& pair : games) {
+                if (pair.second && accepts(*pair.second)) {
+                    result.push_back(pair.second);
+                }
+            }
+            return result;
+        }
+        
+        std::vector<BoardGame*> all;
+        all.reserve(games.size());
+        for (const auto& pair : games) {
+            all.push_back(pair.second);
+        }
+        return ParallelScan::select(all, [this](BoardGame* game) { return game && accepts(*game); });
+    }
+};
+
+#endif
+
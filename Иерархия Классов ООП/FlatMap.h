@@ -0,0 +1,78 @@
+#ifndef FLAT_MAP_H
+#define FLAT_MAP_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+
+// ассоциативный контейнер на отсортированном векторе пар
+// порядок обхода и семантика как у std::map, но элементы лежат подряд в памяти:
+// нет отдельного узла в куче на каждую запись, поиск - бинарный по непрерывному массиву
+// подходит для маленьких словарей, которые читаются чаще, чем изменяются
+template <typename Key, typename Value>
+class FlatMap {
+public:
+    typedef std::pair<Key, Value> value_type;
+    typedef typename std::vector<value_type>::iterator iterator;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+private:
+    std::vector<value_type> items; // отсортированы по ключу
+
+    struct KeyLess {
+        template <typename K>
+        bool operator()(const value_type& item, const K& key) const { return item.first < key; }
+    };
+
+public:
+    iterator begin() { return items.begin(); }
+    iterator end() { return items.end(); }
+    const_iterator begin() const { return items.begin(); }
+    const_iterator end() const { return items.end(); }
+
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+    void reserve(size_t count) { items.reserve(count); }
+    void clear() { items.clear(); }
+
+    // поиск принимает любой тип, сравнимый с ключом (например, const char* для строк)
+    template <typename K>
+    iterator find(const K& key) {
+        iterator it = std::lower_bound(items.begin(), items.end(), key, KeyLess());
+        return (it != items.end() && !(key < it->first)) ? it : items.end();
+    }
+
+    template <typename K>
+    const_iterator find(const K& key) const {
+        const_iterator it = std::lower_bound(items.begin(), items.end(), key, KeyLess());
+        return (it != items.end() && !(key < it->first)) ? it : items.end();
+    }
+
+    template <typename K>
+    bool contains(const K& key) const {
+        return find(key) != end();
+    }
+
+    // вставка без замены: false, если ключ уже есть
+    // новые ключи обычно больше существующих (номера из SymbolTable растут), тогда вставка - в конец
+    bool insert(const Key& key, const Value& value) {
+        iterator it = std::lower_bound(items.begin(), items.end(), key, KeyLess());
+        if (it != items.end() && !(key < it->first)) {
+            return false;
+        }
+        items.insert(it, value_type(key, value));
+        return true;
+    }
+
+    void erase(iterator it) {
+        items.erase(it);
+    }
+
+    // байты в куче под элементы (без динамической памяти самих ключей и значений)
+    size_t capacityBytes() const {
+        return items.capacity() * sizeof(value_type);
+    }
+};
+
+#endif
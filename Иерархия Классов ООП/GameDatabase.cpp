@@ -1,522 +1,1390 @@
-#include "GameDatabase.h"
-#include "RatingFilter.h"
-#include "FeatureFilter.h"
-#include "SimilarGamesFilter.h"
-#include <iostream>
-#include <iomanip>
-
-// Конструктор
-GameDatabase::GameDatabase() {}
-
-// Деструктор - освобождает всю выделенную память
-GameDatabase::~GameDatabase() {
-    // Удаляем все игры
-    for (auto& pair : games) {
-        delete pair.second;
-    }
-    
-    // Удаляем всех игроков
-    for (auto& pair : players) {
-        delete pair.second;
-    }
-    
-    // Удаляем все партии
-    for (Match* match : matches) {
-        delete match;
-    }
-}
-
-// === Управление играми ===
-
-bool GameDatabase::addGame(BoardGame* game) {
-    if (!game) return false;
-    
-    std::string name = game->getName();
-    if (games.find(name) != games.end()) {
-        return false;  // Игра с таким названием уже существует
-    }
-    
-    games[name] = game;
-    return true;
-}
-
-bool GameDatabase::removeGame(const std::string& gameName) {
-    auto it = games.find(gameName);
-    if (it == games.end()) {
-        return false;
-    }
-    
-    delete it->second;
-    games.erase(it);
-    return true;
-}
-
-BoardGame* GameDatabase::getGame(const std::string& gameName) const {
-    auto it = games.find(gameName);
-    return (it != games.end()) ? it->second : nullptr;
-}
-
-// Возврат по const ссылке - избегаем копирования большого контейнера
-const std::map<std::string, BoardGame*>& GameDatabase::getAllGames() const {
-    return games;
-}
-
-// Перегрузка operator[] для удобного доступа к играм
-// Возвращает указатель на игру или nullptr, если игра не найдена
-BoardGame* GameDatabase::operator[](const std::string& gameName) const {
-    return getGame(gameName);
-}
-
-// === Управление игроками ===
-
-bool GameDatabase::addPlayer(Player* player) {
-    if (!player) return false;
-    
-    std::string id = player->getPlayerId();
-    if (players.find(id) != players.end()) {
-        return false;  // Игрок с таким ID уже существует
-    }
-    
-    players[id] = player;
-    return true;
-}
-
-bool GameDatabase::removePlayer(const std::string& playerId) {
-    auto it = players.find(playerId);
-    if (it == players.end()) {
-        return false;
-    }
-    
-    delete it->second;
-    players.erase(it);
-    return true;
-}
-
-Player* GameDatabase::getPlayer(const std::string& playerId) const {
-    auto it = players.find(playerId);
-    return (it != players.end()) ? it->second : nullptr;
-}
-
-// Возврат по const ссылке - избегаем копирования контейнера
-const std::map<std::string, Player*>& GameDatabase::getAllPlayers() const {
-    return players;
-}
-
-// === Управление партиями ===
-
-bool GameDatabase::addMatch(Match* match) {
-    if (!match) return false;
-    
-    // Проверяем, что игра существует
-    if (games.find(match->getGameName()) == games.end()) {
-        return false;  // Игра не найдена
-    }
-    
-    // Добавляем партию в общий список
-    matches.push_back(match);
-    
-    // Добавляем партию в историю каждого игрока
-    std::map<std::string, double> results = match->getPlayerResults();
-    for (const auto& playerResult : results) {
-        const std::string& playerId = playerResult.first;
-        Player* player = getPlayer(playerId);
-        if (player) {
-            player->addMatchToHistory(match->getMatchId());
-        }
-    }
-    
-    return true;
-}
-
-Match* GameDatabase::getMatch(const std::string& matchId) const {
-    for (Match* match : matches) {
-        if (match && match->getMatchId() == matchId) {
-            return match;
-        }
-    }
-    return nullptr;
-}
-
-// Возврат по const ссылке - избегаем копирования вектора
-const std::vector<Match*>& GameDatabase::getAllMatches() const {
-    return matches;
-}
-
-std::vector<Match*> GameDatabase::getMatchesByGame(const std::string& gameName) const {
-    std::vector<Match*> result;
-    
-    for (Match* match : matches) {
-        if (match && match->getGameName() == gameName) {
-            result.push_back(match);
-        }
-    }
-    
-    return result;
-}
-
-std::vector<Match*> GameDatabase::getMatchesByPlayer(const std::string& playerId) const {
-    std::vector<Match*> result;
-    
-    for (Match* match : matches) {
-        if (match && match->hasPlayer(playerId)) {
-            result.push_back(match);
-        }
-    }
-    
-    return result;
-}
-
-// === Управление оценками ===
-
-bool GameDatabase::addRating(const std::string& gameName, const std::string& playerId, int rating) {
-    BoardGame* game = getGame(gameName);
-    Player* player = getPlayer(playerId);
-    
-    if (!game || !player) {
-        return false;
-    }
-    
-    return game->addRating(playerId, rating);
-}
-
-// === Управление схожестью игр ===
-
-bool GameDatabase::addSimilarity(const std::string& game1, const std::string& game2) {
-    // Проверяем существование обеих игр
-    if (games.find(game1) == games.end() || games.find(game2) == games.end()) {
-        return false;
-    }
-    
-    // Избегаем самосвязей
-    if (game1 == game2) {
-        return false;
-    }
-    
-    // Добавляем связь (храним в лексикографическом порядке для единообразия)
-    std::string first = (game1 < game2) ? game1 : game2;
-    std::string second = (game1 < game2) ? game2 : game1;
-    
-    similarGames.insert({first, second});
-    return true;
-}
-
-bool GameDatabase::areSimilar(const std::string& game1, const std::string& game2) const {
-    std::string first = (game1 < game2) ? game1 : game2;
-    std::string second = (game1 < game2) ? game2 : game1;
-    
-    return similarGames.find({first, second}) != similarGames.end();
-}
-
-std::vector<std::string> GameDatabase::getSimilarGames(const std::string& gameName) const {
-    std::vector<std::string> result;
-    
-    for (const auto& pair : similarGames) {
-        if (pair.first == gameName) {
-            result.push_back(pair.second);
-        } else if (pair.second == gameName) {
-            result.push_back(pair.first);
-        }
-    }
-    
-    return result;
-}
-
-const std::set<std::pair<std::string, std::string>>* GameDatabase::getSimilarityData() const {
-    return &similarGames;
-}
-
-// === Статистика и аналитика ===
-
-double GameDatabase::getPlayerRatingInGame(const std::string& playerId, const std::string& gameName) const {
-    // Находим все партии игрока в указанной игре
-    std::vector<Match*> playerMatches = getMatchesByPlayer(playerId);
-    
-    std::vector<double> results;
-    for (Match* match : playerMatches) {
-        if (match->getGameName() == gameName) {
-            double result = match->getPlayerResult(playerId);
-            if (result >= 0) {  // Проверка на валидность результата
-                results.push_back(result);
-            }
-        }
-    }
-    
-    // Используем метод Player для расчета среднего
-    Player* player = getPlayer(playerId);
-    if (player) {
-        return player->calculateRatingInGame(results);
-    }
-    
-    return 0.0;
-}
-
-std::vector<std::string> GameDatabase::getPlayerGames(const std::string& playerId) const {
-    std::vector<Match*> playerMatches = getMatchesByPlayer(playerId);
-    
-    std::set<std::string> uniqueGames;  // Используем set для уникальности
-    for (Match* match : playerMatches) {
-        uniqueGames.insert(match->getGameName());
-    }
-    
-    return std::vector<std::string>(uniqueGames.begin(), uniqueGames.end());
-}
-
-// === Фильтрация игр ===
-
-std::vector<BoardGame*> GameDatabase::findGames(Filter* filter) const {
-    if (!filter) {
-        return std::vector<BoardGame*>();
-    }
-    
-    std::vector<BoardGame*> result = filter->apply(games);
-    sortGamesByRating(result);
-    return result;
-}
-
-std::vector<BoardGame*> GameDatabase::findGames(const std::vector<Filter*>& filters) const {
-    if (filters.empty()) {
-        return std::vector<BoardGame*>();
-    }
-    
-    // Применяем первый фильтр ко всем играм
-    std::vector<BoardGame*> result = filters[0]->apply(games);
-    
-    // Последовательно применяем остальные фильтры к результату
-    for (size_t i = 1; i < filters.size(); ++i) {
-        // Преобразуем вектор в map для передачи в фильтр
-        std::map<std::string, BoardGame*> tempMap;
-        for (BoardGame* game : result) {
-            tempMap[game->getName()] = game;
-        }
-        
-        result = filters[i]->apply(tempMap);
-    }
-    
-    sortGamesByRating(result);
-    return result;
-}
-
-// Сортировка игр по убыванию среднего рейтинга
-void GameDatabase::sortGamesByRating(std::vector<BoardGame*>& games) const {
-    std::sort(games.begin(), games.end(), 
-        [](BoardGame* a, BoardGame* b) {
-            return a->getAverageRating() > b->getAverageRating();
-        });
-}
-
-// === Вывод информации ===
-
-void GameDatabase::printAllGames() const {
-    std::cout << "\n=== Все игры в базе ===" << std::endl;
-    if (games.empty()) {
-        std::cout << "База игр пуста." << std::endl;
-        return;
-    }
-    
-    for (const auto& pair : games) {
-        pair.second->printInfo();
-        std::cout << std::endl;
-    }
-}
-
-void GameDatabase::printAllPlayers() const {
-    std::cout << "\n=== Все игроки ===" << std::endl;
-    if (players.empty()) {
-        std::cout << "Нет зарегистрированных игроков." << std::endl;
-        return;
-    }
-    
-    for (const auto& pair : players) {
-        pair.second->printInfo();
-        std::cout << std::endl;
-    }
-}
-
-void GameDatabase::printAllMatches() const {
-    std::cout << "\n=== Все партии ===" << std::endl;
-    if (matches.empty()) {
-        std::cout << "Партий пока не было." << std::endl;
-        return;
-    }
-    
-    for (Match* match : matches) {
-        match->printInfo();
-        std::cout << std::endl;
-    }
-}
-
-void GameDatabase::printStatistics() const {
-    std::cout << "\n=== Статистика базы данных ===" << std::endl;
-    std::cout << "Всего игр: " << games.size() << std::endl;
-    std::cout << "Всего игроков: " << players.size() << std::endl;
-    std::cout << "Всего партий: " << matches.size() << std::endl;
-    std::cout << "Связей схожести: " << similarGames.size() << std::endl;
-}
-
-// === Автоматические тесты ===
-
-void GameDatabase::runTests() {
-    std::cout << "\n=== Тестирование класса GameDatabase ===" << std::endl;
-    
-    GameDatabase db;
-    
-    // Тест 1: Добавление игр
-    BoardGame* g1 = new BoardGame("Шахматы", "Стратегия", 2, 2, "Классика");
-    BoardGame* g2 = new BoardGame("Каркассон", "Тайлы", 2, 6, "Big Box");
-    BoardGame* g3 = new BoardGame("Колонизаторы", "Ресурсы", 3, 4, "5-е издание");
-    
-    db.addGame(g1);
-    db.addGame(g2);
-    db.addGame(g3);
-    
-    std::cout << "Тест 1 - Добавление игр: ";
-    if (db.getAllGames().size() == 3) {
-        std::cout << "PASSED" << std::endl;
-    } else {
-        std::cout << "FAILED" << std::endl;
-    }
-    
-    // Тест 2: Добавление игроков
-    Player* p1 = new Player("player_001", "Иван");
-    Player* p2 = new Player("player_002", "Мария");
-    Player* p3 = new Player("player_003", "Петр");
-    
-    db.addPlayer(p1);
-    db.addPlayer(p2);
-    db.addPlayer(p3);
-    
-    std::cout << "Тест 2 - Добавление игроков: ";
-    if (db.getAllPlayers().size() == 3) {
-        std::cout << "PASSED" << std::endl;
-    } else {
-        std::cout << "FAILED" << std::endl;
-    }
-    
-    // Тест 3: Выставление оценок
-    db.addRating("Шахматы", "player_001", 5);
-    db.addRating("Шахматы", "player_002", 4);
-    db.addRating("Каркассон", "player_001", 4);
-    db.addRating("Каркассон", "player_003", 5);
-    db.addRating("Колонизаторы", "player_002", 3);
-    
-    std::cout << "Тест 3 - Выставление оценок: ";
-    BoardGame* chess = db.getGame("Шахматы");
-    if (chess && chess->getRatings().size() == 2) {
-        std::cout << "PASSED" << std::endl;
-    } else {
-        std::cout << "FAILED" << std::endl;
-    }
-    
-    // Тест 4: Добавление партий
-    Match* m1 = new Match("match_001", "Шахматы", "2024-01-15");
-    m1->addPlayerResult("player_001", 1.0);  // Победа
-    m1->addPlayerResult("player_002", 0.0);  // Поражение
-    
-    Match* m2 = new Match("match_002", "Каркассон", "2024-01-16");
-    m2->addPlayerResult("player_001", 85.0);
-    m2->addPlayerResult("player_002", 92.0);
-    m2->addPlayerResult("player_003", 78.0);
-    
-    db.addMatch(m1);
-    db.addMatch(m2);
-    
-    std::cout << "Тест 4 - Добавление партий: ";
-    if (db.getAllMatches().size() == 2) {
-        std::cout << "PASSED" << std::endl;
-    } else {
-        std::cout << "FAILED" << std::endl;
-    }
-    
-    // Тест 5: Получение партий игрока
-    std::vector<Match*> player1Matches = db.getMatchesByPlayer("player_001");
-    
-    std::cout << "Тест 5 - Получение партий игрока: ";
-    if (player1Matches.size() == 2) {
-        std::cout << "PASSED" << std::endl;
-    } else {
-        std::cout << "FAILED (ожидалось 2, получено " << player1Matches.size() << ")" << std::endl;
-    }
-    
-    // Тест 6: Расчет рейтинга игрока в игре
-    double rating = db.getPlayerRatingInGame("player_001", "Каркассон");
-    
-    std::cout << "Тест 6 - Расчет рейтинга игрока: ";
-    if (rating == 85.0) {
-        std::cout << "PASSED (рейтинг: " << rating << ")" << std::endl;
-    } else {
-        std::cout << "FAILED (ожидалось 85.0, получено " << rating << ")" << std::endl;
-    }
-    
-    // Тест 7: Добавление схожести
-    db.addSimilarity("Шахматы", "Каркассон");
-    db.addSimilarity("Каркассон", "Колонизаторы");
-    
-    std::cout << "Тест 7 - Добавление схожести: ";
-    if (db.areSimilar("Шахматы", "Каркассон") && db.areSimilar("Колонизаторы", "Каркассон")) {
-        std::cout << "PASSED" << std::endl;
-    } else {
-        std::cout << "FAILED" << std::endl;
-    }
-    
-    // Тест 8: Фильтрация по рейтингу
-    RatingFilter ratingFilter(4.0);
-    std::vector<BoardGame*> highRatedGames = db.findGames(&ratingFilter);
-    
-    std::cout << "Тест 8 - Фильтрация по рейтингу: ";
-    if (highRatedGames.size() >= 2) {
-        std::cout << "PASSED (найдено " << highRatedGames.size() << " игр)" << std::endl;
-    } else {
-        std::cout << "FAILED" << std::endl;
-    }
-    
-    // Тест 9: Фильтрация по признакам
-    g1->addFeature("Жанр", "Стратегия");
-    g2->addFeature("Жанр", "Семейная");
-    g3->addFeature("Жанр", "Стратегия");
-    
-    std::map<std::string, std::string> features;
-    features["Жанр"] = "Стратегия";
-    FeatureFilter featureFilter(features);
-    
-    std::vector<BoardGame*> strategyGames = db.findGames(&featureFilter);
-    
-    std::cout << "Тест 9 - Фильтрация по признакам: ";
-    if (strategyGames.size() == 2) {
-        std::cout << "PASSED (найдено " << strategyGames.size() << " игры)" << std::endl;
-    } else {
-        std::cout << "FAILED (ожидалось 2, найдено " << strategyGames.size() << ")" << std::endl;
-    }
-    
-    // Тест 10: Фильтрация по схожести
-    std::vector<std::string> refs = {"Шахматы"};
-    SimilarGamesFilter similarFilter(refs, db.getSimilarityData());
-    
-    std::vector<BoardGame*> similarGames = db.findGames(&similarFilter);
-    
-    std::cout << "Тест 10 - Фильтрация по схожести: ";
-    if (similarGames.size() >= 1) {
-        std::cout << "PASSED (найдено " << similarGames.size() << " игра)" << std::endl;
-    } else {
-        std::cout << "FAILED" << std::endl;
-    }
-    
-    // Тест 11: Цепочка фильтров
-    std::vector<Filter*> filterChain;
-    filterChain.push_back(&ratingFilter);
-    filterChain.push_back(&featureFilter);
-    
-    std::vector<BoardGame*> chainResult = db.findGames(filterChain);
-    
-    std::cout << "Тест 11 - Цепочка фильтров: ";
-    if (chainResult.size() >= 1) {
-        std::cout << "PASSED (найдено " << chainResult.size() << " игр)" << std::endl;
-    } else {
-        std::cout << "FAILED" << std::endl;
-    }
-    
-    // Вывод статистики
-    db.printStatistics();
-    
-    std::cout << "=== Тестирование GameDatabase завершено ===\n" << std::endl;
-}
-
+#include "GameDatabase.h"
+#include "RatingFilter.h"
+#include "FeatureFilter.h"
+#include "SimilarGamesFilter.h"
+#include "Journal.h"
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+
+// Конструктор
+GameDatabase::GameDatabase()
+    : leaderboardMetric(new MeanResultMetric()), catalogVersion(0), catalogStatsBuilt(false), statsCatalogVersion(0),
+      statsGameVersion(0), columnsBuilt(false), columnsPublished(false), columnsGameSetVersion(0), gameSetVersion(0),
+      journal(nullptr) {
+    publish();  // читатели сразу получают (пустую) версию
+}
+
+// Деструктор - освобождает всю выделенную память
+GameDatabase::~GameDatabase() {
+    // Удаляем все игры
+    for (auto& pair : games) {
+        delete pair.second;
+    }
+    
+    // Удаляем всех игроков
+    for (auto& pair : players) {
+        delete pair.second;
+    }
+    
+    // Удаляем все партии
+    for (Match* match : matches) {
+        delete match;
+    }
+}
+
+// === Управление играми ===
+
+bool GameDatabase::addGame(BoardGame* game) {
+    if (!game) return false;
+    
+    if (games.find(game->getName()) != games.end()) {
+        return false;  // Игра с таким названием уже существует
+    }
+    
+    // Регистрируем номер игры для связей и множеств кандидатов; ключ - строка из таблицы имен,
+    // она живет все время работы программы и не зависит от игры (setName не оставит висячий ключ)
+    SymbolId handle = SymbolTable::games().intern(game->getName());
+    games.emplace(SymbolTable::games().name(handle), game);
+    
+    if (handle >= gamesByHandle.size()) {
+        gamesByHandle.resize(handle + static_cast<size_t>(1), nullptr);
+    }
+    gamesByHandle[handle] = game;
+    game->attachChangeLog(&gameChanges, handle);
+    gameChanges.record(handle);
+    ++catalogVersion;
+    ++gameSetVersion;
+    if (journal) {
+        journal->recordAddGame(*game);
+        checkpointIfDue();
+    }
+    return true;
+}
+
+bool GameDatabase::removeGame(std::string_view gameName) {
+    auto it = games.find(gameName);
+    if (it == games.end()) {
+        return false;
+    }
+    
+    BoardGame* game = it->second;
+    SymbolId handle = SymbolTable::games().find(gameName);
+    gamesByHandle[handle] = nullptr;
+    gameChanges.record(handle);
+    if (journal) {
+        journal->recordRemoveGame(gameName);  // до удаления: название может принадлежать самой игре
+    }
+    games.erase(it);
+    delete game;
+    ++catalogVersion;
+    ++gameSetVersion;
+    if (journal) {
+        checkpointIfDue();
+    }
+    return true;
+}
+
+BoardGame* GameDatabase::getGame(std::string_view gameName) const {
+    auto it = games.find(gameName);
+    return (it != games.end()) ? it->second : nullptr;
+}
+
+// Возврат по const ссылке - избегаем копирования большого контейнера
+const GameMap& GameDatabase::getAllGames() const {
+    return games;
+}
+
+// Перегрузка operator[] для удобного доступа к играм
+// Возвращает указатель на игру или nullptr, если игра не найдена
+BoardGame* GameDatabase::operator[](std::string_view gameName) const {
+    return getGame(gameName);
+}
+
+// === Управление игроками ===
+
+bool GameDatabase::addPlayer(Player* player) {
+    if (!player) return false;
+    
+    std::string_view id = player->getPlayerId();
+    if (players.find(id) != players.end()) {
+        return false;  // Игрок с таким ID уже существует
+    }
+    
+    players.emplace(id, player);
+    if (journal) {
+        journal->recordAddPlayer(*player);
+        checkpointIfDue();
+    }
+    return true;
+}
+
+bool GameDatabase::removePlayer(std::string_view playerId) {
+    auto it = players.find(playerId);
+    if (it == players.end()) {
+        return false;
+    }
+    
+    Player* player = it->second;
+    if (journal) {
+        journal->recordRemovePlayer(playerId);  // до удаления: ID может принадлежать самому игроку
+    }
+    players.erase(it);
+    delete player;
+    if (journal) {
+        checkpointIfDue();
+    }
+    return true;
+}
+
+Player* GameDatabase::getPlayer(std::string_view playerId) const {
+    auto it = players.find(playerId);
+    return (it != players.end()) ? it->second : nullptr;
+}
+
+// Возврат по const ссылке - избегаем копирования контейнера
+const std::map<std::string_view, Player*>& GameDatabase::getAllPlayers() const {
+    return players;
+}
+
+bool GameDatabase::addExternalPlayer(std::string_view playerId) {
+    if (players.find(playerId) != players.end()) {
+        return false;
+    }
+    return externalPlayers.insert(SymbolTable::players().intern(playerId)).second;
+}
+
+bool GameDatabase::removeExternalPlayer(std::string_view playerId) {
+    return externalPlayers.erase(SymbolTable::players().find(playerId)) > 0;
+}
+
+bool GameDatabase::hasPlayer(std::string_view playerId) const {
+    return players.find(playerId) != players.end() ||
+           (!externalPlayers.empty() && externalPlayers.count(SymbolTable::players().find(playerId)) > 0);
+}
+
+// === Управление партиями ===
+
+bool GameDatabase::addMatch(Match* match) {
+    if (!match) return false;
+    
+    // Проверяем, что игра существует
+    if (games.find(match->getGameName()) == games.end()) {
+        return false;  // Игра не найдена
+    }
+    
+    // ID партии должен быть уникальным
+    if (!matchIndex.emplace(match->getMatchHandle(), match).second) {
+        return false;
+    }
+    
+    indexMatch(match);
+    if (journal) {
+        journal->recordAddMatch(*match);
+        checkpointIfDue();
+    }
+    return true;
+}
+
+size_t GameDatabase::addMatches(const std::vector<Match*>& batch, std::vector<size_t>* rejected) {
+    // Сначала строки: проверка, справочник ID и журнал; индексы строятся потом сразу для всей пачки
+    std::vector<Match*> accepted;
+    accepted.reserve(batch.size());
+    matchIndex.reserve(matchIndex.size() + batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        Match* match = batch[i];
+        if (!match || !hasGame(match->getGameHandle()) ||
+            !matchIndex.emplace(match->getMatchHandle(), match).second) {
+            if (rejected) rejected->push_back(i);
+            continue;
+        }
+        accepted.push_back(match);
+        if (journal) {
+            journal->recordAddMatch(*match);
+        }
+    }
+    if (accepted.empty()) {
+        return 0;
+    }
+    
+    matches.insert(matches.end(), accepted.begin(), accepted.end());
+    matchesByTime.reserve(matchesByTime.size() + accepted.size());
+    for (Match* match : accepted) {
+        matchesByTime.add(match);
+    }
+    
+    // Индексы игр: партии пачки по играм (внутри игры - в порядке пачки), поэтому каждый список игры
+    // растет один раз, а таблица лидеров перестраивает места один раз на игрока, а не после каждой партии
+    std::vector<Match*> byGame(accepted);
+    std::stable_sort(byGame.begin(), byGame.end(),
+                     [](const Match* a, const Match* b) { return a->getGameHandle() < b->getGameHandle(); });
+    SymbolId lastGame = byGame.back()->getGameHandle();
+    if (lastGame >= matchCounts.size()) {
+        matchCounts.resize(lastGame + static_cast<size_t>(1), 0);
+    }
+    for (size_t first = 0; first < byGame.size();) {
+        SymbolId game = byGame[first]->getGameHandle();
+        size_t last = first;
+        while (last < byGame.size() && byGame[last]->getGameHandle() == game) ++last;
+        MatchRange run{byGame.data() + first, byGame.data() + last};
+        
+        std::vector<Match*>& gameMatches = matchesByGame[game];
+        gameMatches.insert(gameMatches.end(), run.begin(), run.end());
+        MatchTimeIndex& gameTime = matchesByGameTime[game];
+        gameTime.reserve(gameTime.size() + run.size());
+        for (Match* match : run) {
+            gameTime.add(match);
+        }
+        matchCounts[game] += static_cast<uint32_t>(run.size());
+        leaderboardOf(game).addMatches(run);
+        first = last;
+    }
+    // Игры независимы, поэтому по играм - тот же результат, что и в порядке пачки
+    skillRatings.addMatches(MatchRange{byGame.data(), byGame.data() + byGame.size()});
+    
+    // Индексы игроков - в порядке пачки (история и списки партий игрока идут в порядке добавления);
+    // игроки ищутся по ID один раз на пачку
+    std::unordered_map<SymbolId, Player*> batchPlayers;
+    for (Match* match : accepted) {
+        indexPlayers(match, &batchPlayers);
+    }
+    
+    // Контрольная точка журнала - не посреди пачки, а после нее
+    if (journal) {
+        checkpointIfDue();
+    }
+    return accepted.size();
+}
+
+bool GameDatabase::hasGame(SymbolId handle) const {
+    return handle < gamesByHandle.size() && gamesByHandle[handle] != nullptr;
+}
+
+void GameDatabase::indexMatch(Match* match) {
+    // Добавляем партию в общий список и в индекс по игре
+    matches.push_back(match);
+    SymbolId game = match->getGameHandle();
+    matchesByGame[game].push_back(match);
+    matchesByTime.add(match);
+    matchesByGameTime[game].add(match);
+    if (game >= matchCounts.size()) {
+        matchCounts.resize(game + static_cast<size_t>(1), 0);
+    }
+    ++matchCounts[game];
+    
+    leaderboardOf(game).addMatch(*match);
+    skillRatings.addMatch(*match);
+    indexPlayers(match, nullptr);
+}
+
+void GameDatabase::indexPlayers(Match* match, std::unordered_map<SymbolId, Player*>* playerCache) {
+    // Добавляем партию в индексы и историю каждого игрока
+    SymbolId game = match->getGameHandle();
+    const FlatMap<SymbolId, double>& results = match->getPlayerResults();
+    for (const auto& playerResult : results) {
+        SymbolId playerHandle = playerResult.first;
+        matchesByPlayer[playerHandle].push_back(match);
+        
+        std::vector<Match*>& playerGameMatches = matchesByPlayerGame[playerGameKey(playerHandle, game)];
+        if (playerGameMatches.empty()) {
+            gamesByPlayer[playerHandle].push_back(game);  // Первая партия игрока в эту игру
+        }
+        playerGameMatches.push_back(match);
+        
+        // Отрицательный результат не учитывается, как и в расчете рейтинга
+        if (playerResult.second >= 0) {
+            playerGameStats[playerGameKey(playerHandle, game)].addResult(playerResult.second, match->getDay());
+            changedStats.push_back(playerGameKey(playerHandle, game));
+        }
+        
+        Player* player = nullptr;
+        if (playerCache) {
+            auto cached = playerCache->find(playerHandle);
+            if (cached == playerCache->end()) {
+                cached = playerCache->emplace(playerHandle, getPlayer(SymbolTable::players().name(playerHandle))).first;
+            }
+            player = cached->second;
+        } else {
+            player = getPlayer(SymbolTable::players().name(playerHandle));
+        }
+        if (player) {
+            player->addMatchToHistory(match->getMatchHandle());
+        }
+    }
+}
+
+Match* GameDatabase::getMatch(std::string_view matchId) const {
+    auto it = matchIndex.find(SymbolTable::matches().find(matchId));
+    return (it != matchIndex.end()) ? it->second : nullptr;
+}
+
+// Возврат по const ссылке - избегаем копирования вектора
+const std::vector<Match*>& GameDatabase::getAllMatches() const {
+    return matches;
+}
+
+std::vector<Match*> GameDatabase::getMatchesByGame(std::string_view gameName) const {
+    MatchRange range = matchesOfGame(gameName);
+    return std::vector<Match*>(range.begin(), range.end());
+}
+
+std::vector<Match*> GameDatabase::getMatchesByPlayer(std::string_view playerId) const {
+    MatchRange range = matchesOfPlayer(playerId);
+    return std::vector<Match*>(range.begin(), range.end());
+}
+
+template <typename Key>
+MatchRange GameDatabase::rangeOf(const std::unordered_map<Key, std::vector<Match*>>& index, Key key) {
+    auto it = index.find(key);
+    if (it == index.end()) {
+        return MatchRange{nullptr, nullptr};
+    }
+    const std::vector<Match*>& list = it->second;
+    return MatchRange{list.data(), list.data() + list.size()};
+}
+
+MatchRange GameDatabase::matchesOfGame(std::string_view gameName) const {
+    return rangeOf(matchesByGame, SymbolTable::games().find(gameName));
+}
+
+MatchRange GameDatabase::matchesOfPlayer(std::string_view playerId) const {
+    return rangeOf(matchesByPlayer, SymbolTable::players().find(playerId));
+}
+
+MatchRange GameDatabase::matchesOfPlayerInGame(std::string_view playerId, std::string_view gameName) const {
+    SymbolId player = SymbolTable::players().find(playerId);
+    SymbolId game = SymbolTable::games().find(gameName);
+    if (player == INVALID_SYMBOL || game == INVALID_SYMBOL) {
+        return MatchRange{nullptr, nullptr};
+    }
+    return rangeOf(matchesByPlayerGame, playerGameKey(player, game));
+}
+
+MatchRange GameDatabase::getMatchesBetween(Date from, Date to) const {
+    return matchesByTime.between(from, to);
+}
+
+MatchRange GameDatabase::getMatchesBetween(Date from, Date to, std::string_view gameName) const {
+    auto it = matchesByGameTime.find(SymbolTable::games().find(gameName));
+    return (it != matchesByGameTime.end()) ? it->second.between(from, to) : MatchRange{nullptr, nullptr};
+}
+
+// === Управление оценками ===
+
+bool GameDatabase::addRating(std::string_view gameName, std::string_view playerId, int rating) {
+    BoardGame* game = getGame(gameName);
+    Player* player = getPlayer(playerId);
+    
+    if (!game || (!player && !hasPlayer(playerId))) {
+        return false;
+    }
+    
+    bool added = player ? game->addRating(player->getPlayerId(), rating) : game->addRating(std::string(playerId), rating);
+    if (!added) {
+        return false;
+    }
+    if (journal) {
+        journal->recordRating(gameName, playerId, rating);
+        checkpointIfDue();
+    }
+    return true;
+}
+
+bool GameDatabase::updateRating(std::string_view gameName, std::string_view playerId, int rating) {
+    BoardGame* game = getGame(gameName);
+    if (!game || !game->updateRating(playerId, rating)) {
+        return false;
+    }
+    if (journal) {
+        journal->recordUpdateRating(gameName, playerId, rating);
+        checkpointIfDue();
+    }
+    return true;
+}
+
+bool GameDatabase::removeRating(std::string_view gameName, std::string_view playerId) {
+    BoardGame* game = getGame(gameName);
+    if (!game || !game->removeRating(playerId)) {
+        return false;
+    }
+    if (journal) {
+        journal->recordRemoveRating(gameName, playerId);
+        checkpointIfDue();
+    }
+    return true;
+}
+
+// === Управление признаками игр ===
+
+bool GameDatabase::addFeature(std::string_view gameName, const std::string& featureName, const std::string& featureValue) {
+    BoardGame* game = getGame(gameName);
+    if (!game || !game->addFeature(featureName, featureValue)) {
+        return false;
+    }
+    if (journal) {
+        journal->recordAddFeature(gameName, featureName, featureValue);
+        checkpointIfDue();
+    }
+    return true;
+}
+
+bool GameDatabase::updateFeature(std::string_view gameName, std::string_view featureName, const std::string& featureValue) {
+    BoardGame* game = getGame(gameName);
+    if (!game || !game->updateFeature(featureName, featureValue)) {
+        return false;
+    }
+    if (journal) {
+        journal->recordUpdateFeature(gameName, featureName, featureValue);
+        checkpointIfDue();
+    }
+    return true;
+}
+
+bool GameDatabase::removeFeature(std::string_view gameName, std::string_view featureName) {
+    BoardGame* game = getGame(gameName);
+    if (!game || !game->removeFeature(featureName)) {
+        return false;
+    }
+    if (journal) {
+        journal->recordRemoveFeature(gameName, featureName);
+        checkpointIfDue();
+    }
+    return true;
+}
+
+// === Управление схожестью игр ===
+
+bool GameDatabase::addSimilarity(std::string_view game1, std::string_view game2) {
+    // Проверяем существование обеих игр
+    if (games.find(game1) == games.end() || games.find(game2) == games.end()) {
+        return false;
+    }
+    
+    // Избегаем самосвязей
+    if (game1 == game2) {
+        return false;
+    }
+    
+    // Связь симметрична, граф хранит ее в обоих направлениях
+    if (similarGames.addEdge(SymbolTable::games().intern(game1), SymbolTable::games().intern(game2))) {
+        ++catalogVersion;
+        if (journal) {
+            journal->recordSimilarity(game1, game2);
+            checkpointIfDue();
+        }
+    }
+    return true;
+}
+
+bool GameDatabase::areSimilar(std::string_view game1, std::string_view game2) const {
+    return similarGames.contains(SymbolTable::games().find(game1), SymbolTable::games().find(game2));
+}
+
+std::vector<std::string> GameDatabase::getSimilarGames(std::string_view gameName) const {
+    std::vector<std::string> result;
+    NeighborRange neighbors = similarGames.neighbors(SymbolTable::games().find(gameName));
+    result.reserve(neighbors.size());
+    for (SymbolId neighbor : neighbors) {
+        result.push_back(SymbolTable::games().name(neighbor));
+    }
+    
+    return result;
+}
+
+const SimilarityGraph* GameDatabase::getSimilarityData() const {
+    return &similarGames;
+}
+
+void GameDatabase::compactSimilarity() {
+    similarGames.compact();
+}
+
+// === Статистика и аналитика ===
+
+double GameDatabase::getPlayerRatingInGame(std::string_view playerId, std::string_view gameName) const {
+    // Рейтинг считается только для зарегистрированных игроков
+    if (!hasPlayer(playerId)) {
+        return 0.0;
+    }
+    
+    const PlayerGameStats* stats = getPlayerGameStats(playerId, gameName);
+    return stats ? stats->getMean() : 0.0;
+}
+
+const PlayerGameStats* GameDatabase::getPlayerGameStats(std::string_view playerId, std::string_view gameName) const {
+    SymbolId player = SymbolTable::players().find(playerId);
+    SymbolId game = SymbolTable::games().find(gameName);
+    if (player == INVALID_SYMBOL || game == INVALID_SYMBOL) {
+        return nullptr;
+    }
+    
+    auto it = playerGameStats.find(playerGameKey(player, game));
+    return (it != playerGameStats.end()) ? &it->second : nullptr;
+}
+
+const Leaderboard* GameDatabase::getLeaderboard(std::string_view gameName) const {
+    auto it = leaderboards.find(SymbolTable::games().find(gameName));
+    return (it != leaderboards.end()) ? &it->second : nullptr;
+}
+
+void GameDatabase::setLeaderboardMetric(const LeaderboardMetric& metric) {
+    leaderboardMetric = metric.create();
+    leaderboards.clear();
+    for (Match* match : matches) {
+        leaderboardOf(match->getGameHandle()).addMatch(*match);
+    }
+}
+
+const SkillRating* GameDatabase::getSkillRating(std::string_view playerId, std::string_view gameName) const {
+    return skillRatings.getRating(SymbolTable::players().find(playerId), SymbolTable::games().find(gameName));
+}
+
+const SkillRatingEngine& GameDatabase::getSkillRatings() const {
+    return skillRatings;
+}
+
+void GameDatabase::recomputeSkillRatings() {
+    skillRatings.recompute(matches);
+}
+
+void GameDatabase::setSkillOptions(const SkillOptions& options) {
+    skillRatings.setOptions(options);
+    skillRatings.recompute(matches);
+}
+
+Leaderboard& GameDatabase::leaderboardOf(SymbolId game) {
+    auto board = leaderboards.find(game);
+    if (board == leaderboards.end()) {
+        board = leaderboards.emplace(game, Leaderboard(leaderboardMetric->create())).first;
+    }
+    return board->second;
+}
+
+const LeaderboardMetric& GameDatabase::getLeaderboardMetric() const {
+    return *leaderboardMetric;
+}
+
+std::vector<std::pair<std::string_view, const PlayerGameStats*>> GameDatabase::getPlayerStats(std::string_view playerId) const {
+    std::vector<std::pair<std::string_view, const PlayerGameStats*>> result;
+    SymbolId player = SymbolTable::players().find(playerId);
+    auto it = gamesByPlayer.find(player);
+    if (it == gamesByPlayer.end()) {
+        return result;
+    }
+    
+    result.reserve(it->second.size());
+    for (SymbolId game : it->second) {
+        auto stats = playerGameStats.find(playerGameKey(player, game));
+        if (stats != playerGameStats.end()) {
+            result.push_back({SymbolTable::games().name(game), &stats->second});
+        }
+    }
+    return result;
+}
+
+std::vector<std::string> GameDatabase::getPlayerGames(std::string_view playerId) const {
+    std::set<std::string_view> uniqueGames;  // Сортировка по названию, как и раньше
+    auto it = gamesByPlayer.find(SymbolTable::players().find(playerId));
+    if (it != gamesByPlayer.end()) {
+        for (SymbolId game : it->second) {
+            uniqueGames.insert(SymbolTable::games().name(game));
+        }
+    }
+    
+    return std::vector<std::string>(uniqueGames.begin(), uniqueGames.end());
+}
+
+// === Фильтрация игр ===
+
+std::vector<BoardGame*> GameDatabase::findGames(Filter* filter) const {
+    if (!filter) {
+        return std::vector<BoardGame*>();
+    }
+    
+    return findGames(std::vector<Filter*>{filter});
+}
+
+std::vector<BoardGame*> GameDatabase::findGames(const std::vector<Filter*>& filters, QueryPlan* plan) const {
+    if (filters.empty()) {
+        return std::vector<BoardGame*>();
+    }
+    
+    // Выполненный план нужен только при выполнении, такой запрос кеш не читает
+    std::string key;
+    std::vector<uint64_t> stamps;
+    bool cacheable = !plan && queryCache.getMemoryBudget() > 0 &&
+                     QueryCache::describe(filters, gameSetVersion, key, stamps);
+    std::vector<BoardGame*> result;
+    if (cacheable && queryCache.find(key, stamps, result)) {
+        return result;
+    }
+    
+    CatalogView catalog = view();
+    result = gamesOf(CatalogQuery::order(catalog, CatalogQuery::select(catalog, filters, plan), OrderBy{SortKey::byRating()}));
+    if (cacheable) {
+        queryCache.store(key, stamps, result);
+    }
+    return result;
+}
+
+std::vector<BoardGame*> GameDatabase::findGames(const std::vector<Filter*>& filters, const OrderBy& order) const {
+    if (filters.empty()) {
+        return std::vector<BoardGame*>();
+    }
+    
+    CatalogView catalog = view();
+    return gamesOf(CatalogQuery::order(catalog, CatalogQuery::select(catalog, filters, nullptr), order));
+}
+
+ResultPage GameDatabase::findGames(const std::vector<Filter*>& filters, size_t limit, const std::string& cursor) const {
+    ResultPage page;
+    page.hasMore = false;
+    if (filters.empty() || limit == 0) {
+        return page;
+    }
+    
+    CatalogView catalog = view();
+    PageIds ids = CatalogQuery::page(catalog, CatalogQuery::select(catalog, filters, nullptr), limit, cursor);
+    page.games = gamesOf(ids.ids);
+    page.nextCursor = ids.nextCursor;
+    page.hasMore = ids.hasMore;
+    return page;
+}
+
+size_t GameDatabase::forEachGame(const std::vector<Filter*>& filters, const GameVisitor& visit) const {
+    if (filters.empty()) {
+        return 0;
+    }
+    
+    return CatalogQuery::stream(view(), filters, [&](uint32_t id) { return visit(gamesByHandle[id]); });
+}
+
+QueryCache& GameDatabase::getQueryCache() {
+    return queryCache;
+}
+
+const QueryCache& GameDatabase::getQueryCache() const {
+    return queryCache;
+}
+
+QueryPlan GameDatabase::planQuery(const std::vector<Filter*>& filters) const {
+    return CatalogQuery::plan(view(), filters);
+}
+
+const CatalogStats& GameDatabase::getCatalogStats() const {
+    // Считаются только изменения игр этой базы: правки в других базах (шардах, копиях) ее не касаются
+    uint64_t changes = gameChanges.version - statsGameVersion;
+    bool stale = !catalogStatsBuilt || statsCatalogVersion != catalogVersion ||
+                 changes > catalogStats.getGameCount() / 16;
+    if (stale) {
+        catalogStats.build(gamesByHandle, &similarGames);
+        catalogStatsBuilt = true;
+        statsCatalogVersion = catalogVersion;
+        statsGameVersion = gameChanges.version;
+    }
+    return catalogStats;
+}
+
+const CatalogColumns& GameDatabase::getCatalogColumns() const {
+    if (!columnsBuilt || columnsGameSetVersion != gameSetVersion) {
+        catalogColumns = std::make_shared<CatalogColumns>();
+        catalogColumns->build(gamesByHandle, &games);
+        columnsBuilt = true;
+        columnsPublished = false;
+        columnsGameSetVersion = gameSetVersion;
+    } else if (!gameChanges.changed.empty()) {
+        // Состав каталога тот же: перезаписываются только строки измененных игр;
+        // опубликованный снимок сначала копируется - копия делит с ним блоки, и копируются лишь блоки этих строк
+        if (columnsPublished) {
+            catalogColumns = std::make_shared<CatalogColumns>(*catalogColumns);
+            columnsPublished = false;
+        }
+        catalogColumns->updateRows(gamesByHandle, gameChanges.changed);
+    }
+    
+    // Учтенные в столбцах изменения ждут следующей публикации
+    for (SymbolId handle : gameChanges.changed) {
+        unpublishedGames.record(handle);
+    }
+    gameChanges.clear();
+    return *catalogColumns;
+}
+
+std::shared_ptr<const DatabaseSnapshot> GameDatabase::publish() {
+    std::shared_ptr<const DatabaseSnapshot> previous = std::atomic_load(&published);
+    std::shared_ptr<DatabaseSnapshot> next(new DatabaseSnapshot());
+    next->version = previous ? previous->version + 1 : 1;
+    next->catalogVersion = catalogVersion;
+    next->gameVersion = gameChanges.version;
+    next->matchCount = matches.size();
+    
+    bool catalogChanged = !previous || previous->catalogVersion != catalogVersion;
+    getCatalogColumns();  // столбцы общие с живой базой; заодно переносит измененные игры в unpublishedGames
+    next->columns = catalogColumns;
+    columnsPublished = true;
+    bool gamesChanged = !previous || !unpublishedGames.changed.empty();
+    
+    // Игры: копируются только добавленные, удаленные и измененные с прошлой публикации;
+    // блоки копий без изменений общие с прошлой версией, заново собирается только массив указателей по номерам
+    if (gamesChanged) {
+        typedef DatabaseSnapshot::CopyBlock CopyBlock;
+        const size_t BLOCK = DatabaseSnapshot::COPY_BLOCK;
+        std::shared_ptr<DatabaseSnapshot::GameCopies> copies = previous
+            ? std::make_shared<DatabaseSnapshot::GameCopies>(*previous->games)
+            : std::make_shared<DatabaseSnapshot::GameCopies>();
+        copies->byHandle.resize(gamesByHandle.size(), nullptr);
+        copies->blocks.resize((gamesByHandle.size() + BLOCK - 1) / BLOCK);
+        std::vector<bool> ownBlock(copies->blocks.size(), false);  // блок уже принадлежит новой версии
+        for (SymbolId id : unpublishedGames.changed) {
+            size_t block = id / BLOCK;
+            if (!ownBlock[block]) {
+                copies->blocks[block] = copies->blocks[block] ? std::make_shared<CopyBlock>(*copies->blocks[block])
+                                                              : std::make_shared<CopyBlock>(BLOCK);
+                ownBlock[block] = true;
+            }
+            std::shared_ptr<BoardGame>& copy = (*copies->blocks[block])[id % BLOCK];
+            const BoardGame* game = gamesByHandle[id];
+            copies->count -= copy ? 1 : 0;
+            copy = game ? std::make_shared<BoardGame>(*game) : nullptr;
+            copies->count += copy ? 1 : 0;
+            copies->byHandle[id] = copy.get();
+        }
+        next->games = copies;
+    } else {
+        next->games = previous->games;
+    }
+    
+    // Граф меняется только вместе с catalogVersion; копия укладывается в CSR для чтения
+    if (catalogChanged) {
+        std::shared_ptr<SimilarityGraph> graph = std::make_shared<SimilarityGraph>(similarGames);
+        graph->compact();
+        next->similarity = graph;
+    } else {
+        next->similarity = previous->similarity;
+    }
+    
+    // Статистика каталога - с тем же допуском, что и у живой базы (см. getCatalogStats)
+    bool statsStale = catalogChanged ||
+                      next->gameVersion - previous->statsGameVersion > previous->stats->getGameCount() / 16;
+    if (statsStale) {
+        std::shared_ptr<CatalogStats> stats = std::make_shared<CatalogStats>();
+        stats->build(next->games->byHandle, next->similarity.get());
+        next->stats = stats;
+        next->statsGameVersion = next->gameVersion;
+    } else {
+        next->stats = previous->stats;
+        next->statsGameVersion = previous->statsGameVersion;
+    }
+    
+    bool matchesChanged = !previous || previous->matchCount != matches.size();
+    next->matchCounts = matchesChanged ? std::make_shared<const std::vector<uint32_t>>(matchCounts) : previous->matchCounts;
+    
+    // Статистика игроков: части примерно по COPY_BLOCK пар, копируются только части, в которые попали новые партии;
+    // число частей растет вдвое вместе со статистикой, и тогда части раскладываются заново (раз на удвоение)
+    size_t shards = DatabaseSnapshot::STATS_SHARDS;
+    while (shards * DatabaseSnapshot::COPY_BLOCK < playerGameStats.size()) {
+        shards *= 2;
+    }
+    if (previous && previous->playerStats.size() == shards) {
+        next->playerStats = previous->playerStats;
+        std::vector<std::shared_ptr<DatabaseSnapshot::StatsShard>> touched(shards);
+        for (uint64_t key : changedStats) {
+            size_t shard = DatabaseSnapshot::shardOf(key, shards);
+            if (!touched[shard]) {
+                touched[shard] = std::make_shared<DatabaseSnapshot::StatsShard>(*next->playerStats[shard]);
+                next->playerStats[shard] = touched[shard];
+            }
+            (*touched[shard])[key] = playerGameStats.at(key);
+        }
+    } else {
+        std::vector<std::shared_ptr<DatabaseSnapshot::StatsShard>> parts(shards);
+        for (auto& part : parts) {
+            part = std::make_shared<DatabaseSnapshot::StatsShard>();
+        }
+        for (const auto& entry : playerGameStats) {
+            parts[DatabaseSnapshot::shardOf(entry.first, shards)]->emplace(entry.first, entry.second);
+        }
+        next->playerStats.assign(parts.begin(), parts.end());
+    }
+    
+    unpublishedGames.clear();
+    changedStats.clear();
+    std::atomic_store(&published, std::shared_ptr<const DatabaseSnapshot>(next));
+    return next;
+}
+
+std::shared_ptr<const DatabaseSnapshot> GameDatabase::snapshot() const {
+    return std::atomic_load(&published);
+}
+
+// === Журнал изменений ===
+
+void GameDatabase::attachJournal(Journal* journal) {
+    this->journal = journal;
+}
+
+Journal* GameDatabase::getJournal() const {
+    return journal;
+}
+
+void GameDatabase::checkpointIfDue() {
+    // неудачная контрольная точка не мешает: журнал остается полным, попытка повторится позже
+    if (journal->checkpointDue()) {
+        journal->checkpoint(*this);
+    }
+}
+
+CatalogView GameDatabase::view() const {
+    return CatalogView{&gamesByHandle, &getCatalogColumns(), &getCatalogStats(), &matchCounts, nullptr};
+}
+
+std::vector<BoardGame*> GameDatabase::gamesOf(const std::vector<uint32_t>& ids) const {
+    std::vector<BoardGame*> result;
+    result.reserve(ids.size());
+    for (uint32_t id : ids) {
+        result.push_back(gamesByHandle[id]);
+    }
+    return result;
+}
+
+// === Вывод информации ===
+
+void GameDatabase::printAllGames() const {
+    std::cout << "\n=== Все игры в базе ===" << std::endl;
+    if (games.empty()) {
+        std::cout << "База игр пуста." << std::endl;
+        return;
+    }
+    
+    for (const auto& pair : games) {
+        pair.second->printInfo();
+        std::cout << std::endl;
+    }
+}
+
+void GameDatabase::printAllPlayers() const {
+    std::cout << "\n=== Все игроки ===" << std::endl;
+    if (players.empty()) {
+        std::cout << "Нет зарегистрированных игроков." << std::endl;
+        return;
+    }
+    
+    for (const auto& pair : players) {
+        pair.second->printInfo();
+        std::cout << std::endl;
+    }
+}
+
+void GameDatabase::printAllMatches() const {
+    std::cout << "\n=== Все партии ===" << std::endl;
+    if (matches.empty()) {
+        std::cout << "Партий пока не было." << std::endl;
+        return;
+    }
+    
+    for (Match* match : matches) {
+        match->printInfo();
+        std::cout << std::endl;
+    }
+}
+
+void GameDatabase::printStatistics() const {
+    std::cout << "\n=== Статистика базы данных ===" << std::endl;
+    std::cout << "Всего игр: " << games.size() << std::endl;
+    std::cout << "Всего игроков: " << players.size() << std::endl;
+    std::cout << "Всего партий: " << matches.size() << std::endl;
+    std::cout << "Связей схожести: " << similarGames.edgeCount() << std::endl;
+}
+
+// === Автоматические тесты ===
+
+void GameDatabase::runTests() {
+    std::cout << "\n=== Тестирование класса GameDatabase ===" << std::endl;
+    
+    GameDatabase db;
+    
+    // Тест 1: Добавление игр
+    BoardGame* g1 = new BoardGame("Шахматы", "Стратегия", 2, 2, "Классика");
+    BoardGame* g2 = new BoardGame("Каркассон", "Тайлы", 2, 6, "Big Box");
+    BoardGame* g3 = new BoardGame("Колонизаторы", "Ресурсы", 3, 4, "5-е издание");
+    
+    db.addGame(g1);
+    db.addGame(g2);
+    db.addGame(g3);
+    
+    std::cout << "Тест 1 - Добавление игр: ";
+    if (db.getAllGames().size() == 3) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 1а: Поиск по string_view без создания временной строки
+    std::string request = "игра=Каркассон";
+    std::string_view requestedName = std::string_view(request).substr(request.find('=') + 1);
+    
+    const std::string& internedName = SymbolTable::games().name(SymbolTable::games().find("Каркассон"));
+    std::cout << "Тест 1а - Поиск по string_view: ";
+    if (db.getGame(requestedName) == g2 && db.getAllGames().find(requestedName)->first.data() == internedName.data()) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 1б: Переименование игры в базе оставляет прежний ключ, но не висячий
+    {
+        GameDatabase renamed;
+        BoardGame* game = new BoardGame("Имя До", "", 2, 4, "");
+        renamed.addGame(game);
+        game->setName(std::string(64, 'x'));  // длинная строка: старый буфер названия освобождается
+        std::cout << "Тест 1б - Ключ после setName: ";
+        if (renamed.getGame("Имя До") == game && renamed.getAllGames().begin()->first == "Имя До") {
+            std::cout << "PASSED" << std::endl;
+        } else {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+    
+    // Тест 2: Добавление игроков
+    Player* p1 = new Player("player_001", "Иван");
+    Player* p2 = new Player("player_002", "Мария");
+    Player* p3 = new Player("player_003", "Петр");
+    
+    db.addPlayer(p1);
+    db.addPlayer(p2);
+    db.addPlayer(p3);
+    
+    std::cout << "Тест 2 - Добавление игроков: ";
+    if (db.getAllPlayers().size() == 3) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 3: Выставление оценок
+    db.addRating("Шахматы", "player_001", 5);
+    db.addRating("Шахматы", "player_002", 4);
+    db.addRating("Каркассон", "player_001", 4);
+    db.addRating("Каркассон", "player_003", 5);
+    db.addRating("Колонизаторы", "player_002", 3);
+    
+    std::cout << "Тест 3 - Выставление оценок: ";
+    BoardGame* chess = db.getGame("Шахматы");
+    if (chess && chess->getRatings().size() == 2) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 4: Добавление партий
+    Match* m1 = new Match("match_001", "Шахматы", "2024-01-15");
+    m1->addPlayerResult("player_001", 1.0);  // Победа
+    m1->addPlayerResult("player_002", 0.0);  // Поражение
+    
+    Match* m2 = new Match("match_002", "Каркассон", "2024-01-16");
+    m2->addPlayerResult("player_001", 85.0);
+    m2->addPlayerResult("player_002", 92.0);
+    m2->addPlayerResult("player_003", 78.0);
+    
+    db.addMatch(m1);
+    db.addMatch(m2);
+    
+    std::cout << "Тест 4 - Добавление партий: ";
+    if (db.getAllMatches().size() == 2) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 4а: Поиск партии по ID и уникальность ID
+    Match duplicate("match_001", "Каркассон", "2024-01-17");
+    
+    std::cout << "Тест 4а - Поиск партии по ID и защита от повтора ID: ";
+    if (db.getMatch("match_002") == m2 && db.getMatch("match_999") == nullptr &&
+        !db.addMatch(&duplicate) && db.getAllMatches().size() == 2) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 5: Получение партий игрока
+    std::vector<Match*> player1Matches = db.getMatchesByPlayer("player_001");
+    
+    std::cout << "Тест 5 - Получение партий игрока: ";
+    if (player1Matches.size() == 2) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED (ожидалось 2, получено " << player1Matches.size() << ")" << std::endl;
+    }
+    
+    // Тест 5а: Инвертированные индексы партий
+    MatchRange carcassonneMatches = db.matchesOfGame("Каркассон");
+    MatchRange player3InChess = db.matchesOfPlayerInGame("player_003", "Шахматы");
+    std::vector<std::string> player2Games = db.getPlayerGames("player_002");
+    
+    std::cout << "Тест 5а - Индексы партий по игре, игроку и паре: ";
+    if (carcassonneMatches.size() == 1 && carcassonneMatches[0] == m2 &&
+        player3InChess.empty() && db.matchesOfPlayer("player_003").size() == 1 &&
+        db.matchesOfGame("Нет такой игры").empty() &&
+        player2Games.size() == 2 && player2Games[0] == "Каркассон" && player2Games[1] == "Шахматы") {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 5б: Партии за период - по индексу времени, в порядке дат
+    Match* early = new Match("match_early", "Шахматы", "2023-12-31");
+    early->addPlayerResult("player_early", 1.0);
+    db.addMatch(early);
+    MatchRange january = db.getMatchesBetween(Date(2024, 1, 1), Date(2024, 1, 31));
+    MatchRange chessSince = db.getMatchesBetween(Date(2023, 12, 1), Date(2024, 1, 15), "Шахматы");
+    
+    std::cout << "Тест 5б - Партии за период: ";
+    if (january.size() == 2 && january[0] == m1 && january[1] == m2 &&
+        chessSince.size() == 2 && chessSince[0] == early && chessSince[1] == m1 &&
+        db.getMatchesBetween(Date(2024, 1, 1), Date(2024, 1, 31), "Нет такой игры").empty()) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 6: Расчет рейтинга игрока в игре
+    double rating = db.getPlayerRatingInGame("player_001", "Каркассон");
+    
+    std::cout << "Тест 6 - Расчет рейтинга игрока: ";
+    if (rating == 85.0) {
+        std::cout << "PASSED (рейтинг: " << rating << ")" << std::endl;
+    } else {
+        std::cout << "FAILED (ожидалось 85.0, получено " << rating << ")" << std::endl;
+    }
+    
+    // Тест 6а: Накопленная статистика игрока
+    Match* m3 = new Match("match_003", "Каркассон", "2024-02-01");
+    m3->addPlayerResult("player_001", 95.0);
+    db.addMatch(m3);
+    
+    const PlayerGameStats* stats = db.getPlayerGameStats("player_001", "Каркассон");
+    std::vector<std::pair<std::string_view, const PlayerGameStats*>> allStats = db.getPlayerStats("player_001");
+    
+    std::cout << "Тест 6а - Статистика игрока по играм: ";
+    if (stats && stats->getCount() == 2 && stats->getMin() == 85.0 && stats->getMax() == 95.0 &&
+        stats->getLastPlayed() == "2024-02-01" && std::abs(stats->getVariance() - 50.0) < 1e-9 &&
+        db.getPlayerRatingInGame("player_001", "Каркассон") == 90.0 &&
+        allStats.size() == 2 && allStats[0].first == "Шахматы" && allStats[0].second->getMean() == 1.0) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 6б: Таблица лидеров обновляется партиями, показатель можно сменить
+    const Leaderboard* board = db.getLeaderboard("Каркассон");
+    std::vector<LeaderboardEntry> leaders = board ? board->top(2) : std::vector<LeaderboardEntry>();
+    bool meanRanks = board && board->size() == 3 && leaders.size() == 2 &&
+                     leaders[0].playerId == "player_002" && leaders[1].playerId == "player_001" &&
+                     leaders[1].score == db.getPlayerRatingInGame("player_001", "Каркассон") &&
+                     board->rankOf("player_003") == 3 && !db.getLeaderboard("Колонизаторы");
+    db.setLeaderboardMetric(WinRateMetric());
+    board = db.getLeaderboard("Каркассон");
+    bool winRanks = board && board->scoreOf("player_001") == 0.5 && board->rankOf("player_002") == 1 &&
+                    board->percentileOf("player_003") == 0.0;
+    db.setLeaderboardMetric(MeanResultMetric());
+    
+    std::cout << "Тест 6б - Таблица лидеров игры: ";
+    if (meanRanks && winRanks && db.getLeaderboard("Шахматы")->rankOf("player_001") == 1) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 6в: Рейтинг силы - одна шкала для шахмат (1/0) и Каркассона (очки)
+    const SkillRating* chessSkill = db.getSkillRating("player_001", "Шахматы");
+    const SkillRating* carcassonneSkill = db.getSkillRating("player_002", "Каркассон");
+    const SkillRating* loserSkill = db.getSkillRating("player_003", "Каркассон");
+    bool glicko = chessSkill && carcassonneSkill && loserSkill && chessSkill->rating > 1500 &&
+                  carcassonneSkill->rating > 1500 && loserSkill->rating < 1500 && chessSkill->deviation < 350 &&
+                  db.getSkillRating("player_001", "Каркассон")->matches == 2 &&
+                  !db.getSkillRating("player_003", "Шахматы");
+    double carcassonneRating = carcassonneSkill ? carcassonneSkill->rating : 0.0;  // пересчет заменяет рейтинги
+    SkillOptions eloOptions;
+    eloOptions.model = SkillModel::Elo;
+    db.setSkillOptions(eloOptions);
+    bool elo = db.getSkillRating("player_001", "Шахматы")->rating == 1516.0;
+    db.setSkillOptions(SkillOptions());
+    
+    std::cout << "Тест 6в - Рейтинг силы игрока в игре: ";
+    if (glicko && elo && db.getSkillRating("player_002", "Каркассон")->rating == carcassonneRating) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 7: Добавление схожести
+    db.addSimilarity("Шахматы", "Каркассон");
+    db.addSimilarity("Каркассон", "Колонизаторы");
+    
+    std::cout << "Тест 7 - Добавление схожести: ";
+    if (db.areSimilar("Шахматы", "Каркассон") && db.areSimilar("Колонизаторы", "Каркассон")) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 8: Фильтрация по рейтингу
+    RatingFilter ratingFilter(4.0);
+    std::vector<BoardGame*> highRatedGames = db.findGames(&ratingFilter);
+    
+    std::cout << "Тест 8 - Фильтрация по рейтингу: ";
+    if (highRatedGames.size() >= 2) {
+        std::cout << "PASSED (найдено " << highRatedGames.size() << " игр)" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 9: Фильтрация по признакам
+    db.addFeature("Шахматы", "Жанр", "Стратегия");
+    db.addFeature("Каркассон", "Жанр", "Семейная");
+    db.addFeature("Колонизаторы", "Жанр", "Стратегия");
+    
+    std::map<std::string, std::string> features;
+    features["Жанр"] = "Стратегия";
+    FeatureFilter featureFilter(features);
+    
+    std::vector<BoardGame*> strategyGames = db.findGames(&featureFilter);
+    
+    std::cout << "Тест 9 - Фильтрация по признакам: ";
+    if (strategyGames.size() == 2) {
+        std::cout << "PASSED (найдено " << strategyGames.size() << " игры)" << std::endl;
+    } else {
+        std::cout << "FAILED (ожидалось 2, найдено " << strategyGames.size() << ")" << std::endl;
+    }
+    
+    // Тест 10: Фильтрация по схожести
+    std::vector<std::string> refs = {"Шахматы"};
+    SimilarGamesFilter similarFilter(refs, db.getSimilarityData());
+    
+    std::vector<BoardGame*> similarGames = db.findGames(&similarFilter);
+    
+    std::cout << "Тест 10 - Фильтрация по схожести: ";
+    if (similarGames.size() >= 1) {
+        std::cout << "PASSED (найдено " << similarGames.size() << " игра)" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 11: Цепочка фильтров
+    std::vector<Filter*> filterChain;
+    filterChain.push_back(&ratingFilter);
+    filterChain.push_back(&featureFilter);
+    
+    std::vector<BoardGame*> chainResult = db.findGames(filterChain);
+    
+    std::cout << "Тест 11 - Цепочка фильтров: ";
+    if (chainResult.size() >= 1) {
+        std::cout << "PASSED (найдено " << chainResult.size() << " игр)" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 11а: Цепочка из трех фильтров сужает множество кандидатов
+    std::vector<std::string> carcassonneRefs = {"Каркассон"};
+    SimilarGamesFilter similarToCarcassonne(carcassonneRefs, db.getSimilarityData());
+    filterChain.push_back(&similarToCarcassonne);
+    
+    std::vector<BoardGame*> tripleResult = db.findGames(filterChain);
+    
+    std::cout << "Тест 11а - Цепочка из трех фильтров: ";
+    if (tripleResult.size() == 1 && tripleResult[0] == g1) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED (найдено " << tripleResult.size() << ")" << std::endl;
+    }
+    
+    // Тест 12: Планировщик ставит редкий признак раньше дешевого, но неизбирательного фильтра
+    // (проверка по кандидатам без столбцов: в маленьком каталоге сканирование столбцов дешевле любого порядка)
+    RatingFilter anyRating(1.0);
+    std::map<std::string, std::string> family;
+    family["Жанр"] = "Семейная";
+    FeatureFilter familyFilter(family);
+    std::vector<Filter*> plannedChain = {&anyRating, &familyFilter};
+    QueryPlan plan = QueryPlan::build(plannedChain, db.getCatalogStats(), false);
+    
+    std::cout << "Тест 12 - Порядок фильтров по стоимости: ";
+    if (plan.steps.size() == 2 && plan.steps[0].filter == &familyFilter && plan.steps[0].position == 1 &&
+        plan.reordered && plan.estimatedCost < plan.originalCost) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 12а: Результат не зависит от порядка, выполненный план содержит фактические размеры
+    QueryPlan executed;
+    std::vector<BoardGame*> plannedResult = db.findGames(filterChain, &executed);
+    
+    std::cout << "Тест 12а - Выполнение плана: ";
+    if (plannedResult == tripleResult && executed.steps.size() == 3 &&
+        executed.steps[0].executed && executed.steps[2].actualOutput == 1) {
+        std::cout << "PASSED" << std::endl;
+        executed.printInfo();
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 13: Постраничная выдача совпадает с полной сортировкой, равные рейтинги - по названию
+    GameDatabase pagedDb;
+    const int pageRatings[] = {4, 5, 4, 3, 4, 5, 2};
+    for (int i = 0; i < 7; ++i) {
+        BoardGame* game = new BoardGame(std::string("Страница ") + char('G' - i), "", 2, 4, "");
+        game->addRating("critic", pageRatings[i]);
+        pagedDb.addGame(game);
+    }
+    RatingFilter everyRating(0.0);
+    std::vector<Filter*> everything = {&everyRating};
+    std::vector<BoardGame*> fullOrder = pagedDb.findGames(everything);
+    
+    std::vector<BoardGame*> paged;
+    std::string cursor;
+    int pageCount = 0;
+    bool pagesValid = true;
+    do {
+        ResultPage page = pagedDb.findGames(everything, 3, cursor);
+        pagesValid = pagesValid && page.games.size() <= 3 && page.hasMore == !page.nextCursor.empty();
+        paged.insert(paged.end(), page.games.begin(), page.games.end());
+        cursor = page.nextCursor;
+        ++pageCount;
+    } while (!cursor.empty() && pageCount < 10);
+    
+    std::cout << "Тест 13 - Постраничная выдача: ";
+    if (pagesValid && pageCount == 3 && paged == fullOrder &&
+        fullOrder[0]->getName() == "Страница B" && fullOrder[1]->getName() == "Страница F") {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 13а: Некорректный курсор и нулевой размер страницы
+    ResultPage badCursor = pagedDb.findGames(everything, 3, "не курсор");
+    ResultPage emptyLimit = pagedDb.findGames(everything, 0, "");
+    
+    std::cout << "Тест 13а - Некорректный курсор: ";
+    if (badCursor.games.empty() && !badCursor.hasMore && emptyLimit.games.empty()) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 14: ORDER BY по нескольким ключам
+    pagedDb.addFeature("Страница A", "Время", "90");
+    pagedDb.addFeature("Страница C", "Время", "30");
+    pagedDb.addFeature("Страница E", "Время", "120");
+    pagedDb.addFeature("Страница G", "Время", "долго");
+    Match* longMatch = new Match("page_match_1", "Страница D", "2024-02-01");
+    Match* shortMatch = new Match("page_match_2", "Страница D", "2024-02-02");
+    Match* onlyMatch = new Match("page_match_3", "Страница A", "2024-02-03");
+    pagedDb.addMatch(longMatch);
+    pagedDb.addMatch(shortMatch);
+    pagedDb.addMatch(onlyMatch);
+    
+    auto names = [](const std::vector<BoardGame*>& ordered) {
+        std::string letters;
+        for (BoardGame* game : ordered) {
+            letters += game->getName().back();
+        }
+        return letters;
+    };
+    std::string byNameDesc = names(pagedDb.findGames(everything, OrderBy{SortKey::byName(true)}));
+    std::string byTimeAsc = names(pagedDb.findGames(everything, OrderBy{SortKey::byFeature("Время")}));
+    std::string byTimeDesc = names(pagedDb.findGames(everything, OrderBy{SortKey::byFeature("Время", true)}));
+    std::string byMatches = names(pagedDb.findGames(everything, OrderBy{SortKey::byMatchCount(), SortKey::byRating()}));
+    
+    std::cout << "Тест 14 - Сортировка по нескольким ключам: ";
+    if (byNameDesc == "GFEDCBA" && byTimeAsc == "CAEBDFG" && byTimeDesc == "EACBDFG" && byMatches == "DABFCEG") {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED (" << byNameDesc << " " << byTimeAsc << " " << byTimeDesc << " " << byMatches << ")" << std::endl;
+    }
+    
+    // Тест 14а: Курсор продолжает выдачу, даже если его последней игры уже нет в каталоге
+    ResultPage firstPage = pagedDb.findGames(everything, 3, "");
+    std::string firstNames = names(firstPage.games);
+    pagedDb.removeGame("Страница C");
+    ResultPage afterRemoval = pagedDb.findGames(everything, 3, firstPage.nextCursor);
+    
+    std::cout << "Тест 14а - Курсор после удаления игры: ";
+    if (firstNames == "BFC" && names(afterRemoval.games) == "EGD" && afterRemoval.hasMore) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 15: Потоковая выдача - по алфавиту, с остановкой получателем
+    RatingFilter highRated(4.0);
+    std::vector<Filter*> highChain = {&everyRating, &highRated};
+    std::string streamed;
+    size_t streamedCount = pagedDb.forEachGame(highChain, [&](BoardGame* game) {
+        streamed += game->getName().back();
+        return true;
+    });
+    std::string stopped;
+    size_t stoppedCount = pagedDb.forEachGame(highChain, [&](BoardGame* game) {
+        stopped += game->getName().back();
+        return stopped.size() < 2;
+    });
+    
+    std::cout << "Тест 15 - Потоковая выдача: ";
+    if (streamed == "BEFG" && streamedCount == 4 && stopped == "BE" && stoppedCount == 2 &&
+        pagedDb.forEachGame(std::vector<Filter*>(), [](BoardGame*) { return true; }) == 0) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED (" << streamed << " " << stopped << ")" << std::endl;
+    }
+    
+    // Тест 15а: Каталог из нескольких частей потоковой выдачи дает те же игры, что и findGames
+    GameDatabase streamDb;
+    const int streamGames = int(CatalogQuery::STREAM_BLOCK) * 3 + 17;
+    size_t highCount = 0;
+    for (int i = 0; i < streamGames; ++i) {
+        BoardGame* game = new BoardGame("Поток " + std::to_string(i), "", 2, 4, "");
+        game->addRating("critic", i % 5 + 1);
+        highCount += i % 5 + 1 >= 4;
+        streamDb.addGame(game);
+    }
+    std::vector<Filter*> streamChain = {&highRated};
+    std::vector<std::string> expectedNames;
+    for (BoardGame* game : streamDb.findGames(streamChain)) {
+        expectedNames.push_back(game->getName());
+    }
+    std::sort(expectedNames.begin(), expectedNames.end());
+    std::vector<std::string> streamedNames;
+    streamDb.forEachGame(streamChain, [&](BoardGame* game) {
+        streamedNames.push_back(game->getName());
+        return true;
+    });
+    
+    std::cout << "Тест 15а - Потоковая выдача по частям: ";
+    if (streamedNames == expectedNames && expectedNames.size() == highCount) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED (" << streamedNames.size() << " из " << expectedNames.size() << ")" << std::endl;
+    }
+    
+    // Тест 16: Новая связь схожести не пересобирает столбцы: в них нет ничего из графа
+    const CatalogColumns* columnsBefore = &pagedDb.getCatalogColumns();
+    pagedDb.addSimilarity("Страница A", "Страница B");
+    std::vector<std::string> similarToA = {"Страница A"};
+    SimilarGamesFilter similarToPage(similarToA, pagedDb.getSimilarityData());
+    std::vector<BoardGame*> similarPages = pagedDb.findGames(&similarToPage);
+    
+    std::cout << "Тест 16 - Связь схожести без пересборки столбцов: ";
+    if (&pagedDb.getCatalogColumns() == columnsBefore && similarPages.size() == 1 &&
+        similarPages[0]->getName() == "Страница B") {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Вывод статистики
+    db.printStatistics();
+    
+    std::cout << "=== Тестирование GameDatabase завершено ===\n" << std::endl;
+}
+
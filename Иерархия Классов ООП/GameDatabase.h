@@ -1,134 +1,343 @@
-#ifndef GAME_DATABASE_H
-#define GAME_DATABASE_H
-
-#include "BoardGame.h"
-#include "Player.h"
-#include "Match.h"
-#include "Filter.h"
-#include <map>
-#include <set>
-#include <vector>
-#include <string>
-#include <algorithm>
-
-// Центральный класс базы данных настольных игр
-// Управляет всеми сущностями: играми, игроками, партиями, связями схожести
-// Предоставляет единый интерфейс для работы со всей системой
-class GameDatabase {
-private:
-    std::map<std::string, BoardGame*> games;           // Игры: название -> объект
-    std::map<std::string, Player*> players;            // Игроки: ID -> объект
-    std::vector<Match*> matches;                       // Все партии
-    std::set<std::pair<std::string, std::string>> similarGames;  // Пары схожих игр
-    
-public:
-    // Конструктор и деструктор
-    GameDatabase();
-    ~GameDatabase();  // Освобождает всю выделенную память
-    
-    // === Управление играми ===
-    
-    // Добавление игры (база берет владение указателем)
-    bool addGame(BoardGame* game);
-    
-    // Удаление игры по названию
-    bool removeGame(const std::string& gameName);
-    
-    // Получение игры по названию
-    BoardGame* getGame(const std::string& gameName) const;
-    
-    // Получение всех игр (возврат по const ссылке для эффективности)
-    const std::map<std::string, BoardGame*>& getAllGames() const;
-    
-    // Перегрузка operator[] для доступа к играм по названию (Лекция 3, стр. 135)
-    // Возвращает ссылку на указатель для возможности изменения
-    // Если игры нет - возвращает nullptr
-    BoardGame* operator[](const std::string& gameName) const;
-    
-    // === Управление игроками ===
-    
-    // Добавление игрока (база берет владение указателем)
-    bool addPlayer(Player* player);
-    
-    // Удаление игрока по ID
-    bool removePlayer(const std::string& playerId);
-    
-    // Получение игрока по ID
-    Player* getPlayer(const std::string& playerId) const;
-    
-    // Получение всех игроков (возврат по const ссылке для эффективности)
-    const std::map<std::string, Player*>& getAllPlayers() const;
-    
-    // === Управление партиями ===
-    
-    // Добавление партии (база берет владение указателем)
-    // Автоматически добавляет партию в историю каждого игрока
-    bool addMatch(Match* match);
-    
-    // Получение партии по ID
-    Match* getMatch(const std::string& matchId) const;
-    
-    // Получение всех партий (возврат по const ссылке для эффективности)
-    const std::vector<Match*>& getAllMatches() const;
-    
-    // Получение партий конкретной игры
-    std::vector<Match*> getMatchesByGame(const std::string& gameName) const;
-    
-    // Получение партий конкретного игрока
-    std::vector<Match*> getMatchesByPlayer(const std::string& playerId) const;
-    
-    // === Управление оценками ===
-    
-    // Выставление оценки игре от игрока
-    // Логика: находит игру и игрока, вызывает addRating
-    bool addRating(const std::string& gameName, const std::string& playerId, int rating);
-    
-    // === Управление схожестью игр ===
-    
-    // Добавление связи схожести между играми (симметричная)
-    bool addSimilarity(const std::string& game1, const std::string& game2);
-    
-    // Проверка схожести двух игр
-    bool areSimilar(const std::string& game1, const std::string& game2) const;
-    
-    // Получение всех игр, схожих с данной
-    std::vector<std::string> getSimilarGames(const std::string& gameName) const;
-    
-    // Получение множества всех связей схожести (для фильтров)
-    const std::set<std::pair<std::string, std::string>>* getSimilarityData() const;
-    
-    // === Статистика и аналитика ===
-    
-    // Расчет рейтинга игрока в конкретной игре
-    // Логика: находит все партии игрока в этой игре, считает средний результат
-    double getPlayerRatingInGame(const std::string& playerId, const std::string& gameName) const;
-    
-    // Получение всех игр игрока
-    std::vector<std::string> getPlayerGames(const std::string& playerId) const;
-    
-    // === Фильтрация игр ===
-    
-    // Применение одного фильтра
-    std::vector<BoardGame*> findGames(Filter* filter) const;
-    
-    // Применение цепочки фильтров последовательно
-    // Каждый следующий фильтр применяется к результату предыдущего
-    std::vector<BoardGame*> findGames(const std::vector<Filter*>& filters) const;
-    
-    // === Вывод информации ===
-    
-    void printAllGames() const;
-    void printAllPlayers() const;
-    void printAllMatches() const;
-    void printStatistics() const;
-    
-    // Встроенные тесты
-    static void runTests();
-    
-private:
-    // Вспомогательный метод: сортировка игр по убыванию среднего рейтинга
-    void sortGamesByRating(std::vector<BoardGame*>& games) const;
-};
-
-#endif
-
+#ifndef GAME_DATABASE_H
+#define GAME_DATABASE_H
+
+#include "BoardGame.h"
+#include "Player.h"
+#include "Match.h"
+#include "Filter.h"
+#include "SimilarityGraph.h"
+#include "SymbolTable.h"
+#include "PlayerGameStats.h"
+#include "CatalogStats.h"
+#include "CatalogColumns.h"
+#include "QueryPlan.h"
+#include "OrderBy.h"
+#include "CatalogQuery.h"
+#include "DatabaseSnapshot.h"
+#include "QueryCache.h"
+#include "Leaderboard.h"
+#include "MatchTimeIndex.h"
+#include <memory>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <algorithm>
+
+class Journal;
+
+// Страница результатов поиска (см. findGames с limit и cursor)
+struct ResultPage {
+    std::vector<BoardGame*> games;  // Не больше limit игр в порядке выдачи
+    std::string nextCursor;         // Продолжение со следующей игры (пусто, если страниц больше нет)
+    bool hasMore;                   // Есть ли игры после этой страницы
+};
+
+// Центральный класс базы данных настольных игр
+// Управляет всеми сущностями: играми, игроками, партиями, связями схожести
+// Предоставляет единый интерфейс для работы со всей системой
+// Потоки: изменять базу и читать ее напрямую может только один поток (писатель);
+// остальные потоки читают опубликованные снимки (publish/snapshot), не блокируя писателя и друг друга
+class GameDatabase {
+private:
+    GameMap games;                                     // Игры: название (строка из SymbolTable::games()) -> объект
+    std::vector<BoardGame*> gamesByHandle;             // Игры по номеру (nullptr - нет в базе)
+    std::map<std::string_view, Player*> players;       // Игроки: ID (принадлежит игроку) -> объект
+    std::unordered_set<SymbolId> externalPlayers;      // Игроки без объектов в этой базе (см. addExternalPlayer)
+    std::vector<Match*> matches;                       // Все партии
+    std::unordered_map<SymbolId, Match*> matchIndex;   // Индекс партий: номер ID -> партия
+    
+    // Инвертированные индексы партий (списки в порядке добавления)
+    std::unordered_map<SymbolId, std::vector<Match*>> matchesByGame;        // игра -> партии
+    std::unordered_map<SymbolId, std::vector<Match*>> matchesByPlayer;      // игрок -> партии
+    std::unordered_map<uint64_t, std::vector<Match*>> matchesByPlayerGame;  // (игрок, игра) -> партии
+    std::unordered_map<SymbolId, std::vector<SymbolId>> gamesByPlayer;      // игрок -> сыгранные игры
+    MatchTimeIndex matchesByTime;                                           // все партии по дате
+    std::unordered_map<SymbolId, MatchTimeIndex> matchesByGameTime;         // игра -> партии по дате
+    std::unordered_map<uint64_t, PlayerGameStats> playerGameStats;         // (игрок, игра) -> статистика
+    std::vector<uint32_t> matchCounts;                                      // номер игры -> число партий
+    std::unordered_map<SymbolId, Leaderboard> leaderboards;                 // игра -> таблица лидеров
+    std::unique_ptr<LeaderboardMetric> leaderboardMetric;                   // образец показателя таблиц
+    SkillRatingEngine skillRatings;                                         // (игрок, игра) -> рейтинг силы
+    SimilarityGraph similarGames;  // Граф схожести игр по номерам
+    
+    // Статистика каталога для планировщика фильтров, пересобирается лениво (см. getCatalogStats)
+    uint64_t catalogVersion;                 // Растет при добавлении/удалении игр и связей схожести
+    mutable CatalogStats catalogStats;
+    mutable bool catalogStatsBuilt;
+    mutable uint64_t statsCatalogVersion;    // catalogVersion на момент сборки
+    mutable uint64_t statsGameVersion;       // gameChanges.version на момент сборки
+    
+    // Столбцовый снимок для сканирования фильтрами; в отличие от статистики должен быть точным,
+    // поэтому пересобирается после добавления/удаления игр, а после изменения игр обновляются их строки
+    // Снимок, отданный в опубликованную версию, не меняется: правится его копия, общая с ним по блокам строк
+    mutable std::shared_ptr<CatalogColumns> catalogColumns;
+    mutable bool columnsBuilt;
+    mutable bool columnsPublished;           // catalogColumns попал в опубликованную версию
+    mutable uint64_t columnsGameSetVersion;  // gameSetVersion на момент сборки: связи схожести столбцы не меняют
+    mutable GameChangeLog gameChanges;       // Игры этой базы, измененные после обновления столбцов
+    
+    // Кеш результатов findGames; записи проверяются по версиям при чтении (см. QueryCache)
+    uint64_t gameSetVersion;                 // Растет при добавлении/удалении игр (связи схожести не считаются)
+    mutable QueryCache queryCache;
+    
+    // Опубликованная версия для читателей и изменения с момента ее публикации
+    std::shared_ptr<const DatabaseSnapshot> published;  // читается и заменяется атомарно
+    mutable GameChangeLog unpublishedGames;             // игры, добавленные, удаленные или измененные с публикации
+    std::vector<uint64_t> changedStats;                 // ключи измененной статистики игроков
+    
+    Journal* journal;  // Журнал изменений (nullptr - не ведется); принадлежит вызывающему
+    
+public:
+    // Конструктор и деструктор
+    GameDatabase();
+    ~GameDatabase();  // Освобождает всю выделенную память
+    
+    // === Управление играми ===
+    
+    // Добавление игры (база берет владение указателем)
+    bool addGame(BoardGame* game);
+    
+    // Удаление игры по названию
+    bool removeGame(std::string_view gameName);
+    
+    // Получение игры по названию
+    BoardGame* getGame(std::string_view gameName) const;
+    
+    // Получение всех игр (возврат по const ссылке для эффективности)
+    const GameMap& getAllGames() const;
+    
+    // Перегрузка operator[] для доступа к играм по названию (Лекция 3, стр. 135)
+    // Возвращает ссылку на указатель для возможности изменения
+    // Если игры нет - возвращает nullptr
+    BoardGame* operator[](std::string_view gameName) const;
+    
+    // === Управление игроками ===
+    
+    // Добавление игрока (база берет владение указателем)
+    bool addPlayer(Player* player);
+    
+    // Удаление игрока по ID
+    bool removePlayer(std::string_view playerId);
+    
+    // Получение игрока по ID
+    Player* getPlayer(std::string_view playerId) const;
+    
+    // Получение всех игроков (возврат по const ссылке для эффективности)
+    const std::map<std::string_view, Player*>& getAllPlayers() const;
+    
+    // Игрок, объект которого хранится вне базы (шард ShardedGameDatabase: объекты у координатора)
+    // Оценки и статистика принимают такого игрока, историю его партий ведет владелец объекта
+    bool addExternalPlayer(std::string_view playerId);
+    bool removeExternalPlayer(std::string_view playerId);
+    
+    // Зарегистрирован ли игрок (своим объектом или как внешний)
+    bool hasPlayer(std::string_view playerId) const;
+    
+    // === Управление партиями ===
+    
+    // Добавление партии (база берет владение указателем)
+    // Автоматически добавляет партию в историю каждого игрока
+    // Возвращает false, если игры нет или партия с таким ID уже есть (владение не передается)
+    bool addMatch(Match* match);
+    
+    // Пакетное добавление партий (импорт выгрузок) с тем же результатом, что addMatch для каждой по порядку
+    // Индексы строятся после проверки всей пачки: партии группируются по играм, списки игры растут один раз,
+    // таблица лидеров меняет место игрока один раз на пачку, игроки ищутся по ID один раз на пачку,
+    // контрольная точка журнала - после пачки
+    // Возвращает число принятых; номера отклоненных в пачке - в rejected (владение ими не передается)
+    size_t addMatches(const std::vector<Match*>& batch, std::vector<size_t>* rejected = nullptr);
+    
+    // Получение партии по ID (O(1) через хеш-индекс)
+    Match* getMatch(std::string_view matchId) const;
+    
+    // Получение всех партий (возврат по const ссылке для эффективности)
+    const std::vector<Match*>& getAllMatches() const;
+    
+    // Получение партий конкретной игры
+    std::vector<Match*> getMatchesByGame(std::string_view gameName) const;
+    
+    // Получение партий конкретного игрока
+    std::vector<Match*> getMatchesByPlayer(std::string_view playerId) const;
+    
+    // То же без копирования: диапазоны прямо из индексов, O(1)
+    MatchRange matchesOfGame(std::string_view gameName) const;
+    MatchRange matchesOfPlayer(std::string_view playerId) const;
+    MatchRange matchesOfPlayerInGame(std::string_view playerId, std::string_view gameName) const;
+    
+    // Партии с from по to включительно (по дате, равные даты - в порядке добавления), O(log n + k) по индексу времени
+    // Партии с неизвестной датой в диапазоны не попадают
+    MatchRange getMatchesBetween(Date from, Date to) const;
+    MatchRange getMatchesBetween(Date from, Date to, std::string_view gameName) const;
+    
+    // === Управление оценками ===
+    
+    // Выставление оценки игре от игрока
+    // Логика: находит игру и игрока, вызывает addRating
+    bool addRating(std::string_view gameName, std::string_view playerId, int rating);
+    
+    // Изменение и удаление оценки игрока (оценка должна быть выставлена)
+    bool updateRating(std::string_view gameName, std::string_view playerId, int rating);
+    bool removeRating(std::string_view gameName, std::string_view playerId);
+    
+    // === Управление признаками игр ===
+    // Оценки и признаки игры из базы меняются этими методами, а не прямо у игры: так изменение попадает в журнал
+    
+    bool addFeature(std::string_view gameName, const std::string& featureName, const std::string& featureValue);
+    bool updateFeature(std::string_view gameName, std::string_view featureName, const std::string& featureValue);
+    bool removeFeature(std::string_view gameName, std::string_view featureName);
+    
+    // === Управление схожестью игр ===
+    
+    // Добавление связи схожести между играми (симметричная)
+    bool addSimilarity(std::string_view game1, std::string_view game2);
+    
+    // Проверка схожести двух игр
+    bool areSimilar(std::string_view game1, std::string_view game2) const;
+    
+    // Получение всех игр, схожих с данной
+    std::vector<std::string> getSimilarGames(std::string_view gameName) const;
+    
+    // Получение графа схожести (для фильтров)
+    const SimilarityGraph* getSimilarityData() const;
+    
+    // Уложить граф схожести в компактный вид для чтения (после массового добавления связей)
+    void compactSimilarity();
+    
+    // === Статистика и аналитика ===
+    
+    // Расчет рейтинга игрока в конкретной игре
+    // Логика: средний результат по всем партиям игрока в этой игре, O(1) по накопленной статистике
+    double getPlayerRatingInGame(std::string_view playerId, std::string_view gameName) const;
+    
+    // Накопленная статистика игрока в игре (nullptr, если партий не было)
+    const PlayerGameStats* getPlayerGameStats(std::string_view playerId, std::string_view gameName) const;
+    
+    // Статистика игрока сразу по всем его играм (в порядке первой партии в каждую игру)
+    std::vector<std::pair<std::string_view, const PlayerGameStats*>> getPlayerStats(std::string_view playerId) const;
+    
+    // Таблица лидеров игры (nullptr, если партий в нее не было)
+    // Таблицы ведутся для всех игр и обновляются каждой партией за O(участники * log игроков), см. Leaderboard
+    const Leaderboard* getLeaderboard(std::string_view gameName) const;
+    
+    // Показатель таблиц лидеров (по умолчанию - средний результат, MeanResultMetric)
+    // Смена показателя пересобирает таблицы всех игр по партиям в порядке добавления
+    void setLeaderboardMetric(const LeaderboardMetric& metric);
+    const LeaderboardMetric& getLeaderboardMetric() const;
+    
+    // Рейтинг силы игрока в игре (Эло или Glicko-2, сравним между играми; nullptr, если он ее не играл)
+    // Обновляется каждой партией по порядку добавления, см. SkillRatingEngine
+    const SkillRating* getSkillRating(std::string_view playerId, std::string_view gameName) const;
+    const SkillRatingEngine& getSkillRatings() const;
+    
+    // Пересчитать рейтинги силы по всем партиям в порядке дат (параллельно по играм):
+    // после загрузки истории, партий не по порядку дат или смены настроек
+    void recomputeSkillRatings();
+    void setSkillOptions(const SkillOptions& options);  // с пересчетом
+    
+    // Получение всех игр игрока
+    std::vector<std::string> getPlayerGames(std::string_view playerId) const;
+    
+    // === Фильтрация игр ===
+    
+    // Применение одного фильтра
+    std::vector<BoardGame*> findGames(Filter* filter) const;
+    
+    // Применение цепочки фильтров
+    // Каждый следующий фильтр отбирает из множества кандидатов, оставшихся после предыдущего
+    // (битовые множества по номерам игр, без промежуточных словарей)
+    // Результат - по убыванию рейтинга, при равенстве - по названию
+    // Переставляемые фильтры применяются в порядке, выбранном планировщиком (planQuery);
+    // если plan не nullptr, в него записывается выполненный план с фактическими размерами шагов
+    std::vector<BoardGame*> findGames(const std::vector<Filter*>& filters, QueryPlan* plan = nullptr) const;
+    
+    // Цепочка с заданным порядком результатов (ORDER BY): ключи по старшинству, у каждого свое направление
+    // Ключи всех игр извлекаются один раз в упакованную таблицу и сортируются поразрядно
+    std::vector<BoardGame*> findGames(const std::vector<Filter*>& filters, const OrderBy& order) const;
+    
+    // Одна страница результатов цепочки: игры по убыванию рейтинга, при равенстве - по названию
+    // Выбираются только limit лучших игр после курсора (ограниченная куча, без сортировки всего результата)
+    // cursor - пустая строка для первой страницы или nextCursor предыдущей; некорректный курсор дает пустую страницу
+    // Курсор хранит позицию (рейтинг, название), поэтому продолжение детерминировано и при изменении каталога
+    ResultPage findGames(const std::vector<Filter*>& filters, size_t limit, const std::string& cursor) const;
+    
+    // Потоковый поиск: игры, прошедшие цепочку, по алфавиту передаются visit без сборки вектора результата
+    // Память не зависит от размера выдачи; если visit вернул false, оставшиеся игры не проверяются
+    // (см. CatalogQuery::stream); возвращает число переданных игр
+    size_t forEachGame(const std::vector<Filter*>& filters, const GameVisitor& visit) const;
+    
+    // Кеш результатов findGames по цепочке фильтров (без plan): счетчики, бюджет памяти (0 - выключен)
+    // Цепочка кешируется, если у всех фильтров есть ключ (Filter::cacheKey); изменение игр, признаков,
+    // оценок и связей схожести делает устаревшими только записи, которые от него зависят
+    QueryCache& getQueryCache();
+    const QueryCache& getQueryCache() const;
+    
+    // План цепочки без выполнения: порядок фильтров и оценки по статистике каталога
+    QueryPlan planQuery(const std::vector<Filter*>& filters) const;
+    
+    // Статистика каталога; пересобирается, если с прошлой сборки менялся состав каталога
+    // или изменилось больше 1/16 игр (мелкие правки оценок на план почти не влияют)
+    const CatalogStats& getCatalogStats() const;
+    
+    // Столбцовый снимок каталога (собирается при первом запросе после изменений)
+    const CatalogColumns& getCatalogColumns() const;
+    
+    // === Снимки для параллельного чтения ===
+    
+    // Опубликовать текущее состояние новой версией (вызывает писатель, обычно после пачки изменений)
+    // Копируются только игры, измененные с прошлой публикации, и части статистики с новыми партиями
+    std::shared_ptr<const DatabaseSnapshot> publish();
+    
+    // Последняя опубликованная версия; можно вызывать из любого потока
+    // Читатель держит снимок, пока он нужен: новые публикации его не меняют
+    std::shared_ptr<const DatabaseSnapshot> snapshot() const;
+    
+    // === Журнал изменений ===
+    
+    // Подключить журнал: каждое принятое изменение записывается в него (nullptr - отключить)
+    // Журнал должен жить, пока подключен; при его checkpointDue база сама делает контрольную точку
+    void attachJournal(Journal* journal);
+    Journal* getJournal() const;
+    
+    // === Вывод информации ===
+    
+    void printAllGames() const;
+    void printAllPlayers() const;
+    void printAllMatches() const;
+    void printStatistics() const;
+    
+    // Встроенные тесты
+    static void runTests();
+    
+private:
+    // Текущее состояние каталога для выполнения запросов
+    CatalogView view() const;
+    
+    // Игры по номерам
+    std::vector<BoardGame*> gamesOf(const std::vector<uint32_t>& ids) const;
+    
+    // Контрольная точка журнала, если он вырос достаточно (после записи изменения)
+    void checkpointIfDue();
+    
+    bool hasGame(SymbolId handle) const;
+    
+    // Внести принятую партию в список, индексы, таблицу лидеров, рейтинги силы, статистику и историю игроков
+    void indexMatch(Match* match);
+    
+    // Часть indexMatch по игрокам партии: их индексы, статистика в игре и история
+    // playerCache (если не nullptr) запоминает найденных игроков по номеру на время пачки
+    void indexPlayers(Match* match, std::unordered_map<SymbolId, Player*>* playerCache);
+    
+    // Таблица лидеров игры (создается с первой партией)
+    Leaderboard& leaderboardOf(SymbolId game);
+    
+    // Диапазон списка из индекса (пустой, если ключа нет)
+    template <typename Key>
+    static MatchRange rangeOf(const std::unordered_map<Key, std::vector<Match*>>& index, Key key);
+};
+
+#endif
+
@@ -0,0 +1,1148 @@
+#include "Journal.h"
+#include "GameDatabase.h"
+#include "SnapshotFile.h"
+#include "SymbolTable.h"
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+// === Формат файла ===
+// Числа записываются в порядке байтов процессора (метка byteOrder отличает чужой порядок)
+// Строки в содержимом - длина (4 байта) и байты, без завершающего нуля
+
+namespace {
+
+const char MAGIC[8] = {'B', 'G', 'J', 'R', 'N', 'L', '\r', '\n'};
+const uint32_t ORDER_MARK = 0x01020304;
+const uint32_t MAX_RECORD_BYTES = 64u << 20; // больше - значит, длина испорчена
+
+struct JournalHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t firstSequence;  // номер первой записи файла (после контрольной точки - следующий за снимком)
+};
+
+struct RecordHeader {
+    uint32_t size;       // байт содержимого
+    uint32_t checksum;   // номера и содержимого
+    uint64_t sequence;
+};
+
+uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// MurmurHash3-подобное перемешивание по 8 байт: запись проверяется при каждом проигрывании, поэтому быстро
+uint32_t checksumOf(uint64_t sequence, const uint8_t* data, size_t size) {
+    const uint64_t c1 = 0x87C37B91114253D5ULL;
+    const uint64_t c2 = 0x4CF5AD432745937FULL;
+    uint64_t hash = 0x9E3779B97F4A7C15ULL ^ (sequence * c2);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash ^= rotateLeft(word * c1, 31) * c2;
+        hash = rotateLeft(hash, 27) * 5 + 0x52DCE729;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, data + i, size - i);
+    hash ^= rotateLeft(tail * c1, 31) * c2;
+    hash ^= size;
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+bool fail(std::string* error, const std::string& message) {
+    if (error) *error = message;
+    return false;
+}
+
+// === Файл для дописывания (дескриптор, чтобы сбрасывать на диск) ===
+
+#ifdef _WIN32
+int openFile(const std::string& path, bool truncate) {
+    int flags = _O_WRONLY | _O_BINARY | _O_CREAT | (truncate ? _O_TRUNC : _O_APPEND);
+    return _open(path.c_str(), flags, _S_IREAD | _S_IWRITE);
+}
+
+bool writeAll(int descriptor, const uint8_t* data, size_t size) {
+    for (size_t done = 0; done < size;) {
+        unsigned chunk = static_cast<unsigned>(std::min<size_t>(size - done, 1 << 30));
+        int written = _write(descriptor, data + done, chunk);
+        if (written <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool syncFile(int descriptor) {
+    return _commit(descriptor) == 0;
+}
+
+bool truncateFile(int descriptor, uint64_t size) {
+    return _chsize_s(descriptor, static_cast<__int64>(size)) == 0;
+}
+
+void closeFile(int descriptor) {
+    _close(descriptor);
+}
+
+void syncDirectory(const std::string&) {
+    // NTFS сохраняет переименование вместе с метаданными файла
+}
+#else
+int openFile(const std::string& path, bool truncate) {
+    int flags = O_WRONLY | O_CREAT | (truncate ? O_TRUNC : O_APPEND);
+    return ::open(path.c_str(), flags, 0644);
+}
+
+bool writeAll(int descriptor, const uint8_t* data, size_t size) {
+    for (size_t done = 0; done < size;) {
+        ssize_t written = ::write(descriptor, data + done, size - done);
+        if (written <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool syncFile(int descriptor) {
+    return fsync(descriptor) == 0;
+}
+
+bool truncateFile(int descriptor, uint64_t size) {
+    return ftruncate(descriptor, static_cast<off_t>(size)) == 0;
+}
+
+void closeFile(int descriptor) {
+    close(descriptor);
+}
+
+// переименование переживает сбой, только если сброшен каталог
+void syncDirectory(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+    int descriptor = ::open(directory.c_str(), O_RDONLY);
+    if (descriptor >= 0) {
+        fsync(descriptor);
+        close(descriptor);
+    }
+}
+#endif
+
+bool fileExists(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return in.good();
+}
+
+bool readFile(const std::string& path, std::vector<uint8_t>& bytes) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return false;
+    }
+    std::streamoff size = in.tellg();
+    bytes.resize(static_cast<size_t>(size));
+    in.seekg(0);
+    return size == 0 || static_cast<bool>(in.read(reinterpret_cast<char*>(bytes.data()), size));
+}
+
+// rename в Windows не заменяет существующий файл - тогда прежний удаляется и переименование повторяется
+bool replaceFile(const std::string& from, const std::string& to) {
+    if (std::rename(from.c_str(), to.c_str()) == 0) {
+        return true;
+    }
+    std::remove(to.c_str());
+    return std::rename(from.c_str(), to.c_str()) == 0;
+}
+
+// Новый файл журнала из одного заголовка, сброшенный на диск
+bool createFile(const std::string& path, uint64_t firstSequence) {
+    JournalHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = Journal::FORMAT_VERSION;
+    header.byteOrder = ORDER_MARK;
+    header.firstSequence = firstSequence;
+
+    int descriptor = openFile(path, true);
+    if (descriptor < 0) {
+        return false;
+    }
+    bool ok = writeAll(descriptor, reinterpret_cast<const uint8_t*>(&header), sizeof(header)) && syncFile(descriptor);
+    closeFile(descriptor);
+    return ok;
+}
+
+// Прочитанный файл журнала: заголовок и граница целых записей
+struct ScannedFile {
+    std::vector<uint8_t> bytes;
+    JournalHeader header;
+    uint64_t validBytes = 0;
+    uint64_t lastSequence = 0;
+};
+
+bool readHeader(const std::string& path, ScannedFile& file, std::string& error) {
+    if (!readFile(path, file.bytes)) {
+        error = "не удалось открыть " + path;
+        return false;
+    }
+    if (file.bytes.size() < sizeof(JournalHeader)) {
+        error = path + ": файл короче заголовка";
+        return false;
+    }
+    std::memcpy(&file.header, file.bytes.data(), sizeof(JournalHeader));
+    if (std::memcmp(file.header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        error = path + ": не файл журнала";
+        return false;
+    }
+    if (file.header.byteOrder != ORDER_MARK) {
+        error = path + ": другой порядок байтов";
+        return false;
+    }
+    if (file.header.version != Journal::FORMAT_VERSION) {
+        error = path + ": версия формата " + std::to_string(file.header.version) +
+                ", ожидалась " + std::to_string(Journal::FORMAT_VERSION);
+        return false;
+    }
+    return true;
+}
+
+// Пройти целые записи: visit(номер, содержимое, длина); false из visit останавливает проход
+// Проход заканчивается на первой оборванной записи, записи с неверной суммой или номером не по возрастанию
+template <typename Visit>
+void scanRecords(ScannedFile& file, Visit visit) {
+    const uint8_t* data = file.bytes.data();
+    size_t size = file.bytes.size();
+    size_t offset = sizeof(JournalHeader);
+    uint64_t previous = file.header.firstSequence - 1;
+    while (size - offset >= sizeof(RecordHeader)) {
+        RecordHeader record;
+        std::memcpy(&record, data + offset, sizeof(record));
+        size_t payload = offset + sizeof(RecordHeader);
+        if (record.size == 0 || record.size > MAX_RECORD_BYTES || record.size > size - payload ||
+            record.sequence <= previous || checksumOf(record.sequence, data + payload, record.size) != record.checksum) {
+            break;
+        }
+        if (!visit(record.sequence, data + payload, record.size)) {
+            break;
+        }
+        previous = record.sequence;
+        offset = payload + record.size;
+    }
+    file.validBytes = offset;
+    file.lastSequence = previous;
+}
+
+}
+
+// === Содержимое записей ===
+
+// Дописывает запись в конец буфера: место под заголовок, вид изменения и параметры
+class Journal::Encoder {
+private:
+    std::vector<uint8_t>& out;
+    size_t start;
+
+public:
+    Encoder(std::vector<uint8_t>& out, RecordType type) : out(out), start(out.size()) {
+        out.resize(start + sizeof(RecordHeader));
+        putByte(type);
+    }
+
+    size_t getStart() const { return start; }
+
+    void putByte(uint8_t value) {
+        out.push_back(value);
+    }
+
+    void putBytes(const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        out.insert(out.end(), bytes, bytes + size);
+    }
+
+    void putUint(uint32_t value) { putBytes(&value, sizeof(value)); }
+    void putInt(int32_t value) { putBytes(&value, sizeof(value)); }
+    void putDouble(double value) { putBytes(&value, sizeof(value)); }
+
+    void putString(std::string_view value) {
+        putUint(static_cast<uint32_t>(value.size()));
+        putBytes(value.data(), value.size());
+    }
+};
+
+// Читает параметры записи; при выходе за конец возвращает нули и сбрасывает ok
+class Journal::Decoder {
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+    bool ok;
+
+    bool has(size_t bytes) {
+        if (size - offset < bytes) {
+            ok = false;
+            offset = size;
+        }
+        return ok;
+    }
+
+public:
+    Decoder(const uint8_t* data, size_t size) : data(data), size(size), offset(0), ok(true) {}
+
+    bool good() const { return ok && offset == size; }
+    bool valid() const { return ok; }
+
+    uint8_t getByte() {
+        return has(1) ? data[offset++] : 0;
+    }
+
+    template <typename T>
+    T get() {
+        T value = T();
+        if (has(sizeof(T))) {
+            std::memcpy(&value, data + offset, sizeof(T));
+            offset += sizeof(T);
+        }
+        return value;
+    }
+
+    uint32_t getUint() { return get<uint32_t>(); }
+    int32_t getInt() { return get<int32_t>(); }
+    double getDouble() { return get<double>(); }
+
+    std::string_view getString() {
+        uint32_t length = getUint();
+        if (!has(length)) {
+            return std::string_view();
+        }
+        std::string_view value(reinterpret_cast<const char*>(data + offset), length);
+        offset += length;
+        return value;
+    }
+};
+
+// === Открытие ===
+
+Journal::Journal(const std::string& path, const Options& options)
+    : path(path), options(options), descriptor(-1), nextSequence(1), writtenSequence(0), durableSequence(0),
+      flushing(false), fileBytes(0), checkpointedBytes(0), syncCount(0),
+      lastSync(std::chrono::steady_clock::now()), failed(false) {}
+
+Journal::~Journal() {
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        if (descriptor >= 0 && nextSequence > 1) {
+            flushUpTo(guard, nextSequence - 1, options.sync != SyncPolicy::Never);
+        }
+    }
+    if (descriptor >= 0) {
+        closeFile(descriptor);
+    }
+}
+
+std::unique_ptr<Journal> Journal::open(const std::string& path, const Options& options, std::string* error) {
+    return openAfter(path, options, 0, error);
+}
+
+std::unique_ptr<Journal> Journal::openAfter(const std::string& path, const Options& options, uint64_t after,
+                                            std::string* error) {
+    std::unique_ptr<Journal> journal(new Journal(path, options));
+
+    ScannedFile file;
+    std::string message;
+    bool created = false;
+    if (!fileExists(path)) {
+        created = true;
+    } else if (!readHeader(path, file, message)) {
+        // заголовок, оборванный при создании файла, - пустой журнал; чужой файл не трогаем
+        bool tornHeader = file.bytes.size() < sizeof(JournalHeader) &&
+                          std::memcmp(file.bytes.data(), MAGIC, std::min(file.bytes.size(), sizeof(MAGIC))) == 0;
+        if (!tornHeader) {
+            fail(error, message);
+            return nullptr;
+        }
+        created = true;
+    }
+
+    if (created) {
+        if (!createFile(path, after + 1)) {
+            fail(error, "не удалось создать " + path);
+            return nullptr;
+        }
+        syncDirectory(path);
+        journal->fileBytes = sizeof(JournalHeader);
+        journal->nextSequence = after + 1;
+    } else {
+        scanRecords(file, [](uint64_t, const uint8_t*, size_t) { return true; });
+        journal->fileBytes = file.validBytes;
+        journal->nextSequence = std::max(file.lastSequence, after) + 1;
+    }
+
+    journal->descriptor = openFile(path, false);
+    if (journal->descriptor < 0) {
+        fail(error, "не удалось открыть " + path + " для записи");
+        return nullptr;
+    }
+    if (!created && file.validBytes < file.bytes.size()) {
+        // оборванный хвост отрезается, чтобы новые записи шли сразу за целыми
+        if (!truncateFile(journal->descriptor, file.validBytes) || !syncFile(journal->descriptor)) {
+            fail(error, "не удалось отрезать оборванный хвост " + path);
+            return nullptr;
+        }
+    }
+    journal->writtenSequence = journal->nextSequence - 1;
+    journal->durableSequence = journal->writtenSequence;
+    journal->checkpointedBytes = journal->fileBytes;
+    return journal;
+}
+
+// === Запись ===
+
+uint64_t Journal::append(Encoder& record, std::unique_lock<std::mutex>& guard) {
+    size_t start = record.getStart();
+    if (failed) {
+        pending.resize(start);  // файл уже не пишется - записи не копятся
+        return 0;
+    }
+    uint64_t sequence = nextSequence++;
+    RecordHeader header;
+    header.size = static_cast<uint32_t>(pending.size() - start - sizeof(RecordHeader));
+    header.sequence = sequence;
+    header.checksum = checksumOf(sequence, pending.data() + start + sizeof(RecordHeader), header.size);
+    std::memcpy(pending.data() + start, &header, sizeof(header));
+
+    if (pending.size() >= options.batchBytes && !flushing) {
+        flushUpTo(guard, sequence, false);
+    }
+    return sequence;
+}
+
+bool Journal::flushUpTo(std::unique_lock<std::mutex>& guard, uint64_t target, bool sync) {
+    while (true) {
+        if (failed) {
+            return false;
+        }
+        if ((sync ? durableSequence : writtenSequence) >= target) {
+            return true;
+        }
+        if (flushing) {
+            flushed.wait(guard);
+            continue;
+        }
+
+        // этот поток - лидер: забирает все накопленное, в том числе записи ждущих потоков
+        flushing = true;
+        std::vector<uint8_t> batch;
+        batch.swap(pending);
+        pending.swap(spare);
+        uint64_t batchLast = nextSequence - 1;
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        bool syncNow = sync || (options.sync == SyncPolicy::Interval &&
+                                now - lastSync >= std::chrono::milliseconds(options.syncIntervalMs));
+        guard.unlock();
+
+        bool ok = writeAll(descriptor, batch.data(), batch.size()) && (!syncNow || syncFile(descriptor));
+
+        guard.lock();
+        flushing = false;
+        if (ok) {
+            fileBytes += batch.size();
+            writtenSequence = batchLast;
+            if (syncNow) {
+                durableSequence = batchLast;
+                lastSync = now;
+                ++syncCount;
+            }
+        } else {
+            failed = true;
+            lastError = "не удалось записать " + path;
+        }
+        batch.clear();
+        spare.swap(batch);
+        flushed.notify_all();
+    }
+}
+
+uint64_t Journal::recordAddGame(const BoardGame& game) {
+    std::unique_lock<std::mutex> guard(lock);
+    Encoder record(pending, ADD_GAME);
+    record.putString(game.getName());
+    record.putString(game.getDescription());
+    record.putString(game.getEdition());
+    record.putInt(game.getMinPlayers());
+    record.putInt(game.getMaxPlayers());
+    record.putUint(static_cast<uint32_t>(game.getFeatures().size()));
+    for (const auto& feature : game.getFeatures()) {
+        record.putString(feature.first);
+        record.putString(feature.second);
+    }
+    record.putUint(static_cast<uint32_t>(game.getRatings().size()));
+    for (const auto& rating : game.getRatings()) {
+        record.putString(SymbolTable::players().name(rating.first));
+        record.putInt(rating.second);
+    }
+    return append(record, guard);
+}
+
+uint64_t Journal::recordRemoveGame(std::string_view gameName) {
+    std::unique_lock<std::mutex> guard(lock);
+    Encoder record(pending, REMOVE_GAME);
+    record.putString(gameName);
+    return append(record, guard);
+}
+
+uint64_t Journal::recordAddPlayer(const Player& player) {
+    std::unique_lock<std::mutex> guard(lock);
+    Encoder record(pending, ADD_PLAYER);
+    record.putString(player.getPlayerId());
+    record.putString(player.getName());
+    record.putUint(static_cast<uint32_t>(player.getMatchHistory().size()));
+    for (SymbolId match : player.getMatchHistory()) {
+        record.putString(SymbolTable::matches().name(match));
+    }
+    return append(record, guard);
+}
+
+uint64_t Journal::recordRemovePlayer(std::string_view playerId) {
+    std::unique_lock<std::mutex> guard(lock);
+    Encoder record(pending, REMOVE_PLAYER);
+    record.putString(playerId);
+    return append(record, guard);
+}
+
+uint64_t Journal::recordAddMatch(const Match& match) {
+    std::unique_lock<std::mutex> guard(lock);
+    Encoder record(pending, ADD_MATCH);
+    record.putString(match.getMatchId());
+    record.putString(match.getGameName());
+    record.putString(match.getDate());
+    record.putUint(static_cast<uint32_t>(match.getPlayerResults().size()));
+    for (const auto& result : match.getPlayerResults()) {
+        record.putString(SymbolTable::players().name(result.first));
+        record.putDouble(result.second);
+    }
+    return append(record, guard);
+}
+
+uint64_t Journal::recordRating(std::string_view gameName, std::string_view playerId, int rating) {
+    std::unique_lock<std::mutex> guard(lock);
+    Encoder record(pending, ADD_RATING);
+    record.putString(gameName);
+    record.putString(playerId);
+    record.putInt(rating);
+    return append(record, guard);
+}
+
+uint64_t Journal::recordUpdateRating(std::string_view gameName, std::string_view playerId, int rating) {
+    std::unique_lock<std::mutex> guard(lock);
+    Encoder record(pending, UPDATE_RATING);
+    record.putString(gameName);
+    record.putString(playerId);
+    record.putInt(rating);
+    return append(record, guard);
+}
+
+uint64_t Journal::recordRemoveRating(std::string_view gameName, std::string_view playerId) {
+    std::unique_lock<std::mutex> guard(lock);
+    Encoder record(pending, REMOVE_RATING);
+    record.putString(gameName);
+    record.putString(playerId);
+    return append(record, guard);
+}
+
+uint64_t Journal::recordAddFeature(std::string_view gameName, std::string_view feature, std::string_view value) {
+    std::unique_lock<std::mutex> guard(lock);
+    Encoder record(pending, ADD_FEATURE);
+    record.putString(gameName);
+    record.putString(feature);
+    record.putString(value);
+    return append(record, guard);
+}
+
+uint64_t Journal::recordUpdateFeature(std::string_view gameName, std::string_view feature, std::string_view value) {
+    std::unique_lock<std::mutex> guard(lock);
+    Encoder record(pending, UPDATE_FEATURE);
+    record.putString(gameName);
+    record.putString(feature);
+    record.putString(value);
+    return append(record, guard);
+}
+
+uint64_t Journal::recordRemoveFeature(std::string_view gameName, std::string_view feature) {
+    std::unique_lock<std::mutex> guard(lock);
+    Encoder record(pending, REMOVE_FEATURE);
+    record.putString(gameName);
+    record.putString(feature);
+    return append(record, guard);
+}
+
+uint64_t Journal::recordSimilarity(std::string_view game1, std::string_view game2) {
+    std::unique_lock<std::mutex> guard(lock);
+    Encoder record(pending, ADD_SIMILARITY);
+    record.putString(game1);
+    record.putString(game2);
+    return append(record, guard);
+}
+
+bool Journal::commit() {
+    std::unique_lock<std::mutex> guard(lock);
+    return flushUpTo(guard, nextSequence - 1, options.sync == SyncPolicy::EveryCommit);
+}
+
+bool Journal::sync() {
+    std::unique_lock<std::mutex> guard(lock);
+    return flushUpTo(guard, nextSequence - 1, true);
+}
+
+// === Контрольные точки ===
+
+bool Journal::checkpointDue() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return options.checkpointBytes > 0 && !options.snapshotPath.empty() && !failed &&
+           fileBytes + pending.size() - checkpointedBytes >= options.checkpointBytes;
+}
+
+bool Journal::checkpoint(const GameDatabase& db, std::string* error) {
+    if (options.snapshotPath.empty()) {
+        return fail(error, "не задан файл снимка");
+    }
+
+    // Все записи - на диск; lock держится до замены журнала, поэтому новых записей не появится
+    std::unique_lock<std::mutex> guard(lock);
+    while (flushing || durableSequence + 1 < nextSequence) {
+        if (flushing) {
+            flushed.wait(guard);
+        } else if (!flushUpTo(guard, nextSequence - 1, true)) {
+            return fail(error, lastError);
+        }
+    }
+    uint64_t last = nextSequence - 1;
+    checkpointedBytes = fileBytes;  // при неудаче следующая попытка - через checkpointBytes
+
+    std::string message;
+    if (!SnapshotFile::write(db, options.snapshotPath, &message, last)) {
+        return fail(error, message);
+    }
+    syncDirectory(options.snapshotPath);
+
+    // Снимок на диске: журнал заменяется пустым, начинающимся со следующей записи
+    // Сбой до замены оставляет прежний журнал - его записи до last восстановление пропустит
+    std::string temporary = path + ".tmp";
+    if (!createFile(temporary, last + 1)) {
+        std::remove(temporary.c_str());
+        return fail(error, "не удалось создать " + temporary);
+    }
+    closeFile(descriptor);
+    bool replaced = replaceFile(temporary, path);
+    descriptor = openFile(path, false);
+    if (descriptor < 0) {
+        failed = true;
+        lastError = "не удалось открыть " + path + " для записи";
+        return fail(error, lastError);
+    }
+    if (!replaced) {
+        std::remove(temporary.c_str());
+        return fail(error, "не удалось заменить " + path);
+    }
+    syncDirectory(path);
+    fileBytes = sizeof(JournalHeader);
+    checkpointedBytes = fileBytes;
+    return true;
+}
+
+// === Проигрывание ===
+
+bool Journal::apply(Decoder& record, GameDatabase& db, bool& accepted) {
+    switch (record.getByte()) {
+    case ADD_GAME: {
+        std::string name(record.getString());
+        std::string description(record.getString());
+        std::string edition(record.getString());
+        int minPlayers = record.getInt();
+        int maxPlayers = record.getInt();
+        std::unique_ptr<BoardGame> game(new BoardGame(name, description, minPlayers, maxPlayers, edition));
+        uint32_t featureCount = record.getUint();
+        for (uint32_t i = 0; i < featureCount && record.valid(); ++i) {
+            std::string feature(record.getString());
+            game->addFeature(feature, std::string(record.getString()));
+        }
+        uint32_t ratingCount = record.getUint();
+        for (uint32_t i = 0; i < ratingCount && record.valid(); ++i) {
+            std::string player(record.getString());
+            game->addRating(player, record.getInt());
+        }
+        if (!record.good()) {
+            return false;
+        }
+        accepted = db.addGame(game.get());
+        if (accepted) {
+            game.release();
+        }
+        return true;
+    }
+    case REMOVE_GAME: {
+        std::string_view name = record.getString();
+        if (!record.good()) {
+            return false;
+        }
+        accepted = db.removeGame(name);
+        return true;
+    }
+    case ADD_PLAYER: {
+        std::string id(record.getString());
+        std::string name(record.getString());
+        std::unique_ptr<Player> player(new Player(id, name));
+        uint32_t historyCount = record.getUint();
+        for (uint32_t i = 0; i < historyCount && record.valid(); ++i) {
+            player->addMatchToHistory(SymbolTable::matches().intern(record.getString()));
+        }
+        if (!record.good()) {
+            return false;
+        }
+        accepted = db.addPlayer(player.get());
+        if (accepted) {
+            player.release();
+        }
+        return true;
+    }
+    case REMOVE_PLAYER: {
+        std::string_view id = record.getString();
+        if (!record.good()) {
+            return false;
+        }
+        accepted = db.removePlayer(id);
+        return true;
+    }
+    case ADD_MATCH: {
+        std::string id(record.getString());
+        std::string game(record.getString());
+        std::string date(record.getString());
+        std::unique_ptr<Match> match(new Match(id, game, date));
+        uint32_t resultCount = record.getUint();
+        for (uint32_t i = 0; i < resultCount && record.valid(); ++i) {
+            std::string player(record.getString());
+            match->addPlayerResult(player, record.getDouble());
+        }
+        if (!record.good()) {
+            return false;
+        }
+        accepted = db.addMatch(match.get());
+        if (accepted) {
+            match.release();
+        }
+        return true;
+    }
+    case ADD_RATING: {
+        std::string_view game = record.getString();
+        std::string_view player = record.getString();
+        int rating = record.getInt();
+        if (!record.good()) {
+            return false;
+        }
+        accepted = db.addRating(game, player, rating);
+        return true;
+    }
+    case ADD_SIMILARITY: {
+        std::string_view game1 = record.getString();
+        std::string_view game2 = record.getString();
+        if (!record.good()) {
+            return false;
+        }
+        accepted = db.addSimilarity(game1, game2);
+        return true;
+    }
+    case UPDATE_RATING: {
+        std::string_view game = record.getString();
+        std::string_view player = record.getString();
+        int rating = record.getInt();
+        if (!record.good()) {
+            return false;
+        }
+        accepted = db.updateRating(game, player, rating);
+        return true;
+    }
+    case REMOVE_RATING: {
+        std::string_view game = record.getString();
+        std::string_view player = record.getString();
+        if (!record.good()) {
+            return false;
+        }
+        accepted = db.removeRating(game, player);
+        return true;
+    }
+    case ADD_FEATURE: {
+        std::string_view game = record.getString();
+        std::string feature(record.getString());
+        std::string value(record.getString());
+        if (!record.good()) {
+            return false;
+        }
+        accepted = db.addFeature(game, feature, value);
+        return true;
+    }
+    case UPDATE_FEATURE: {
+        std::string_view game = record.getString();
+        std::string_view feature = record.getString();
+        std::string value(record.getString());
+        if (!record.good()) {
+            return false;
+        }
+        accepted = db.updateFeature(game, feature, value);
+        return true;
+    }
+    case REMOVE_FEATURE: {
+        std::string_view game = record.getString();
+        std::string_view feature = record.getString();
+        if (!record.good()) {
+            return false;
+        }
+        accepted = db.removeFeature(game, feature);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+ReplayResult Journal::replay(const std::string& path, GameDatabase& db, uint64_t afterSequence) {
+    ReplayResult result;
+    ScannedFile file;
+    if (!readHeader(path, file, result.error)) {
+        return result;
+    }
+
+    // проигрываемые изменения не должны снова попасть в журнал
+    Journal* attached = db.getJournal();
+    db.attachJournal(nullptr);
+    bool decoded = true;
+    scanRecords(file, [&](uint64_t sequence, const uint8_t* payload, size_t size) {
+        if (sequence <= afterSequence) {
+            return true;
+        }
+        Decoder record(payload, size);
+        bool accepted = false;
+        if (!apply(record, db, accepted)) {
+            decoded = false;
+            result.error = path + ": запись " + std::to_string(sequence) + " не разобрана";
+            return false;
+        }
+        ++result.records;
+        result.applied += accepted ? 1 : 0;
+        return true;
+    });
+    db.attachJournal(attached);
+
+    result.ok = decoded;
+    result.lastSequence = file.lastSequence;
+    result.validBytes = file.validBytes;
+    result.tornTail = file.validBytes < file.bytes.size();
+    return result;
+}
+
+std::unique_ptr<Journal> Journal::recover(GameDatabase& db, const std::string& path, const Options& options,
+                                          ReplayResult* result, std::string* error) {
+    uint64_t after = 0;
+    if (!options.snapshotPath.empty() && fileExists(options.snapshotPath)) {
+        std::string message;
+        std::shared_ptr<const SnapshotFile> snapshot = SnapshotFile::open(options.snapshotPath, true, &message);
+        if (!snapshot) {
+            fail(error, message);
+            return nullptr;
+        }
+        snapshot->loadInto(db);
+        after = snapshot->getJournalSequence();
+    }
+
+    // файла нет или он оборван на заголовке при создании - записей нет, открытие создаст журнал заново
+    ReplayResult replayed;
+    replayed.ok = true;
+    std::ifstream existing(path, std::ios::binary | std::ios::ate);
+    if (existing && static_cast<uint64_t>(existing.tellg()) >= sizeof(JournalHeader)) {
+        replayed = replay(path, db, after);
+    }
+    existing.close();
+    if (result) {
+        *result = replayed;
+    }
+    if (!replayed.ok) {
+        fail(error, replayed.error);
+        return nullptr;
+    }
+
+    std::unique_ptr<Journal> journal = openAfter(path, options, std::max(after, replayed.lastSequence), error);
+    if (journal) {
+        db.attachJournal(journal.get());
+    }
+    return journal;
+}
+
+// === Состояние ===
+
+const std::string& Journal::getPath() const {
+    return path;
+}
+
+const Journal::Options& Journal::getOptions() const {
+    return options;
+}
+
+uint64_t Journal::getLastSequence() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return nextSequence - 1;
+}
+
+uint64_t Journal::getDurableSequence() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return durableSequence;
+}
+
+uint64_t Journal::getFileSize() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return fileBytes;
+}
+
+uint64_t Journal::getSyncCount() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return syncCount;
+}
+
+std::string Journal::getLastError() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return lastError;
+}
+
+// === Тесты ===
+
+void Journal::runTests() {
+    std::cout << "\n=== Тестирование класса Journal ===" << std::endl;
+
+    const std::string journalPath = "journal_test.bgj";
+    const std::string snapshotPath = "journal_test.bgs";
+    std::remove(journalPath.c_str());
+    std::remove(snapshotPath.c_str());
+
+    // Тест 1: изменения базы проигрываются в пустую базу с тем же результатом
+    {
+        std::unique_ptr<Journal> journal = open(journalPath);
+        GameDatabase db;
+        db.attachJournal(journal.get());
+
+        BoardGame* game = new BoardGame("Журнал Каркассон", "Тайлы", 2, 5, "Базовая");
+        game->addFeature("Тема", "Средневековье");
+        game->addRating("Журнал Ирина", 4);
+        db.addGame(game);
+        db.addGame(new BoardGame("Журнал Колонизаторы", "Ресурсы", 3, 4, "Базовая"));
+        db.addGame(new BoardGame("Журнал Удаляемая", "", 1, 2, "Базовая"));
+        db.addPlayer(new Player("Журнал Ирина", "Ирина"));
+        db.addPlayer(new Player("Журнал Олег", "Олег"));
+
+        Match* match = new Match("Журнал П1", "Журнал Каркассон", "2024-03-01");
+        match->addPlayerResult("Журнал Ирина", 80);
+        match->addPlayerResult("Журнал Олег", 65);
+        db.addMatch(match);
+        db.addRating("Журнал Каркассон", "Журнал Олег", 5);
+        db.addRating("Журнал Каркассон", "Журнал Олег", 1);  // отклоняется базой и не записывается
+        db.addSimilarity("Журнал Каркассон", "Журнал Колонизаторы");
+        db.removeGame("Журнал Удаляемая");
+        db.addPlayer(new Player("Журнал Гость", "Гость"));
+        db.removePlayer("Журнал Гость");
+        bool committed = journal->commit();
+        uint64_t last = journal->getLastSequence();
+
+        GameDatabase restored;
+        ReplayResult result = replay(journalPath, restored);
+        const BoardGame* carcassonne = restored.getGame("Журнал Каркассон");
+        const Player* irina = restored.getPlayer("Журнал Ирина");
+
+        std::cout << "Тест 1 - Проигрывание изменений: ";
+        if (committed && last == 11 && journal->getDurableSequence() == last && result.ok && !result.tornTail &&
+            result.records == 11 && result.applied == 11 && result.lastSequence == last &&
+            restored.getAllGames().size() == 2 && carcassonne && carcassonne->getAverageRating() == 4.5 &&
+            carcassonne->getFeature("Тема") == "Средневековье" && carcassonne->getEdition() == "Базовая" &&
+            restored.getAllMatches().size() == 1 && irina && irina->getMatchHistory().size() == 1 &&
+            !restored.getPlayer("Журнал Гость") && restored.areSimilar("Журнал Колонизаторы", "Журнал Каркассон") &&
+            restored.getPlayerRatingInGame("Журнал Олег", "Журнал Каркассон") == 65) {
+            std::cout << "PASSED" << std::endl;
+        } else {
+            std::cout << "FAILED" << std::endl;
+        }
+        db.attachJournal(nullptr);
+    }
+
+    // Тест 2: оборванная последняя запись отбрасывается, журнал продолжается сразу за целыми
+    {
+        std::vector<uint8_t> bytes;
+        readFile(journalPath, bytes);
+        {
+            std::ofstream out(journalPath, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size() - 5));
+        }
+
+        GameDatabase torn;
+        ReplayResult result = replay(journalPath, torn);
+
+        std::unique_ptr<Journal> journal = open(journalPath);
+        uint64_t sequence = journal ? journal->recordSimilarity("Журнал Каркассон", "Журнал Удаляемая") : 0;
+        bool committed = journal && journal->commit();
+        journal.reset();
+        GameDatabase continued;
+        ReplayResult again = replay(journalPath, continued);
+
+        std::cout << "Тест 2 - Оборванная запись: ";
+        if (result.ok && result.tornTail && result.records == 10 && result.lastSequence == 10 &&
+            torn.getPlayer("Журнал Гость") && sequence == 11 && committed &&
+            again.ok && !again.tornTail && again.records == 11 && again.lastSequence == 11) {
+            std::cout << "PASSED" << std::endl;
+        } else {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+    std::remove(journalPath.c_str());
+
+    // Тест 3: контрольная точка укорачивает журнал; восстановление - снимок и хвост без повторного применения
+    {
+        Options options;
+        options.checkpointBytes = 2048;
+        options.snapshotPath = snapshotPath;
+        std::unique_ptr<Journal> journal = open(journalPath, options);
+        GameDatabase db;
+        db.attachJournal(journal.get());
+        db.addGame(new BoardGame("Журнал Азул", "Плитки", 2, 4, "Базовая"));
+        for (int i = 0; i < 60; ++i) {
+            std::string id = "Журнал Т" + std::to_string(i);
+            db.addPlayer(new Player(id, id));
+            Match* match = new Match("Журнал ТП" + std::to_string(i), "Журнал Азул", "2024-04-01");
+            match->addPlayerResult(id, i);
+            db.addMatch(match);
+            db.addRating("Журнал Азул", id, 1 + i % 5);
+        }
+        journal->commit();
+        bool checkpointed = journal->getFileSize() < 2048 + 256 && fileExists(snapshotPath);
+
+        GameDatabase restored;
+        ReplayResult result;
+        std::unique_ptr<Journal> reopened = recover(restored, journalPath, options, &result);
+        bool same = reopened && result.ok && result.records > 0 && result.records < 180 &&
+                    restored.getAllMatches().size() == 60 && restored.getAllPlayers().size() == 60 &&
+                    restored.getGame("Журнал Азул")->getAverageRating() == db.getGame("Журнал Азул")->getAverageRating() &&
+                    restored.getJournal() == reopened.get() && reopened->getLastSequence() == journal->getLastSequence();
+        restored.attachJournal(nullptr);
+        reopened.reset();
+
+        // сбой между записью снимка и заменой журнала: в снимке уже все записи журнала
+        SnapshotFile::write(db, snapshotPath, nullptr, journal->getLastSequence());
+        GameDatabase crashed;
+        ReplayResult tail;
+        std::unique_ptr<Journal> afterCrash = recover(crashed, journalPath, options, &tail);
+        bool skipped = afterCrash && tail.ok && tail.records == 0 && tail.lastSequence == journal->getLastSequence() &&
+                       crashed.getAllMatches().size() == 60 && crashed.getPlayer("Журнал Т7")->getMatchHistory().size() == 1;
+        crashed.attachJournal(nullptr);
+        db.attachJournal(nullptr);
+
+        std::cout << "Тест 3 - Контрольная точка и восстановление: ";
+        if (checkpointed && same && skipped) {
+            std::cout << "PASSED" << std::endl;
+        } else {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+    std::remove(journalPath.c_str());
+    std::remove(snapshotPath.c_str());
+
+    // Тест 4: commit из нескольких потоков - каждая запись на диске ровно один раз, сбросов не больше commit
+    {
+        std::unique_ptr<Journal> journal = open(journalPath);
+        const int threadCount = 4;
+        const int perThread = 100;
+        const size_t total = threadCount * perThread;
+        std::vector<std::thread> writers;
+        std::vector<int> failures(threadCount, 0);
+        for (int t = 0; t < threadCount; ++t) {
+            writers.emplace_back([&, t]() {
+                for (int i = 0; i < perThread; ++i) {
+                    journal->recordSimilarity("Журнал Поток", std::to_string(t * perThread + i));
+                    if (!journal->commit()) {
+                        ++failures[t];
+                    }
+                }
+            });
+        }
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+        uint64_t durable = journal->getDurableSequence();
+        uint64_t syncs = journal->getSyncCount();
+        journal.reset();
+
+        GameDatabase db;
+        ReplayResult result = replay(journalPath, db);
+
+        std::cout << "Тест 4 - Групповой commit: ";
+        if (durable == total && syncs <= durable && result.ok && result.records == total && result.applied == 0 &&
+            std::count(failures.begin(), failures.end(), 0) == threadCount) {
+            std::cout << "PASSED" << std::endl;
+        } else {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+    std::remove(journalPath.c_str());
+
+    // Тест 5: изменения оценок и признаков игры через базу тоже проигрываются
+    {
+        std::unique_ptr<Journal> journal = open(journalPath);
+        GameDatabase db;
+        db.attachJournal(journal.get());
+
+        db.addGame(new BoardGame("Журнал Азул", "Плитки", 2, 4, "Базовая"));
+        db.addPlayer(new Player("Журнал Анна", "Анна"));
+        db.addPlayer(new Player("Журнал Борис", "Борис"));
+        db.addRating("Журнал Азул", "Журнал Анна", 3);
+        db.addRating("Журнал Азул", "Журнал Борис", 2);
+        db.updateRating("Журнал Азул", "Журнал Анна", 5);
+        db.removeRating("Журнал Азул", "Журнал Борис");
+        db.addFeature("Журнал Азул", "Тема", "Португалия");
+        db.addFeature("Журнал Азул", "Сложность", "Низкая");
+        db.updateFeature("Журнал Азул", "Тема", "Мозаика");
+        db.removeFeature("Журнал Азул", "Сложность");
+        db.updateRating("Журнал Азул", "Журнал Борис", 4);  // оценки уже нет - отклоняется и не записывается
+        db.removeFeature("Журнал Азул", "Сложность");       // то же для признака
+        journal->commit();
+        uint64_t last = journal->getLastSequence();
+
+        GameDatabase restored;
+        ReplayResult result = replay(journalPath, restored);
+        const BoardGame* azul = restored.getGame("Журнал Азул");
+
+        std::cout << "Тест 5 - Проигрывание оценок и признаков: ";
+        if (last == 11 && result.ok && result.records == 11 && result.applied == 11 && azul &&
+            azul->getRatingsCount() == 1 && azul->getAverageRating() == 5 &&
+            azul->getFeature("Тема") == "Мозаика" && !azul->hasFeature("Сложность") &&
+            azul->getFeatures().size() == 1) {
+            std::cout << "PASSED" << std::endl;
+        } else {
+            std::cout << "FAILED" << std::endl;
+        }
+        db.attachJournal(nullptr);
+    }
+    std::remove(journalPath.c_str());
+
+    std::cout << "=== Тестирование Journal завершено ===\n" << std::endl;
+}
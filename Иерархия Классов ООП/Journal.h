@@ -0,0 +1,182 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "BoardGame.h"
+#include "Player.h"
+#include "Match.h"
+#include <memory>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+class GameDatabase;
+
+// Режим сброса журнала на диск (fsync) при commit
+enum class SyncPolicy {
+    Never,        // только запись в файл, сброс оставлен системе
+    EveryCommit,  // commit возвращается, когда записи на диске
+    Interval      // сброс не чаще раза в syncIntervalMs; при сбое теряется не больше этого интервала
+};
+
+// Настройки журнала (см. Journal)
+struct JournalOptions {
+    SyncPolicy sync = SyncPolicy::EveryCommit;
+    size_t batchBytes = 64 * 1024;       // накопленный объем, после которого записи пишутся в файл без commit
+    unsigned syncIntervalMs = 50;        // для SyncPolicy::Interval
+    uint64_t checkpointBytes = 0;        // объем журнала, после которого база делает контрольную точку (0 - никогда)
+    std::string snapshotPath;            // файл снимка для контрольных точек и восстановления
+};
+
+// Итог проигрывания журнала
+struct ReplayResult {
+    bool ok = false;            // файл прочитан (испорченный хвост ошибкой не считается)
+    size_t records = 0;         // целых записей после пропущенных
+    size_t applied = 0;         // из них принято базой
+    uint64_t lastSequence = 0;  // номер последней целой записи (0, если записей нет)
+    uint64_t validBytes = 0;    // длина целой части файла
+    bool tornTail = false;      // после целой части есть оборванная или испорченная запись
+    std::string error;
+};
+
+// Журнал изменений базы (write-ahead log): двоичный файл, в который только дописываются записи
+// Файл - заголовок (сигнатура, версия, номер первой записи) и записи: длина, контрольная сумма,
+// номер записи и содержимое - вид изменения и его параметры
+// Подключенная база (GameDatabase::attachJournal) записывает каждое принятое изменение; оценки и признаки
+// игры из базы меняются через методы базы (GameDatabase::updateRating, addFeature и т.д.), иначе они не попадут в журнал
+// Записи копятся в памяти и пишутся в файл пачками (batchBytes) или при commit; commit из нескольких потоков
+// объединяется: один поток пишет и сбрасывает на диск все накопленное, остальные ждут его (групповой commit)
+// Восстановление (recover) загружает последний снимок (SnapshotFile) и проигрывает записи журнала после него;
+// оборванная при сбое последняя запись отбрасывается
+// Контрольная точка (checkpoint) записывает снимок базы и начинает журнал заново, поэтому журнал не растет бесконечно
+// Методы можно вызывать из нескольких потоков
+class Journal {
+public:
+    static const uint32_t FORMAT_VERSION = 1;
+
+    typedef JournalOptions Options;
+
+private:
+    // вид изменения - первый байт содержимого записи
+    enum RecordType : uint8_t {
+        ADD_GAME = 1,
+        REMOVE_GAME,
+        ADD_PLAYER,
+        REMOVE_PLAYER,
+        ADD_MATCH,
+        ADD_RATING,
+        ADD_SIMILARITY,
+        UPDATE_RATING,
+        REMOVE_RATING,
+        ADD_FEATURE,
+        UPDATE_FEATURE,
+        REMOVE_FEATURE
+    };
+
+    class Encoder;
+    class Decoder;
+
+    std::string path;
+    Options options;
+    int descriptor;
+
+    mutable std::mutex lock;
+    std::condition_variable flushed;      // лидер группового commit закончил запись
+    std::vector<uint8_t> pending;         // записи, еще не отданные в файл
+    std::vector<uint8_t> spare;           // буфер прошлой пачки для повторного использования
+    uint64_t nextSequence;
+    uint64_t writtenSequence;             // последняя запись, отданная в файл
+    uint64_t durableSequence;             // последняя запись, сброшенная на диск
+    bool flushing;                        // пачку пишет один из потоков
+    uint64_t fileBytes;
+    uint64_t checkpointedBytes;           // размер журнала после последней контрольной точки
+    uint64_t syncCount;
+    std::chrono::steady_clock::time_point lastSync;
+    bool failed;                          // запись в файл не удалась, дальнейшие commit возвращают false
+    std::string lastError;
+
+    Journal(const std::string& path, const Options& options);
+
+    // Открыть журнал; новый файл начинается с записи after + 1, номера продолжаются не меньше чем с нее
+    static std::unique_ptr<Journal> openAfter(const std::string& path, const Options& options, uint64_t after,
+                                              std::string* error);
+
+    // Закончить запись, начатую Encoder в pending: номер, длина и контрольная сумма; возвращает номер (0 после сбоя записи)
+    // Накопив batchBytes, отдает записи в файл; вызывается под lock
+    uint64_t append(Encoder& record, std::unique_lock<std::mutex>& guard);
+
+    // Дождаться, пока записи до target будут в файле (sync - и на диске); при необходимости стать лидером
+    // Вызывается под lock, на время записи отпускает его
+    bool flushUpTo(std::unique_lock<std::mutex>& guard, uint64_t target, bool sync);
+
+    // Применить одну запись к базе
+    static bool apply(Decoder& record, GameDatabase& db, bool& accepted);
+
+public:
+    ~Journal();  // Пишет и сбрасывает на диск накопленные записи
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    // Открыть журнал для дописывания (создается, если файла нет); оборванный хвост отрезается
+    // nullptr и текст ошибки в error, если файл не журнал или его не удалось открыть
+    static std::unique_ptr<Journal> open(const std::string& path, const Options& options = Options(),
+                                         std::string* error = nullptr);
+
+    // Проиграть записи с номерами больше afterSequence в базу (журнал базы на это время отключается)
+    static ReplayResult replay(const std::string& path, GameDatabase& db, uint64_t afterSequence = 0);
+
+    // Восстановить пустую базу: снимок options.snapshotPath (если есть), затем хвост журнала;
+    // журнал открывается для продолжения и подключается к базе; итог проигрывания - в result
+    static std::unique_ptr<Journal> recover(GameDatabase& db, const std::string& path, const Options& options = Options(),
+                                            ReplayResult* result = nullptr, std::string* error = nullptr);
+
+    // === Записи изменений (вызывает база после принятого изменения) ===
+    // Возвращают номер записи (0, если запись в файл уже не удалась)
+
+    uint64_t recordAddGame(const BoardGame& game);  // с признаками и оценками
+    uint64_t recordRemoveGame(std::string_view gameName);
+    uint64_t recordAddPlayer(const Player& player);  // с историей партий
+    uint64_t recordRemovePlayer(std::string_view playerId);
+    uint64_t recordAddMatch(const Match& match);
+    uint64_t recordRating(std::string_view gameName, std::string_view playerId, int rating);
+    uint64_t recordUpdateRating(std::string_view gameName, std::string_view playerId, int rating);
+    uint64_t recordRemoveRating(std::string_view gameName, std::string_view playerId);
+    uint64_t recordAddFeature(std::string_view gameName, std::string_view feature, std::string_view value);
+    uint64_t recordUpdateFeature(std::string_view gameName, std::string_view feature, std::string_view value);
+    uint64_t recordRemoveFeature(std::string_view gameName, std::string_view feature);
+    uint64_t recordSimilarity(std::string_view game1, std::string_view game2);
+
+    // Записать накопленное в файл и сбросить на диск по политике; false, если запись не удалась
+    bool commit();
+
+    // То же со сбросом на диск независимо от политики
+    bool sync();
+
+    // === Контрольные точки ===
+
+    // Пора ли сделать контрольную точку (журнал вырос на checkpointBytes с прошлой)
+    bool checkpointDue() const;
+
+    // Записать снимок базы с номером последней записи и начать журнал заново
+    // При сбое между записью снимка и заменой журнала восстановление пропустит записи, уже вошедшие в снимок
+    bool checkpoint(const GameDatabase& db, std::string* error = nullptr);
+
+    // === Состояние ===
+
+    const std::string& getPath() const;
+    const Options& getOptions() const;
+    uint64_t getLastSequence() const;     // номер последней записи
+    uint64_t getDurableSequence() const;  // номер последней записи на диске
+    uint64_t getFileSize() const;         // байт в файле (без накопленных в памяти)
+    uint64_t getSyncCount() const;        // сколько раз файл сбрасывался на диск
+    std::string getLastError() const;
+
+    static void runTests();
+};
+
+#endif
@@ -0,0 +1,443 @@
+#include "Leaderboard.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// === Показатели ===
+
+void LeaderboardMetric::participants(const Match& match, std::vector<std::pair<SymbolId, double>>& out) {
+    out.clear();
+    for (const auto& playerResult : match.getPlayerResults()) {
+        if (playerResult.second >= 0) {
+            out.push_back(playerResult);
+        }
+    }
+}
+
+std::unique_ptr<LeaderboardMetric> MeanResultMetric::create() const {
+    return std::unique_ptr<LeaderboardMetric>(new MeanResultMetric());
+}
+
+std::string MeanResultMetric::getName() const {
+    return "средний результат";
+}
+
+void MeanResultMetric::addMatch(const Match& match, std::vector<std::pair<SymbolId, double>>& scores) {
+    participants(match, scratch);
+    for (const auto& playerResult : scratch) {
+        Totals& player = totals.emplace(playerResult.first, Totals{0, 0.0}).first->second;
+        ++player.count;
+        player.sum += playerResult.second;
+        scores.emplace_back(playerResult.first, player.sum / player.count);
+    }
+}
+
+std::unique_ptr<LeaderboardMetric> WinRateMetric::create() const {
+    return std::unique_ptr<LeaderboardMetric>(new WinRateMetric());
+}
+
+std::string WinRateMetric::getName() const {
+    return "доля побед";
+}
+
+void WinRateMetric::addMatch(const Match& match, std::vector<std::pair<SymbolId, double>>& scores) {
+    participants(match, scratch);
+    for (const auto& playerResult : scratch) {
+        Totals& player = totals.emplace(playerResult.first, Totals{0, 0}).first->second;
+        ++player.played;
+        player.won += match.getPlacement(playerResult.first) == 1;
+        scores.emplace_back(playerResult.first, static_cast<double>(player.won) / player.played);
+    }
+}
+
+SkillMetric::SkillMetric(const SkillOptions& options) : options(options) {}
+
+std::unique_ptr<LeaderboardMetric> SkillMetric::create() const {
+    return std::unique_ptr<LeaderboardMetric>(new SkillMetric(options));
+}
+
+std::string SkillMetric::getName() const {
+    return options.model == SkillModel::Elo ? "рейтинг Эло" : "рейтинг Glicko-2";
+}
+
+void SkillMetric::addMatch(const Match& match, std::vector<std::pair<SymbolId, double>>& scores) {
+    SkillRatingEngine::rate(options, match, ratings, &scores);
+}
+
+// === Таблица ===
+
+namespace {
+
+// Приоритет узла декартова дерева: перемешанный номер игрока (детерминированно, без генератора)
+uint32_t priorityOf(SymbolId player) {
+    uint32_t x = player + 0x9e3779b9u;
+    x ^= x >> 16;
+    x *= 0x85ebca6bu;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35u;
+    x ^= x >> 16;
+    return x;
+}
+
+}
+
+Leaderboard::Leaderboard(std::unique_ptr<LeaderboardMetric> metric)
+    : metric(std::move(metric)), nodes(1, Node{0.0, 0, 0, NIL, NIL, 0}), root(NIL) {}
+
+const LeaderboardMetric& Leaderboard::getMetric() const {
+    return *metric;
+}
+
+bool Leaderboard::above(uint32_t a, uint32_t b) const {
+    const Node& x = nodes[a];
+    const Node& y = nodes[b];
+    return x.score > y.score || (x.score == y.score && x.player < y.player);
+}
+
+void Leaderboard::update(uint32_t node) {
+    Node& n = nodes[node];
+    n.size = nodes[n.left].size + nodes[n.right].size + 1;
+}
+
+// Слияние деревьев, все узлы left выше всех узлов right
+uint32_t Leaderboard::merge(uint32_t left, uint32_t right) {
+    if (left == NIL) return right;
+    if (right == NIL) return left;
+    if (nodes[left].priority > nodes[right].priority) {
+        nodes[left].right = merge(nodes[left].right, right);
+        update(left);
+        return left;
+    }
+    nodes[right].left = merge(left, nodes[right].left);
+    update(right);
+    return right;
+}
+
+uint32_t Leaderboard::insert(uint32_t tree, uint32_t node) {
+    if (tree == NIL) {
+        nodes[node].left = nodes[node].right = NIL;
+        update(node);
+        return node;
+    }
+    if (nodes[node].priority > nodes[tree].priority) {
+        // Узел становится корнем поддерева: делим поддерево на тех, кто выше него, и остальных
+        uint32_t higher = NIL, lower = NIL;
+        uint32_t* higherTail = &higher;
+        uint32_t* lowerTail = &lower;
+        std::vector<uint32_t> path;
+        for (uint32_t t = tree; t != NIL;) {
+            path.push_back(t);
+            if (above(t, node)) {
+                *higherTail = t;
+                higherTail = &nodes[t].right;
+                t = nodes[t].right;
+            } else {
+                *lowerTail = t;
+                lowerTail = &nodes[t].left;
+                t = nodes[t].left;
+            }
+        }
+        *higherTail = NIL;
+        *lowerTail = NIL;
+        for (size_t i = path.size(); i-- > 0;) {
+            update(path[i]);
+        }
+        nodes[node].left = higher;
+        nodes[node].right = lower;
+        update(node);
+        return node;
+    }
+    if (above(node, tree)) {
+        nodes[tree].left = insert(nodes[tree].left, node);
+    } else {
+        nodes[tree].right = insert(nodes[tree].right, node);
+    }
+    update(tree);
+    return tree;
+}
+
+uint32_t Leaderboard::erase(uint32_t tree, uint32_t node) {
+    if (tree == node) {
+        return merge(nodes[node].left, nodes[node].right);
+    }
+    if (above(node, tree)) {
+        nodes[tree].left = erase(nodes[tree].left, node);
+    } else {
+        nodes[tree].right = erase(nodes[tree].right, node);
+    }
+    update(tree);
+    return tree;
+}
+
+size_t Leaderboard::countAbove(double score, bool strict) const {
+    size_t count = 0;
+    for (uint32_t t = root; t != NIL;) {
+        const Node& n = nodes[t];
+        if (strict ? n.score > score : n.score >= score) {
+            count += nodes[n.left].size + 1;
+            t = n.right;
+        } else {
+            t = n.left;
+        }
+    }
+    return count;
+}
+
+void Leaderboard::setScore(SymbolId player, double score) {
+    auto found = nodeOf.find(player);
+    uint32_t node;
+    if (found == nodeOf.end()) {
+        node = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(Node{score, player, priorityOf(player), NIL, NIL, 1});
+        nodeOf.emplace(player, node);
+    } else {
+        node = found->second;
+        if (nodes[node].score == score) {
+            return;
+        }
+        root = erase(root, node);
+        nodes[node].score = score;
+    }
+    root = insert(root, node);
+}
+
+void Leaderboard::addMatch(const Match& match) {
+    scores.clear();
+    metric->addMatch(match, scores);
+    for (const auto& playerScore : scores) {
+        setScore(playerScore.first, playerScore.second);
+    }
+}
+
+void Leaderboard::addMatches(MatchRange batch) {
+    scores.clear();
+    for (const Match* match : batch) {
+        metric->addMatch(*match, scores);
+    }
+    // Очки игрока дописаны в порядке партий: после устойчивой сортировки последние - в конце его участка
+    std::stable_sort(scores.begin(), scores.end(),
+                     [](const std::pair<SymbolId, double>& a, const std::pair<SymbolId, double>& b) {
+                         return a.first < b.first;
+                     });
+    for (size_t i = 0; i < scores.size(); ++i) {
+        if (i + 1 == scores.size() || scores[i + 1].first != scores[i].first) {
+            setScore(scores[i].first, scores[i].second);
+        }
+    }
+}
+
+size_t Leaderboard::size() const {
+    return nodes[root].size;
+}
+
+bool Leaderboard::contains(std::string_view playerId) const {
+    return nodeOf.find(SymbolTable::players().find(playerId)) != nodeOf.end();
+}
+
+std::vector<LeaderboardEntry> Leaderboard::top(size_t count) const {
+    return range(0, count);
+}
+
+std::vector<LeaderboardEntry> Leaderboard::range(size_t offset, size_t count) const {
+    std::vector<LeaderboardEntry> result;
+    if (offset >= size() || count == 0) {
+        return result;
+    }
+    result.reserve(std::min(count, size() - offset));
+
+    // Спуск к узлу на позиции offset; в стеке - узлы, которые идут после него по порядку
+    std::vector<uint32_t> stack;
+    size_t skip = offset;
+    for (uint32_t t = root; t != NIL;) {
+        size_t leftSize = nodes[nodes[t].left].size;
+        if (skip < leftSize) {
+            stack.push_back(t);
+            t = nodes[t].left;
+        } else if (skip == leftSize) {
+            stack.push_back(t);
+            break;
+        } else {
+            skip -= leftSize + 1;
+            t = nodes[t].right;
+        }
+    }
+
+    // Симметричный обход от найденного узла
+    while (!stack.empty() && result.size() < count) {
+        uint32_t t = stack.back();
+        stack.pop_back();
+        const Node& n = nodes[t];
+        size_t rank;
+        if (result.empty()) {
+            rank = countAbove(n.score, true) + 1;
+        } else if (result.back().score == n.score) {
+            rank = result.back().rank;
+        } else {
+            rank = offset + result.size() + 1;
+        }
+        result.push_back(LeaderboardEntry{SymbolTable::players().name(n.player), n.score, rank});
+        for (uint32_t c = n.right; c != NIL; c = nodes[c].left) {
+            stack.push_back(c);
+        }
+    }
+    return result;
+}
+
+double Leaderboard::scoreOf(std::string_view playerId) const {
+    auto found = nodeOf.find(SymbolTable::players().find(playerId));
+    return found != nodeOf.end() ? nodes[found->second].score : 0.0;
+}
+
+size_t Leaderboard::rankOf(std::string_view playerId) const {
+    auto found = nodeOf.find(SymbolTable::players().find(playerId));
+    if (found == nodeOf.end()) {
+        return 0;
+    }
+    return countAbove(nodes[found->second].score, true) + 1;
+}
+
+double Leaderboard::percentileOf(std::string_view playerId) const {
+    auto found = nodeOf.find(SymbolTable::players().find(playerId));
+    if (found == nodeOf.end()) {
+        return 0.0;
+    }
+    if (size() == 1) {
+        return 100.0;
+    }
+    size_t below = size() - countAbove(nodes[found->second].score, false);
+    return 100.0 * below / (size() - 1);
+}
+
+void Leaderboard::runTests() {
+    std::cout << "\n=== Тестирование класса Leaderboard ===" << std::endl;
+
+    auto match = [](const std::string& id, const std::vector<std::pair<std::string, double>>& results) {
+        Match m(id, "Таблица Каркассон", "2024-05-01");
+        for (const auto& result : results) {
+            m.addPlayerResult(result.first, result.second);
+        }
+        return m;
+    };
+
+    // Тест 1: Средний результат, места с равными очками и процентиль
+    Leaderboard mean{std::unique_ptr<LeaderboardMetric>(new MeanResultMetric())};
+    mean.addMatch(match("board_1", {{"board_anna", 80}, {"board_boris", 90}, {"board_vera", 70}}));
+    mean.addMatch(match("board_2", {{"board_anna", 100}, {"board_gleb", 90}, {"board_dina", -1}}));
+    std::vector<LeaderboardEntry> leaders = mean.top(10);
+
+    std::cout << "Тест 1 - Средний результат и места: ";
+    if (mean.size() == 4 && leaders.size() == 4 && !mean.contains("board_dina") &&
+        leaders[0].score == 90 && leaders[0].rank == 1 && leaders[1].rank == 1 && leaders[2].rank == 1 &&
+        leaders[3].playerId == "board_vera" && leaders[3].rank == 4 &&
+        mean.scoreOf("board_anna") == 90 && mean.rankOf("board_vera") == 4 && mean.rankOf("board_dina") == 0 &&
+        mean.percentileOf("board_vera") == 0.0 && std::abs(mean.percentileOf("board_boris") - 100.0 / 3) < 1e-9) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // Тест 2: Очки меняются с новыми партиями, игрок переходит на свое место
+    mean.addMatch(match("board_3", {{"board_vera", 130}}));
+    leaders = mean.top(2);
+
+    std::cout << "Тест 2 - Пересчет мест после партии: ";
+    if (leaders.size() == 2 && leaders[0].playerId == "board_vera" && leaders[0].score == 100 &&
+        leaders[0].rank == 1 && leaders[1].rank == 2 && mean.percentileOf("board_vera") == 100.0 &&
+        mean.top(0).empty() && mean.range(4, 3).empty()) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // Тест 3: Доля побед (ничья за первое место - победа обоих) и рейтинг Эло
+    Leaderboard wins{std::unique_ptr<LeaderboardMetric>(new WinRateMetric())};
+    SkillOptions eloOptions;
+    eloOptions.model = SkillModel::Elo;
+    Leaderboard elo{std::unique_ptr<LeaderboardMetric>(new SkillMetric(eloOptions))};
+    Match first = match("board_4", {{"board_anna", 10}, {"board_boris", 10}, {"board_vera", 5}});
+    Match second = match("board_5", {{"board_anna", 3}, {"board_boris", 7}});
+    for (const Match* m : {&first, &second}) {
+        wins.addMatch(*m);
+        elo.addMatch(*m);
+    }
+
+    std::cout << "Тест 3 - Доля побед и рейтинг Эло: ";
+    if (wins.scoreOf("board_boris") == 1.0 && wins.scoreOf("board_anna") == 0.5 && wins.scoreOf("board_vera") == 0.0 &&
+        elo.rankOf("board_boris") == 1 && elo.rankOf("board_anna") == 2 && elo.rankOf("board_vera") == 3 &&
+        elo.scoreOf("board_vera") < 1500 && elo.scoreOf("board_boris") > 1500 &&
+        wins.getMetric().getName() != elo.getMetric().getName()) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // Тест 4: Большая таблица совпадает с полной сортировкой (страницы, места, процентили)
+    Leaderboard large{std::unique_ptr<LeaderboardMetric>(new MeanResultMetric())};
+    std::vector<double> sums(500, 0.0);
+    std::vector<int> counts(500, 0);
+    for (int i = 0; i < 3000; ++i) {
+        int player = (i * 7919) % 500;
+        double result = (i * 31) % 97;
+        sums[player] += result;
+        ++counts[player];
+        large.addMatch(match("board_large_" + std::to_string(i), {{"board_p" + std::to_string(player), result}}));
+    }
+    std::vector<std::pair<double, std::string>> expected;
+    for (int p = 0; p < 500; ++p) {
+        if (counts[p] > 0) {
+            expected.emplace_back(sums[p] / counts[p], "board_p" + std::to_string(p));
+        }
+    }
+    std::sort(expected.begin(), expected.end(),
+              [](const std::pair<double, std::string>& a, const std::pair<double, std::string>& b) {
+                  return a.first > b.first;
+              });
+    bool same = large.size() == expected.size();
+    std::vector<LeaderboardEntry> page = large.range(100, 50);
+    for (size_t i = 0; same && i < page.size(); ++i) {
+        const LeaderboardEntry& entry = page[i];
+        size_t higher = 0;
+        while (higher < expected.size() && expected[higher].first > entry.score) ++higher;
+        same = entry.score == expected[100 + i].first && entry.rank == higher + 1 &&
+               large.rankOf(entry.playerId) == entry.rank;
+    }
+
+    std::cout << "Тест 4 - Большая таблица и страницы: ";
+    if (same && page.size() == 50 && large.top(expected.size() + 10).size() == expected.size()) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // Тест 5: Пачка партий дает ту же таблицу, что и партии по одной
+    Leaderboard batched{std::unique_ptr<LeaderboardMetric>(new WinRateMetric())};
+    Leaderboard oneByOne{std::unique_ptr<LeaderboardMetric>(new WinRateMetric())};
+    std::vector<Match> batchMatches;
+    for (int i = 0; i < 400; ++i) {
+        batchMatches.push_back(match("board_batch_" + std::to_string(i),
+                                     {{"board_b" + std::to_string(i % 37), double(i % 11)},
+                                      {"board_b" + std::to_string((i * 5 + 3) % 37), double(i % 7)}}));
+    }
+    std::vector<Match*> batch;
+    for (Match& m : batchMatches) {
+        batch.push_back(&m);
+        oneByOne.addMatch(m);
+    }
+    batched.addMatches(MatchRange{batch.data(), batch.data() + batch.size()});
+    std::vector<LeaderboardEntry> batchedAll = batched.top(100);
+    std::vector<LeaderboardEntry> oneByOneAll = oneByOne.top(100);
+    bool sameTable = batchedAll.size() == oneByOneAll.size() && batched.size() == 37;
+    for (size_t i = 0; sameTable && i < batchedAll.size(); ++i) {
+        sameTable = batchedAll[i].playerId == oneByOneAll[i].playerId && batchedAll[i].score == oneByOneAll[i].score &&
+                    batchedAll[i].rank == oneByOneAll[i].rank;
+    }
+
+    std::cout << "Тест 5 - Пачка партий: ";
+    if (sameTable) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    std::cout << "=== Тестирование Leaderboard завершено ===\n" << std::endl;
+}
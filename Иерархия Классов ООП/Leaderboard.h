@@ -0,0 +1,154 @@
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include "Match.h"
+#include "SymbolTable.h"
+#include "SkillRatingEngine.h"
+#include "MatchTimeIndex.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+// Показатель, по которому упорядочена таблица лидеров одной игры
+// Экземпляр принадлежит таблице и сам накапливает по ее игрокам то, что нужно для очков
+// Результат меньше 0 не учитывается (как в PlayerGameStats): такой игрок в партии не участвует
+class LeaderboardMetric {
+public:
+    virtual ~LeaderboardMetric() {}
+
+    // Пустой показатель того же вида с теми же настройками (для таблицы другой игры)
+    virtual std::unique_ptr<LeaderboardMetric> create() const = 0;
+
+    virtual std::string getName() const = 0;
+
+    // Учесть партию; в scores дописываются участники, чьи очки изменились, и их новые очки
+    virtual void addMatch(const Match& match, std::vector<std::pair<SymbolId, double>>& scores) = 0;
+
+protected:
+    // Участники партии с учитываемыми результатами (по возрастанию номера игрока)
+    static void participants(const Match& match, std::vector<std::pair<SymbolId, double>>& out);
+};
+
+// Средний результат игрока в игре (то же, что GameDatabase::getPlayerRatingInGame)
+class MeanResultMetric : public LeaderboardMetric {
+private:
+    struct Totals { int count; double sum; };
+    std::unordered_map<SymbolId, Totals> totals;
+    std::vector<std::pair<SymbolId, double>> scratch;
+
+public:
+    std::unique_ptr<LeaderboardMetric> create() const override;
+    std::string getName() const override;
+    void addMatch(const Match& match, std::vector<std::pair<SymbolId, double>>& scores) override;
+};
+
+// Доля побед: победители партии - все участники на первом месте (Match::getPlacement)
+class WinRateMetric : public LeaderboardMetric {
+private:
+    struct Totals { int played; int won; };
+    std::unordered_map<SymbolId, Totals> totals;
+    std::vector<std::pair<SymbolId, double>> scratch;
+
+public:
+    std::unique_ptr<LeaderboardMetric> create() const override;
+    std::string getName() const override;
+    void addMatch(const Match& match, std::vector<std::pair<SymbolId, double>>& scores) override;
+};
+
+// Рейтинг силы (Эло или Glicko-2, см. SkillRatingEngine) по партиям этой игры
+class SkillMetric : public LeaderboardMetric {
+private:
+    SkillOptions options;
+    SkillRatingEngine::GameRatings ratings;
+
+public:
+    explicit SkillMetric(const SkillOptions& options = SkillOptions());
+
+    std::unique_ptr<LeaderboardMetric> create() const override;
+    std::string getName() const override;
+    void addMatch(const Match& match, std::vector<std::pair<SymbolId, double>>& scores) override;
+};
+
+// Строка таблицы лидеров
+struct LeaderboardEntry {
+    std::string_view playerId;  // строка из SymbolTable::players()
+    double score;
+    size_t rank;                // место с 1; у равных очков место одно (1, 2, 2, 4)
+};
+
+// Таблица лидеров одной игры: игроки по убыванию очков показателя, при равенстве - по номеру игрока
+// Хранится в дереве порядковой статистики (декартово дерево с размерами поддеревьев в массиве узлов),
+// поэтому партия обновляет таблицу за O(участники * log n), место игрока и страница таблицы -
+// за O(log n) и O(log n + размер страницы), без просмотра всех игроков и партий
+class Leaderboard {
+private:
+    static const uint32_t NIL = 0;  // узел 0 - пустое поддерево
+
+    struct Node {
+        double score;
+        SymbolId player;
+        uint32_t priority;
+        uint32_t left;
+        uint32_t right;
+        uint32_t size;  // узлов в поддереве
+    };
+
+    std::unique_ptr<LeaderboardMetric> metric;
+    std::vector<Node> nodes;                        // у каждого игрока свой узел навсегда
+    std::unordered_map<SymbolId, uint32_t> nodeOf;  // игрок -> узел
+    uint32_t root;
+    std::vector<std::pair<SymbolId, double>> scores;  // новые очки партии (буфер)
+
+    // Стоит ли узел a выше узла b
+    bool above(uint32_t a, uint32_t b) const;
+    void update(uint32_t node);
+    uint32_t merge(uint32_t left, uint32_t right);
+    uint32_t insert(uint32_t tree, uint32_t node);
+    uint32_t erase(uint32_t tree, uint32_t node);
+
+    // Число игроков с очками больше score (strict) или не меньше score
+    size_t countAbove(double score, bool strict) const;
+
+    void setScore(SymbolId player, double score);
+
+public:
+    explicit Leaderboard(std::unique_ptr<LeaderboardMetric> metric);
+
+    Leaderboard(Leaderboard&&) = default;
+    Leaderboard& operator=(Leaderboard&&) = default;
+
+    const LeaderboardMetric& getMetric() const;
+
+    // Учесть партию этой игры
+    void addMatch(const Match& match);
+
+    // Учесть партии этой игры по порядку (пакетное добавление): показатель считает каждую партию,
+    // а дерево меняется один раз на игрока - с его очками после всей пачки
+    void addMatches(MatchRange batch);
+
+    size_t size() const;  // игроков в таблице
+    bool contains(std::string_view playerId) const;
+
+    // Лучшие count игроков
+    std::vector<LeaderboardEntry> top(size_t count) const;
+
+    // Страница таблицы: count игроков, начиная с позиции offset (с 0)
+    std::vector<LeaderboardEntry> range(size_t offset, size_t count) const;
+
+    // Очки и место игрока (0, если игрока нет в таблице)
+    double scoreOf(std::string_view playerId) const;
+    size_t rankOf(std::string_view playerId) const;
+
+    // Процентиль игрока: доля остальных игроков с меньшими очками, 0..100
+    // (100 у единственного игрока; 0, если игрока нет в таблице)
+    double percentileOf(std::string_view playerId) const;
+
+    static void runTests();
+};
+
+#endif
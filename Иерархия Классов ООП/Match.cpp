@@ -1,174 +1,275 @@
-#include "Match.h"
-#include <algorithm>
-#include <limits>
-#include <iomanip>
-
-Match::Match() : matchId(""), gameName(""), date("") {}
-
-Match::Match(const std::string& matchId, const std::string& gameName, const std::string& date)
-    : matchId(matchId), gameName(gameName), date(date) {}
-
-Match::~Match() {}
-std::string Match::getMatchId() const {
-    return matchId;
-}
-
-std::string Match::getGameName() const {
-    return gameName;
-}
-
-std::string Match::getDate() const {
-    return date;
-}
-
-const std::map<std::string, double>& Match::getPlayerResults() const {
-    return playerResults;
-}
-
-int Match::getPlayerCount() const {
-    return playerResults.size();
-}
-
-bool Match::addPlayerResult(const std::string& playerId, double result) {
-    // игрок может участвовать в партии только один раз
-    if (playerResults.find(playerId) != playerResults.end()) {
-        return false;
-    }
-    
-    playerResults[playerId] = result;
-    return true;
-}
-
-double Match::getPlayerResult(const std::string& playerId) const {
-    auto it = playerResults.find(playerId);
-    if (it != playerResults.end()) {
-        return it->second;
-    }
-    return -1.0;
-}
-
-bool Match::hasPlayer(const std::string& playerId) const {
-    return playerResults.find(playerId) != playerResults.end();
-}
-
-std::string Match::getWinner() const {
-    if (playerResults.empty()) {
-        return "";
-    }
-    
-    // находим игрока с максимальным результатом
-    auto maxElement = std::max_element(
-        playerResults.begin(), 
-        playerResults.end(),
-        [](const std::pair<std::string, double>& a, const std::pair<std::string, double>& b) {
-            return a.second < b.second;
-        }
-    );
-    
-    return maxElement->first;
-}
-
-bool Match::operator<(const Match& other) const {
-    return this->date < other.date;
-}
-
-std::ostream& operator<<(std::ostream& os, const Match& match) {
-    os << "Match[ID: " << match.matchId 
-       << ", Game: " << match.gameName 
-       << ", Date: " << match.date 
-       << ", Players: " << match.playerResults.size() << "]";
-    return os;
-}
-void Match::printInfo() const {
-    std::cout << "=== Партия ===" << std::endl;
-    std::cout << "ID: " << matchId << std::endl;
-    std::cout << "Игра: " << gameName << std::endl;
-    std::cout << "Дата: " << date << std::endl;
-    std::cout << "Количество игроков: " << playerResults.size() << std::endl;
-    
-    if (!playerResults.empty()) {
-        std::cout << "Результаты:" << std::endl;
-        for (const auto& pair : playerResults) {
-            std::cout << "  " << pair.first << ": " << std::fixed 
-                      << std::setprecision(1) << pair.second;
-            if (pair.first == getWinner()) {
-                std::cout << " (победитель)";
-            }
-            std::cout << std::endl;
-        }
-    }
-}
-
-void Match::runTests() {
-    std::cout << "\n=== Тестирование класса Match ===" << std::endl;
-    
-    Match m1("match_001", "Шахматы", "2024-01-15");
-    
-    std::cout << "Тест 1 - Создание партии: ";
-    if (m1.getMatchId() == "match_001" && 
-        m1.getGameName() == "Шахматы" && 
-        m1.getDate() == "2024-01-15") {
-        std::cout << "PASSED" << std::endl;
-    } else {
-        std::cout << "FAILED" << std::endl;
-    }
-    
-    m1.addPlayerResult("player_001", 85.5);
-    m1.addPlayerResult("player_002", 92.0);
-    m1.addPlayerResult("player_003", 78.3);
-    
-    std::cout << "Тест 2 - Добавление результатов: ";
-    if (m1.getPlayerCount() == 3) {
-        std::cout << "PASSED" << std::endl;
-    } else {
-        std::cout << "FAILED" << std::endl;
-    }
-    
-    bool duplicate = m1.addPlayerResult("player_001", 100.0);
-    
-    std::cout << "Тест 3 - Защита от дублирования: ";
-    if (!duplicate && m1.getPlayerCount() == 3) {
-        std::cout << "PASSED" << std::endl;
-    } else {
-        std::cout << "FAILED" << std::endl;
-    }
-    
-    double result = m1.getPlayerResult("player_002");
-    
-    std::cout << "Тест 4 - Получение результата: ";
-    if (result == 92.0) {
-        std::cout << "PASSED" << std::endl;
-    } else {
-        std::cout << "FAILED" << std::endl;
-    }
-    
-    std::string winner = m1.getWinner();
-    
-    std::cout << "Тест 5 - Определение победителя: ";
-    if (winner == "player_002") {
-        std::cout << "PASSED (победитель: " << winner << ")" << std::endl;
-    } else {
-        std::cout << "FAILED" << std::endl;
-    }
-    
-    std::cout << "Тест 6 - Проверка участия: ";
-    if (m1.hasPlayer("player_001") && !m1.hasPlayer("player_999")) {
-        std::cout << "PASSED" << std::endl;
-    } else {
-        std::cout << "FAILED" << std::endl;
-    }
-    
-    Match m2("match_002", "Каркассон", "2024-02-20");
-    
-    std::cout << "Тест 7 - Сравнение по дате: ";
-    if (m1 < m2) {
-        std::cout << "PASSED" << std::endl;
-    } else {
-        std::cout << "FAILED" << std::endl;
-    }
-    
-    std::cout << "Тест 8 - Оператор вывода: " << m1 << std::endl;
-    
-    std::cout << "=== Тестирование Match завершено ===\n" << std::endl;
-}
-
+#include "Match.h"
+#include <algorithm>
+#include <limits>
+#include <iomanip>
+
+Match::Match() 
+    : matchId(SymbolTable::matches().intern("")), gameName(SymbolTable::games().intern("")), date() {}
+
+Match::Match(const std::string& matchId, const std::string& gameName, const std::string& date)
+    : matchId(SymbolTable::matches().intern(matchId)), 
+      gameName(SymbolTable::games().intern(gameName)), date(Date::parse(date)) {}
+
+Match::Match(const std::string& matchId, const std::string& gameName, Date date)
+    : matchId(SymbolTable::matches().intern(matchId)), 
+      gameName(SymbolTable::games().intern(gameName)), date(date) {}
+
+Match::~Match() {}
+const std::string& Match::getMatchId() const {
+    return SymbolTable::matches().name(matchId);
+}
+
+const std::string& Match::getGameName() const {
+    return SymbolTable::games().name(gameName);
+}
+
+std::string Match::getDate() const {
+    return date.toString();
+}
+
+Date Match::getDay() const {
+    return date;
+}
+
+SymbolId Match::getMatchHandle() const {
+    return matchId;
+}
+
+SymbolId Match::getGameHandle() const {
+    return gameName;
+}
+
+const FlatMap<SymbolId, double>& Match::getPlayerResults() const {
+    return playerResults;
+}
+
+int Match::getPlayerCount() const {
+    return playerResults.size();
+}
+
+bool Match::addPlayerResult(const std::string& playerId, double result) {
+    // игрок может участвовать в партии только один раз
+    SymbolId player = SymbolTable::players().intern(playerId);
+    if (playerResults.size() >= UINT16_MAX || !playerResults.insert(player, result)) {
+        return false;
+    }
+    
+    rankPlayers();
+    return true;
+}
+
+void Match::rankPlayers() {
+    // участников в партии немного, поэтому места проще пересчитать целиком
+    ranking.resize(playerResults.size());
+    for (size_t i = 0; i < ranking.size(); ++i) {
+        ranking[i] = static_cast<uint16_t>(i);
+    }
+    FlatMap<SymbolId, double>::const_iterator results = playerResults.begin();
+    std::sort(ranking.begin(), ranking.end(), [&](uint16_t a, uint16_t b) {
+        return results[a].second > results[b].second || (results[a].second == results[b].second && a < b);
+    });
+    
+    places.resize(playerResults.size());
+    for (size_t i = 0; i < ranking.size(); ++i) {
+        bool tied = i > 0 && results[ranking[i]].second == results[ranking[i - 1]].second;
+        places[ranking[i]] = tied ? places[ranking[i - 1]] : static_cast<uint16_t>(i + 1);
+    }
+}
+
+double Match::getPlayerResult(std::string_view playerId) const {
+    return getPlayerResult(SymbolTable::players().find(playerId));
+}
+
+double Match::getPlayerResult(SymbolId player) const {
+    auto it = playerResults.find(player);
+    if (it != playerResults.end()) {
+        return it->second;
+    }
+    return -1.0;
+}
+
+bool Match::hasPlayer(std::string_view playerId) const {
+    return hasPlayer(SymbolTable::players().find(playerId));
+}
+
+bool Match::hasPlayer(SymbolId player) const {
+    return playerResults.find(player) != playerResults.end();
+}
+
+const std::string& Match::getWinner() const {
+    static const std::string empty;
+    SymbolId winner = getWinnerHandle();
+    return winner != INVALID_SYMBOL ? SymbolTable::players().name(winner) : empty;
+}
+
+SymbolId Match::getWinnerHandle() const {
+    return ranking.empty() ? INVALID_SYMBOL : playerResults.begin()[ranking[0]].first;
+}
+
+int Match::getPlacement(std::string_view playerId) const {
+    return getPlacement(SymbolTable::players().find(playerId));
+}
+
+int Match::getPlacement(SymbolId player) const {
+    auto it = playerResults.find(player);
+    return (it != playerResults.end()) ? places[it - playerResults.begin()] : 0;
+}
+
+Placement Match::getStanding(size_t position) const {
+    if (position >= ranking.size()) {
+        return Placement{INVALID_SYMBOL, 0.0, 0};
+    }
+    uint16_t index = ranking[position];
+    const auto& result = playerResults.begin()[index];
+    return Placement{result.first, result.second, places[index]};
+}
+
+size_t Match::getPodiumSize() const {
+    size_t count = 0;
+    while (count < ranking.size() && places[ranking[count]] <= 3) {
+        ++count;
+    }
+    return count;
+}
+
+std::vector<Placement> Match::getPodium() const {
+    std::vector<Placement> podium;
+    size_t count = getPodiumSize();
+    podium.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        podium.push_back(getStanding(i));
+    }
+    return podium;
+}
+
+bool Match::operator<(const Match& other) const {
+    return this->date < other.date;
+}
+
+std::ostream& operator<<(std::ostream& os, const Match& match) {
+    os << "Match[ID: " << match.getMatchId() 
+       << ", Game: " << match.getGameName() 
+       << ", Date: " << match.date.toString()
+       << ", Players: " << match.playerResults.size() << "]";
+    return os;
+}
+void Match::printInfo() const {
+    std::cout << "=== Партия ===" << std::endl;
+    std::cout << "ID: " << getMatchId() << std::endl;
+    std::cout << "Игра: " << getGameName() << std::endl;
+    std::cout << "Дата: " << date.toString() << std::endl;
+    std::cout << "Количество игроков: " << playerResults.size() << std::endl;
+    
+    if (!playerResults.empty()) {
+        std::cout << "Результаты:" << std::endl;
+        SymbolId winner = getWinnerHandle();
+        for (const auto& pair : playerResults) {
+            const std::string& playerId = SymbolTable::players().name(pair.first);
+            std::cout << "  " << playerId << ": " << std::fixed 
+                      << std::setprecision(1) << pair.second;
+            if (pair.first == winner) {
+                std::cout << " (победитель)";
+            }
+            std::cout << std::endl;
+        }
+    }
+}
+
+void Match::runTests() {
+    std::cout << "\n=== Тестирование класса Match ===" << std::endl;
+    
+    Match m1("match_001", "Шахматы", "2024-01-15");
+    
+    std::cout << "Тест 1 - Создание партии: ";
+    if (m1.getMatchId() == "match_001" && 
+        m1.getGameName() == "Шахматы" && 
+        m1.getDate() == "2024-01-15" && m1.getDay() == Date(2024, 1, 15) &&
+        Match("match_no_date", "Шахматы", "15.01.2024").getDate().empty()) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    m1.addPlayerResult("player_001", 85.5);
+    m1.addPlayerResult("player_002", 92.0);
+    m1.addPlayerResult("player_003", 78.3);
+    
+    std::cout << "Тест 2 - Добавление результатов: ";
+    if (m1.getPlayerCount() == 3) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    bool duplicate = m1.addPlayerResult("player_001", 100.0);
+    
+    std::cout << "Тест 3 - Защита от дублирования: ";
+    if (!duplicate && m1.getPlayerCount() == 3) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    double result = m1.getPlayerResult("player_002");
+    
+    std::cout << "Тест 4 - Получение результата: ";
+    if (result == 92.0) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    std::string winner = m1.getWinner();
+    
+    std::cout << "Тест 5 - Определение победителя: ";
+    if (winner == "player_002") {
+        std::cout << "PASSED (победитель: " << winner << ")" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 5а: места с равными результатами (1, 2, 2, 4, 4, 6) считаются при добавлении результатов
+    Match tied("match_tied", "Каркассон", "2024-02-01");
+    tied.addPlayerResult("placement_d", 70.0);
+    tied.addPlayerResult("placement_a", 90.0);
+    tied.addPlayerResult("placement_b", 80.0);
+    tied.addPlayerResult("placement_c", 80.0);
+    tied.addPlayerResult("placement_e", 70.0);
+    tied.addPlayerResult("placement_f", 10.0);
+    std::vector<Placement> podium = tied.getPodium();
+    
+    std::cout << "Тест 5а - Места и пьедестал: ";
+    if (m1.getPlacement("player_002") == 1 && m1.getPlacement("player_001") == 2 &&
+        m1.getPlacement("player_003") == 3 && m1.getPlacement("player_999") == 0 &&
+        tied.getWinner() == "placement_a" && tied.getPlacement("placement_c") == 2 &&
+        tied.getPlacement("placement_e") == 4 && tied.getPlacement("placement_f") == 6 &&
+        podium.size() == 3 && podium[1].player == SymbolTable::players().find("placement_b") &&
+        podium[2].place == 2 && tied.getStanding(5).result == 10.0 &&
+        tied.getStanding(6).player == INVALID_SYMBOL && tied.getStanding(6).place == 0 &&
+        Match().getWinner().empty() && Match().getPodiumSize() == 0) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    std::cout << "Тест 6 - Проверка участия: ";
+    if (m1.hasPlayer("player_001") && !m1.hasPlayer("player_999")) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    Match m2("match_002", "Каркассон", "2024-02-20");
+    
+    std::cout << "Тест 7 - Сравнение по дате: ";
+    if (m1 < m2) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    std::cout << "Тест 8 - Оператор вывода: " << m1 << std::endl;
+    
+    std::cout << "=== Тестирование Match завершено ===\n" << std::endl;
+}
+
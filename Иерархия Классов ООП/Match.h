@@ -1,39 +1,71 @@
-#ifndef MATCH_H
-#define MATCH_H
-
-#include <string>
-#include <map>
-#include <iostream>
-
-class Match {
-private:
-    std::string matchId; // уникальный ID партии
-    std::string gameName; // название игры
-    std::string date; // дата проведения (YYYY-MM-DD)
-    std::map<std::string, double> playerResults; // результаты игроков
-    
-public:
-    Match();
-    Match(const std::string& matchId, const std::string& gameName, const std::string& date);
-    ~Match();
-    
-    std::string getMatchId() const;
-    std::string getGameName() const;
-    std::string getDate() const;
-    const std::map<std::string, double>& getPlayerResults() const;
-    int getPlayerCount() const;
-    
-    bool addPlayerResult(const std::string& playerId, double result);
-    double getPlayerResult(const std::string& playerId) const;
-    bool hasPlayer(const std::string& playerId) const;
-    std::string getWinner() const; // игрок с максимальным результатом
-    
-    bool operator<(const Match& other) const; // сравнение по дате
-    friend std::ostream& operator<<(std::ostream& os, const Match& match);
-    
-    void printInfo() const;
-    static void runTests();
-};
-
-#endif
-
+#ifndef MATCH_H
+#define MATCH_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include "SymbolTable.h"
+#include "Date.h"
+#include "FlatMap.h"
+
+// Место игрока в партии
+struct Placement {
+    SymbolId player;
+    double result;
+    int place; // 1 - наибольший результат; равные результаты делят место (1, 2, 2, 4)
+};
+
+class Match {
+private:
+    SymbolId matchId; // уникальный ID партии (номер в SymbolTable::matches())
+    SymbolId gameName; // название игры (номер в SymbolTable::games())
+    Date date; // дата проведения (разобрана из YYYY-MM-DD при создании)
+    FlatMap<SymbolId, double> playerResults; // результаты по возрастанию номера игрока, подряд в памяти
+    // места считаются один раз при добавлении результата, а не при каждом запросе
+    std::vector<uint16_t> places; // место участника, в порядке playerResults
+    std::vector<uint16_t> ranking; // позиции участников в playerResults по местам (равные - по номеру игрока)
+    
+    void rankPlayers();
+    
+public:
+    Match();
+    Match(const std::string& matchId, const std::string& gameName, const std::string& date); // дата не в виде YYYY-MM-DD - неизвестная
+    Match(const std::string& matchId, const std::string& gameName, Date date);
+    ~Match();
+    
+    // ID и название возвращаются по ссылке (хранятся в SymbolTable)
+    const std::string& getMatchId() const;
+    const std::string& getGameName() const;
+    std::string getDate() const; // YYYY-MM-DD (пустая строка, если дата неизвестна)
+    Date getDay() const;
+    SymbolId getMatchHandle() const;
+    SymbolId getGameHandle() const;
+    const FlatMap<SymbolId, double>& getPlayerResults() const; // ключ - номер игрока
+    int getPlayerCount() const;
+    
+    bool addPlayerResult(const std::string& playerId, double result); // false, если игрок уже есть (или их 65535)
+    double getPlayerResult(std::string_view playerId) const;
+    double getPlayerResult(SymbolId player) const;
+    bool hasPlayer(std::string_view playerId) const;
+    bool hasPlayer(SymbolId player) const;
+    const std::string& getWinner() const; // игрок с максимальным результатом (при равенстве - с меньшим номером)
+    SymbolId getWinnerHandle() const; // INVALID_SYMBOL, если результатов нет
+    
+    // места участников, O(1) или O(log n) без пересчета
+    int getPlacement(std::string_view playerId) const; // 0, если игрок не участвовал
+    int getPlacement(SymbolId player) const;
+    Placement getStanding(size_t position) const; // участник на позиции position (с 0) по местам; {INVALID_SYMBOL, 0, 0} за концом
+    size_t getPodiumSize() const; // участников с местами 1-3 (при равных результатах их может быть больше трех)
+    std::vector<Placement> getPodium() const;
+    
+    bool operator<(const Match& other) const; // сравнение по дате (номера дней, без строк)
+    friend std::ostream& operator<<(std::ostream& os, const Match& match);
+    
+    void printInfo() const;
+    static void runTests();
+};
+
+#endif
+
@@ -0,0 +1,149 @@
+#include "MatchTimeIndex.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+void MatchTimeIndex::add(Match* match) {
+    int32_t day = match->getDay().getDayNumber();
+    // Дата не раньше последней - сразу на место; отложенные партии раньше нее, поэтому порядок не нарушается
+    if (days.empty() || day >= days.back()) {
+        days.push_back(day);
+        matches.push_back(match);
+    } else {
+        late.emplace_back(day, match);
+    }
+}
+
+void MatchTimeIndex::reserve(size_t count) {
+    days.reserve(count);
+    matches.reserve(count);
+}
+
+void MatchTimeIndex::mergeLate() const {
+    if (late.empty()) {
+        return;
+    }
+    // Отложенные - по дате с сохранением порядка добавления; при равной дате первыми идут влитые раньше
+    std::stable_sort(late.begin(), late.end(),
+                     [](const std::pair<int32_t, Match*>& a, const std::pair<int32_t, Match*>& b) {
+                         return a.first < b.first;
+                     });
+    std::vector<int32_t> mergedDays;
+    std::vector<Match*> mergedMatches;
+    mergedDays.reserve(days.size() + late.size());
+    mergedMatches.reserve(days.size() + late.size());
+    size_t i = 0;
+    size_t j = 0;
+    while (i < days.size() || j < late.size()) {
+        if (j == late.size() || (i < days.size() && days[i] <= late[j].first)) {
+            mergedDays.push_back(days[i]);
+            mergedMatches.push_back(matches[i]);
+            ++i;
+        } else {
+            mergedDays.push_back(late[j].first);
+            mergedMatches.push_back(late[j].second);
+            ++j;
+        }
+    }
+    days.swap(mergedDays);
+    matches.swap(mergedMatches);
+    late.clear();
+}
+
+size_t MatchTimeIndex::size() const {
+    return matches.size() + late.size();
+}
+
+MatchRange MatchTimeIndex::between(Date from, Date to) const {
+    mergeLate();
+    if (!from.isKnown() || !to.isKnown() || to < from) {
+        return MatchRange{nullptr, nullptr};
+    }
+    size_t first = std::lower_bound(days.begin(), days.end(), from.getDayNumber()) - days.begin();
+    size_t last = std::upper_bound(days.begin() + first, days.end(), to.getDayNumber()) - days.begin();
+    return MatchRange{matches.data() + first, matches.data() + last};
+}
+
+MatchRange MatchTimeIndex::all() const {
+    mergeLate();
+    return MatchRange{matches.data(), matches.data() + matches.size()};
+}
+
+void MatchTimeIndex::runTests() {
+    std::cout << "\n=== Тестирование класса MatchTimeIndex ===" << std::endl;
+
+    // партии вперемешку по датам: октябрь, сентябрь, ноябрь, снова октябрь, без даты
+    std::vector<Match*> owned;
+    MatchTimeIndex index;
+    auto add = [&](const std::string& id, const std::string& date) {
+        owned.push_back(new Match(id, "Время Каркассон", date));
+        index.add(owned.back());
+    };
+    add("time_1", "2024-10-05");
+    add("time_2", "2024-09-30");
+    add("time_3", "2024-11-01");
+    add("time_4", "2024-10-05");
+    add("time_5", "2024-10-31");
+    add("time_6", "");
+    add("time_7", "2024-10-01");
+
+    auto ids = [](MatchRange range) {
+        std::string result;
+        for (Match* match : range) {
+            result += match->getMatchId().back();
+        }
+        return result;
+    };
+
+    // Тест 1: Диапазон включает границы, равные даты - в порядке добавления
+    std::cout << "Тест 1 - Партии за месяц: ";
+    std::string october = ids(index.between(Date(2024, 10, 1), Date(2024, 10, 31)));
+    if (october == "7145" && index.size() == 7) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED (" << october << ")" << std::endl;
+    }
+
+    // Тест 2: Пустые и неверные диапазоны, неизвестная дата - в начале общего порядка
+    std::cout << "Тест 2 - Пустые диапазоны и неизвестная дата: ";
+    if (index.between(Date(2024, 10, 2), Date(2024, 10, 4)).empty() &&
+        index.between(Date(2024, 11, 1), Date(2024, 10, 1)).empty() &&
+        index.between(Date(), Date(2024, 12, 31)).empty() &&
+        ids(index.all()) == "6271453" && ids(index.between(Date(2024, 11, 1), Date(2030, 1, 1))) == "3") {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // Тест 3: Большой поток с опозданиями совпадает с сортировкой и перебором
+    MatchTimeIndex large;
+    std::vector<Match*> sorted;
+    for (int i = 0; i < 2000; ++i) {
+        Date day = Date(2024, 1, 1).addDays((i * 37) % 400);
+        owned.push_back(new Match("time_large_" + std::to_string(i), "Время Каркассон", day));
+        large.add(owned.back());
+        sorted.push_back(owned.back());
+        if (i % 500 == 0) large.between(Date(2024, 1, 1), Date(2024, 2, 1));  // слияние посреди потока
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Match* a, const Match* b) { return *a < *b; });
+    MatchRange spring = large.between(Date(2024, 3, 1), Date(2024, 5, 31));
+    size_t expected = 0;
+    for (const Match* match : sorted) {
+        expected += match->getDay() >= Date(2024, 3, 1) && match->getDay() <= Date(2024, 5, 31);
+    }
+    MatchRange everything = large.all();
+
+    std::cout << "Тест 3 - Слияние опоздавших партий: ";
+    if (spring.size() == expected && std::equal(everything.begin(), everything.end(), sorted.begin()) &&
+        everything.size() == sorted.size()) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    for (Match* match : owned) {
+        delete match;
+    }
+
+    std::cout << "=== Тестирование MatchTimeIndex завершено ===\n" << std::endl;
+}
@@ -0,0 +1,53 @@
+#ifndef MATCH_TIME_INDEX_H
+#define MATCH_TIME_INDEX_H
+
+#include "Match.h"
+#include "Date.h"
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+// Легковесный диапазон партий из индекса (без копирования)
+// Действителен до следующего добавления партии в базу
+struct MatchRange {
+    Match* const* first;
+    Match* const* last;
+
+    Match* const* begin() const { return first; }
+    Match* const* end() const { return last; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+    Match* operator[](size_t index) const { return first[index]; }
+};
+
+// Индекс партий по времени: номера дней и партии в двух параллельных массивах, упорядоченных по дате
+// (равные даты - в порядке добавления), поэтому диапазон дат - два бинарных поиска по массиву дней
+// и непрерывный участок массива партий, O(log n + k)
+// Партии обычно приходят по порядку дат и просто дописываются в конец; партия с датой раньше последней
+// откладывается и вливается в массивы при следующем запросе - одно слияние на всю пачку таких партий
+// Партии с неизвестной датой стоят в начале и в диапазоны дат не попадают
+class MatchTimeIndex {
+private:
+    mutable std::vector<int32_t> days;                     // Date::getDayNumber, по возрастанию
+    mutable std::vector<Match*> matches;                   // партии в том же порядке
+    mutable std::vector<std::pair<int32_t, Match*>> late;  // пришли не по порядку дат, еще не влиты
+
+    void mergeLate() const;
+
+public:
+    void add(Match* match);
+    void reserve(size_t count);
+
+    size_t size() const;
+
+    // Партии с from по to включительно
+    MatchRange between(Date from, Date to) const;
+
+    // Все партии по дате
+    MatchRange all() const;
+
+    static void runTests();
+};
+
+#endif
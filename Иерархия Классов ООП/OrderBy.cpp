@@ -0,0 +1,175 @@
+#include "OrderBy.h"
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <cstring>
+#include <iostream>
+
+SortKey SortKey::byRating(bool descending) {
+    return SortKey{SortField::AverageRating, descending, ""};
+}
+
+SortKey SortKey::byRatingCount(bool descending) {
+    return SortKey{SortField::RatingCount, descending, ""};
+}
+
+SortKey SortKey::byName(bool descending) {
+    return SortKey{SortField::Name, descending, ""};
+}
+
+SortKey SortKey::byMinPlayers(bool descending) {
+    return SortKey{SortField::MinPlayers, descending, ""};
+}
+
+SortKey SortKey::byMaxPlayers(bool descending) {
+    return SortKey{SortField::MaxPlayers, descending, ""};
+}
+
+SortKey SortKey::byMatchCount(bool descending) {
+    return SortKey{SortField::MatchCount, descending, ""};
+}
+
+SortKey SortKey::byFeature(const std::string& featureName, bool descending) {
+    return SortKey{SortField::Feature, descending, featureName};
+}
+
+PackedSortKeys::PackedSortKeys(size_t width) : width(width) {}
+
+void PackedSortKeys::reserve(size_t rows) {
+    keys.reserve(rows * width);
+    ids.reserve(rows);
+}
+
+uint64_t* PackedSortKeys::addRow(uint32_t id) {
+    ids.push_back(id);
+    keys.resize(keys.size() + width, 0);
+    return keys.data() + keys.size() - width;
+}
+
+size_t PackedSortKeys::rowCount() const {
+    return ids.size();
+}
+
+void PackedSortKeys::sort() {
+    size_t rows = ids.size();
+    std::vector<uint32_t> order(rows);
+    std::iota(order.begin(), order.end(), 0u);
+    std::vector<uint32_t> buffer(rows);
+
+    // младший ключ - первым; каждый проход устойчив, поэтому старшие ключи решают последними
+    for (size_t column = width; column-- > 0;) {
+        // гистограммы всех восьми байтов ключа за один проход по строкам
+        std::vector<std::array<size_t, 256>> counts(8);
+        for (auto& count : counts) {
+            count.fill(0);
+        }
+        for (size_t row = 0; row < rows; ++row) {
+            uint64_t key = keys[row * width + column];
+            for (int byte = 0; byte < 8; ++byte) {
+                ++counts[byte][(key >> (byte * 8)) & 0xFF];
+            }
+        }
+
+        for (int byte = 0; byte < 8; ++byte) {
+            std::array<size_t, 256>& count = counts[byte];
+            // байт одинаков у всех строк - проход ничего не изменит
+            if (std::find(count.begin(), count.end(), rows) != count.end()) {
+                continue;
+            }
+
+            size_t offset = 0;
+            for (size_t& bucket : count) {
+                size_t size = bucket;
+                bucket = offset;
+                offset += size;
+            }
+            for (uint32_t row : order) {
+                buffer[count[(keys[row * width + column] >> (byte * 8)) & 0xFF]++] = row;
+            }
+            order.swap(buffer);
+        }
+    }
+
+    std::vector<uint32_t> sorted(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        sorted[i] = ids[order[i]];
+    }
+    ids.swap(sorted);
+
+    std::vector<uint64_t> sortedKeys(keys.size());
+    for (size_t i = 0; i < rows; ++i) {
+        std::copy_n(keys.begin() + order[i] * width, width, sortedKeys.begin() + i * width);
+    }
+    keys.swap(sortedKeys);
+}
+
+const std::vector<uint32_t>& PackedSortKeys::sortedIds() const {
+    return ids;
+}
+
+uint64_t PackedSortKeys::encodeDouble(double value) {
+    // IEEE 754: у положительных чисел достаточно поднять знаковый бит,
+    // у отрицательных - инвертировать все биты (больший модуль - меньшее число)
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+}
+
+uint64_t PackedSortKeys::encodeInt(int64_t value) {
+    return static_cast<uint64_t>(value) ^ (uint64_t(1) << 63);
+}
+
+uint64_t PackedSortKeys::descending(uint64_t key) {
+    return ~key;
+}
+
+void PackedSortKeys::runTests() {
+    std::cout << "\n=== Тестирование класса PackedSortKeys ===" << std::endl;
+
+    double values[] = {-1e9, -2.5, -0.0, 0.0, 1e-300, 3.5, 4.0, 1e300};
+    bool ordered = true;
+    for (size_t i = 0; i + 1 < sizeof(values) / sizeof(values[0]); ++i) {
+        ordered = ordered && encodeDouble(values[i]) <= encodeDouble(values[i + 1]);
+    }
+    ordered = ordered && encodeInt(-5) < encodeInt(0) && encodeInt(0) < encodeInt(7) &&
+              descending(encodeInt(7)) < descending(encodeInt(0));
+
+    std::cout << "Тест 1 - Кодирование с сохранением порядка: ";
+    if (ordered) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // два ключа: первый с повторами, второй различает равные первые
+    PackedSortKeys table(2);
+    std::vector<std::pair<std::pair<uint64_t, uint64_t>, uint32_t>> expected;
+    uint64_t state = 12345;
+    for (uint32_t id = 0; id < 1000; ++id) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        uint64_t first = encodeInt(static_cast<int64_t>(state >> 60) - 8);
+        uint64_t second = descending(encodeDouble(static_cast<double>(state % 1000) / 7));
+        uint64_t* row = table.addRow(id);
+        row[0] = first;
+        row[1] = second;
+        expected.push_back(std::make_pair(std::make_pair(first, second), id));
+    }
+    table.sort();
+    std::stable_sort(expected.begin(), expected.end(),
+        [](const std::pair<std::pair<uint64_t, uint64_t>, uint32_t>& a,
+           const std::pair<std::pair<uint64_t, uint64_t>, uint32_t>& b) { return a.first < b.first; });
+
+    bool same = table.sortedIds().size() == expected.size();
+    for (size_t i = 0; same && i < expected.size(); ++i) {
+        same = table.sortedIds()[i] == expected[i].second;
+    }
+
+    std::cout << "Тест 2 - Поразрядная сортировка совпадает с устойчивой сортировкой: ";
+    if (same) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    std::cout << "=== Тестирование PackedSortKeys завершено ===\n" << std::endl;
+}
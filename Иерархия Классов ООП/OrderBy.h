@@ -0,0 +1,65 @@
+#ifndef ORDER_BY_H
+#define ORDER_BY_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// поле сортировки результатов поиска
+enum class SortField {
+    AverageRating,
+    RatingCount,
+    Name,
+    MinPlayers,
+    MaxPlayers,
+    MatchCount,
+    Feature // числовое значение признака; игры без признака (или с нечисловым значением) идут последними
+};
+
+// один ключ сортировки
+struct SortKey {
+    SortField field;
+    bool descending;
+    std::string featureName; // только для SortField::Feature
+
+    static SortKey byRating(bool descending = true);
+    static SortKey byRatingCount(bool descending = true);
+    static SortKey byName(bool descending = false);
+    static SortKey byMinPlayers(bool descending = false);
+    static SortKey byMaxPlayers(bool descending = false);
+    static SortKey byMatchCount(bool descending = true);
+    static SortKey byFeature(const std::string& featureName, bool descending = false);
+};
+
+// порядок: ключи по старшинству; при полном равенстве игры упорядочиваются по названию
+typedef std::vector<SortKey> OrderBy;
+
+// таблица упакованных ключей: по строке из width беззнаковых 64-битных чисел на игру
+// каждое поле кодируется так, что порядок чисел совпадает с нужным порядком значений,
+// поэтому строки сортируются поразрядно (LSD, по байту за проход) без вызова компаратора
+class PackedSortKeys {
+private:
+    size_t width;
+    std::vector<uint64_t> keys; // строка i - keys[i * width .. i * width + width)
+    std::vector<uint32_t> ids;  // номер игры строки
+
+public:
+    explicit PackedSortKeys(size_t width);
+
+    void reserve(size_t rows);
+    uint64_t* addRow(uint32_t id); // новая строка; ключи заполняет вызывающий
+
+    size_t rowCount() const;
+    void sort(); // устойчивая, по возрастанию ключей слева направо
+    const std::vector<uint32_t>& sortedIds() const;
+
+    // кодирование с сохранением порядка
+    static uint64_t encodeDouble(double value);
+    static uint64_t encodeInt(int64_t value);
+    static uint64_t descending(uint64_t key); // обратный порядок
+
+    static void runTests();
+};
+
+#endif
@@ -0,0 +1,335 @@
+#include "ParallelScan.h"
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <exception>
+#include <stdexcept>
+#include <chrono>
+
+namespace {
+
+std::atomic<size_t> threshold(ParallelScan::DEFAULT_THRESHOLD);
+std::atomic<uint64_t> stolen(0);
+thread_local bool insideChunk = false; // поток выполняет часть задания пула (вложенные проходы - без пула)
+
+// пул потоков с перехватом работы; участник 0 - вызывающий поток, остальные - потоки пула
+class WorkStealingPool {
+private:
+    // диапазон частей участника [front, back): владелец берет с начала, чужие - вторую половину с конца
+    struct Range {
+        std::mutex lock;
+        size_t front = 0;
+        size_t back = 0;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<Range>> ranges; // по участнику
+    std::mutex jobLock; // одно задание за раз
+    std::mutex stateLock;
+    std::condition_variable started;
+    std::condition_variable finished;
+    uint64_t generation; // номер текущего задания
+    size_t running; // потоков пула, еще не закончивших задание
+    bool stopping;
+    const std::function<void(size_t)>* body;
+    std::exception_ptr failure; // первое исключение задания
+
+    bool take(size_t self, size_t& chunk);
+    void participate(size_t self);
+    void work(size_t self);
+
+public:
+    explicit WorkStealingPool(size_t workerCount);
+    ~WorkStealingPool();
+
+    size_t size() const;
+
+    // false - пул занят другим заданием, ничего не выполнено
+    bool tryRun(size_t chunkCount, const std::function<void(size_t)>& task);
+};
+
+WorkStealingPool::WorkStealingPool(size_t workerCount)
+    : generation(0), running(0), stopping(false), body(nullptr) {
+    for (size_t i = 0; i <= workerCount; ++i) {
+        ranges.emplace_back(new Range());
+    }
+    for (size_t i = 1; i <= workerCount; ++i) {
+        workers.emplace_back(&WorkStealingPool::work, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> guard(stateLock);
+        stopping = true;
+    }
+    started.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+size_t WorkStealingPool::size() const {
+    return workers.size();
+}
+
+bool WorkStealingPool::take(size_t self, size_t& chunk) {
+    Range& own = *ranges[self];
+    {
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (own.front < own.back) {
+            chunk = own.front++;
+            return true;
+        }
+    }
+
+    // свой диапазон кончился: забираем вторую половину первого непустого чужого
+    for (size_t k = 1; k < ranges.size(); ++k) {
+        Range& victim = *ranges[(self + k) % ranges.size()];
+        size_t first = 0;
+        size_t last = 0;
+        {
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (victim.front == victim.back) {
+                continue;
+            }
+            first = victim.front + (victim.back - victim.front) / 2;
+            last = victim.back;
+            victim.back = first;
+        }
+        stolen.fetch_add(last - first, std::memory_order_relaxed);
+
+        chunk = first;
+        std::lock_guard<std::mutex> guard(own.lock);
+        own.front = first + 1;
+        own.back = last;
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::participate(size_t self) {
+    insideChunk = true;
+    size_t chunk = 0;
+    while (take(self, chunk)) {
+        try {
+            (*body)(chunk);
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(stateLock);
+            if (!failure) {
+                failure = std::current_exception();
+            }
+        }
+    }
+    insideChunk = false;
+}
+
+void WorkStealingPool::work(size_t self) {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> guard(stateLock);
+            started.wait(guard, [&]() { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+
+        participate(self);
+
+        std::lock_guard<std::mutex> guard(stateLock);
+        if (--running == 0) {
+            finished.notify_one();
+        }
+    }
+}
+
+bool WorkStealingPool::tryRun(size_t chunkCount, const std::function<void(size_t)>& task) {
+    std::unique_lock<std::mutex> busy(jobLock, std::try_to_lock);
+    if (!busy.owns_lock()) {
+        return false;
+    }
+
+    // начальная раздача: участнику i - i-я доля частей подряд
+    size_t participants = ranges.size();
+    for (size_t i = 0; i < participants; ++i) {
+        std::lock_guard<std::mutex> guard(ranges[i]->lock);
+        ranges[i]->front = chunkCount * i / participants;
+        ranges[i]->back = chunkCount * (i + 1) / participants;
+    }
+    {
+        std::lock_guard<std::mutex> guard(stateLock);
+        body = &task;
+        failure = nullptr;
+        running = workers.size();
+        ++generation;
+    }
+    started.notify_all();
+
+    participate(0);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> guard(stateLock);
+        finished.wait(guard, [&]() { return running == 0; });
+        body = nullptr;
+        error = failure;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return true;
+}
+
+std::mutex poolLock; // замена пула при смене числа потоков
+std::shared_ptr<WorkStealingPool> sharedPool;
+size_t requestedWorkers = 0;
+
+std::shared_ptr<WorkStealingPool> currentPool() {
+    std::lock_guard<std::mutex> guard(poolLock);
+    if (!sharedPool) {
+        size_t workers = requestedWorkers;
+        if (workers == 0) {
+            unsigned cores = std::thread::hardware_concurrency();
+            workers = cores > 1 ? cores - 1 : 0;
+        }
+        sharedPool = std::make_shared<WorkStealingPool>(workers);
+    }
+    return sharedPool;
+}
+
+}
+
+void ParallelScan::setThreshold(size_t items) {
+    threshold.store(items);
+}
+
+size_t ParallelScan::getThreshold() {
+    return threshold.load();
+}
+
+bool ParallelScan::worthParallel(size_t items) {
+    // без потоков пула разбиение на части только добавляет работы
+    return items >= threshold.load(std::memory_order_relaxed) && items > CHUNK_SIZE && currentPool()->size() > 0;
+}
+
+void ParallelScan::setWorkerCount(size_t workers) {
+    std::shared_ptr<WorkStealingPool> previous;
+    std::lock_guard<std::mutex> guard(poolLock);
+    requestedWorkers = workers;
+    previous.swap(sharedPool);  // прежний пул завершится, когда закончатся его задания
+}
+
+size_t ParallelScan::getWorkerCount() {
+    return currentPool()->size();
+}
+
+uint64_t ParallelScan::stolenChunks() {
+    return stolen.load();
+}
+
+void ParallelScan::forEachChunk(size_t chunkCount, const std::function<void(size_t)>& body) {
+    if (chunkCount == 0) {
+        return;
+    }
+
+    if (chunkCount > 1 && !insideChunk) {
+        std::shared_ptr<WorkStealingPool> pool = currentPool();
+        if (pool->size() > 0 && pool->tryRun(chunkCount, body)) {
+            return;
+        }
+    }
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        body(chunk);
+    }
+}
+
+void ParallelScan::runTests() {
+    std::cout << "\n=== Тестирование класса ParallelScan ===" << std::endl;
+
+    size_t savedThreshold = getThreshold();
+    setWorkerCount(3);
+    setThreshold(4 * CHUNK_SIZE);
+
+    // Тест 1: параллельный отбор дает тот же результат и порядок, что и последовательный
+    std::vector<int> numbers(100000);
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        numbers[i] = static_cast<int>((i * 7919) % 100003);
+    }
+    auto even = [](int value) { return value % 2 == 0; };
+    std::vector<int> parallel = select(numbers, even);
+    std::vector<int> expected;
+    for (int value : numbers) {
+        if (even(value)) expected.push_back(value);
+    }
+    std::vector<int> small(numbers.begin(), numbers.begin() + 100);
+    std::vector<int> smallResult = select(small, even);  // ниже порога - в вызывающем потоке
+    std::vector<int> smallExpected;
+    for (int value : small) {
+        if (even(value)) smallExpected.push_back(value);
+    }
+
+    std::cout << "Тест 1 - Порядок результата: ";
+    if (parallel == expected && smallResult == smallExpected && getWorkerCount() == 3) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // Тест 2: медленные части первого участника перехватываются, каждая часть выполняется один раз
+    const size_t chunkCount = 64;
+    std::vector<std::atomic<int>> runs(chunkCount);
+    for (std::atomic<int>& count : runs) {
+        count.store(0);
+    }
+    uint64_t stolenBefore = stolenChunks();
+    forEachChunk(chunkCount, [&](size_t chunk) {
+        if (chunk < chunkCount / 4) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        ++runs[chunk];
+    });
+    bool once = true;
+    for (std::atomic<int>& count : runs) {
+        once = once && count.load() == 1;
+    }
+
+    std::cout << "Тест 2 - Перехват работы: ";
+    if (once && stolenChunks() > stolenBefore) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // Тест 3: исключение части доходит до вызывающего, вложенный проход выполняется без пула
+    std::atomic<int> completed(0);
+    std::atomic<int> nested(0);
+    bool caught = false;
+    try {
+        forEachChunk(chunkCount, [&](size_t chunk) {
+            if (chunk == 5) {
+                throw std::runtime_error("часть 5");
+            }
+            forEachChunk(3, [&](size_t) { ++nested; });
+            ++completed;
+        });
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+
+    std::cout << "Тест 3 - Исключения и вложенные проходы: ";
+    if (caught && completed == static_cast<int>(chunkCount) - 1 && nested == 3 * (static_cast<int>(chunkCount) - 1)) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    setThreshold(savedThreshold);
+    setWorkerCount(0);
+
+    std::cout << "=== Тестирование ParallelScan завершено ===\n" << std::endl;
+}
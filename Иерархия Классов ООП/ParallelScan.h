@@ -0,0 +1,82 @@
+#ifndef PARALLEL_SCAN_H
+#define PARALLEL_SCAN_H
+
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+// параллельный проход по большим наборам (каталог игр, кандидаты фильтра)
+// набор делится на части по CHUNK_SIZE элементов; части выполняются пулом потоков с перехватом работы:
+// у каждого потока свой непрерывный диапазон частей, он берет их с начала, а освободившийся поток
+// забирает вторую половину чужого диапазона с конца
+// результаты частей складываются по номеру части, поэтому порядок результата не зависит от потоков
+// наборы меньше порога (и любые наборы, если у пула нет потоков) обрабатываются в вызывающем потоке без раздачи работы
+// пул общий на процесс; если он занят запросом другого потока, проход выполняется в вызывающем потоке
+class ParallelScan {
+public:
+    static const size_t CHUNK_SIZE = 2048; // элементов в части
+    static const size_t DEFAULT_THRESHOLD = 32768; // наименьший набор для параллельного прохода
+
+    // порог параллельного прохода (SIZE_MAX - всегда последовательно)
+    static void setThreshold(size_t items);
+    static size_t getThreshold();
+    static bool worthParallel(size_t items);
+
+    // число потоков пула помимо вызывающего (0 - по числу ядер минус один)
+    static void setWorkerCount(size_t workers);
+    static size_t getWorkerCount();
+
+    // сколько частей выполнено не тем потоком, которому они были выданы (для тестов и замеров)
+    static uint64_t stolenChunks();
+
+    // body(chunk) для каждой части 0..chunkCount-1; возвращается, когда выполнены все
+    // исключение из body передается вызывающему после завершения остальных частей
+    static void forEachChunk(size_t chunkCount, const std::function<void(size_t)>& body);
+
+    // emit(item, out) добавляет в out результаты для одного элемента; результаты - в порядке элементов
+    template <typename Out, typename T, typename Emit>
+    static std::vector<Out> collect(const std::vector<T>& items, Emit emit) {
+        std::vector<Out> result;
+        if (!worthParallel(items.size())) {
+            for (const T& item : items) {
+                emit(item, result);
+            }
+            return result;
+        }
+
+        size_t chunkCount = (items.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        std::vector<std::vector<Out>> parts(chunkCount);
+        forEachChunk(chunkCount, [&](size_t chunk) {
+            size_t last = std::min(items.size(), (chunk + 1) * CHUNK_SIZE);
+            for (size_t i = chunk * CHUNK_SIZE; i < last; ++i) {
+                emit(items[i], parts[chunk]);
+            }
+        });
+
+        size_t total = 0;
+        for (const std::vector<Out>& part : parts) {
+            total += part.size();
+        }
+        result.reserve(total);
+        for (const std::vector<Out>& part : parts) {
+            result.insert(result.end(), part.begin(), part.end());
+        }
+        return result;
+    }
+
+    // элементы, для которых keep(item) истинно, в исходном порядке
+    template <typename T, typename Keep>
+    static std::vector<T> select(const std::vector<T>& items, Keep keep) {
+        return collect<T>(items, [&](const T& item, std::vector<T>& out) {
+            if (keep(item)) {
+                out.push_back(item);
+            }
+        });
+    }
+
+    static void runTests();
+};
+
+#endif
@@ -0,0 +1,110 @@
+#include "PlayerGameStats.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+PlayerGameStats::PlayerGameStats()
+    : count(0), sum(0.0), minResult(0.0), maxResult(0.0), mean(0.0), m2(0.0), lastPlayed() {}
+
+void PlayerGameStats::addResult(double result, const std::string& date) {
+    addResult(result, Date::parse(date));
+}
+
+void PlayerGameStats::addResult(double result, Date date) {
+    if (count == 0) {
+        minResult = result;
+        maxResult = result;
+    } else {
+        minResult = std::min(minResult, result);
+        maxResult = std::max(maxResult, result);
+    }
+    
+    // шаг Уэлфорда: численно устойчивое обновление среднего и дисперсии
+    ++count;
+    sum += result;
+    double delta = result - mean;
+    mean += delta / count;
+    m2 += delta * (result - mean);
+    
+    if (date > lastPlayed) {
+        lastPlayed = date;
+    }
+}
+
+int PlayerGameStats::getCount() const {
+    return count;
+}
+
+double PlayerGameStats::getSum() const {
+    return sum;
+}
+
+double PlayerGameStats::getMin() const {
+    return minResult;
+}
+
+double PlayerGameStats::getMax() const {
+    return maxResult;
+}
+
+double PlayerGameStats::getMean() const {
+    return (count > 0) ? sum / count : 0.0;
+}
+
+double PlayerGameStats::getVariance() const {
+    return (count > 1) ? m2 / (count - 1) : 0.0;
+}
+
+double PlayerGameStats::getStdDev() const {
+    return std::sqrt(getVariance());
+}
+
+std::string PlayerGameStats::getLastPlayed() const {
+    return lastPlayed.toString();
+}
+
+Date PlayerGameStats::getLastPlayedDay() const {
+    return lastPlayed;
+}
+
+void PlayerGameStats::runTests() {
+    std::cout << "\n=== Тестирование класса PlayerGameStats ===" << std::endl;
+    
+    PlayerGameStats stats;
+    stats.addResult(85.0, "2024-01-16");
+    stats.addResult(95.0, "2024-03-02");
+    stats.addResult(90.0, "2024-02-10");
+    
+    std::cout << "Тест 1 - Количество, сумма, минимум и максимум: ";
+    if (stats.getCount() == 3 && stats.getSum() == 270.0 &&
+        stats.getMin() == 85.0 && stats.getMax() == 95.0) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    std::cout << "Тест 2 - Среднее и дисперсия: ";
+    if (stats.getMean() == 90.0 && std::abs(stats.getVariance() - 25.0) < 1e-9) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED (среднее " << stats.getMean() << ", дисперсия " << stats.getVariance() << ")" << std::endl;
+    }
+    
+    std::cout << "Тест 3 - Дата последней партии: ";
+    if (stats.getLastPlayed() == "2024-03-02") {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    PlayerGameStats empty;
+    
+    std::cout << "Тест 4 - Пустая статистика: ";
+    if (empty.getCount() == 0 && empty.getMean() == 0.0 && empty.getVariance() == 0.0) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    std::cout << "=== Тестирование PlayerGameStats завершено ===\n" << std::endl;
+}
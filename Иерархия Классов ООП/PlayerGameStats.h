@@ -0,0 +1,44 @@
+#ifndef PLAYER_GAME_STATS_H
+#define PLAYER_GAME_STATS_H
+
+#include "Date.h"
+#include <string>
+#include <cstdint>
+
+// накопленная статистика игрока в одной игре
+// обновляется за O(1) при каждой новой партии, дисперсия - по алгоритму Уэлфорда
+class PlayerGameStats {
+private:
+    int count; // число учтенных партий
+    double sum; // сумма результатов
+    double minResult;
+    double maxResult;
+    double mean; // текущее среднее
+    double m2; // сумма квадратов отклонений от среднего
+    Date lastPlayed; // самая поздняя дата партии
+    
+public:
+    PlayerGameStats();
+    
+    void addResult(double result, Date date);
+    void addResult(double result, const std::string& date); // дата YYYY-MM-DD
+    
+    int getCount() const;
+    double getSum() const;
+    double getMin() const;
+    double getMax() const;
+    double getMean() const; // 0, если партий нет
+    double getVariance() const; // выборочная дисперсия (0 при count < 2)
+    double getStdDev() const;
+    std::string getLastPlayed() const; // YYYY-MM-DD (пустая строка, если дат не было)
+    Date getLastPlayedDay() const;
+    
+    static void runTests();
+};
+
+// ключ пары (игрок, игра) в индексах статистики: номера из SymbolTable::players() и SymbolTable::games()
+inline uint64_t playerGameKey(uint32_t player, uint32_t game) {
+    return (static_cast<uint64_t>(player) << 32) | game;
+}
+
+#endif
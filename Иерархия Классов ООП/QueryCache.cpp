@@ -0,0 +1,318 @@
+#include "QueryCache.h"
+#include "BoardGame.h"
+#include "GameDatabase.h"
+#include "RatingFilter.h"
+#include "FeatureFilter.h"
+#include "SimilarGamesFilter.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+namespace {
+
+// служебная память записи: узел списка, узел индекса и заголовки векторов
+const size_t ENTRY_OVERHEAD = 128;
+
+}
+
+QueryCache::QueryCache(size_t memoryBudget)
+    : budget(memoryBudget), used(0), hits(0), misses(0), invalidations(0), evictions(0) {}
+
+// Фильтры между непереставляемыми сортируются по ключу, как их может переставить планировщик;
+// непереставляемый фильтр остается на месте и отмечается в отпечатке
+bool QueryCache::describe(const std::vector<Filter*>& filters, uint64_t catalogVersion,
+                          std::string& key, std::vector<uint64_t>& stamps) {
+    typedef std::pair<std::string, const Filter*> KeyedFilter;
+    std::vector<KeyedFilter> keyed;
+    for (const Filter* filter : filters) {
+        if (!filter) {
+            continue;
+        }
+        std::string filterKey = filter->cacheKey();
+        if (filterKey.empty()) {
+            return false;
+        }
+        keyed.emplace_back(filterKey, filter);
+    }
+    if (keyed.empty()) {
+        return false;
+    }
+
+    size_t segment = 0;
+    for (size_t i = 0; i <= keyed.size(); ++i) {
+        if (i == keyed.size() || !keyed[i].second->isCommutative()) {
+            std::sort(keyed.begin() + segment, keyed.begin() + i,
+                      [](const KeyedFilter& a, const KeyedFilter& b) { return a.first < b.first; });
+            segment = i + 1;
+        }
+    }
+
+    key.clear();
+    stamps.clear();
+    stamps.push_back(catalogVersion);
+    for (const KeyedFilter& filter : keyed) {
+        key += filter.second->isCommutative() ? "" : "|";
+        key += std::to_string(filter.first.size()) + ":" + filter.first;
+        filter.second->cacheStamps(stamps);
+    }
+    return true;
+}
+
+bool QueryCache::find(const std::string& key, const std::vector<uint64_t>& stamps, std::vector<BoardGame*>& games) {
+    if (budget == 0) {
+        return false;
+    }
+
+    auto found = index.find(key);
+    if (found == index.end()) {
+        ++misses;
+        return false;
+    }
+
+    EntryList::iterator entry = found->second;
+    bool valid = entry->stamps == stamps;
+    uint64_t ratingChanges = BoardGame::getRatingChangeCount();
+    if (valid && entry->checkedRatings != ratingChanges) {
+        for (size_t i = 0; valid && i < entry->games.size(); ++i) {
+            valid = entry->games[i]->getAverageRating() == entry->ratings[i];
+        }
+        entry->checkedRatings = ratingChanges;
+    }
+    if (!valid) {
+        erase(entry);
+        ++invalidations;
+        ++misses;
+        return false;
+    }
+
+    entries.splice(entries.begin(), entries, entry);
+    games = entry->games;
+    ++hits;
+    return true;
+}
+
+void QueryCache::store(const std::string& key, const std::vector<uint64_t>& stamps, const std::vector<BoardGame*>& games) {
+    auto found = index.find(key);
+    if (found != index.end()) {
+        erase(found->second);
+    }
+
+    size_t bytes = ENTRY_OVERHEAD + key.size() + stamps.size() * sizeof(uint64_t) +
+                   games.size() * (sizeof(BoardGame*) + sizeof(double));
+    if (bytes > budget) {
+        return;
+    }
+    evictTo(budget - bytes);
+
+    Entry entry;
+    entry.key = key;
+    entry.stamps = stamps;
+    entry.games = games;
+    entry.ratings.reserve(games.size());
+    for (const BoardGame* game : games) {
+        entry.ratings.push_back(game->getAverageRating());
+    }
+    entry.checkedRatings = BoardGame::getRatingChangeCount();
+    entry.bytes = bytes;
+
+    entries.push_front(std::move(entry));
+    index[entries.front().key] = entries.begin();
+    used += bytes;
+}
+
+void QueryCache::erase(EntryList::iterator entry) {
+    used -= entry->bytes;
+    index.erase(entry->key);
+    entries.erase(entry);
+}
+
+void QueryCache::evictTo(size_t limit) {
+    while (used > limit && !entries.empty()) {
+        erase(std::prev(entries.end()));
+        ++evictions;
+    }
+}
+
+void QueryCache::clear() {
+    index.clear();
+    entries.clear();
+    used = 0;
+}
+
+void QueryCache::setMemoryBudget(size_t bytes) {
+    budget = bytes;
+    evictTo(budget);
+}
+
+size_t QueryCache::getMemoryBudget() const {
+    return budget;
+}
+
+size_t QueryCache::getMemoryUsage() const {
+    return used;
+}
+
+size_t QueryCache::getEntryCount() const {
+    return entries.size();
+}
+
+uint64_t QueryCache::getHits() const {
+    return hits;
+}
+
+uint64_t QueryCache::getMisses() const {
+    return misses;
+}
+
+uint64_t QueryCache::getInvalidations() const {
+    return invalidations;
+}
+
+uint64_t QueryCache::getEvictions() const {
+    return evictions;
+}
+
+double QueryCache::getHitRate() const {
+    uint64_t lookups = hits + misses;
+    return lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups;
+}
+
+void QueryCache::printStatistics() const {
+    std::cout << "Кеш запросов: " << entries.size() << " записей, " << used / 1024 << " из " << budget / 1024
+              << " КБ; попаданий " << hits << ", промахов " << misses << " (" << std::fixed << std::setprecision(1)
+              << getHitRate() * 100.0 << "%), устарело " << invalidations << ", вытеснено " << evictions << std::endl;
+}
+
+void QueryCache::runTests() {
+    std::cout << "\n=== Тестирование класса QueryCache ===" << std::endl;
+
+    GameDatabase db;
+    const char* genres[] = {"Стратегия", "Семейная", "Кооператив"};
+    for (int i = 0; i < 30; ++i) {
+        BoardGame* game = new BoardGame("Кеш " + std::to_string(100 + i), "", 2, 4, "");
+        game->addFeature("Жанр", genres[i % 3]);
+        game->addRating("cache_critic", 1 + i % 5);
+        db.addGame(game);
+    }
+    db.addSimilarity("Кеш 100", "Кеш 101");
+    db.addPlayer(new Player("cache_player", "Кешев"));
+    db.addPlayer(new Player("cache_other", "Запросов"));
+
+    RatingFilter rated(4.0);
+    FeatureFilter strategy(std::map<std::string, std::string>{{"Жанр", "Стратегия"}});
+    SimilarGamesFilter similar({"Кеш 100"}, db.getSimilarityData());
+    std::vector<Filter*> both = {&rated, &strategy};
+    std::vector<Filter*> reversed = {&strategy, &rated};
+    std::vector<Filter*> byRating = {&rated};
+    std::vector<Filter*> byGenre = {&strategy};
+    std::vector<Filter*> bySimilarity = {&similar};
+    QueryCache& cache = db.getQueryCache();
+
+    // Тест 1: повтор запроса и та же цепочка в другом порядке читаются из кеша
+    std::vector<BoardGame*> first = db.findGames(both);
+    std::vector<BoardGame*> second = db.findGames(both);
+    std::vector<BoardGame*> swapped = db.findGames(reversed);
+    std::cout << "Тест 1 - Попадание по отпечатку цепочки: ";
+    if (!first.empty() && first == second && first == swapped && cache.getHits() == 2 && cache.getMisses() == 1 &&
+        cache.getEntryCount() == 1) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED (попаданий " << cache.getHits() << ", промахов " << cache.getMisses() << ")" << std::endl;
+    }
+
+    // Тест 2: изменение устаревает только записи, которые от него зависят
+    db.findGames(byRating);
+    db.findGames(byGenre);
+    db.findGames(bySimilarity);
+    auto hitsOf = [&](const std::vector<Filter*>& chain) {
+        uint64_t before = cache.getHits();
+        db.findGames(chain);
+        return cache.getHits() > before;
+    };
+
+    // признак, который запросы не проверяют (даже у найденной игры), и оценка игры вне результатов,
+    // не переходящая порог 4 (средний 1 -> 1.5)
+    db.addFeature("Кеш 103", "Время", "60");
+    db.addRating("Кеш 110", "cache_player", 2);
+    bool unrelated = hitsOf(byRating) && hitsOf(byGenre) && hitsOf(bySimilarity) && hitsOf(both);
+
+    // жанр игры, не проходящей порог рейтинга: устаревают только цепочки с жанром
+    db.updateFeature("Кеш 106", "Жанр", "Семейная");
+    bool genreChanged = hitsOf(byRating) && !hitsOf(byGenre) && !hitsOf(both) && hitsOf(bySimilarity);
+
+    // оценка переводит игру через порог, новая связь меняет только запрос схожести
+    db.addRating("Кеш 102", "cache_player", 5);
+    db.addRating("Кеш 102", "cache_other", 5);
+    bool ratingChanged = !hitsOf(byRating) && hitsOf(byGenre);
+    
+    // оценка найденной игры без перехода порога (5 -> 4.5) меняет порядок выдачи
+    db.addRating("Кеш 104", "cache_player", 4);
+    bool orderChanged = !hitsOf(byRating) && hitsOf(byGenre);
+    db.addSimilarity("Кеш 100", "Кеш 104");
+    bool similarityChanged = !hitsOf(bySimilarity) && hitsOf(byRating) && hitsOf(byGenre);
+
+    // новая игра меняет состав каталога: устаревает все
+    db.addGame(new BoardGame("Кеш новая", "", 2, 4, ""));
+    bool catalogChanged = !hitsOf(byRating) && !hitsOf(byGenre) && !hitsOf(bySimilarity);
+
+    std::cout << "Тест 2 - Устаревание по версиям: ";
+    if (unrelated && genreChanged && ratingChanged && orderChanged && similarityChanged && catalogChanged &&
+        cache.getInvalidations() >= 7) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED (" << unrelated << genreChanged << ratingChanged << orderChanged << similarityChanged
+                  << catalogChanged
+                  << ")" << std::endl;
+    }
+
+    // Тест 3: результаты из кеша совпадают с выполнением без кеша
+    size_t budget = cache.getMemoryBudget();
+    std::vector<std::vector<Filter*>> chains = {both, byRating, byGenre, bySimilarity};
+    std::vector<std::vector<BoardGame*>> cached;
+    for (const auto& chain : chains) {
+        db.findGames(chain);
+        cached.push_back(db.findGames(chain));
+    }
+    cache.setMemoryBudget(0);
+    bool sameResults = cache.getEntryCount() == 0;
+    for (size_t i = 0; i < chains.size(); ++i) {
+        sameResults = sameResults && db.findGames(chains[i]) == cached[i];
+    }
+    cache.setMemoryBudget(budget);
+
+    std::cout << "Тест 3 - Результаты как без кеша: ";
+    if (sameResults) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // Тест 4: бюджет памяти и вытеснение давно не читавшихся записей
+    QueryCache small(3 * 200);
+    std::vector<BoardGame*> result = {db.getGame("Кеш 100"), db.getGame("Кеш 101")};
+    std::vector<uint64_t> stamps = {1, 2};
+    std::vector<BoardGame*> out;
+    small.store("a", stamps, result);
+    small.store("b", stamps, result);
+    small.store("c", stamps, result);
+    bool readA = small.find("a", stamps, out);
+    small.store("d", stamps, result);  // вытесняет b - самую давнюю
+    bool lru = readA && small.find("a", stamps, out) && !small.find("b", stamps, out) &&
+               small.find("c", stamps, out) && small.find("d", stamps, out) && small.getEvictions() == 1;
+    bool staleStamps = !small.find("a", std::vector<uint64_t>{1, 3}, out) && small.getInvalidations() == 1;
+    std::vector<BoardGame*> huge(1000, db.getGame("Кеш 100"));
+    small.store("huge", stamps, huge);
+    bool bounded = !small.find("huge", stamps, out) && small.getMemoryUsage() <= small.getMemoryBudget();
+    small.setMemoryBudget(300);
+    bool shrunk = small.getEntryCount() <= 1 && small.getMemoryUsage() <= 300;
+
+    std::cout << "Тест 4 - Бюджет и LRU: ";
+    if (lru && staleStamps && bounded && shrunk) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED (" << lru << staleStamps << bounded << shrunk << ")" << std::endl;
+    }
+
+    cache.printStatistics();
+    std::cout << "=== Тестирование QueryCache завершено ===\n" << std::endl;
+}
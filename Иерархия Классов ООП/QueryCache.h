@@ -0,0 +1,89 @@
+#ifndef QUERY_CACHE_H
+#define QUERY_CACHE_H
+
+#include "Filter.h"
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+class BoardGame;
+
+// Кеш результатов цепочек фильтров (см. GameDatabase::findGames)
+// Ключ - отпечаток цепочки из ключей фильтров (Filter::cacheKey); переставляемые фильтры упорядочиваются,
+// поэтому одна и та же цепочка в другом порядке попадает в ту же запись
+// Запись хранит версии данных, от которых зависит отбор (версия состава каталога и Filter::cacheStamps),
+// и средние рейтинги найденных игр: по ним упорядочена выдача
+// Изменение игры, признака или графа схожести не очищает кеш: устаревшая запись обнаруживается при чтении
+// (версии не совпали) и удаляется, записи, не зависящие от изменения, остаются
+// Объем записей ограничен бюджетом памяти; при превышении вытесняются давно не читавшиеся (LRU)
+// Кешем пользуется один поток (писатель базы)
+class QueryCache {
+public:
+    static const size_t DEFAULT_BUDGET = 16 << 20; // байт
+
+private:
+    struct Entry {
+        std::string key;
+        std::vector<uint64_t> stamps;        // версии данных на момент выполнения
+        std::vector<BoardGame*> games;       // результат в порядке выдачи
+        std::vector<double> ratings;         // средние рейтинги игр результата
+        uint64_t checkedRatings;             // BoardGame::getRatingChangeCount() при последней проверке рейтингов
+        size_t bytes;
+    };
+    typedef std::list<Entry> EntryList;
+
+    EntryList entries;  // от недавно прочитанных к давним
+    std::unordered_map<std::string_view, EntryList::iterator> index;  // ключ - строка из записи
+    size_t budget;
+    size_t used;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t invalidations;  // устаревших записей удалено при чтении
+    uint64_t evictions;      // вытеснено по бюджету
+
+    void erase(EntryList::iterator entry);
+    void evictTo(size_t limit);  // вытеснять с конца, пока записи занимают больше limit
+
+public:
+    explicit QueryCache(size_t memoryBudget = DEFAULT_BUDGET);
+
+    QueryCache(const QueryCache&) = delete;
+    QueryCache& operator=(const QueryCache&) = delete;
+
+    // Отпечаток цепочки в key и текущие версии ее данных в stamps: catalogVersion (состав каталога)
+    // и версии фильтров; false, если результат не кешируется (цепочка пуста или у фильтра нет ключа)
+    static bool describe(const std::vector<Filter*>& filters, uint64_t catalogVersion,
+                         std::string& key, std::vector<uint64_t>& stamps);
+
+    // Результат по отпечатку, если запись есть, ее версии равны stamps и рейтинги игр результата те же
+    // Игры читаются только после сравнения версий: при удалении игры из каталога меняется catalogVersion
+    // Рейтинги сверяются, только если с прошлой проверки менялась хоть одна оценка (BoardGame::getRatingChangeCount)
+    bool find(const std::string& key, const std::vector<uint64_t>& stamps, std::vector<BoardGame*>& games);
+
+    // Запомнить результат (заменяет прежнюю запись); запись больше бюджета не сохраняется
+    void store(const std::string& key, const std::vector<uint64_t>& stamps, const std::vector<BoardGame*>& games);
+
+    void clear();
+
+    // Бюджет памяти; уменьшение сразу вытесняет лишнее, 0 выключает кеш
+    void setMemoryBudget(size_t bytes);
+    size_t getMemoryBudget() const;
+    size_t getMemoryUsage() const;  // примерный объем записей в байтах
+    size_t getEntryCount() const;
+
+    uint64_t getHits() const;
+    uint64_t getMisses() const;
+    uint64_t getInvalidations() const;
+    uint64_t getEvictions() const;
+    double getHitRate() const;  // доля попаданий среди обращений (0, если обращений не было)
+
+    void printStatistics() const;
+
+    static void runTests();
+};
+
+#endif
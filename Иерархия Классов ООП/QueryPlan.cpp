@@ -0,0 +1,167 @@
+#include "QueryPlan.h"
+#include "CatalogStats.h"
+#include <algorithm>
+#include <limits>
+#include <iostream>
+#include <iomanip>
+
+namespace {
+
+// до стольких фильтров в участке порядок ищется точно (перебор подмножеств, 2^k * k)
+const size_t EXACT_ORDER_LIMIT = 12;
+
+// стоимость шага в зависимости от числа кандидатов на входе
+struct CostModel {
+    double catalogSize;
+    bool columnar;
+    
+    double operator()(const FilterEstimate& estimate, double input) const {
+        // то же условие, что выбирает плотное представление CandidateSet
+        bool dense = input * 32 > catalogSize;
+        if (columnar && dense && estimate.scanCost >= 0.0) {
+            return estimate.scanCost;
+        }
+        return estimate.setupCost + estimate.costPerCandidate * input;
+    }
+};
+
+// порядок фильтров участка [first, last) с минимальной суммарной стоимостью
+// при равной стоимости сохраняется исходный порядок
+std::vector<size_t> orderSegment(const std::vector<FilterEstimate>& estimates, const CostModel& stepCost,
+                                 size_t first, size_t last, double input) {
+    size_t count = last - first;
+    std::vector<size_t> order;
+
+    if (count <= EXACT_ORDER_LIMIT) {
+        // cost[mask] - лучшая стоимость применения фильтров из mask в каком-либо порядке;
+        // выход после них от порядка не зависит: input * произведение долей
+        size_t full = size_t(1) << count;
+        std::vector<double> rows(full, input);
+        std::vector<double> cost(full, std::numeric_limits<double>::infinity());
+        std::vector<size_t> lastStep(full, 0);
+        cost[0] = 0.0;
+
+        for (size_t mask = 1; mask < full; ++mask) {
+            size_t lowest = __builtin_ctzll(mask);
+            rows[mask] = rows[mask & (mask - 1)] * estimates[first + lowest].selectivity;
+
+            // с конца: меньший номер вытесняет больший только при заметном выигрыше
+            for (size_t i = count; i-- > 0;) {
+                if (!(mask >> i & 1)) continue;
+                size_t previous = mask ^ (size_t(1) << i);
+                double candidate = cost[previous] + stepCost(estimates[first + i], rows[previous]);
+                bool unset = cost[mask] == std::numeric_limits<double>::infinity();
+                if (unset || candidate < cost[mask] - 1e-9 * std::max(1.0, cost[mask])) {
+                    cost[mask] = candidate;
+                    lastStep[mask] = i;
+                }
+            }
+        }
+
+        for (size_t mask = full - 1; mask != 0; mask ^= size_t(1) << lastStep[mask]) {
+            order.push_back(first + lastStep[mask]);
+        }
+        std::reverse(order.begin(), order.end());
+        return order;
+    }
+
+    // длинная цепочка: жадно по стоимости на отсеянного кандидата
+    for (size_t i = first; i < last; ++i) {
+        order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        auto rank = [&](size_t index) {
+            double perCandidate = stepCost(estimates[index], input) / std::max(input, 1.0);
+            return perCandidate / std::max(1.0 - estimates[index].selectivity, 1e-9);
+        };
+        return rank(a) < rank(b);
+    });
+    return order;
+}
+
+}
+
+QueryPlan QueryPlan::build(const std::vector<Filter*>& filters, const CatalogStats& stats, bool columnar) {
+    QueryPlan plan;
+    plan.catalogSize = stats.getGameCount();
+    CostModel stepCost{static_cast<double>(plan.catalogSize), columnar};
+    plan.estimatedCost = 0.0;
+    plan.originalCost = 0.0;
+    plan.reordered = false;
+
+    std::vector<const Filter*> chain;
+    std::vector<size_t> positions;
+    std::vector<FilterEstimate> estimates;
+    for (size_t i = 0; i < filters.size(); ++i) {
+        if (!filters[i]) continue;
+        FilterEstimate estimate = filters[i]->estimate(stats);
+        estimate.selectivity = std::min(std::max(estimate.selectivity, 0.0), 1.0);
+        chain.push_back(filters[i]);
+        positions.push_back(i);
+        estimates.push_back(estimate);
+    }
+
+    // стоимость исходного порядка - для сравнения в отчете
+    double rows = static_cast<double>(plan.catalogSize);
+    for (const FilterEstimate& estimate : estimates) {
+        plan.originalCost += stepCost(estimate, rows);
+        rows *= estimate.selectivity;
+    }
+
+    rows = static_cast<double>(plan.catalogSize);
+    size_t segmentStart = 0;
+    for (size_t i = 0; i <= chain.size(); ++i) {
+        bool barrier = i == chain.size() || !chain[i]->isCommutative();
+        if (!barrier) continue;
+
+        std::vector<size_t> order = orderSegment(estimates, stepCost, segmentStart, i, rows);
+        if (i < chain.size()) {
+            order.push_back(i);
+        }
+
+        for (size_t index : order) {
+            const FilterEstimate& estimate = estimates[index];
+            PlanStep step;
+            step.filter = chain[index];
+            step.position = positions[index];
+            step.selectivity = estimate.selectivity;
+            step.estimatedInput = rows;
+            step.estimatedOutput = rows * estimate.selectivity;
+            step.estimatedCost = stepCost(estimate, rows);
+            step.executed = false;
+            step.actualOutput = 0;
+
+            plan.reordered = plan.reordered || index != plan.steps.size();
+            plan.estimatedCost += step.estimatedCost;
+            rows = step.estimatedOutput;
+            plan.steps.push_back(step);
+        }
+        segmentStart = i + 1;
+    }
+
+    return plan;
+}
+
+void QueryPlan::printInfo() const {
+    std::cout << std::fixed << std::setprecision(1)
+              << "План запроса: игр в каталоге " << catalogSize
+              << ", оценка стоимости " << estimatedCost;
+    if (reordered) {
+        std::cout << " (в исходном порядке " << originalCost << ")";
+    }
+    std::cout << std::endl;
+
+    for (size_t i = 0; i < steps.size(); ++i) {
+        const PlanStep& step = steps[i];
+        std::cout << "  " << (i + 1) << ". ";
+        step.filter->printInfo();
+        std::cout << std::setprecision(2) << ": доля " << step.selectivity
+                  << std::setprecision(1) << ", вход ~" << step.estimatedInput
+                  << ", выход ~" << step.estimatedOutput
+                  << ", стоимость ~" << step.estimatedCost;
+        if (step.executed) {
+            std::cout << ", найдено " << step.actualOutput;
+        }
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef QUERY_PLAN_H
+#define QUERY_PLAN_H
+
+#include "Filter.h"
+#include <vector>
+#include <cstddef>
+
+class CatalogStats;
+
+// шаг плана: фильтр и его оценки на месте в выбранном порядке
+struct PlanStep {
+    const Filter* filter;
+    size_t position;          // место фильтра в цепочке, переданной вызывающим
+    double selectivity;
+    double estimatedInput;    // ожидаемое число кандидатов на входе
+    double estimatedOutput;
+    double estimatedCost;
+    bool executed;            // false, если до шага кандидатов не осталось
+    size_t actualOutput;      // фактическое число кандидатов после шага
+};
+
+// порядок применения цепочки фильтров
+// переставляемые фильтры (isCommutative) упорядочиваются по минимуму ожидаемой стоимости:
+// фильтр дешевле и избирательнее идет раньше и уменьшает вход следующих;
+// непереставляемый фильтр остается на своем месте и делит цепочку на независимые участки
+struct QueryPlan {
+    std::vector<PlanStep> steps;
+    size_t catalogSize;       // игр в каталоге на момент планирования
+    double estimatedCost;     // сумма по шагам
+    double originalCost;      // стоимость порядка, переданного вызывающим
+    bool reordered;           // порядок отличается от исходного
+
+    // nullptr в цепочке пропускаются
+    // columnar - фильтрам доступен столбцовый снимок: плотное множество кандидатов
+    // (больше 1/32 каталога) фильтр со scanCost >= 0 отбирает сканированием за scanCost
+    static QueryPlan build(const std::vector<Filter*>& filters, const CatalogStats& stats, bool columnar);
+
+    void printInfo() const;
+};
+
+#endif
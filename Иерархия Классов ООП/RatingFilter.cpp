@@ -1,92 +1,167 @@
-#include "RatingFilter.h"
-#include <iomanip>
-
-RatingFilter::RatingFilter(double minRating) : minRating(minRating) {}
-
-RatingFilter::~RatingFilter() {}
-
-std::vector<BoardGame*> RatingFilter::apply(const std::map<std::string, BoardGame*>& games) const {
-    std::vector<BoardGame*> result;
-    
-    // отбираем игры с рейтингом выше порога
-    for (const auto& pair : games) {
-        BoardGame* game = pair.second;
-        if (game && game->getAverageRating() >= minRating) {
-            result.push_back(game);
-        }
-    }
-    
-    return result;
-}
-
-void RatingFilter::printInfo() const {
-    std::cout << "RatingFilter[минимальный рейтинг >= " << std::fixed 
-              << std::setprecision(2) << minRating << "]";
-}
-
-double RatingFilter::getMinRating() const {
-    return minRating;
-}
-void RatingFilter::runTests() {
-    std::cout << "\n=== Тестирование класса RatingFilter ===" << std::endl;
-    
-    BoardGame* g1 = new BoardGame("Игра А", "Описание", 2, 4, "1-е издание");
-    BoardGame* g2 = new BoardGame("Игра Б", "Описание", 2, 6, "2-е издание");
-    BoardGame* g3 = new BoardGame("Игра В", "Описание", 3, 5, "1-е издание");
-    
-    g1->addRating("p1", 5);
-    g1->addRating("p2", 5);
-    
-    g2->addRating("p1", 3);
-    g2->addRating("p2", 4);
-    
-    g3->addRating("p1", 4);
-    g3->addRating("p2", 4);
-    g3->addRating("p3", 5);
-    
-    std::map<std::string, BoardGame*> games;
-    games["Игра А"] = g1;
-    games["Игра Б"] = g2;
-    games["Игра В"] = g3;
-    
-    RatingFilter filter1(4.0);
-    std::vector<BoardGame*> result1 = filter1.apply(games);
-    
-    std::cout << "Тест 1 - Фильтр рейтинг >= 4.0: ";
-    if (result1.size() == 2) {
-        std::cout << "PASSED (найдено " << result1.size() << " игры)" << std::endl;
-    } else {
-        std::cout << "FAILED (ожидалось 2, найдено " << result1.size() << ")" << std::endl;
-    }
-    
-    RatingFilter filter2(5.0);
-    std::vector<BoardGame*> result2 = filter2.apply(games);
-    
-    std::cout << "Тест 2 - Фильтр рейтинг >= 5.0: ";
-    if (result2.size() == 1) {
-        std::cout << "PASSED (найдено " << result2.size() << " игра)" << std::endl;
-    } else {
-        std::cout << "FAILED (ожидалось 1, найдено " << result2.size() << ")" << std::endl;
-    }
-    
-    RatingFilter filter3(6.0);
-    std::vector<BoardGame*> result3 = filter3.apply(games);
-    
-    std::cout << "Тест 3 - Фильтр рейтинг >= 6.0: ";
-    if (result3.empty()) {
-        std::cout << "PASSED (найдено 0 игр)" << std::endl;
-    } else {
-        std::cout << "FAILED (ожидалось 0, найдено " << result3.size() << ")" << std::endl;
-    }
-    
-    std::cout << "Тест 4 - Вывод информации: ";
-    filter1.printInfo();
-    std::cout << " - OK" << std::endl;
-    
-    delete g1;
-    delete g2;
-    delete g3;
-    
-    std::cout << "=== Тестирование RatingFilter завершено ===\n" << std::endl;
-}
-
+#include "RatingFilter.h"
+#include "CatalogStats.h"
+#include "CatalogColumns.h"
+#include <iomanip>
+#include <cstring>
+
+RatingFilter::RatingFilter(double minRating) : minRating(minRating) {}
+
+RatingFilter::~RatingFilter() {}
+
+std::vector<BoardGame*> RatingFilter::apply(const GameMap& games) const {
+    // отбираем игры с рейтингом выше порога
+    return acceptAll(games);
+}
+
+bool RatingFilter::accepts(const BoardGame& game) const {
+    return game.getAverageRating() >= minRating;
+}
+
+CandidateSet RatingFilter::select(const FilterContext& context, const CandidateSet& candidates) const {
+    // немного кандидатов - проверяем их по отдельности, иначе сканируем столбец целиком
+    if (!context.columns || !candidates.isDense()) {
+        return Filter::select(context, candidates);
+    }
+    
+    std::vector<uint64_t> bits;
+    context.columns->scanRatingAtLeast(minRating, bits);
+    CandidateSet result = candidates;
+    result.intersectWithBits(bits);
+    return result;
+}
+
+bool RatingFilter::readsGames(const FilterContext& context, const CandidateSet& candidates) const {
+    // сканирование столбца обходится без объектов игр
+    return !context.columns || !candidates.isDense();
+}
+
+FilterEstimate RatingFilter::estimate(const CatalogStats& stats) const {
+    // средний рейтинг читается за O(1), доля - по гистограмме средних; по столбцам - одно сканирование
+    double scanCost = FilterEstimate::COLUMN_SCAN_COST * stats.getGameCount();
+    return FilterEstimate{0.0, 1.0, stats.ratingAtLeast(minRating), scanCost};
+}
+
+// Ключ - точное значение порога (двоичное представление), чтобы близкие пороги не совпали
+std::string RatingFilter::cacheKey() const {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &minRating, sizeof(bits));
+    return "rating>=" + std::to_string(bits);
+}
+
+// Отбор меняется, только если средний рейтинг какой-либо игры пересек порог
+void RatingFilter::cacheStamps(std::vector<uint64_t>& stamps) const {
+    stamps.push_back(BoardGame::getRatingVersion(minRating));
+}
+
+void RatingFilter::printInfo() const {
+    std::cout << "RatingFilter[минимальный рейтинг >= " << std::fixed 
+              << std::setprecision(2) << minRating << "]";
+}
+
+double RatingFilter::getMinRating() const {
+    return minRating;
+}
+void RatingFilter::runTests() {
+    std::cout << "\n=== Тестирование класса RatingFilter ===" << std::endl;
+    
+    BoardGame* g1 = new BoardGame("Игра А", "Описание", 2, 4, "1-е издание");
+    BoardGame* g2 = new BoardGame("Игра Б", "Описание", 2, 6, "2-е издание");
+    BoardGame* g3 = new BoardGame("Игра В", "Описание", 3, 5, "1-е издание");
+    
+    g1->addRating("p1", 5);
+    g1->addRating("p2", 5);
+    
+    g2->addRating("p1", 3);
+    g2->addRating("p2", 4);
+    
+    g3->addRating("p1", 4);
+    g3->addRating("p2", 4);
+    g3->addRating("p3", 5);
+    
+    GameMap games;
+    games["Игра А"] = g1;
+    games["Игра Б"] = g2;
+    games["Игра В"] = g3;
+    
+    RatingFilter filter1(4.0);
+    std::vector<BoardGame*> result1 = filter1.apply(games);
+    
+    std::cout << "Тест 1 - Фильтр рейтинг >= 4.0: ";
+    if (result1.size() == 2) {
+        std::cout << "PASSED (найдено " << result1.size() << " игры)" << std::endl;
+    } else {
+        std::cout << "FAILED (ожидалось 2, найдено " << result1.size() << ")" << std::endl;
+    }
+    
+    RatingFilter filter2(5.0);
+    std::vector<BoardGame*> result2 = filter2.apply(games);
+    
+    std::cout << "Тест 2 - Фильтр рейтинг >= 5.0: ";
+    if (result2.size() == 1) {
+        std::cout << "PASSED (найдено " << result2.size() << " игра)" << std::endl;
+    } else {
+        std::cout << "FAILED (ожидалось 1, найдено " << result2.size() << ")" << std::endl;
+    }
+    
+    RatingFilter filter3(6.0);
+    std::vector<BoardGame*> result3 = filter3.apply(games);
+    
+    std::cout << "Тест 3 - Фильтр рейтинг >= 6.0: ";
+    if (result3.empty()) {
+        std::cout << "PASSED (найдено 0 игр)" << std::endl;
+    } else {
+        std::cout << "FAILED (ожидалось 0, найдено " << result3.size() << ")" << std::endl;
+    }
+    
+    std::cout << "Тест 4 - Вывод информации: ";
+    filter1.printInfo();
+    std::cout << " - OK" << std::endl;
+    
+    // Тест 5: большой каталог проверяется по частям параллельно, результат тот же, что и подряд
+    std::vector<BoardGame*> many;
+    std::vector<BoardGame*> byHandle;
+    GameMap manyGames;
+    for (int i = 0; i < 20000; ++i) {
+        BoardGame* game = new BoardGame("Параллельная " + std::to_string(i), "", 2, 4, "");
+        game->addRating("p1", 1 + (i * 7) % 5);
+        many.push_back(game);
+        manyGames[game->getName()] = game;
+        SymbolId handle = SymbolTable::games().intern(game->getName());
+        if (handle >= byHandle.size()) byHandle.resize(handle + static_cast<size_t>(1), nullptr);
+        byHandle[handle] = game;
+    }
+    CandidateSet everyGame(byHandle.size());
+    for (size_t id = 0; id < byHandle.size(); ++id) {
+        if (byHandle[id]) everyGame.add(static_cast<uint32_t>(id));
+    }
+    FilterContext pointersOnly{&byHandle, nullptr};
+    
+    size_t savedThreshold = ParallelScan::getThreshold();
+    ParallelScan::setThreshold(SIZE_MAX);
+    std::vector<BoardGame*> sequential = filter1.apply(manyGames);
+    std::vector<uint32_t> sequentialIds = filter1.select(pointersOnly, everyGame).toVector();
+    ParallelScan::setThreshold(4096);
+    ParallelScan::setWorkerCount(2);
+    std::vector<BoardGame*> parallel = filter1.apply(manyGames);
+    std::vector<uint32_t> parallelIds = filter1.select(pointersOnly, everyGame).toVector();
+    ParallelScan::setThreshold(savedThreshold);
+    ParallelScan::setWorkerCount(0);
+    
+    std::cout << "Тест 5 - Параллельная проверка большого каталога: ";
+    if (parallel == sequential && parallelIds == sequentialIds && parallel.size() == 8000 &&
+        parallelIds.size() == 8000) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    for (BoardGame* game : many) {
+        delete game;
+    }
+    
+    delete g1;
+    delete g2;
+    delete g3;
+    
+    std::cout << "=== Тестирование RatingFilter завершено ===\n" << std::endl;
+}
+
@@ -1,23 +1,29 @@
-#ifndef RATING_FILTER_H
-#define RATING_FILTER_H
-
-#include "Filter.h"
-#include "BoardGame.h"
-#include <iostream>
-
-// фильтр по минимальному рейтингу
-class RatingFilter : public Filter {
-private:
-    double minRating; // минимальный требуемый рейтинг
-    
-public:
-    explicit RatingFilter(double minRating);
-    virtual ~RatingFilter();
-    virtual std::vector<BoardGame*> apply(const std::map<std::string, BoardGame*>& games) const override;
-    virtual void printInfo() const override;
-    double getMinRating() const;
-    static void runTests();
-};
-
-#endif
-
+#ifndef RATING_FILTER_H
+#define RATING_FILTER_H
+
+#include "Filter.h"
+#include "BoardGame.h"
+#include <iostream>
+
+// фильтр по минимальному рейтингу
+class RatingFilter : public Filter {
+private:
+    double minRating; // минимальный требуемый рейтинг
+    
+public:
+    explicit RatingFilter(double minRating);
+    virtual ~RatingFilter();
+    virtual std::vector<BoardGame*> apply(const GameMap& games) const override;
+    virtual bool accepts(const BoardGame& game) const override;
+    virtual CandidateSet select(const FilterContext& context, const CandidateSet& candidates) const override;
+    virtual bool readsGames(const FilterContext& context, const CandidateSet& candidates) const override;
+    virtual FilterEstimate estimate(const CatalogStats& stats) const override;
+    virtual std::string cacheKey() const override;
+    virtual void cacheStamps(std::vector<uint64_t>& stamps) const override;
+    virtual void printInfo() const override;
+    double getMinRating() const;
+    static void runTests();
+};
+
+#endif
+
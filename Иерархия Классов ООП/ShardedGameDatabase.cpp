@@ -0,0 +1,854 @@
+#include "ShardedGameDatabase.h"
+#include "RatingFilter.h"
+#include "FeatureFilter.h"
+#include "SimilarGamesFilter.h"
+#include <iostream>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <atomic>
+
+namespace {
+
+// Слияние упорядоченных списков в один (куча из голов списков)
+// При равенстве элементов раньше идет элемент списка с меньшим номером
+template <typename T, typename Before>
+std::vector<T> mergeOrdered(const std::vector<std::vector<T>>& lists, Before before) {
+    std::vector<T> result;
+    size_t total = 0;
+    for (const std::vector<T>& list : lists) {
+        total += list.size();
+    }
+    result.reserve(total);
+
+    typedef std::pair<size_t, size_t> Head;  // (список, позиция)
+    auto after = [&](const Head& a, const Head& b) {
+        const T& x = lists[a.first][a.second];
+        const T& y = lists[b.first][b.second];
+        if (before(x, y)) return false;
+        if (before(y, x)) return true;
+        return a.first > b.first;
+    };
+    std::vector<Head> heads;
+    for (size_t i = 0; i < lists.size(); ++i) {
+        if (!lists[i].empty()) {
+            heads.push_back({i, 0});
+        }
+    }
+    std::make_heap(heads.begin(), heads.end(), after);
+    while (!heads.empty()) {
+        std::pop_heap(heads.begin(), heads.end(), after);
+        Head& head = heads.back();
+        result.push_back(lists[head.first][head.second]);
+        if (++head.second < lists[head.first].size()) {
+            std::push_heap(heads.begin(), heads.end(), after);
+        } else {
+            heads.pop_back();
+        }
+    }
+    return result;
+}
+
+// Порядок выдачи по умолчанию: рейтинг по убыванию, при равенстве - название по возрастанию
+bool rankedBefore(const BoardGame* a, const BoardGame* b) {
+    double ratingA = a->getAverageRating();
+    double ratingB = b->getAverageRating();
+    if (ratingA != ratingB) {
+        return ratingA > ratingB;
+    }
+    return a->getName() < b->getName();
+}
+
+// Игра результата с ключами сортировки (NaN - значения нет, такие игры последними)
+// Ключи считаются в шарде, направление уже учтено (по убыванию - со знаком минус)
+struct OrderedGame {
+    BoardGame* game;
+    std::vector<double> keys;
+};
+
+double numericFeature(const BoardGame& game, const std::string& featureName) {
+    const std::string& value = game.getFeature(featureName);
+    double number = 0.0;
+    std::from_chars_result parsed = std::from_chars(value.data(), value.data() + value.size(), number);
+    bool numeric = !value.empty() && parsed.ec == std::errc() && parsed.ptr == value.data() + value.size();
+    return numeric ? number : std::nan("");
+}
+
+OrderedGame orderedGame(BoardGame* game, const OrderBy& order, const GameDatabase& shard) {
+    OrderedGame row{game, std::vector<double>(order.size(), 0.0)};
+    for (size_t k = 0; k < order.size(); ++k) {
+        double key = 0.0;
+        switch (order[k].field) {
+            case SortField::AverageRating: key = game->getAverageRating(); break;
+            case SortField::RatingCount: key = static_cast<double>(game->getRatingsCount()); break;
+            case SortField::Name: continue;  // названия сравниваются как строки
+            case SortField::MinPlayers: key = game->getMinPlayers(); break;
+            case SortField::MaxPlayers: key = game->getMaxPlayers(); break;
+            case SortField::MatchCount: key = static_cast<double>(shard.matchesOfGame(game->getName()).size()); break;
+            case SortField::Feature: key = numericFeature(*game, order[k].featureName); break;
+        }
+        row.keys[k] = order[k].descending ? -key : key;
+    }
+    return row;
+}
+
+bool orderedBefore(const OrderedGame& a, const OrderedGame& b, const OrderBy& order) {
+    for (size_t k = 0; k < order.size(); ++k) {
+        if (order[k].field == SortField::Name) {
+            int compared = a.game->getName().compare(b.game->getName());
+            if (compared != 0) {
+                return order[k].descending ? compared > 0 : compared < 0;
+            }
+            continue;
+        }
+        double x = a.keys[k];
+        double y = b.keys[k];
+        bool missingX = x != x;
+        bool missingY = y != y;
+        if (missingX || missingY) {
+            if (missingX != missingY) return missingY;
+            continue;
+        }
+        if (x != y) return x < y;
+    }
+    return a.game->getName() < b.game->getName();
+}
+
+}
+
+// === Потоки шардов ===
+
+ShardedGameDatabase::ShardedGameDatabase(size_t shardCount) : gameCount(0) {
+    if (shardCount == 0) {
+        shardCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    shards.reserve(shardCount);
+    for (size_t i = 0; i < shardCount; ++i) {
+        shards.emplace_back(new Shard());
+        shards.back()->worker = std::thread(work, shards.back().get());
+    }
+}
+
+ShardedGameDatabase::~ShardedGameDatabase() {
+    // Поток шарда выполняет оставшиеся задания и завершается; базы шардов удаляют свои игры и партии
+    for (std::unique_ptr<Shard>& shard : shards) {
+        {
+            std::lock_guard<std::mutex> guard(shard->lock);
+            shard->stopping = true;
+        }
+        shard->wake.notify_one();
+    }
+    for (std::unique_ptr<Shard>& shard : shards) {
+        shard->worker.join();
+    }
+
+    for (auto& pair : players) {
+        delete pair.second;
+    }
+}
+
+void ShardedGameDatabase::work(Shard* shard) {
+    std::vector<std::function<void()>> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> guard(shard->lock);
+            shard->wake.wait(guard, [&]() { return shard->stopping || !shard->tasks.empty(); });
+            if (shard->tasks.empty()) {
+                return;  // остановка, и очередь пуста
+            }
+            // Забираем всю очередь разом: писатель не ждет, пока шард выполняет пачку
+            batch.assign(std::make_move_iterator(shard->tasks.begin()), std::make_move_iterator(shard->tasks.end()));
+            shard->tasks.clear();
+        }
+        for (std::function<void()>& task : batch) {
+            task();
+        }
+        batch.clear();
+    }
+}
+
+uint32_t ShardedGameDatabase::shardOf(std::string_view gameName) const {
+    return static_cast<uint32_t>(std::hash<std::string_view>()(gameName) % shards.size());
+}
+
+void ShardedGameDatabase::submit(uint32_t shard, std::function<void()> task) const {
+    Shard& target = *shards[shard];
+    {
+        std::lock_guard<std::mutex> guard(target.lock);
+        target.tasks.push_back(std::move(task));
+    }
+    target.wake.notify_one();
+}
+
+void ShardedGameDatabase::scatter(const std::function<void(uint32_t, GameDatabase&)>& task) const {
+    std::mutex doneLock;
+    std::condition_variable doneSignal;
+    size_t remaining = shards.size();
+
+    for (uint32_t i = 0; i < shards.size(); ++i) {
+        GameDatabase* db = &shards[i]->db;
+        submit(i, [&, i, db]() {
+            task(i, *db);
+            std::lock_guard<std::mutex> guard(doneLock);
+            if (--remaining == 0) {
+                doneSignal.notify_one();
+            }
+        });
+    }
+
+    std::unique_lock<std::mutex> guard(doneLock);
+    doneSignal.wait(guard, [&]() { return remaining == 0; });
+}
+
+void ShardedGameDatabase::ask(uint32_t shard, const std::function<void(GameDatabase&)>& task) const {
+    std::mutex doneLock;
+    std::condition_variable doneSignal;
+    bool done = false;
+    GameDatabase* db = &shards[shard]->db;
+    submit(shard, [&, db]() {
+        task(*db);
+        std::lock_guard<std::mutex> guard(doneLock);
+        done = true;
+        doneSignal.notify_one();
+    });
+
+    std::unique_lock<std::mutex> guard(doneLock);
+    doneSignal.wait(guard, [&]() { return done; });
+}
+
+bool ShardedGameDatabase::hasGame(SymbolId handle) const {
+    return handle < gamePresent.size() && gamePresent[handle];
+}
+
+size_t ShardedGameDatabase::getShardCount() const {
+    return shards.size();
+}
+
+void ShardedGameDatabase::flush() const {
+    scatter([](uint32_t, GameDatabase&) {});
+}
+
+// === Управление играми ===
+
+bool ShardedGameDatabase::addGame(BoardGame* game) {
+    if (!game) return false;
+
+    std::lock_guard<std::mutex> guard(lock);
+    SymbolId handle = SymbolTable::games().intern(game->getName());
+    if (hasGame(handle)) {
+        return false;  // Игра с таким названием уже существует
+    }
+    if (handle >= gamePresent.size()) {
+        gamePresent.resize(handle + static_cast<size_t>(1), 0);
+    }
+    gamePresent[handle] = 1;
+    ++gameCount;
+    // Оценки, выставленные до добавления, тоже учитываются при проверке повторов
+    if (!game->getRatings().empty()) {
+        std::unordered_set<SymbolId>& rated = raters[handle];
+        for (const auto& rating : game->getRatings()) {
+            rated.insert(rating.first);
+        }
+    }
+
+    GameDatabase* db = &shards[shardOf(game->getName())]->db;
+    submit(shardOf(game->getName()), [db, game]() { db->addGame(game); });
+    return true;
+}
+
+bool ShardedGameDatabase::removeGame(std::string_view gameName) {
+    std::lock_guard<std::mutex> guard(lock);
+    SymbolId handle = SymbolTable::games().find(gameName);
+    if (!hasGame(handle)) {
+        return false;
+    }
+    gamePresent[handle] = 0;
+    --gameCount;
+    raters.erase(handle);
+
+    uint32_t shard = shardOf(gameName);
+    GameDatabase* db = &shards[shard]->db;
+    submit(shard, [db, name = std::string(gameName)]() { db->removeGame(name); });
+    return true;
+}
+
+BoardGame* ShardedGameDatabase::getGame(std::string_view gameName) const {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!hasGame(SymbolTable::games().find(gameName))) {
+            return nullptr;
+        }
+    }
+    BoardGame* game = nullptr;
+    ask(shardOf(gameName), [&](GameDatabase& db) { game = db.getGame(gameName); });
+    return game;
+}
+
+size_t ShardedGameDatabase::getGameCount() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return gameCount;
+}
+
+GameMap ShardedGameDatabase::getAllGames() const {
+    std::vector<GameMap> lists(shards.size());
+    scatter([&](uint32_t i, GameDatabase& db) { lists[i] = db.getAllGames(); });
+
+    GameMap result;
+    for (const GameMap& games : lists) {
+        result.insert(games.begin(), games.end());
+    }
+    return result;
+}
+
+BoardGame* ShardedGameDatabase::operator[](std::string_view gameName) const {
+    return getGame(gameName);
+}
+
+// === Управление игроками ===
+
+bool ShardedGameDatabase::addPlayer(Player* player) {
+    if (!player) return false;
+
+    std::lock_guard<std::mutex> guard(lock);
+    std::string_view id = player->getPlayerId();
+    if (players.find(id) != players.end()) {
+        return false;  // Игрок с таким ID уже существует
+    }
+    players.emplace(id, player);
+
+    // Шарды получают только ID: по нему оценки проверяют игрока в порядке очереди шарда
+    for (uint32_t i = 0; i < shards.size(); ++i) {
+        GameDatabase* db = &shards[i]->db;
+        submit(i, [db, playerId = std::string(id)]() { db->addExternalPlayer(playerId); });
+    }
+    return true;
+}
+
+bool ShardedGameDatabase::removePlayer(std::string_view playerId) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = players.find(playerId);
+    if (it == players.end()) {
+        return false;
+    }
+
+    std::string id(playerId);
+    Player* player = it->second;
+    players.erase(it);
+    delete player;
+    for (uint32_t i = 0; i < shards.size(); ++i) {
+        GameDatabase* db = &shards[i]->db;
+        submit(i, [db, id]() { db->removeExternalPlayer(id); });
+    }
+    return true;
+}
+
+Player* ShardedGameDatabase::getPlayer(std::string_view playerId) const {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = players.find(playerId);
+    return (it != players.end()) ? it->second : nullptr;
+}
+
+// Копия, а не ссылка: addPlayer и removePlayer из других потоков меняют справочник под блокировкой
+std::map<std::string_view, Player*> ShardedGameDatabase::getAllPlayers() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return players;
+}
+
+// === Управление партиями ===
+
+bool ShardedGameDatabase::addMatch(Match* match) {
+    if (!match) return false;
+
+    std::lock_guard<std::mutex> guard(lock);
+    if (!hasGame(match->getGameHandle())) {
+        return false;  // Игра не найдена
+    }
+
+    uint32_t shard = shardOf(match->getGameName());
+    MatchEntry entry{shard, matchIndex.size()};
+    if (!matchIndex.emplace(match->getMatchHandle(), entry).second) {
+        return false;  // ID партии должен быть уникальным
+    }
+
+    // Общая история игроков ведется здесь, индексы и статистика - в шарде
+    for (const auto& playerResult : match->getPlayerResults()) {
+        auto player = players.find(SymbolTable::players().name(playerResult.first));
+        if (player != players.end()) {
+            player->second->addMatchToHistory(match->getMatchHandle());
+        }
+    }
+
+    GameDatabase* db = &shards[shard]->db;
+    submit(shard, [db, match]() { db->addMatch(match); });
+    return true;
+}
+
+Match* ShardedGameDatabase::getMatch(std::string_view matchId) const {
+    uint32_t shard;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = matchIndex.find(SymbolTable::matches().find(matchId));
+        if (it == matchIndex.end()) {
+            return nullptr;
+        }
+        shard = it->second.shard;
+    }
+    Match* match = nullptr;
+    ask(shard, [&](GameDatabase& db) { match = db.getMatch(matchId); });
+    return match;
+}
+
+size_t ShardedGameDatabase::getMatchCount() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return matchIndex.size();
+}
+
+std::vector<Match*> ShardedGameDatabase::getAllMatches() const {
+    std::vector<std::vector<Match*>> lists(shards.size());
+    scatter([&](uint32_t i, GameDatabase& db) { lists[i] = db.getAllMatches(); });
+
+    // Порядок добавления - в справочнике; партия попадает в него раньше, чем в очередь шарда
+    std::lock_guard<std::mutex> guard(lock);
+    return mergeOrdered(lists, [&](const Match* a, const Match* b) {
+        return matchIndex.at(a->getMatchHandle()).sequence < matchIndex.at(b->getMatchHandle()).sequence;
+    });
+}
+
+std::vector<Match*> ShardedGameDatabase::getMatchesByGame(std::string_view gameName) const {
+    std::vector<Match*> result;
+    ask(shardOf(gameName), [&](GameDatabase& db) { result = db.getMatchesByGame(gameName); });
+    return result;
+}
+
+std::vector<Match*> ShardedGameDatabase::getMatchesByPlayer(std::string_view playerId) const {
+    std::vector<std::vector<Match*>> lists(shards.size());
+    scatter([&](uint32_t i, GameDatabase& db) {
+        MatchRange range = db.matchesOfPlayer(playerId);
+        lists[i].assign(range.begin(), range.end());
+    });
+
+    std::lock_guard<std::mutex> guard(lock);
+    return mergeOrdered(lists, [&](const Match* a, const Match* b) {
+        return matchIndex.at(a->getMatchHandle()).sequence < matchIndex.at(b->getMatchHandle()).sequence;
+    });
+}
+
+std::vector<Match*> ShardedGameDatabase::getMatchesBetween(Date from, Date to) const {
+    std::vector<std::vector<Match*>> lists(shards.size());
+    scatter([&](uint32_t i, GameDatabase& db) {
+        MatchRange range = db.getMatchesBetween(from, to);
+        lists[i].assign(range.begin(), range.end());
+    });
+
+    std::lock_guard<std::mutex> guard(lock);
+    return mergeOrdered(lists, [&](const Match* a, const Match* b) {
+        if (a->getDay() != b->getDay()) return *a < *b;
+        return matchIndex.at(a->getMatchHandle()).sequence < matchIndex.at(b->getMatchHandle()).sequence;
+    });
+}
+
+std::vector<Match*> ShardedGameDatabase::getMatchesBetween(Date from, Date to, std::string_view gameName) const {
+    std::vector<Match*> result;
+    ask(shardOf(gameName), [&](GameDatabase& db) {
+        MatchRange range = db.getMatchesBetween(from, to, gameName);
+        result.assign(range.begin(), range.end());
+    });
+    return result;
+}
+
+// === Управление оценками ===
+
+bool ShardedGameDatabase::addRating(std::string_view gameName, std::string_view playerId, int rating) {
+    std::lock_guard<std::mutex> guard(lock);
+    SymbolId game = SymbolTable::games().find(gameName);
+    auto player = players.find(playerId);
+    if (!hasGame(game) || player == players.end() || rating < 1 || rating > 5) {
+        return false;
+    }
+    if (!raters[game].insert(player->second->getHandle()).second) {
+        return false;  // Игрок уже оценил игру
+    }
+
+    uint32_t shard = shardOf(gameName);
+    GameDatabase* db = &shards[shard]->db;
+    submit(shard, [db, name = std::string(gameName), id = std::string(playerId), rating]() {
+        db->addRating(name, id, rating);
+    });
+    return true;
+}
+
+// === Управление схожестью игр ===
+
+bool ShardedGameDatabase::addSimilarity(std::string_view game1, std::string_view game2) {
+    SymbolId handle1 = SymbolTable::games().find(game1);
+    SymbolId handle2 = SymbolTable::games().find(game2);
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!hasGame(handle1) || !hasGame(handle2) || handle1 == handle2) {
+            return false;
+        }
+    }
+
+    // Граф читается шардами во время поиска: связь добавляется, когда текущие поиски закончатся;
+    // справочник на это время уже отпущен, поэтому остальная запись поиски не ждет
+    std::unique_lock<std::shared_mutex> graphGuard(similarityLock);
+    similarGames.addEdge(handle1, handle2);
+    return true;
+}
+
+bool ShardedGameDatabase::areSimilar(std::string_view game1, std::string_view game2) const {
+    std::shared_lock<std::shared_mutex> graphGuard(similarityLock);
+    return similarGames.contains(SymbolTable::games().find(game1), SymbolTable::games().find(game2));
+}
+
+std::vector<std::string> ShardedGameDatabase::getSimilarGames(std::string_view gameName) const {
+    std::shared_lock<std::shared_mutex> graphGuard(similarityLock);
+    std::vector<std::string> result;
+    NeighborRange neighbors = similarGames.neighbors(SymbolTable::games().find(gameName));
+    result.reserve(neighbors.size());
+    for (SymbolId neighbor : neighbors) {
+        result.push_back(SymbolTable::games().name(neighbor));
+    }
+    return result;
+}
+
+const SimilarityGraph* ShardedGameDatabase::getSimilarityData() const {
+    return &similarGames;
+}
+
+void ShardedGameDatabase::compactSimilarity() {
+    std::unique_lock<std::shared_mutex> graphGuard(similarityLock);
+    similarGames.compact();
+}
+
+// === Статистика и аналитика ===
+
+double ShardedGameDatabase::getPlayerRatingInGame(std::string_view playerId, std::string_view gameName) const {
+    double result = 0.0;
+    ask(shardOf(gameName), [&](GameDatabase& db) { result = db.getPlayerRatingInGame(playerId, gameName); });
+    return result;
+}
+
+const PlayerGameStats* ShardedGameDatabase::getPlayerGameStats(std::string_view playerId, std::string_view gameName) const {
+    const PlayerGameStats* result = nullptr;
+    ask(shardOf(gameName), [&](GameDatabase& db) { result = db.getPlayerGameStats(playerId, gameName); });
+    return result;
+}
+
+const Leaderboard* ShardedGameDatabase::getLeaderboard(std::string_view gameName) const {
+    const Leaderboard* result = nullptr;
+    ask(shardOf(gameName), [&](GameDatabase& db) { result = db.getLeaderboard(gameName); });
+    return result;
+}
+
+void ShardedGameDatabase::setLeaderboardMetric(const LeaderboardMetric& metric) {
+    scatter([&](uint32_t, GameDatabase& db) { db.setLeaderboardMetric(metric); });
+}
+
+const SkillRating* ShardedGameDatabase::getSkillRating(std::string_view playerId, std::string_view gameName) const {
+    const SkillRating* result = nullptr;
+    ask(shardOf(gameName), [&](GameDatabase& db) { result = db.getSkillRating(playerId, gameName); });
+    return result;
+}
+
+void ShardedGameDatabase::recomputeSkillRatings() {
+    scatter([](uint32_t, GameDatabase& db) { db.recomputeSkillRatings(); });
+}
+
+std::vector<std::string> ShardedGameDatabase::getPlayerGames(std::string_view playerId) const {
+    std::vector<std::vector<std::string>> lists(shards.size());
+    scatter([&](uint32_t i, GameDatabase& db) { lists[i] = db.getPlayerGames(playerId); });
+
+    // Игра живет в одном шарде, поэтому списки не пересекаются
+    return mergeOrdered(lists, [](const std::string& a, const std::string& b) { return a < b; });
+}
+
+// === Фильтрация игр ===
+
+std::vector<BoardGame*> ShardedGameDatabase::findGames(Filter* filter) const {
+    if (!filter) {
+        return std::vector<BoardGame*>();
+    }
+
+    return findGames(std::vector<Filter*>{filter});
+}
+
+std::vector<BoardGame*> ShardedGameDatabase::findGames(const std::vector<Filter*>& filters) const {
+    if (filters.empty()) {
+        return std::vector<BoardGame*>();
+    }
+
+    std::shared_lock<std::shared_mutex> graphGuard(similarityLock);  // фильтр схожести читает граф координатора
+    std::vector<std::vector<BoardGame*>> lists(shards.size());
+    scatter([&](uint32_t i, GameDatabase& db) { lists[i] = db.findGames(filters); });
+    return mergeOrdered(lists, rankedBefore);
+}
+
+std::vector<BoardGame*> ShardedGameDatabase::findGames(const std::vector<Filter*>& filters, const OrderBy& order) const {
+    if (filters.empty()) {
+        return std::vector<BoardGame*>();
+    }
+
+    std::shared_lock<std::shared_mutex> graphGuard(similarityLock);
+    std::vector<std::vector<OrderedGame>> lists(shards.size());
+    scatter([&](uint32_t i, GameDatabase& db) {
+        std::vector<BoardGame*> found = db.findGames(filters, order);
+        lists[i].reserve(found.size());
+        for (BoardGame* game : found) {
+            lists[i].push_back(orderedGame(game, order, db));
+        }
+    });
+
+    std::vector<OrderedGame> merged = mergeOrdered(lists, [&](const OrderedGame& a, const OrderedGame& b) {
+        return orderedBefore(a, b, order);
+    });
+    std::vector<BoardGame*> result;
+    result.reserve(merged.size());
+    for (const OrderedGame& row : merged) {
+        result.push_back(row.game);
+    }
+    return result;
+}
+
+ResultPage ShardedGameDatabase::findGames(const std::vector<Filter*>& filters, size_t limit, const std::string& cursor) const {
+    ResultPage page;
+    page.hasMore = false;
+    if (filters.empty() || limit == 0) {
+        return page;
+    }
+
+    std::shared_lock<std::shared_mutex> graphGuard(similarityLock);
+    std::vector<ResultPage> pages(shards.size());
+    scatter([&](uint32_t i, GameDatabase& db) { pages[i] = db.findGames(filters, limit, cursor); });
+
+    std::vector<std::vector<BoardGame*>> lists(shards.size());
+    for (size_t i = 0; i < pages.size(); ++i) {
+        lists[i] = std::move(pages[i].games);
+        page.hasMore = page.hasMore || pages[i].hasMore;
+    }
+    page.games = mergeOrdered(lists, rankedBefore);
+    if (page.games.size() > limit) {
+        page.games.resize(limit);
+        page.hasMore = true;
+    }
+    if (page.hasMore) {
+        const BoardGame* last = page.games.back();
+        page.nextCursor = CatalogQuery::cursorAfter(last->getAverageRating(), last->getName());
+    }
+    return page;
+}
+
+// === Вывод информации ===
+
+void ShardedGameDatabase::printStatistics() const {
+    std::vector<size_t> perShard(shards.size());
+    scatter([&](uint32_t i, GameDatabase& db) { perShard[i] = db.getAllGames().size(); });
+    size_t edgeCount;
+    {
+        std::shared_lock<std::shared_mutex> graphGuard(similarityLock);
+        edgeCount = similarGames.edgeCount();
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    std::cout << "\n=== Статистика шардированной базы ===" << std::endl;
+    std::cout << "Шардов: " << shards.size() << std::endl;
+    std::cout << "Всего игр: " << gameCount << std::endl;
+    std::cout << "Всего игроков: " << players.size() << std::endl;
+    std::cout << "Всего партий: " << matchIndex.size() << std::endl;
+    std::cout << "Связей схожести: " << edgeCount << std::endl;
+    std::cout << "Игр по шардам:";
+    for (size_t count : perShard) {
+        std::cout << " " << count;
+    }
+    std::cout << std::endl;
+}
+
+// === Автоматические тесты ===
+
+void ShardedGameDatabase::runTests() {
+    std::cout << "\n=== Тестирование класса ShardedGameDatabase ===" << std::endl;
+
+    // Одинаковые данные в обычной и шардированной базе: результаты должны совпадать
+    GameDatabase single;
+    ShardedGameDatabase sharded(4);
+    const char* genres[] = {"Стратегия", "Семейная", "Кооператив"};
+    for (int g = 0; g < 40; ++g) {
+        std::string name = "Шард " + std::to_string(g);
+        for (int copy = 0; copy < 2; ++copy) {
+            BoardGame* game = new BoardGame(name, "", 1 + g % 3, 2 + g % 5, "");
+            game->addFeature("Жанр", genres[g % 3]);
+            game->addFeature("Время", std::to_string(30 + (g % 4) * 15));
+            if (copy == 0) single.addGame(game); else sharded.addGame(game);
+        }
+    }
+    for (int p = 0; p < 5; ++p) {
+        std::string id = "shard_player_" + std::to_string(p);
+        single.addPlayer(new Player(id));
+        sharded.addPlayer(new Player(id));
+        for (int g = p; g < 40; g += 3) {
+            int rating = 1 + (g * 7 + p) % 5;
+            single.addRating("Шард " + std::to_string(g), id, rating);
+            sharded.addRating("Шард " + std::to_string(g), id, rating);
+        }
+    }
+    for (int m = 0; m < 60; ++m) {
+        std::string id = "shard_match_" + std::to_string(m);
+        std::string game = "Шард " + std::to_string((m * 11) % 40);
+        for (int copy = 0; copy < 2; ++copy) {
+            Match* match = new Match(id, game, "2024-04-01");
+            match->addPlayerResult("shard_player_" + std::to_string(m % 5), m % 9);
+            match->addPlayerResult("shard_player_" + std::to_string((m + 2) % 5), m % 4);
+            if (copy == 0) single.addMatch(match); else sharded.addMatch(match);
+        }
+    }
+
+    // Тест 1: игры разошлись по шардам, справочник отклоняет повторы и партии без игры
+    BoardGame duplicate("Шард 3", "", 2, 4, "");
+    Match orphan("shard_orphan", "Нет такой игры", "2024-04-02");
+    Match repeated("shard_match_0", "Шард 1", "2024-04-02");
+    sharded.flush();
+    bool spread = true;
+    for (const std::unique_ptr<Shard>& shard : sharded.shards) {
+        spread = spread && !shard->db.getAllGames().empty() && shard->db.getAllPlayers().empty() &&
+                 shard->db.hasPlayer("shard_player_4");
+    }
+
+    std::cout << "Тест 1 - Распределение по шардам и проверка записей: ";
+    if (spread && sharded.getGameCount() == 40 && sharded.getAllGames().size() == 40 &&
+        !sharded.addGame(&duplicate) && !sharded.addMatch(&orphan) && !sharded.addMatch(&repeated) &&
+        !sharded.addRating("Шард 1", "shard_player_0", 6) && !sharded.addRating("Шард 3", "shard_player_0", 2) &&
+        sharded.getMatchCount() == 60 &&
+        sharded.getGame("Шард 7") && sharded.getGame("Шард 7")->getName() == "Шард 7") {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // Тест 2: партии игрока собираются из всех шардов в порядке добавления
+    auto ids = [](const std::vector<Match*>& list) {
+        std::vector<std::string> result;
+        for (Match* match : list) {
+            result.push_back(match->getMatchId());
+        }
+        return result;
+    };
+
+    MatchRange singleRange = single.getMatchesBetween(Date(2024, 1, 1), Date(2024, 12, 31));
+    std::vector<Match*> singleYear(singleRange.begin(), singleRange.end());
+
+    std::cout << "Тест 2 - Партии и статистика игрока по всем шардам: ";
+    if (ids(sharded.getMatchesByPlayer("shard_player_1")) == ids(single.getMatchesByPlayer("shard_player_1")) &&
+        ids(sharded.getAllMatches()) == ids(single.getAllMatches()) &&
+        ids(sharded.getMatchesBetween(Date(2024, 1, 1), Date(2024, 12, 31))) == ids(singleYear) &&
+        sharded.getPlayerGames("shard_player_2") == single.getPlayerGames("shard_player_2") &&
+        sharded.getPlayerRatingInGame("shard_player_1", "Шард 11") == single.getPlayerRatingInGame("shard_player_1", "Шард 11") &&
+        sharded.getLeaderboard("Шард 11") && single.getLeaderboard("Шард 11") &&
+        sharded.getLeaderboard("Шард 11")->rankOf("shard_player_1") == single.getLeaderboard("Шард 11")->rankOf("shard_player_1") &&
+        sharded.getSkillRating("shard_player_1", "Шард 11") &&
+        sharded.getSkillRating("shard_player_1", "Шард 11")->rating == single.getSkillRating("shard_player_1", "Шард 11")->rating &&
+        sharded.getPlayer("shard_player_1")->getMatchHistory() == single.getPlayer("shard_player_1")->getMatchHistory() &&
+        sharded.getMatch("shard_match_7") && sharded.getMatch("shard_match_7")->getGameName() == "Шард 37") {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // Тест 3: слияние результатов поиска совпадает с обычной базой (по рейтингу, ORDER BY, по страницам)
+    auto names = [](const std::vector<BoardGame*>& games) {
+        std::vector<std::string> result;
+        for (BoardGame* game : games) {
+            result.push_back(game->getName());
+        }
+        return result;
+    };
+    RatingFilter anyRating(0.0);
+    std::map<std::string, std::string> strategy;
+    strategy["Жанр"] = "Стратегия";
+    FeatureFilter genre(strategy);
+    std::vector<Filter*> all = {&anyRating};
+    std::vector<Filter*> strategies = {&anyRating, &genre};
+    OrderBy order{SortKey::byFeature("Время", true), SortKey::byMatchCount(), SortKey::byName(true)};
+
+    std::vector<std::string> paged;
+    std::string cursor;
+    int pageCount = 0;
+    do {
+        ResultPage page = sharded.findGames(all, 7, cursor);
+        std::vector<std::string> pageNames = names(page.games);
+        paged.insert(paged.end(), pageNames.begin(), pageNames.end());
+        cursor = page.nextCursor;
+        ++pageCount;
+    } while (!cursor.empty() && pageCount < 20);
+
+    std::cout << "Тест 3 - Слияние результатов поиска: ";
+    if (names(sharded.findGames(strategies)) == names(single.findGames(strategies)) &&
+        names(sharded.findGames(all, order)) == names(single.findGames(all, order)) &&
+        paged == names(single.findGames(all)) && pageCount == 6) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // Тест 4: схожесть между играми разных шардов
+    sharded.addSimilarity("Шард 0", "Шард 1");
+    sharded.addSimilarity("Шард 0", "Шард 2");
+    std::vector<std::string> refs = {"Шард 0"};
+    SimilarGamesFilter similar(refs, sharded.getSimilarityData());
+    std::vector<BoardGame*> similarGames = sharded.findGames(&similar);
+
+    std::cout << "Тест 4 - Схожесть между шардами: ";
+    if (similarGames.size() == 2 && sharded.areSimilar("Шард 2", "Шард 0") &&
+        sharded.getSimilarGames("Шард 0").size() == 2 && !sharded.addSimilarity("Шард 0", "Шард 0")) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // Тест 5: несколько потоков пишут одновременно (и регистрируют игроков и связи схожести,
+    // пока другой поток читает справочник и ищет игры), удаление видно в поиске
+    std::atomic<bool> writing(true);
+    std::thread playerReader([&sharded, &writing, &all]() {
+        size_t seen = 0;
+        while (writing.load()) {
+            seen = std::max(seen, sharded.getAllPlayers().size() + sharded.findGames(all).size());
+        }
+    });
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&sharded, t]() {
+            sharded.addPlayer(new Player("shard_parallel_player_" + std::to_string(t)));
+            sharded.addSimilarity("Шард " + std::to_string(30 + t), "Шард " + std::to_string(35 + t));
+            for (int m = 0; m < 250; ++m) {
+                Match* match = new Match("shard_parallel_" + std::to_string(t) + "_" + std::to_string(m),
+                                         "Шард " + std::to_string((t * 13 + m) % 40), "2024-04-03");
+                match->addPlayerResult("shard_player_" + std::to_string(t), m % 10);
+                if (!sharded.addMatch(match)) {
+                    delete match;
+                }
+            }
+        });
+    }
+    for (std::thread& writer : writers) {
+        writer.join();
+    }
+    writing = false;
+    playerReader.join();
+    sharded.removeGame("Шард 5");
+
+    std::cout << "Тест 5 - Параллельная запись: ";
+    if (sharded.getMatchCount() == 1060 && sharded.getAllMatches().size() == 1060 &&
+        sharded.getMatchesByPlayer("shard_player_3").size() == single.getMatchesByPlayer("shard_player_3").size() + 250 &&
+        !sharded.getGame("Шард 5") && sharded.findGames(all).size() == 39 && sharded.getAllPlayers().size() == 9 &&
+        sharded.removePlayer("shard_parallel_player_0") && !sharded.addRating("Шард 1", "shard_parallel_player_0", 3) &&
+        sharded.getAllPlayers().size() == 8 && sharded.areSimilar("Шард 38", "Шард 33")) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    sharded.printStatistics();
+
+    std::cout << "=== Тестирование ShardedGameDatabase завершено ===\n" << std::endl;
+}
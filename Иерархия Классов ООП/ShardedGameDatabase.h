@@ -0,0 +1,170 @@
+#ifndef SHARDED_GAME_DATABASE_H
+#define SHARDED_GAME_DATABASE_H
+
+#include "GameDatabase.h"
+#include <memory>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+
+// База, разделенная на шарды по хешу названия игры, с отдельным потоком на каждый шард
+// Шард - обычная GameDatabase со своими играми, их оценками, партиями и статистикой игроков в этих играх,
+// поэтому запись в игры разных шардов идет параллельно на разных ядрах
+// Интерфейс тот же, что у GameDatabase:
+//  - запись проверяется по справочнику координатора (какие игры, игроки, ID партий и оценки уже есть)
+//    и ставится в очередь шарда; результат true означает, что изменение принято
+//  - чтение выполняется потоком шарда после записей, поставленных раньше, поэтому видит все принятые изменения;
+//    запросы по всем играм рассылаются шардам, выполняются параллельно, и результаты сливаются
+//  - пока чтение ждет шарды, блокировка координатора не держится: запись в другие игры и шарды продолжается
+// Объекты игроков и их история партий - только у координатора, шарды знают лишь ID игроков
+// (GameDatabase::addExternalPlayer); граф схожести - один на всю базу у координатора
+// Методы можно вызывать из нескольких потоков: справочник защищен блокировкой координатора,
+// граф схожести - отдельной (поиск читает его в шардах, пока добавление связей ждет);
+// обе блокировки никогда не держатся вместе, поэтому добавление связи не задерживает остальную запись
+// Возвращенные игры и партии читать безопасно, пока в их шард не поступают новые записи
+class ShardedGameDatabase {
+private:
+    // Шард: база и поток, выполняющий задания из очереди по порядку
+    struct Shard {
+        GameDatabase db;
+        std::thread worker;
+        std::mutex lock;
+        std::condition_variable wake;
+        std::deque<std::function<void()>> tasks;
+        bool stopping = false;
+    };
+
+    // Партия в справочнике: шард и место в общем порядке добавления
+    struct MatchEntry {
+        uint32_t shard;
+        uint64_t sequence;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    mutable std::mutex lock;                              // справочник
+    mutable std::shared_mutex similarityLock;             // граф схожести (не берется под lock и наоборот)
+    std::vector<uint8_t> gamePresent;                     // номер игры -> есть ли игра в базе
+    size_t gameCount;
+    std::map<std::string_view, Player*> players;          // Игроки: ID -> объект (только здесь)
+    std::unordered_map<SymbolId, MatchEntry> matchIndex;  // номер ID партии -> шард и порядок
+    std::unordered_map<SymbolId, std::unordered_set<SymbolId>> raters;  // игра -> игроки, уже оценившие ее
+    SimilarityGraph similarGames;                         // Граф схожести по номерам игр всех шардов
+
+    static void work(Shard* shard);
+
+    // Шард игры по хешу названия
+    uint32_t shardOf(std::string_view gameName) const;
+
+    // Поставить задание в очередь шарда
+    void submit(uint32_t shard, std::function<void()> task) const;
+
+    // Выполнить задание в каждом шарде после уже поставленных и дождаться всех (задание получает номер шарда и его базу)
+    // Вызывается без блокировки координатора: пока шарды выполняют задание, запись продолжается
+    void scatter(const std::function<void(uint32_t, GameDatabase&)>& task) const;
+
+    // То же для одного шарда
+    void ask(uint32_t shard, const std::function<void(GameDatabase&)>& task) const;
+
+    bool hasGame(SymbolId handle) const;
+
+public:
+    // По шарду на ядро, если число не задано
+    explicit ShardedGameDatabase(size_t shardCount = 0);
+    ~ShardedGameDatabase();  // Дожидается очередей и освобождает всю память
+
+    ShardedGameDatabase(const ShardedGameDatabase&) = delete;
+    ShardedGameDatabase& operator=(const ShardedGameDatabase&) = delete;
+
+    size_t getShardCount() const;
+
+    // Дождаться выполнения всех принятых изменений
+    void flush() const;
+
+    // === Управление играми ===
+
+    bool addGame(BoardGame* game);
+    bool removeGame(std::string_view gameName);
+    BoardGame* getGame(std::string_view gameName) const;
+    size_t getGameCount() const;
+    GameMap getAllGames() const;  // Игры всех шардов (собирается при вызове)
+    BoardGame* operator[](std::string_view gameName) const;
+
+    // === Управление игроками ===
+
+    bool addPlayer(Player* player);
+    bool removePlayer(std::string_view playerId);
+    Player* getPlayer(std::string_view playerId) const;
+    std::map<std::string_view, Player*> getAllPlayers() const;  // Копия справочника на момент вызова
+
+    // === Управление партиями ===
+
+    // Партия уходит в шард своей игры; false, если игры нет или ID занят (владение не передается)
+    bool addMatch(Match* match);
+    Match* getMatch(std::string_view matchId) const;
+    size_t getMatchCount() const;
+
+    // Списки в порядке добавления во всю базу (слияние списков шардов)
+    std::vector<Match*> getAllMatches() const;
+    std::vector<Match*> getMatchesByGame(std::string_view gameName) const;
+    std::vector<Match*> getMatchesByPlayer(std::string_view playerId) const;
+
+    // Партии за период: по дате, равные даты - в порядке добавления во всю базу
+    std::vector<Match*> getMatchesBetween(Date from, Date to) const;
+    std::vector<Match*> getMatchesBetween(Date from, Date to, std::string_view gameName) const;
+
+    // === Управление оценками ===
+
+    // false, если игры или игрока нет, оценка вне 1..5 или игрок уже оценил игру (как в GameDatabase)
+    bool addRating(std::string_view gameName, std::string_view playerId, int rating);
+
+    // === Управление схожестью игр ===
+
+    bool addSimilarity(std::string_view game1, std::string_view game2);
+    bool areSimilar(std::string_view game1, std::string_view game2) const;
+    std::vector<std::string> getSimilarGames(std::string_view gameName) const;
+    const SimilarityGraph* getSimilarityData() const;  // Для SimilarGamesFilter: номера игр общие у всех шардов
+    void compactSimilarity();
+
+    // === Статистика и аналитика ===
+
+    double getPlayerRatingInGame(std::string_view playerId, std::string_view gameName) const;
+    const PlayerGameStats* getPlayerGameStats(std::string_view playerId, std::string_view gameName) const;
+    std::vector<std::string> getPlayerGames(std::string_view playerId) const;
+
+    // Таблица игры целиком в ее шарде; показатель меняется во всех шардах сразу
+    const Leaderboard* getLeaderboard(std::string_view gameName) const;
+    void setLeaderboardMetric(const LeaderboardMetric& metric);
+
+    // Рейтинги игры целиком в ее шарде; пересчет идет во всех шардах параллельно
+    const SkillRating* getSkillRating(std::string_view playerId, std::string_view gameName) const;
+    void recomputeSkillRatings();
+
+    // === Фильтрация игр ===
+    // Цепочка выполняется в каждом шарде (со своим планом), упорядоченные результаты сливаются
+
+    std::vector<BoardGame*> findGames(Filter* filter) const;
+    std::vector<BoardGame*> findGames(const std::vector<Filter*>& filters) const;
+    std::vector<BoardGame*> findGames(const std::vector<Filter*>& filters, const OrderBy& order) const;
+
+    // Каждый шард отдает не больше limit лучших после курсора, из них выбираются limit общих
+    ResultPage findGames(const std::vector<Filter*>& filters, size_t limit, const std::string& cursor) const;
+
+    // === Вывод информации ===
+
+    void printStatistics() const;
+
+    static void runTests();
+};
+
+#endif
@@ -0,0 +1,197 @@
+#include "SimilarityGraph.h"
+#include <algorithm>
+#include <queue>
+#include <functional>
+#include <iostream>
+
+std::atomic<uint64_t> SimilarityGraph::nextVersion(0);
+
+SimilarityGraph::SimilarityGraph() : compacted(false), edges(0), version(++nextVersion) {}
+
+SimilarityGraph::~SimilarityGraph() {}
+
+bool SimilarityGraph::addEdge(SymbolId game1, SymbolId game2) {
+    if (game1 == game2 || game1 == INVALID_SYMBOL || game2 == INVALID_SYMBOL) {
+        return false;
+    }
+    if (contains(game1, game2)) {
+        return false;
+    }
+
+    if (compacted) {
+        expand();
+    }
+
+    size_t needed = std::max(game1, game2) + static_cast<size_t>(1);
+    if (lists.size() < needed) {
+        lists.resize(needed);
+    }
+
+    // храним ребро в обоих направлениях, списки остаются отсортированными
+    std::vector<SymbolId>& first = lists[game1];
+    first.insert(std::lower_bound(first.begin(), first.end(), game2), game2);
+    std::vector<SymbolId>& second = lists[game2];
+    second.insert(std::lower_bound(second.begin(), second.end(), game1), game1);
+
+    ++edges;
+    version = ++nextVersion;
+    return true;
+}
+
+bool SimilarityGraph::contains(SymbolId game1, SymbolId game2) const {
+    NeighborRange range = neighbors(game1);
+    return std::binary_search(range.begin(), range.end(), game2);
+}
+
+NeighborRange SimilarityGraph::neighbors(SymbolId game) const {
+    if (compacted) {
+        if (static_cast<size_t>(game) + 1 >= offsets.size()) {
+            return NeighborRange{nullptr, nullptr};
+        }
+        const SymbolId* base = targets.data();
+        return NeighborRange{base + offsets[game], base + offsets[game + 1]};
+    }
+
+    if (game >= lists.size()) {
+        return NeighborRange{nullptr, nullptr};
+    }
+    const std::vector<SymbolId>& list = lists[game];
+    return NeighborRange{list.data(), list.data() + list.size()};
+}
+
+size_t SimilarityGraph::degree(SymbolId game) const {
+    return neighbors(game).size();
+}
+
+size_t SimilarityGraph::edgeCount() const {
+    return edges;
+}
+
+uint64_t SimilarityGraph::getVersion() const {
+    return version;
+}
+
+size_t SimilarityGraph::nodeCount() const {
+    return compacted ? (offsets.empty() ? 0 : offsets.size() - 1) : lists.size();
+}
+
+bool SimilarityGraph::isCompacted() const {
+    return compacted;
+}
+
+void SimilarityGraph::compact() {
+    if (compacted) {
+        return;
+    }
+
+    offsets.assign(lists.size() + 1, 0);
+    targets.clear();
+    targets.reserve(edges * 2);
+    for (size_t i = 0; i < lists.size(); ++i) {
+        offsets[i] = static_cast<uint32_t>(targets.size());
+        targets.insert(targets.end(), lists[i].begin(), lists[i].end());
+    }
+    offsets[lists.size()] = static_cast<uint32_t>(targets.size());
+
+    // освобождаем память списков целиком
+    std::vector<std::vector<SymbolId>>().swap(lists);
+    compacted = true;
+}
+
+void SimilarityGraph::expand() {
+    size_t nodes = offsets.empty() ? 0 : offsets.size() - 1;
+    lists.assign(nodes, std::vector<SymbolId>());
+    for (size_t i = 0; i < nodes; ++i) {
+        lists[i].assign(targets.begin() + offsets[i], targets.begin() + offsets[i + 1]);
+    }
+
+    std::vector<uint32_t>().swap(offsets);
+    std::vector<SymbolId>().swap(targets);
+    compacted = false;
+}
+
+std::vector<std::pair<SymbolId, int>> SimilarityGraph::scoreNeighbors(const std::vector<SymbolId>& references) const {
+    // k-путевое слияние отсортированных списков соседей:
+    // одинаковые номера идут подряд, их число и есть степень схожести
+    typedef std::pair<SymbolId, size_t> Head; // текущий номер, индекс списка
+    std::vector<NeighborRange> ranges;
+    std::vector<const SymbolId*> positions;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+
+    for (SymbolId reference : references) {
+        NeighborRange range = neighbors(reference);
+        if (!range.empty()) {
+            heads.push(Head(*range.begin(), ranges.size()));
+            ranges.push_back(range);
+            positions.push_back(range.begin());
+        }
+    }
+
+    std::vector<std::pair<SymbolId, int>> scores;
+    while (!heads.empty()) {
+        Head head = heads.top();
+        heads.pop();
+
+        if (!scores.empty() && scores.back().first == head.first) {
+            ++scores.back().second;
+        } else {
+            scores.push_back(std::make_pair(head.first, 1));
+        }
+
+        const SymbolId*& position = positions[head.second];
+        ++position;
+        if (position != ranges[head.second].end()) {
+            heads.push(Head(*position, head.second));
+        }
+    }
+
+    return scores;
+}
+
+void SimilarityGraph::runTests() {
+    std::cout << "\n=== Тестирование класса SimilarityGraph ===" << std::endl;
+
+    SimilarityGraph graph;
+    bool added = graph.addEdge(0, 1) && graph.addEdge(0, 2) && graph.addEdge(3, 1);
+    bool rejected = !graph.addEdge(1, 0) && !graph.addEdge(2, 2);
+
+    std::cout << "Тест 1 - Добавление ребер без повторов и петель: ";
+    if (added && rejected && graph.edgeCount() == 3 && graph.degree(1) == 2) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    graph.compact();
+    NeighborRange range = graph.neighbors(1);
+
+    std::cout << "Тест 2 - Чтение после укладки в CSR: ";
+    if (graph.isCompacted() && range.size() == 2 && range.begin()[0] == 0 && range.begin()[1] == 3 &&
+        graph.contains(2, 0) && !graph.contains(2, 3) && graph.neighbors(100).empty()) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    graph.addEdge(2, 3);
+
+    std::cout << "Тест 3 - Добавление после укладки: ";
+    if (!graph.isCompacted() && graph.edgeCount() == 4 && graph.contains(3, 2) && graph.contains(0, 1)) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // 0 и 3 оба схожи с 1 и 2
+    std::vector<std::pair<SymbolId, int>> scores = graph.scoreNeighbors({0, 3});
+
+    std::cout << "Тест 4 - Подсчет схожести слиянием списков: ";
+    if (scores.size() == 2 && scores[0] == std::make_pair(SymbolId(1), 2) &&
+        scores[1] == std::make_pair(SymbolId(2), 2)) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    std::cout << "=== Тестирование SimilarityGraph завершено ===\n" << std::endl;
+}
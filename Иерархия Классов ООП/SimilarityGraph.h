@@ -0,0 +1,64 @@
+#ifndef SIMILARITY_GRAPH_H
+#define SIMILARITY_GRAPH_H
+
+#include "SymbolTable.h"
+#include <vector>
+#include <utility>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// соседи игры в графе схожести: отсортированный по номеру непрерывный участок памяти
+struct NeighborRange {
+    const SymbolId* first;
+    const SymbolId* last;
+
+    const SymbolId* begin() const { return first; }
+    const SymbolId* end() const { return last; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+};
+
+// неориентированный граф схожести игр по номерам из SymbolTable::games()
+// пока граф наполняется, у каждой игры свой отсортированный список соседей;
+// compact() укладывает все списки в один массив (CSR: смещения + соседи) для быстрого чтения
+// чтение работает в обоих состояниях, добавление ребра после compact() распаковывает граф обратно
+class SimilarityGraph {
+private:
+    std::vector<std::vector<SymbolId>> lists; // списки соседей (режим наполнения)
+    std::vector<uint32_t> offsets; // CSR: соседи игры i лежат в [offsets[i], offsets[i+1])
+    std::vector<SymbolId> targets; // CSR: все списки соседей подряд
+    bool compacted; // граф уложен в CSR, lists пуст
+    size_t edges; // число неориентированных ребер
+    uint64_t version; // меняется при каждом изменении ребер (см. getVersion)
+
+    static std::atomic<uint64_t> nextVersion; // общий счетчик версий всех графов
+
+    void expand(); // CSR -> списки (перед изменением)
+
+public:
+    SimilarityGraph();
+    ~SimilarityGraph();
+
+    bool addEdge(SymbolId game1, SymbolId game2); // false для петли или повтора
+    bool contains(SymbolId game1, SymbolId game2) const; // O(log degree)
+    NeighborRange neighbors(SymbolId game) const; // O(1), соседи по возрастанию номера
+    size_t degree(SymbolId game) const;
+    size_t edgeCount() const;
+    size_t nodeCount() const; // размер пространства номеров (наибольший номер + 1)
+    bool isCompacted() const;
+    
+    // версия содержимого: новый граф и каждое добавленное ребро получают следующее значение общего счетчика,
+    // копия - версию оригинала, поэтому графы с одинаковой версией совпадают по ребрам (для кеша результатов)
+    uint64_t getVersion() const;
+
+    void compact(); // уложить граф в CSR
+
+    // для каждой игры - сколько образцов из списка с ней схожи (слияние списков соседей образцов)
+    // результат упорядочен по номеру игры; повтор образца в списке учитывается повторно
+    std::vector<std::pair<SymbolId, int>> scoreNeighbors(const std::vector<SymbolId>& references) const;
+
+    static void runTests();
+};
+
+#endif
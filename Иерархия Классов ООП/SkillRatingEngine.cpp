@@ -0,0 +1,319 @@
+#include "SkillRatingEngine.h"
+#include "ParallelScan.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+// Шкала Glicko-2: рейтинг 1500 и отклонение 350 переводятся в mu = 0 и phi = 350 / 173.7178
+const double GLICKO_SCALE = 173.7178;
+const double PI = 3.14159265358979323846;
+
+// Участник партии с рейтингом до нее
+struct Participant {
+    SymbolId player;
+    double result;
+    SkillRating before;
+};
+
+// Очки встречи a с b: победа 1, ничья 0.5, поражение 0
+double outcome(double a, double b) {
+    return a > b ? 1.0 : (a < b ? 0.0 : 0.5);
+}
+
+SkillRating updateElo(const SkillOptions& options, const std::vector<Participant>& field, size_t self) {
+    const Participant& me = field[self];
+    double surplus = 0.0;  // набранные очки встреч минус ожидаемые
+    for (size_t j = 0; j < field.size(); ++j) {
+        if (j == self) continue;
+        double expected = 1.0 / (1.0 + std::pow(10.0, (field[j].before.rating - me.before.rating) / 400.0));
+        surplus += outcome(me.result, field[j].result) - expected;
+    }
+    SkillRating after = me.before;
+    if (field.size() > 1) {
+        after.rating += options.eloK * surplus / (field.size() - 1);
+    }
+    return after;
+}
+
+// Шаг Glicko-2 (Glickman, "Example of the Glicko-2 system"): соперники - остальные участники партии
+SkillRating updateGlicko(const SkillOptions& options, const std::vector<Participant>& field, size_t self) {
+    const Participant& me = field[self];
+    double mu = (me.before.rating - 1500.0) / GLICKO_SCALE;
+    double phi = me.before.deviation / GLICKO_SCALE;
+    double sigma = me.before.volatility;
+    SkillRating after = me.before;
+
+    double inverseV = 0.0;
+    double scoreSum = 0.0;  // сумма g * (s - E)
+    for (size_t j = 0; j < field.size(); ++j) {
+        if (j == self) continue;
+        double muJ = (field[j].before.rating - 1500.0) / GLICKO_SCALE;
+        double phiJ = field[j].before.deviation / GLICKO_SCALE;
+        double g = 1.0 / std::sqrt(1.0 + 3.0 * phiJ * phiJ / (PI * PI));
+        double expected = 1.0 / (1.0 + std::exp(-g * (mu - muJ)));
+        inverseV += g * g * expected * (1.0 - expected);
+        scoreSum += g * (outcome(me.result, field[j].result) - expected);
+    }
+    if (inverseV == 0.0) {
+        return after;  // соперников нет: период без партий не меняет рейтинг
+    }
+    double v = 1.0 / inverseV;
+    double delta = v * scoreSum;
+
+    // Новая волатильность: корень f(x) = 0 методом Иллинойса
+    double tau = options.tau;
+    double a = std::log(sigma * sigma);
+    auto f = [&](double x) {
+        double ex = std::exp(x);
+        double denominator = phi * phi + v + ex;
+        return ex * (delta * delta - phi * phi - v - ex) / (2.0 * denominator * denominator) - (x - a) / (tau * tau);
+    };
+    double lower = a;
+    double upper;
+    if (delta * delta > phi * phi + v) {
+        upper = std::log(delta * delta - phi * phi - v);
+    } else {
+        int k = 1;
+        while (f(a - k * tau) < 0) {
+            ++k;
+        }
+        upper = a - k * tau;
+    }
+    double fLower = f(lower);
+    double fUpper = f(upper);
+    while (std::abs(upper - lower) > 1e-6) {
+        double middle = lower + (lower - upper) * fLower / (fUpper - fLower);
+        double fMiddle = f(middle);
+        if (fMiddle * fUpper <= 0) {
+            lower = upper;
+            fLower = fUpper;
+        } else {
+            fLower /= 2.0;
+        }
+        upper = middle;
+        fUpper = fMiddle;
+    }
+    double newSigma = std::exp(lower / 2.0);
+
+    double phiStar = std::sqrt(phi * phi + newSigma * newSigma);
+    double newPhi = 1.0 / std::sqrt(1.0 / (phiStar * phiStar) + 1.0 / v);
+    double newMu = mu + newPhi * newPhi * scoreSum;
+
+    after.rating = GLICKO_SCALE * newMu + 1500.0;
+    after.deviation = GLICKO_SCALE * newPhi;
+    after.volatility = newSigma;
+    return after;
+}
+
+}
+
+SkillRatingEngine::SkillRatingEngine(const Options& options) : options(options) {}
+
+void SkillRatingEngine::rate(const Options& options, const Match& match, GameRatings& ratings,
+                             std::vector<std::pair<SymbolId, double>>* changed) {
+    std::vector<Participant> field;
+    field.reserve(match.getPlayerResults().size());
+    for (const auto& playerResult : match.getPlayerResults()) {
+        if (playerResult.second < 0) continue;
+        SkillRating initial{options.initialRating, options.initialDeviation, options.initialVolatility, 0};
+        field.push_back(Participant{playerResult.first, playerResult.second,
+                                    ratings.emplace(playerResult.first, initial).first->second});
+    }
+
+    for (size_t i = 0; i < field.size(); ++i) {
+        SkillRating after = options.model == SkillModel::Elo ? updateElo(options, field, i)
+                                                             : updateGlicko(options, field, i);
+        ++after.matches;
+        ratings[field[i].player] = after;
+        if (changed) {
+            changed->emplace_back(field[i].player, after.rating);
+        }
+    }
+}
+
+const SkillRatingEngine::Options& SkillRatingEngine::getOptions() const {
+    return options;
+}
+
+void SkillRatingEngine::setOptions(const Options& newOptions) {
+    options = newOptions;
+}
+
+void SkillRatingEngine::addMatch(const Match& match) {
+    rate(options, match, games[match.getGameHandle()]);
+}
+
+void SkillRatingEngine::addMatches(MatchRange batch) {
+    GameRatings* ratings = nullptr;
+    SymbolId game = INVALID_SYMBOL;
+    for (const Match* match : batch) {
+        if (!ratings || match->getGameHandle() != game) {
+            game = match->getGameHandle();
+            ratings = &games[game];
+        }
+        rate(options, *match, *ratings);
+    }
+}
+
+void SkillRatingEngine::recompute(const std::vector<Match*>& matches) {
+    // Партии по играм; внутри игры - по дате, равные даты - в исходном порядке
+    std::unordered_map<SymbolId, size_t> slotOf;
+    std::vector<SymbolId> gameIds;
+    std::vector<std::vector<const Match*>> byGame;
+    for (const Match* match : matches) {
+        auto slot = slotOf.emplace(match->getGameHandle(), byGame.size());
+        if (slot.second) {
+            gameIds.push_back(match->getGameHandle());
+            byGame.emplace_back();
+        }
+        byGame[slot.first->second].push_back(match);
+    }
+
+    // Каждая игра проигрывается в своих рейтингах, поэтому игры не мешают друг другу
+    std::vector<GameRatings> results(byGame.size());
+    ParallelScan::forEachChunk(byGame.size(), [&](size_t game) {
+        std::vector<const Match*>& list = byGame[game];
+        std::stable_sort(list.begin(), list.end(),
+                         [](const Match* a, const Match* b) { return *a < *b; });
+        for (const Match* match : list) {
+            rate(options, *match, results[game]);
+        }
+    });
+
+    games.clear();
+    for (size_t i = 0; i < gameIds.size(); ++i) {
+        games.emplace(gameIds[i], std::move(results[i]));
+    }
+}
+
+void SkillRatingEngine::clear() {
+    games.clear();
+}
+
+const SkillRating* SkillRatingEngine::getRating(SymbolId player, SymbolId game) const {
+    const GameRatings* ratings = getGameRatings(game);
+    if (!ratings) {
+        return nullptr;
+    }
+    auto it = ratings->find(player);
+    return (it != ratings->end()) ? &it->second : nullptr;
+}
+
+const SkillRatingEngine::GameRatings* SkillRatingEngine::getGameRatings(SymbolId game) const {
+    auto it = games.find(game);
+    return (it != games.end()) ? &it->second : nullptr;
+}
+
+void SkillRatingEngine::runTests() {
+    std::cout << "\n=== Тестирование класса SkillRatingEngine ===" << std::endl;
+
+    SymbolTable& players = SymbolTable::players();
+    SymbolId chess = SymbolTable::games().intern("Сила Шахматы");
+
+    // Тест 1: Эло - победа над равным дает k/2, партия на троих сохраняет сумму рейтингов
+    Options elo;
+    elo.model = SkillModel::Elo;
+    SkillRatingEngine eloEngine(elo);
+    Match duel("skill_1", "Сила Шахматы", "2024-01-01");
+    duel.addPlayerResult("skill_anna", 1.0);
+    duel.addPlayerResult("skill_boris", 0.0);
+    eloEngine.addMatch(duel);
+    Match trio("skill_2", "Сила Шахматы", "2024-01-02");
+    trio.addPlayerResult("skill_anna", 3.0);
+    trio.addPlayerResult("skill_boris", 7.0);
+    trio.addPlayerResult("skill_vera", 7.0);
+    trio.addPlayerResult("skill_gleb", -1.0);
+    SkillRating annaAfterDuel = *eloEngine.getRating(players.find("skill_anna"), chess);
+    eloEngine.addMatch(trio);
+    const SkillRatingEngine::GameRatings* table = eloEngine.getGameRatings(chess);
+    double sum = 0.0;
+    for (const auto& entry : *table) {
+        sum += entry.second.rating;
+    }
+
+    std::cout << "Тест 1 - Эло: попарные встречи и сохранение суммы: ";
+    if (annaAfterDuel.rating == 1516.0 && annaAfterDuel.matches == 1 && table->size() == 3 &&
+        std::abs(sum - 4500.0) < 1e-9 && eloEngine.getRating(players.find("skill_anna"), chess)->matches == 2 &&
+        !eloEngine.getRating(players.find("skill_gleb"), chess)) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // Тест 2: Glicko-2 на примере Гликмана: 1500/200 против 1400/30 (победа), 1550/100 и 1700/300 (поражения)
+    Options glicko;
+    glicko.tau = 0.5;
+    SkillRatingEngine::GameRatings ratings;
+    ratings[players.intern("skill_hero")] = SkillRating{1500, 200, 0.06, 0};
+    ratings[players.intern("skill_p1")] = SkillRating{1400, 30, 0.06, 0};
+    ratings[players.intern("skill_p2")] = SkillRating{1550, 100, 0.06, 0};
+    ratings[players.intern("skill_p3")] = SkillRating{1700, 300, 0.06, 0};
+    Match period("skill_3", "Сила Шахматы", "2024-01-03");
+    period.addPlayerResult("skill_p1", 0);
+    period.addPlayerResult("skill_hero", 1);
+    period.addPlayerResult("skill_p2", 2);
+    period.addPlayerResult("skill_p3", 3);
+    std::vector<std::pair<SymbolId, double>> changed;
+    rate(glicko, period, ratings, &changed);
+    const SkillRating& hero = ratings[players.find("skill_hero")];
+
+    std::cout << "Тест 2 - Glicko-2 по эталонному примеру: ";
+    if (std::abs(hero.rating - 1464.06) < 0.01 && std::abs(hero.deviation - 151.52) < 0.01 &&
+        std::abs(hero.volatility - 0.05999) < 1e-5 && hero.matches == 1 && changed.size() == 4) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED (" << hero.rating << " " << hero.deviation << " " << hero.volatility << ")" << std::endl;
+    }
+
+    // Тест 3: Полный пересчет (параллельно по играм) - как добавление партий по дате
+    std::vector<Match*> history;
+    for (int i = 0; i < 400; ++i) {
+        std::string game = "Сила Игра " + std::to_string(i % 7);
+        std::string date = "2024-0" + std::to_string(1 + (i * 5) % 9) + "-1" + std::to_string(i % 10);
+        Match* match = new Match("skill_history_" + std::to_string(i), game, date);
+        for (int seat = 0; seat < 3; ++seat) {
+            match->addPlayerResult("skill_h" + std::to_string((i * 3 + seat) % 23), (i * 17 + seat * 5) % 11);
+        }
+        history.push_back(match);
+    }
+    std::vector<Match*> byDate = history;
+    std::stable_sort(byDate.begin(), byDate.end(),
+                     [](const Match* a, const Match* b) { return *a < *b; });
+    SkillRatingEngine incremental;
+    for (const Match* match : byDate) {
+        incremental.addMatch(*match);
+    }
+    ParallelScan::setWorkerCount(3);
+    SkillRatingEngine recomputed;
+    recomputed.addMatch(duel);  // пересчет заменяет все прежнее
+    recomputed.recompute(history);
+    ParallelScan::setWorkerCount(0);
+    bool same = !recomputed.getGameRatings(chess);
+    for (int g = 0; g < 7 && same; ++g) {
+        SymbolId game = SymbolTable::games().find("Сила Игра " + std::to_string(g));
+        const GameRatings* expected = incremental.getGameRatings(game);
+        const GameRatings* actual = recomputed.getGameRatings(game);
+        same = expected && actual && expected->size() == actual->size();
+        if (same) {
+            for (const auto& entry : *expected) {
+                const SkillRating* other = recomputed.getRating(entry.first, game);
+                same = same && other && other->rating == entry.second.rating &&
+                       other->deviation == entry.second.deviation && other->matches == entry.second.matches;
+            }
+        }
+    }
+    for (Match* match : history) {
+        delete match;
+    }
+
+    std::cout << "Тест 3 - Полный пересчет по дате: ";
+    if (same) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    std::cout << "=== Тестирование SkillRatingEngine завершено ===\n" << std::endl;
+}
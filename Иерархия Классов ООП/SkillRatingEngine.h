@@ -0,0 +1,86 @@
+#ifndef SKILL_RATING_ENGINE_H
+#define SKILL_RATING_ENGINE_H
+
+#include "Match.h"
+#include "SymbolTable.h"
+#include "MatchTimeIndex.h"
+#include <unordered_map>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+// Модель рейтинга силы
+enum class SkillModel {
+    Elo,      // рейтинг без оценки точности
+    Glicko2   // рейтинг, его отклонение (неуверенность) и волатильность
+};
+
+// Настройки рейтинга силы (см. SkillRatingEngine)
+struct SkillOptions {
+    SkillModel model = SkillModel::Glicko2;
+    double initialRating = 1500.0;
+    double eloK = 32.0;               // Эло: наибольшее изменение за партию
+    double initialDeviation = 350.0;  // Glicko-2: отклонение нового игрока
+    double initialVolatility = 0.06;  // Glicko-2: волатильность нового игрока
+    double tau = 0.5;                 // Glicko-2: насколько быстро может меняться волатильность
+};
+
+// Рейтинг силы игрока в одной игре
+struct SkillRating {
+    double rating;
+    double deviation;   // Glicko-2; у Эло не меняется
+    double volatility;  // Glicko-2; у Эло не меняется
+    int matches;        // учтенных партий
+};
+
+// Рейтинг силы игроков по играм (Эло или Glicko-2), сравнимый между играми в отличие от сырых результатов
+// (1/0 в шахматах и 85-102 очка в Каркассоне дают одну шкалу)
+// Партия на n участников - попарные встречи каждого с каждым: больший результат - победа, равный - ничья;
+// все встречи считаются по рейтингам до партии, результат меньше 0 не учитывается (как в PlayerGameStats)
+// У Эло изменение делится на число соперников; у Glicko-2 партия - отдельный рейтинговый период
+// Обновление при добавлении партии - O(n^2) для n участников, остальные игроки не затрагиваются
+// Полный пересчет проигрывает партии каждой игры по дате (при равных датах - в порядке добавления);
+// игры независимы, поэтому пересчитываются параллельно (ParallelScan)
+class SkillRatingEngine {
+public:
+    typedef SkillOptions Options;
+    typedef std::unordered_map<SymbolId, SkillRating> GameRatings;  // игрок -> рейтинг
+
+private:
+    Options options;
+    std::unordered_map<SymbolId, GameRatings> games;  // игра -> рейтинги ее игроков
+
+public:
+    explicit SkillRatingEngine(const Options& options = Options());
+
+    // Учесть партию в рейтингах ее игроков в этой игре; если changed не nullptr,
+    // в него дописываются участники и их новые рейтинги
+    static void rate(const Options& options, const Match& match, GameRatings& ratings,
+                     std::vector<std::pair<SymbolId, double>>* changed = nullptr);
+
+    const Options& getOptions() const;
+
+    // Новые настройки действуют для следующих партий; прежние рейтинги пересчитывает recompute
+    void setOptions(const Options& options);
+
+    void addMatch(const Match& match);
+
+    // То же для партий по порядку; рейтинги игры ищутся один раз на участок подряд идущих партий одной игры
+    void addMatches(MatchRange batch);
+
+    // Пересчитать все рейтинги заново по партиям (в любом порядке: они упорядочиваются по дате)
+    void recompute(const std::vector<Match*>& matches);
+
+    void clear();
+
+    // Рейтинг игрока в игре (nullptr, если он ее не играл)
+    const SkillRating* getRating(SymbolId player, SymbolId game) const;
+
+    // Рейтинги всех игроков игры (nullptr, если партий не было)
+    const GameRatings* getGameRatings(SymbolId game) const;
+
+    static void runTests();
+};
+
+#endif
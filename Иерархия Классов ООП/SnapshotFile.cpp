@@ -0,0 +1,1233 @@
+#include "SnapshotFile.h"
+#include "GameDatabase.h"
+#include "RatingFilter.h"
+#include "FeatureFilter.h"
+#include "SimilarGamesFilter.h"
+#include "SymbolTable.h"
+#include <iostream>
+#include <fstream>
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <cstdio>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// === Формат файла ===
+// Числа записываются в порядке байтов процессора (метка byteOrder отличает чужой порядок),
+// каждый раздел начинается с границы 8 байт; записи не содержат указателей, только номера
+
+struct SnapshotFile::GameRecord {
+    uint32_t name;          // строки
+    uint32_t description;
+    uint32_t edition;
+    int32_t minPlayers;
+    int32_t maxPlayers;
+    uint32_t reserved;
+    double averageRating;   // готовое значение для столбца, без прохода по оценкам
+};
+
+struct SnapshotFile::RatingRecord {
+    uint32_t player;        // строка ID игрока
+    int32_t rating;
+};
+
+struct SnapshotFile::FeatureRecord {
+    uint32_t name;
+    uint32_t value;
+};
+
+struct SnapshotFile::PlayerRecord {
+    uint32_t id;
+    uint32_t name;
+};
+
+struct SnapshotFile::MatchRecord {
+    uint32_t id;
+    uint32_t game;          // строка названия игры
+    int32_t day;            // Date::getDayNumber (Date::UNKNOWN - дата неизвестна)
+    uint32_t gameIndex;     // номер игры в файле (NO_INDEX - игры уже нет в базе)
+};
+
+struct SnapshotFile::ResultRecord {
+    uint32_t player;        // строка ID игрока
+    uint32_t reserved;
+    double result;
+};
+
+struct SnapshotFile::FeatureColumnRecord {
+    uint32_t name;
+    uint32_t firstValue;    // значения словаря - featureValues[firstValue, firstValue + valueCount)
+    uint32_t valueCount;
+    uint32_t reserved;
+};
+
+namespace {
+
+const char MAGIC[8] = {'B', 'G', 'S', 'N', 'A', 'P', '\r', '\n'}; // \r\n - порча при текстовой передаче видна сразу
+const uint32_t ORDER_MARK = 0x01020304;
+const uint32_t NO_INDEX = 0xFFFFFFFFu;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t formatVersion;
+    uint32_t byteOrder;
+    uint32_t sectionCount;
+    uint32_t reserved;
+    uint64_t fileSize;
+    uint64_t checksum;      // всех байтов после заголовка (каталог разделов и разделы)
+    uint64_t journalSequence;
+};
+
+struct SectionEntry {
+    uint32_t id;
+    uint32_t recordSize;    // проверяется при открытии: другой размер - другая раскладка записи
+    uint64_t offset;        // от начала файла
+    uint64_t count;
+};
+
+enum SectionId : uint32_t {
+    STRING_OFFSETS = 1, STRING_BYTES,
+    GAMES, GAME_RATINGS_AT, RATINGS, GAME_FEATURES_AT, FEATURES, GAME_MATCHES_AT, GAME_MATCHES, SIMILAR_AT, SIMILAR,
+    PLAYERS, PLAYER_HISTORY_AT, PLAYER_HISTORY, PLAYER_MATCHES_AT, PLAYER_MATCHES,
+    MATCHES, MATCH_RESULTS_AT, RESULTS, MATCHES_BY_ID,
+    FEATURE_COLUMNS, FEATURE_VALUES, FEATURE_CODES
+};
+
+inline uint64_t rotl(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// Контрольная сумма по 8-байтовым словам: раунд и завершение MurmurHash3 (x64), длина кратна 8
+uint64_t checksumOf(const uint8_t* data, size_t size) {
+    uint64_t hash = 0x9e3779b97f4a7c15ull ^ size;
+    for (size_t i = 0; i + 8 <= size; i += 8) {
+        uint64_t word = 0;
+        std::memcpy(&word, data + i, sizeof(word));
+        word *= 0x87c37b91114253d5ull;
+        word = rotl(word, 31);
+        word *= 0x4cf5ad432745937full;
+        hash ^= word;
+        hash = rotl(hash, 27) * 5 + 0x52dce729;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+// Таблица строк записи: одинаковые строки хранятся один раз, строка 0 - пустая
+// идентификаторы из SymbolTable узнаются по номеру, без хеширования самой строки
+class StringPool {
+private:
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<uint32_t> bySymbol[3]; // номер в таблице -> строка файла (NO_INDEX - еще не записана)
+
+    uint32_t append(std::string_view text) {
+        bytes.insert(bytes.end(), text.begin(), text.end());
+        offsets.push_back(bytes.size());
+        return static_cast<uint32_t>(offsets.size() - 2);
+    }
+
+public:
+    enum Table { GAMES, PLAYERS, MATCHES };
+
+    std::vector<uint64_t> offsets;
+    std::vector<char> bytes;
+
+    StringPool() : offsets(1, 0) {
+        ids.emplace(std::string(), append(std::string_view()));
+    }
+
+    uint32_t add(std::string_view text) {
+        auto it = ids.emplace(std::string(text), static_cast<uint32_t>(offsets.size() - 1));
+        if (it.second) {
+            append(text);
+        }
+        return it.first->second;
+    }
+
+    uint32_t add(Table table, SymbolId id) {
+        std::vector<uint32_t>& known = bySymbol[table];
+        if (id >= known.size()) {
+            known.resize(id + 1, NO_INDEX);
+        }
+        if (known[id] == NO_INDEX) {
+            const SymbolTable& symbols = table == GAMES ? SymbolTable::games()
+                                       : table == PLAYERS ? SymbolTable::players() : SymbolTable::matches();
+            known[id] = append(symbols.name(id));
+        }
+        return known[id];
+    }
+};
+
+// Разделы в порядке добавления; смещения назначаются при сборке файла
+class SectionWriter {
+private:
+    std::vector<SectionEntry> directory;
+    std::vector<uint8_t> body;
+
+public:
+    template <typename T>
+    void add(SectionId id, const std::vector<T>& records) {
+        SectionEntry entry{id, static_cast<uint32_t>(sizeof(T)), body.size(), records.size()};
+        directory.push_back(entry);
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(records.data());
+        body.insert(body.end(), bytes, bytes + records.size() * sizeof(T));
+        body.resize((body.size() + 7) / 8 * 8, 0);
+    }
+
+    // заголовок, каталог и разделы одним буфером
+    std::vector<uint8_t> assemble(uint64_t journalSequence) {
+        size_t start = sizeof(FileHeader) + directory.size() * sizeof(SectionEntry);
+        for (SectionEntry& entry : directory) {
+            entry.offset += start;
+        }
+
+        std::vector<uint8_t> file(start + body.size(), 0);
+        std::memcpy(file.data() + sizeof(FileHeader), directory.data(), directory.size() * sizeof(SectionEntry));
+        std::memcpy(file.data() + start, body.data(), body.size());
+
+        FileHeader header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.formatVersion = SnapshotFile::FORMAT_VERSION;
+        header.byteOrder = ORDER_MARK;
+        header.sectionCount = static_cast<uint32_t>(directory.size());
+        header.reserved = 0;
+        header.fileSize = file.size();
+        header.checksum = checksumOf(file.data() + sizeof(FileHeader), file.size() - sizeof(FileHeader));
+        header.journalSequence = journalSequence;
+        std::memcpy(file.data(), &header, sizeof(header));
+        return file;
+    }
+};
+
+bool fail(std::string* error, const std::string& message) {
+    if (error) *error = message;
+    return false;
+}
+
+// Записать буфер в файл и дождаться, пока он окажется на диске
+bool writeDurably(const std::string& path, const std::vector<uint8_t>& bytes) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    bool ok = true;
+    for (size_t done = 0; ok && done < bytes.size();) {
+        DWORD chunk = static_cast<DWORD>(std::min<size_t>(bytes.size() - done, 1 << 30));
+        DWORD written = 0;
+        ok = WriteFile(file, bytes.data() + done, chunk, &written, nullptr) && written > 0;
+        done += written;
+    }
+    ok = ok && FlushFileBuffers(file);
+    CloseHandle(file);
+    return ok;
+#else
+    int descriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (descriptor < 0) {
+        return false;
+    }
+    bool ok = true;
+    for (size_t done = 0; ok && done < bytes.size();) {
+        ssize_t written = ::write(descriptor, bytes.data() + done, bytes.size() - done);
+        ok = written > 0;
+        done += ok ? static_cast<size_t>(written) : 0;
+    }
+    ok = fsync(descriptor) == 0 && ok;
+    close(descriptor);
+    return ok;
+#endif
+}
+
+}
+
+// === Отображение файла в память ===
+
+struct SnapshotFile::Mapping {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE section = nullptr;
+#endif
+
+    bool open(const std::string& path, std::string& error);
+    ~Mapping();
+};
+
+#ifdef _WIN32
+
+bool SnapshotFile::Mapping::open(const std::string& path, std::string& error) {
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER length;
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &length)) {
+        error = "не удалось открыть файл " + path;
+        return false;
+    }
+    size = static_cast<size_t>(length.QuadPart);
+    if (size < sizeof(FileHeader)) {
+        error = "файл короче заголовка";
+        return false;
+    }
+    section = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    data = section ? static_cast<const uint8_t*>(MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+    if (!data) {
+        error = "не удалось отобразить файл в память";
+        return false;
+    }
+    return true;
+}
+
+SnapshotFile::Mapping::~Mapping() {
+    if (data) UnmapViewOfFile(data);
+    if (section) CloseHandle(section);
+    if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+}
+
+#else
+
+bool SnapshotFile::Mapping::open(const std::string& path, std::string& error) {
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    struct stat info;
+    if (descriptor < 0 || fstat(descriptor, &info) != 0) {
+        if (descriptor >= 0) close(descriptor);
+        error = "не удалось открыть файл " + path;
+        return false;
+    }
+    size = static_cast<size_t>(info.st_size);
+    if (size < sizeof(FileHeader)) {
+        close(descriptor);
+        error = "файл короче заголовка";
+        return false;
+    }
+
+    // отображение остается действительным и после закрытия дескриптора
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (mapped == MAP_FAILED) {
+        error = "не удалось отобразить файл в память";
+        return false;
+    }
+    data = static_cast<const uint8_t*>(mapped);
+    return true;
+}
+
+SnapshotFile::Mapping::~Mapping() {
+    if (data) munmap(const_cast<uint8_t*>(data), size);
+}
+
+#endif
+
+// === Запись ===
+
+bool SnapshotFile::write(const GameDatabase& db, const std::string& path, std::string* error, uint64_t journalSequence) {
+    StringPool strings;
+    const GameMap& catalog = db.getAllGames();
+    const std::vector<Match*>& allMatches = db.getAllMatches();
+    const CatalogColumns& catalogColumns = db.getCatalogColumns();
+
+    // Игры по названию (порядок GameMap), их номера в файле по номеру SymbolTable
+    std::vector<GameRecord> gameRecords;
+    std::vector<SymbolId> handles;
+    std::unordered_map<SymbolId, uint32_t> gameIndex;
+    gameRecords.reserve(catalog.size());
+    for (const auto& entry : catalog) {
+        const BoardGame& game = *entry.second;
+        SymbolId handle = SymbolTable::games().find(entry.first);
+        gameIndex.emplace(handle, static_cast<uint32_t>(handles.size()));
+        handles.push_back(handle);
+        gameRecords.push_back(GameRecord{strings.add(StringPool::GAMES, handle), strings.add(game.getDescription()),
+                                         strings.add(game.getEdition()), game.getMinPlayers(), game.getMaxPlayers(),
+                                         0, game.getAverageRating()});
+    }
+
+    // Партии в порядке добавления и их результаты
+    std::vector<MatchRecord> matchRecords;
+    std::vector<uint64_t> resultsAt(1, 0);
+    std::vector<ResultRecord> resultRecords;
+    std::unordered_map<const Match*, uint32_t> matchIndex;
+    matchRecords.reserve(allMatches.size());
+    for (const Match* match : allMatches) {
+        auto game = gameIndex.find(match->getGameHandle());
+        matchIndex.emplace(match, static_cast<uint32_t>(matchRecords.size()));
+        matchRecords.push_back(MatchRecord{strings.add(StringPool::MATCHES, match->getMatchHandle()),
+                                           strings.add(StringPool::GAMES, match->getGameHandle()),
+                                           match->getDay().getDayNumber(), game == gameIndex.end() ? NO_INDEX : game->second});
+        for (const auto& result : match->getPlayerResults()) {
+            resultRecords.push_back(ResultRecord{strings.add(StringPool::PLAYERS, result.first), 0, result.second});
+        }
+        resultsAt.push_back(resultRecords.size());
+    }
+
+    std::vector<uint32_t> byId(matchRecords.size());
+    std::vector<std::string_view> matchIds(matchRecords.size());
+    for (size_t i = 0; i < byId.size(); ++i) {
+        byId[i] = static_cast<uint32_t>(i);
+        matchIds[i] = allMatches[i]->getMatchId();
+    }
+    std::sort(byId.begin(), byId.end(), [&](uint32_t a, uint32_t b) { return matchIds[a] < matchIds[b]; });
+
+    // Оценки, признаки, партии и соседи каждой игры (списки подряд, смещения по играм)
+    std::vector<uint64_t> ratingsAt(1, 0), featuresAt(1, 0), gameMatchesAt(1, 0), neighborsAt(1, 0);
+    std::vector<RatingRecord> ratingRecords;
+    std::vector<FeatureRecord> featureRecords;
+    std::vector<uint32_t> gameMatchList, neighborList;
+    const SimilarityGraph* graph = db.getSimilarityData();
+    for (const auto& entry : catalog) {
+        const BoardGame& game = *entry.second;
+        for (const auto& rating : game.getRatings()) {
+            ratingRecords.push_back(RatingRecord{strings.add(StringPool::PLAYERS, rating.first), rating.second});
+        }
+        for (const auto& feature : game.getFeatures()) {
+            featureRecords.push_back(FeatureRecord{strings.add(feature.first), strings.add(feature.second)});
+        }
+        for (Match* match : db.matchesOfGame(entry.first)) {
+            gameMatchList.push_back(matchIndex.at(match));
+        }
+
+        size_t firstNeighbor = neighborList.size();
+        for (SymbolId neighbor : graph->neighbors(SymbolTable::games().find(entry.first))) {
+            auto index = gameIndex.find(neighbor);
+            if (index != gameIndex.end()) {
+                neighborList.push_back(index->second);
+            }
+        }
+        std::sort(neighborList.begin() + firstNeighbor, neighborList.end());
+
+        ratingsAt.push_back(ratingRecords.size());
+        featuresAt.push_back(featureRecords.size());
+        gameMatchesAt.push_back(gameMatchList.size());
+        neighborsAt.push_back(neighborList.size());
+    }
+
+    // Игроки по ID: история и партии из индекса базы
+    std::vector<PlayerRecord> playerRecords;
+    std::vector<uint64_t> historyAt(1, 0), playerMatchesAt(1, 0);
+    std::vector<uint32_t> historyList, playerMatchList;
+    for (const auto& entry : db.getAllPlayers()) {
+        const Player& player = *entry.second;
+        playerRecords.push_back(PlayerRecord{strings.add(StringPool::PLAYERS, player.getHandle()), strings.add(player.getName())});
+        for (SymbolId match : player.getMatchHistory()) {
+            historyList.push_back(strings.add(StringPool::MATCHES, match));
+        }
+        for (Match* match : db.matchesOfPlayer(entry.first)) {
+            playerMatchList.push_back(matchIndex.at(match));
+        }
+        historyAt.push_back(historyList.size());
+        playerMatchesAt.push_back(playerMatchList.size());
+    }
+
+    // Словари признаков из столбцового снимка базы: коды по номерам игр в файле
+    std::vector<FeatureColumnRecord> columnRecords;
+    std::vector<uint32_t> valueList;
+    std::vector<int32_t> codeList;
+    for (const std::string& featureName : catalogColumns.featureNames()) {
+        const std::vector<std::string>& values = *catalogColumns.featureValues(featureName);
+        const BlockColumn<int32_t>& codes = *catalogColumns.featureCodes(featureName);
+        columnRecords.push_back(FeatureColumnRecord{strings.add(featureName), static_cast<uint32_t>(valueList.size()),
+                                                    static_cast<uint32_t>(values.size()), 0});
+        for (const std::string& value : values) {
+            valueList.push_back(strings.add(value));
+        }
+        for (SymbolId handle : handles) {
+            codeList.push_back(codes[handle]);
+        }
+    }
+
+    SectionWriter sections;
+    sections.add(STRING_OFFSETS, strings.offsets);
+    sections.add(STRING_BYTES, strings.bytes);
+    sections.add(GAMES, gameRecords);
+    sections.add(GAME_RATINGS_AT, ratingsAt);
+    sections.add(RATINGS, ratingRecords);
+    sections.add(GAME_FEATURES_AT, featuresAt);
+    sections.add(FEATURES, featureRecords);
+    sections.add(GAME_MATCHES_AT, gameMatchesAt);
+    sections.add(GAME_MATCHES, gameMatchList);
+    sections.add(SIMILAR_AT, neighborsAt);
+    sections.add(SIMILAR, neighborList);
+    sections.add(PLAYERS, playerRecords);
+    sections.add(PLAYER_HISTORY_AT, historyAt);
+    sections.add(PLAYER_HISTORY, historyList);
+    sections.add(PLAYER_MATCHES_AT, playerMatchesAt);
+    sections.add(PLAYER_MATCHES, playerMatchList);
+    sections.add(MATCHES, matchRecords);
+    sections.add(MATCH_RESULTS_AT, resultsAt);
+    sections.add(RESULTS, resultRecords);
+    sections.add(MATCHES_BY_ID, byId);
+    sections.add(FEATURE_COLUMNS, columnRecords);
+    sections.add(FEATURE_VALUES, valueList);
+    sections.add(FEATURE_CODES, codeList);
+    std::vector<uint8_t> file = sections.assemble(journalSequence);
+
+    std::string temporary = path + ".tmp";
+    if (!writeDurably(temporary, file)) {
+        std::remove(temporary.c_str());
+        return fail(error, "не удалось записать " + temporary);
+    }
+
+    // rename в Windows не заменяет существующий файл - тогда прежний удаляется и переименование повторяется
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(path.c_str());
+        if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            return fail(error, "не удалось заменить " + path);
+        }
+    }
+    return true;
+}
+
+// === Открытие ===
+
+SnapshotFile::SnapshotFile() : materializedGames(0), journalSequence(0) {
+    prepareGames = [this](const CandidateSet& candidates) {
+        std::lock_guard<std::mutex> guard(objectLock);
+        candidates.forEach([&](uint32_t id) {
+            if (id < fileIndexOf.size() && fileIndexOf[id] != NO_INDEX) {
+                gameAt(fileIndexOf[id]);
+            }
+        });
+    };
+}
+
+SnapshotFile::~SnapshotFile() {}
+
+std::shared_ptr<const SnapshotFile> SnapshotFile::open(const std::string& path, bool verifyChecksum, std::string* error) {
+    std::shared_ptr<SnapshotFile> file(new SnapshotFile());
+    std::string message;
+    file->mapping.reset(new Mapping());
+    Mapping& mapped = *file->mapping;
+    if (!mapped.open(path, message)) {
+        fail(error, message);
+        return nullptr;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, mapped.data, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        fail(error, "не файл снимка базы");
+        return nullptr;
+    }
+    if (header.byteOrder != ORDER_MARK) {
+        fail(error, "файл записан с другим порядком байтов");
+        return nullptr;
+    }
+    if (header.formatVersion != FORMAT_VERSION) {
+        fail(error, "версия формата " + std::to_string(header.formatVersion) + ", поддерживается " +
+                    std::to_string(FORMAT_VERSION));
+        return nullptr;
+    }
+    if (header.fileSize != mapped.size) {
+        fail(error, "размер файла не совпадает с заголовком (файл усечен?)");
+        return nullptr;
+    }
+    if (verifyChecksum && checksumOf(mapped.data + sizeof(FileHeader), mapped.size - sizeof(FileHeader)) != header.checksum) {
+        fail(error, "контрольная сумма не совпадает");
+        return nullptr;
+    }
+
+    if (!file->bindSections(message) || !file->restoreCatalog(message)) {
+        fail(error, message);
+        return nullptr;
+    }
+    file->journalSequence = header.journalSequence;
+    return file;
+}
+
+bool SnapshotFile::bindSections(std::string& error) {
+    FileHeader header;
+    std::memcpy(&header, mapping->data, sizeof(header));
+    if (header.sectionCount > (mapping->size - sizeof(FileHeader)) / sizeof(SectionEntry)) {
+        error = "каталог разделов выходит за конец файла";
+        return false;
+    }
+    const SectionEntry* directory = reinterpret_cast<const SectionEntry*>(mapping->data + sizeof(FileHeader));
+
+    // раздел: запись нужного размера, начало выровнено, массив целиком внутри файла
+    bool ok = true;
+    auto bind = [&](auto& section, SectionId id) {
+        typedef typename std::remove_reference<decltype(section[0])>::type Record;
+        for (uint32_t i = 0; i < header.sectionCount; ++i) {
+            const SectionEntry& entry = directory[i];
+            if (entry.id != id) continue;
+            if (entry.recordSize != sizeof(Record) || entry.offset % 8 != 0 || entry.offset > mapping->size ||
+                entry.count > (mapping->size - entry.offset) / sizeof(Record)) {
+                break;
+            }
+            section.data = reinterpret_cast<const Record*>(mapping->data + entry.offset);
+            section.count = static_cast<size_t>(entry.count);
+            return;
+        }
+        if (ok) error = "раздел " + std::to_string(id) + " отсутствует или испорчен";
+        ok = false;
+    };
+    bind(stringOffsets, STRING_OFFSETS);
+    bind(stringBytes, STRING_BYTES);
+    bind(games, GAMES);
+    bind(gameRatingsAt, GAME_RATINGS_AT);
+    bind(ratings, RATINGS);
+    bind(gameFeaturesAt, GAME_FEATURES_AT);
+    bind(features, FEATURES);
+    bind(gameMatchesAt, GAME_MATCHES_AT);
+    bind(gameMatches, GAME_MATCHES);
+    bind(similarAt, SIMILAR_AT);
+    bind(similar, SIMILAR);
+    bind(players, PLAYERS);
+    bind(playerHistoryAt, PLAYER_HISTORY_AT);
+    bind(playerHistory, PLAYER_HISTORY);
+    bind(playerMatchesAt, PLAYER_MATCHES_AT);
+    bind(playerMatches, PLAYER_MATCHES);
+    bind(matches, MATCHES);
+    bind(matchResultsAt, MATCH_RESULTS_AT);
+    bind(results, RESULTS);
+    bind(matchesById, MATCHES_BY_ID);
+    bind(featureColumns, FEATURE_COLUMNS);
+    bind(featureValues, FEATURE_VALUES);
+    bind(featureCodes, FEATURE_CODES);
+    if (!ok) {
+        return false;
+    }
+
+    // смещения - по одному на запись и еще одно в конце; содержимое проверяется при чтении (spanOf, stringAt)
+    if (stringOffsets.count == 0 || gameRatingsAt.count != games.count + 1 || gameFeaturesAt.count != games.count + 1 ||
+        gameMatchesAt.count != games.count + 1 || similarAt.count != games.count + 1 ||
+        playerHistoryAt.count != players.count + 1 || playerMatchesAt.count != players.count + 1 ||
+        matchResultsAt.count != matches.count + 1 || matchesById.count != matches.count ||
+        featureCodes.count != featureColumns.count * games.count) {
+        error = "размеры разделов не согласованы";
+        return false;
+    }
+    return true;
+}
+
+bool SnapshotFile::restoreCatalog(std::string& error) {
+    // Названия игр регистрируются в SymbolTable: запросы и фильтры работают с общими номерами игр
+    gameHandles.resize(games.count);
+    size_t universe = 0;
+    for (size_t i = 0; i < games.count; ++i) {
+        std::string_view name = stringAt(games[i].name);
+        if (i > 0 && !(stringAt(games[i - 1].name) < name)) {
+            error = "игры в файле не упорядочены по названию";
+            return false;
+        }
+        gameHandles[i] = SymbolTable::games().intern(name);
+        universe = std::max(universe, static_cast<size_t>(gameHandles[i]) + 1);
+    }
+
+    gamesByHandle.assign(universe, nullptr);
+    gameObjects.resize(games.count);
+    playerObjects.resize(players.count);
+    matchObjects.resize(matches.count);
+    fileIndexOf.assign(universe, NO_INDEX);
+    matchCounts.assign(universe, 0);
+    for (size_t i = 0; i < games.count; ++i) {
+        fileIndexOf[gameHandles[i]] = static_cast<uint32_t>(i);
+        Span played = spanOf(gameMatchesAt, i, gameMatches.count);
+        matchCounts[gameHandles[i]] = static_cast<uint32_t>(played.last - played.first);
+    }
+
+    // Столбцы - прямо из записей игр; игры в файле уже по названию, поэтому порядок названий не сортируется
+    size_t rows = (universe + 63) / 64 * 64;
+    columns.rows = rows;
+    std::vector<uint64_t> present(rows / 64, 0);
+    columns.averageRating.assign(rows, std::numeric_limits<double>::quiet_NaN());
+    columns.ratingCount.assign(rows, 0);
+    columns.minPlayers.assign(rows, 0);
+    columns.maxPlayers.assign(rows, 0);
+    columns.nameRank.assign(rows, 0);
+    columns.nameOrder = std::make_shared<const std::vector<uint32_t>>(gameHandles.begin(), gameHandles.end());
+    for (size_t i = 0; i < games.count; ++i) {
+        SymbolId id = gameHandles[i];
+        Span rated = spanOf(gameRatingsAt, i, ratings.count);
+        present[id / 64] |= uint64_t(1) << (id % 64);
+        columns.averageRating.set(id, games[i].averageRating);
+        columns.ratingCount.set(id, static_cast<uint32_t>(rated.last - rated.first));
+        columns.minPlayers.set(id, games[i].minPlayers);
+        columns.maxPlayers.set(id, games[i].maxPlayers);
+        columns.nameRank.set(id, static_cast<uint32_t>(i));
+    }
+    columns.present = std::make_shared<std::vector<uint64_t>>(std::move(present));
+
+    for (size_t c = 0; c < featureColumns.count; ++c) {
+        const FeatureColumnRecord& record = featureColumns[c];
+        if (record.firstValue > featureValues.count || record.valueCount > featureValues.count - record.firstValue) {
+            error = "словарь признака выходит за раздел значений";
+            return false;
+        }
+        CatalogColumns::FeatureColumn& column = columns.features[std::string(stringAt(record.name))];
+        CatalogColumns::FeatureDictionary& dictionary = *column.dictionary;
+        for (uint32_t v = 0; v < record.valueCount; ++v) {
+            dictionary.values.emplace_back(stringAt(featureValues[record.firstValue + v]));
+            dictionary.codes.emplace(dictionary.values.back(), static_cast<int32_t>(v) + 1);
+        }
+        column.codes.assign(rows, 0);
+        const int32_t* codes = featureCodes.data + c * games.count;
+        for (size_t i = 0; i < games.count; ++i) {
+            bool valid = codes[i] >= 0 && static_cast<uint32_t>(codes[i]) <= record.valueCount;
+            column.codes.set(gameHandles[i], valid ? codes[i] : 0);
+        }
+    }
+
+    // Граф схожести: каждое ребро записано у обеих игр, добавляется один раз
+    for (size_t i = 0; i < games.count; ++i) {
+        Span neighbors = spanOf(similarAt, i, similar.count);
+        for (size_t k = neighbors.first; k < neighbors.last; ++k) {
+            if (similar[k] > i && similar[k] < games.count) {
+                similarity.addEdge(gameHandles[i], gameHandles[similar[k]]);
+            }
+        }
+    }
+    similarity.compact();
+    stats.build(columns, &similarity);
+    return true;
+}
+
+// === Чтение разделов ===
+
+std::string_view SnapshotFile::stringAt(uint32_t index) const {
+    if (static_cast<size_t>(index) + 1 >= stringOffsets.count) {
+        return std::string_view();
+    }
+    uint64_t first = stringOffsets[index];
+    uint64_t last = stringOffsets[index + 1];
+    if (first > last || last > stringBytes.count) {
+        return std::string_view();
+    }
+    return std::string_view(stringBytes.data + first, static_cast<size_t>(last - first));
+}
+
+SnapshotFile::Span SnapshotFile::spanOf(const Section<uint64_t>& offsets, size_t index, size_t total) {
+    uint64_t first = offsets[index];
+    uint64_t last = offsets[index + 1];
+    if (first > last || last > total) {
+        return Span{0, 0};
+    }
+    return Span{static_cast<size_t>(first), static_cast<size_t>(last)};
+}
+
+size_t SnapshotFile::findGame(std::string_view gameName) const {
+    size_t low = 0, high = games.count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (stringAt(games[middle].name) < gameName) low = middle + 1;
+        else high = middle;
+    }
+    return (low < games.count && stringAt(games[low].name) == gameName) ? low : SIZE_MAX;
+}
+
+size_t SnapshotFile::findPlayer(std::string_view playerId) const {
+    size_t low = 0, high = players.count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (stringAt(players[middle].id) < playerId) low = middle + 1;
+        else high = middle;
+    }
+    return (low < players.count && stringAt(players[low].id) == playerId) ? low : SIZE_MAX;
+}
+
+size_t SnapshotFile::findMatch(std::string_view matchId) const {
+    auto idOf = [&](size_t position) {
+        uint32_t index = matchesById[position];
+        return index < matches.count ? stringAt(matches[index].id) : std::string_view();
+    };
+    size_t low = 0, high = matchesById.count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (idOf(middle) < matchId) low = middle + 1;
+        else high = middle;
+    }
+    return (low < matchesById.count && idOf(low) == matchId) ? matchesById[low] : SIZE_MAX;
+}
+
+// === Объекты по требованию ===
+
+BoardGame* SnapshotFile::createGame(size_t index) const {
+    const GameRecord& record = games[index];
+    BoardGame* game = new BoardGame(std::string(stringAt(record.name)), std::string(stringAt(record.description)),
+                                    record.minPlayers, record.maxPlayers, std::string(stringAt(record.edition)));
+    Span listed = spanOf(gameFeaturesAt, index, features.count);
+    for (size_t k = listed.first; k < listed.last; ++k) {
+        game->addFeature(std::string(stringAt(features[k].name)), std::string(stringAt(features[k].value)));
+    }
+    Span rated = spanOf(gameRatingsAt, index, ratings.count);
+    for (size_t k = rated.first; k < rated.last; ++k) {
+        game->addRating(std::string(stringAt(ratings[k].player)), ratings[k].rating);
+    }
+    return game;
+}
+
+Match* SnapshotFile::createMatch(size_t index) const {
+    const MatchRecord& record = matches[index];
+    Match* match = new Match(std::string(stringAt(record.id)), std::string(stringAt(record.game)),
+                             Date::fromDayNumber(record.day));
+    Span played = spanOf(matchResultsAt, index, results.count);
+    for (size_t k = played.first; k < played.last; ++k) {
+        match->addPlayerResult(std::string(stringAt(results[k].player)), results[k].result);
+    }
+    return match;
+}
+
+BoardGame* SnapshotFile::gameAt(size_t index) const {
+    std::unique_ptr<BoardGame>& object = gameObjects[index];
+    if (object) {
+        return object.get();
+    }
+
+    object.reset(createGame(index));
+    gamesByHandle[gameHandles[index]] = object.get();
+    ++materializedGames;
+    return object.get();
+}
+
+Player* SnapshotFile::playerAt(size_t index) const {
+    std::unique_ptr<Player>& object = playerObjects[index];
+    if (!object) {
+        object.reset(new Player(std::string(stringAt(players[index].id)), std::string(stringAt(players[index].name))));
+        Span history = spanOf(playerHistoryAt, index, playerHistory.count);
+        for (size_t k = history.first; k < history.last; ++k) {
+            object->addMatchToHistory(std::string(stringAt(playerHistory[k])));
+        }
+    }
+    return object.get();
+}
+
+Match* SnapshotFile::matchAt(size_t index) const {
+    std::unique_ptr<Match>& object = matchObjects[index];
+    if (!object) {
+        object.reset(createMatch(index));
+    }
+    return object.get();
+}
+
+CatalogView SnapshotFile::view() const {
+    return CatalogView{&gamesByHandle, &columns, &stats, &matchCounts, &prepareGames};
+}
+
+std::vector<const BoardGame*> SnapshotFile::gamesOf(const std::vector<uint32_t>& ids) const {
+    std::vector<const BoardGame*> result;
+    result.reserve(ids.size());
+    std::lock_guard<std::mutex> guard(objectLock);
+    for (uint32_t id : ids) {
+        result.push_back(gameAt(fileIndexOf[id]));
+    }
+    return result;
+}
+
+std::vector<const Match*> SnapshotFile::matchesOf(const Section<uint64_t>& offsets, const Section<uint32_t>& list,
+                                                  size_t index) const {
+    std::vector<const Match*> result;
+    Span span = spanOf(offsets, index, list.count);
+    result.reserve(span.last - span.first);
+    std::lock_guard<std::mutex> guard(objectLock);
+    for (size_t k = span.first; k < span.last; ++k) {
+        if (list[k] < matches.count) {
+            result.push_back(matchAt(list[k]));
+        }
+    }
+    return result;
+}
+
+// === Открытый интерфейс ===
+
+size_t SnapshotFile::getFileSize() const {
+    return mapping->size;
+}
+
+size_t SnapshotFile::getGameCount() const {
+    return games.count;
+}
+
+size_t SnapshotFile::getPlayerCount() const {
+    return players.count;
+}
+
+size_t SnapshotFile::getMatchCount() const {
+    return matches.count;
+}
+
+size_t SnapshotFile::getMaterializedGameCount() const {
+    std::lock_guard<std::mutex> guard(objectLock);
+    return materializedGames;
+}
+
+uint64_t SnapshotFile::getJournalSequence() const {
+    return journalSequence;
+}
+
+void SnapshotFile::loadInto(GameDatabase& db) const {
+    for (size_t i = 0; i < games.count; ++i) {
+        db.addGame(createGame(i));
+    }
+
+    // партии - до игроков: база не дописывает их в историю отсутствующих игроков,
+    // а история каждого игрока восстанавливается из файла целиком
+    for (size_t m = 0; m < matches.count; ++m) {
+        Match* match = createMatch(m);
+        if (!db.addMatch(match)) {
+            delete match;
+        }
+    }
+    for (size_t p = 0; p < players.count; ++p) {
+        Player* player = new Player(std::string(stringAt(players[p].id)), std::string(stringAt(players[p].name)));
+        Span history = spanOf(playerHistoryAt, p, playerHistory.count);
+        for (size_t k = history.first; k < history.last; ++k) {
+            player->addMatchToHistory(std::string(stringAt(playerHistory[k])));
+        }
+        db.addPlayer(player);
+    }
+
+    for (size_t i = 0; i < games.count; ++i) {
+        Span neighbors = spanOf(similarAt, i, similar.count);
+        for (size_t k = neighbors.first; k < neighbors.last; ++k) {
+            if (similar[k] > i && similar[k] < games.count) {
+                db.addSimilarity(stringAt(games[i].name), stringAt(games[similar[k]].name));
+            }
+        }
+    }
+}
+
+const BoardGame* SnapshotFile::getGame(std::string_view gameName) const {
+    size_t index = findGame(gameName);
+    if (index == SIZE_MAX) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> guard(objectLock);
+    return gameAt(index);
+}
+
+const Player* SnapshotFile::getPlayer(std::string_view playerId) const {
+    size_t index = findPlayer(playerId);
+    if (index == SIZE_MAX) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> guard(objectLock);
+    return playerAt(index);
+}
+
+const Match* SnapshotFile::getMatch(std::string_view matchId) const {
+    size_t index = findMatch(matchId);
+    if (index == SIZE_MAX) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> guard(objectLock);
+    return matchAt(index);
+}
+
+std::vector<const Match*> SnapshotFile::getMatchesByGame(std::string_view gameName) const {
+    size_t index = findGame(gameName);
+    return index == SIZE_MAX ? std::vector<const Match*>() : matchesOf(gameMatchesAt, gameMatches, index);
+}
+
+std::vector<const Match*> SnapshotFile::getMatchesByPlayer(std::string_view playerId) const {
+    size_t index = findPlayer(playerId);
+    return index == SIZE_MAX ? std::vector<const Match*>() : matchesOf(playerMatchesAt, playerMatches, index);
+}
+
+PlayerGameStats SnapshotFile::getPlayerGameStats(std::string_view playerId, std::string_view gameName) const {
+    // те же результаты в том же порядке, что накапливала база при добавлении партий
+    PlayerGameStats result;
+    size_t player = findPlayer(playerId);
+    size_t game = findGame(gameName);
+    if (player == SIZE_MAX || game == SIZE_MAX) {
+        return result;
+    }
+
+    Span played = spanOf(playerMatchesAt, player, playerMatches.count);
+    for (size_t k = played.first; k < played.last; ++k) {
+        uint32_t match = playerMatches[k];
+        if (match >= matches.count || matches[match].gameIndex != game) continue;
+
+        Span entries = spanOf(matchResultsAt, match, results.count);
+        for (size_t r = entries.first; r < entries.last; ++r) {
+            if (stringAt(results[r].player) == playerId) {
+                result.addResult(results[r].result, Date::fromDayNumber(matches[match].day));
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<const BoardGame*> SnapshotFile::findGames(const std::vector<Filter*>& filters, QueryPlan* plan) const {
+    if (filters.empty()) {
+        return std::vector<const BoardGame*>();
+    }
+
+    CatalogView catalog = view();
+    return gamesOf(CatalogQuery::order(catalog, CatalogQuery::select(catalog, filters, plan), OrderBy{SortKey::byRating()}));
+}
+
+std::vector<const BoardGame*> SnapshotFile::findGames(const std::vector<Filter*>& filters, const OrderBy& order) const {
+    if (filters.empty()) {
+        return std::vector<const BoardGame*>();
+    }
+
+    CatalogView catalog = view();
+    return gamesOf(CatalogQuery::order(catalog, CatalogQuery::select(catalog, filters, nullptr), order));
+}
+
+SnapshotPage SnapshotFile::findGames(const std::vector<Filter*>& filters, size_t limit, const std::string& cursor) const {
+    SnapshotPage page;
+    page.hasMore = false;
+    if (filters.empty() || limit == 0) {
+        return page;
+    }
+
+    CatalogView catalog = view();
+    PageIds ids = CatalogQuery::page(catalog, CatalogQuery::select(catalog, filters, nullptr), limit, cursor);
+    page.games = gamesOf(ids.ids);
+    page.nextCursor = ids.nextCursor;
+    page.hasMore = ids.hasMore;
+    return page;
+}
+
+size_t SnapshotFile::forEachGame(const std::vector<Filter*>& filters, const SnapshotGameVisitor& visit) const {
+    if (filters.empty()) {
+        return 0;
+    }
+
+    // объекты прошедших игр уже созданы (CatalogQuery::stream готовит их перед передачей)
+    return CatalogQuery::stream(view(), filters, [&](uint32_t id) {
+        const BoardGame* game = nullptr;
+        {
+            std::lock_guard<std::mutex> guard(objectLock);
+            game = gameAt(fileIndexOf[id]);
+        }
+        return visit(game);
+    });
+}
+
+QueryPlan SnapshotFile::planQuery(const std::vector<Filter*>& filters) const {
+    return CatalogQuery::plan(view(), filters);
+}
+
+bool SnapshotFile::areSimilar(std::string_view game1, std::string_view game2) const {
+    return similarity.contains(SymbolTable::games().find(game1), SymbolTable::games().find(game2));
+}
+
+std::vector<std::string> SnapshotFile::getSimilarGames(std::string_view gameName) const {
+    std::vector<std::string> result;
+    NeighborRange neighbors = similarity.neighbors(SymbolTable::games().find(gameName));
+    result.reserve(neighbors.size());
+    for (SymbolId neighbor : neighbors) {
+        result.push_back(SymbolTable::games().name(neighbor));
+    }
+    return result;
+}
+
+const SimilarityGraph* SnapshotFile::getSimilarityData() const {
+    return &similarity;
+}
+
+const CatalogStats& SnapshotFile::getCatalogStats() const {
+    return stats;
+}
+
+const CatalogColumns& SnapshotFile::getCatalogColumns() const {
+    return columns;
+}
+
+void SnapshotFile::runTests() {
+    std::cout << "\n=== Тестирование класса SnapshotFile ===" << std::endl;
+
+    const std::string path = "snapshot_file_test.bgs";
+    GameDatabase db;
+    const char* genres[] = {"Стратегия", "Семейная", "Кооператив"};
+    for (int i = 0; i < 300; ++i) {
+        BoardGame* game = new BoardGame("Файл " + std::to_string(1000 + i), "Описание " + std::to_string(i),
+                                        1 + i % 3, 2 + i % 5, i % 2 ? "2-е издание" : "");
+        game->addFeature("Жанр", genres[i % 3]);
+        if (i % 4 == 0) game->addFeature("Время", std::to_string(30 + i % 90));
+        db.addGame(game);
+    }
+    for (int p = 0; p < 20; ++p) {
+        db.addPlayer(new Player("file_player_" + std::to_string(p), "Игрок " + std::to_string(p)));
+    }
+    for (int i = 0; i < 300; ++i) {
+        for (int p = 0; p < i % 7; ++p) {
+            db.addRating("Файл " + std::to_string(1000 + i), "file_player_" + std::to_string(p), 1 + (i + p) % 5);
+        }
+    }
+    for (int m = 0; m < 200; ++m) {
+        Match* match = new Match("file_match_" + std::to_string(m), "Файл " + std::to_string(1000 + m % 10),
+                                 "2024-0" + std::to_string(1 + m % 9) + "-15");
+        match->addPlayerResult("file_player_" + std::to_string(m % 20), 50.0 + m % 17);
+        match->addPlayerResult("file_player_" + std::to_string((m + 3) % 20), 40.0 + m % 11);
+        db.addMatch(match);
+    }
+    for (int i = 0; i < 50; ++i) {
+        db.addSimilarity("Файл " + std::to_string(1000 + i), "Файл " + std::to_string(1000 + (i * 7 + 1) % 300));
+    }
+
+    std::string error;
+    bool written = SnapshotFile::write(db, path, &error);
+    std::shared_ptr<const SnapshotFile> file = SnapshotFile::open(path, true, &error);
+
+    // Тест 1: открытие не создает объекты, игра по названию совпадает с оригиналом
+    bool lazy = file && file->getMaterializedGameCount() == 0;
+    const BoardGame* copy = file ? file->getGame("Файл 1007") : nullptr;
+    const BoardGame* original = db.getGame("Файл 1007");
+    std::cout << "Тест 1 - Запись, открытие и игра по требованию: ";
+    if (written && lazy && copy && copy != original && copy->getDescription() == original->getDescription() &&
+        copy->getAverageRating() == original->getAverageRating() && copy->getRatingsCount() == original->getRatingsCount() &&
+        copy->getFeature("Жанр") == original->getFeature("Жанр") && copy->getEdition() == original->getEdition() &&
+        file->getGameCount() == 300 && file->getMaterializedGameCount() == 1 && !file->getGame("Нет такой игры")) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // Тест 2: запросы дают те же игры, что и база; фильтр, не читающий игры, создает объекты только результата
+    RatingFilter rated(3.0);
+    FeatureFilter strategy(std::map<std::string, std::string>{{"Жанр", "Стратегия"}});
+    std::vector<Filter*> chain = {&rated, &strategy};
+    bool sameResults = false;
+    bool onlyResults = false;
+    bool samePages = false;
+    bool sameOrder = false;
+    if (file) {
+        std::vector<BoardGame*> expected = db.findGames(chain);
+        std::vector<const BoardGame*> actual = file->findGames(chain);
+        sameResults = !expected.empty() && expected.size() == actual.size();
+        for (size_t i = 0; sameResults && i < actual.size(); ++i) {
+            sameResults = actual[i]->getName() == expected[i]->getName();
+        }
+
+        SimilarGamesFilter similar({"Файл 1010"}, file->getSimilarityData());
+        std::vector<Filter*> bySimilarity = {&similar};
+        size_t before = file->getMaterializedGameCount();
+        std::vector<const BoardGame*> neighbors = file->findGames(bySimilarity);
+        onlyResults = !neighbors.empty() && neighbors.size() == db.getSimilarGames("Файл 1010").size() &&
+                      file->getMaterializedGameCount() <= before + neighbors.size();
+
+        ResultPage livePage = db.findGames(chain, 5, "");
+        SnapshotPage filePage = file->findGames(chain, 5, "");
+        SnapshotPage fileNext = file->findGames(chain, 5, filePage.nextCursor);
+        ResultPage liveNext = db.findGames(chain, 5, livePage.nextCursor);
+        samePages = filePage.nextCursor == livePage.nextCursor && fileNext.games.size() == liveNext.games.size() &&
+                    !fileNext.games.empty() && fileNext.games[0]->getName() == liveNext.games[0]->getName();
+
+        OrderBy byPlayers = {SortKey::byMaxPlayers(true), SortKey::byName()};
+        std::vector<BoardGame*> liveOrder = db.findGames(chain, byPlayers);
+        std::vector<const BoardGame*> fileOrder = file->findGames(chain, byPlayers);
+        sameOrder = liveOrder.size() == fileOrder.size();
+        for (size_t i = 0; sameOrder && i < fileOrder.size(); ++i) {
+            sameOrder = fileOrder[i]->getName() == liveOrder[i]->getName();
+        }
+    }
+    std::cout << "Тест 2 - Запросы как у базы: ";
+    if (sameResults && onlyResults && samePages && sameOrder) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // Тест 2а: потоковая выдача как у базы; после остановки объекты остальных частей каталога не создаются
+    bool sameStream = false;
+    bool lazyStream = false;
+    std::shared_ptr<const SnapshotFile> fresh = SnapshotFile::open(path, false, &error);
+    if (fresh) {
+        std::vector<std::string> live;
+        db.forEachGame(chain, [&](BoardGame* game) {
+            live.push_back(game->getName());
+            return true;
+        });
+        std::string first;
+        size_t stopped = fresh->forEachGame(chain, [&](const BoardGame* game) {
+            first = game->getName();
+            return false;
+        });
+        lazyStream = stopped == 1 && !live.empty() && first == live[0] &&
+                     fresh->getMaterializedGameCount() <= CatalogQuery::STREAM_BLOCK &&
+                     fresh->getMaterializedGameCount() < fresh->getGameCount();
+
+        std::vector<std::string> streamed;
+        fresh->forEachGame(chain, [&](const BoardGame* game) {
+            streamed.push_back(game->getName());
+            return true;
+        });
+        sameStream = streamed == live;
+    }
+    std::cout << "Тест 2а - Потоковая выдача: ";
+    if (sameStream && lazyStream) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    fresh.reset();
+
+    // Тест 3: партии, игроки, статистика и схожесть
+    bool sameData = false;
+    if (file) {
+        const Match* match = file->getMatch("file_match_42");
+        const Player* player = file->getPlayer("file_player_2");
+        const PlayerGameStats* liveStats = db.getPlayerGameStats("file_player_2", "Файл 1002");
+        PlayerGameStats fileStats = file->getPlayerGameStats("file_player_2", "Файл 1002");
+        sameData = match && match->getGameName() == "Файл 1002" && match->getPlayerResult("file_player_2") == 50.0 + 42 % 17 &&
+                   player && player->getName() == "Игрок 2" &&
+                   player->getMatchHistory().size() == db.getPlayer("file_player_2")->getMatchHistory().size() &&
+                   file->getMatchesByGame("Файл 1002").size() == db.getMatchesByGame("Файл 1002").size() &&
+                   file->getMatchesByPlayer("file_player_2").size() == db.getMatchesByPlayer("file_player_2").size() &&
+                   liveStats && fileStats.getCount() == liveStats->getCount() && fileStats.getMean() == liveStats->getMean() &&
+                   fileStats.getLastPlayed() == liveStats->getLastPlayed() &&
+                   file->areSimilar("Файл 1000", "Файл 1001") && file->getSimilarGames("Файл 1000") == db.getSimilarGames("Файл 1000") &&
+                   !file->getMatch("нет партии") && file->getMatchCount() == 200 && file->getPlayerCount() == 20;
+    }
+    std::cout << "Тест 3 - Партии, игроки и схожесть: ";
+    if (sameData) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    // Тест 4: испорченный, усеченный и чужой файлы не открываются
+    std::vector<char> bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto rewrite = [&](const std::vector<char>& content) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(content.data(), static_cast<std::streamsize>(content.size()));
+    };
+    std::vector<char> damaged = bytes;
+    damaged[damaged.size() / 2] ^= 0x40;
+    rewrite(damaged);
+    std::string damagedError;
+    bool damagedRejected = !SnapshotFile::open(path, true, &damagedError) && !damagedError.empty();
+
+    rewrite(std::vector<char>(bytes.begin(), bytes.begin() + bytes.size() / 3));
+    bool truncatedRejected = !SnapshotFile::open(path, false);
+
+    std::vector<char> newer = bytes;
+    newer[8] = static_cast<char>(FORMAT_VERSION + 1);
+    rewrite(newer);
+    bool versionRejected = !SnapshotFile::open(path);
+
+    std::cout << "Тест 4 - Проверка целостности: ";
+    if (damagedRejected && truncatedRejected && versionRejected && !SnapshotFile::open("нет_такого_файла.bgs")) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+
+    file.reset();
+    std::remove(path.c_str());
+
+    std::cout << "=== Тестирование SnapshotFile завершено ===\n" << std::endl;
+}
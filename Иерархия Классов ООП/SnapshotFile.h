@@ -0,0 +1,195 @@
+#ifndef SNAPSHOT_FILE_H
+#define SNAPSHOT_FILE_H
+
+#include "BoardGame.h"
+#include "Player.h"
+#include "Match.h"
+#include "Filter.h"
+#include "SimilarityGraph.h"
+#include "PlayerGameStats.h"
+#include "CatalogStats.h"
+#include "CatalogColumns.h"
+#include "CatalogQuery.h"
+#include "QueryPlan.h"
+#include "OrderBy.h"
+#include "DatabaseSnapshot.h"
+#include <memory>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+class GameDatabase;
+
+// Двоичный файл снимка базы: записывается из живой GameDatabase, открывается отображением в память (mmap)
+// Файл - заголовок (сигнатура, версия формата, размер, контрольная сумма), каталог разделов и сами разделы:
+// плоские массивы записей фиксированного размера - таблица строк, игры (по названию), оценки, признаки,
+// игроки (по ID), партии (в порядке добавления) и готовые индексы: партии по играм и игрокам,
+// партии по ID, граф схожести, словари признаков; записи ссылаются друг на друга номерами в массивах
+// Открытие не разбирает файл целиком: проверяет заголовок и разделы, регистрирует названия игр
+// и заполняет столбцы каталога прямо из массивов, после чего запросы выполняются сразу
+// Объекты игр, игроков и партий создаются при первом обращении и живут, пока открыт файл;
+// фильтрам, проверяющим игры по одной, объекты создаются только для их кандидатов
+// Снимок только для чтения, методы можно вызывать из нескольких потоков
+// Для восстановления изменяемой базы (снимок + хвост журнала, см. Journal) содержимое переносится в GameDatabase (loadInto)
+class SnapshotFile {
+public:
+    static const uint32_t FORMAT_VERSION = 3; // меняется при любом несовместимом изменении заголовка или разделов
+
+private:
+    struct Mapping;
+    struct GameRecord;
+    struct RatingRecord;
+    struct FeatureRecord;
+    struct PlayerRecord;
+    struct MatchRecord;
+    struct ResultRecord;
+    struct FeatureColumnRecord;
+
+    // раздел файла: массив записей прямо в отображенной памяти
+    template <typename T>
+    struct Section {
+        const T* data = nullptr;
+        size_t count = 0;
+
+        const T& operator[](size_t index) const { return data[index]; }
+    };
+
+    // диапазон [first, last) списка из раздела смещений (пустой, если смещения испорчены)
+    struct Span {
+        size_t first;
+        size_t last;
+    };
+
+    std::unique_ptr<Mapping> mapping;
+
+    Section<uint64_t> stringOffsets;  // строка i - байты [offsets[i], offsets[i+1])
+    Section<char> stringBytes;
+    Section<GameRecord> games;        // по возрастанию названия
+    Section<uint64_t> gameRatingsAt;
+    Section<RatingRecord> ratings;
+    Section<uint64_t> gameFeaturesAt;
+    Section<FeatureRecord> features;
+    Section<uint64_t> gameMatchesAt;
+    Section<uint32_t> gameMatches;    // номера партий
+    Section<uint64_t> similarAt;
+    Section<uint32_t> similar;        // номера игр
+    Section<PlayerRecord> players;    // по возрастанию ID
+    Section<uint64_t> playerHistoryAt;
+    Section<uint32_t> playerHistory;  // строки ID партий (история игрока)
+    Section<uint64_t> playerMatchesAt;
+    Section<uint32_t> playerMatches;  // номера партий
+    Section<MatchRecord> matches;     // в порядке добавления в базу
+    Section<uint64_t> matchResultsAt;
+    Section<ResultRecord> results;
+    Section<uint32_t> matchesById;    // номера партий по возрастанию ID
+    Section<FeatureColumnRecord> featureColumns;
+    Section<uint32_t> featureValues;  // строки значений словарей
+    Section<int32_t> featureCodes;    // коды признака c у игры i - [c * число игр + i]
+
+    // каталог, восстановленный при открытии
+    std::vector<SymbolId> gameHandles;       // номер игры в файле -> номер в SymbolTable::games()
+    std::vector<uint32_t> fileIndexOf;       // номер в SymbolTable::games() -> номер в файле
+    CatalogColumns columns;
+    CatalogStats stats;
+    SimilarityGraph similarity;
+    std::vector<uint32_t> matchCounts;
+
+    // объекты, созданные по требованию; меняются только под objectLock
+    mutable std::mutex objectLock;
+    mutable std::vector<BoardGame*> gamesByHandle;
+    mutable std::vector<std::unique_ptr<BoardGame>> gameObjects;
+    mutable std::vector<std::unique_ptr<Player>> playerObjects;
+    mutable std::vector<std::unique_ptr<Match>> matchObjects;
+    mutable size_t materializedGames;
+    std::function<void(const CandidateSet&)> prepareGames;
+    uint64_t journalSequence;
+
+    SnapshotFile();
+
+    bool bindSections(std::string& error);
+    bool restoreCatalog(std::string& error);
+
+    std::string_view stringAt(uint32_t index) const;
+    static Span spanOf(const Section<uint64_t>& offsets, size_t index, size_t total);
+
+    // поиск по отсортированным разделам (SIZE_MAX, если нет)
+    size_t findGame(std::string_view gameName) const;
+    size_t findPlayer(std::string_view playerId) const;
+    size_t findMatch(std::string_view matchId) const;
+
+    // новые объекты по записям файла (владение у вызывающего)
+    BoardGame* createGame(size_t index) const;
+    Match* createMatch(size_t index) const;
+
+    // объекты по номеру в файле; вызываются под objectLock
+    BoardGame* gameAt(size_t index) const;
+    Player* playerAt(size_t index) const;
+    Match* matchAt(size_t index) const;
+
+    CatalogView view() const;
+    std::vector<const BoardGame*> gamesOf(const std::vector<uint32_t>& ids) const;
+    std::vector<const Match*> matchesOf(const Section<uint64_t>& offsets, const Section<uint32_t>& list, size_t index) const;
+
+public:
+    ~SnapshotFile();
+
+    SnapshotFile(const SnapshotFile&) = delete;
+    SnapshotFile& operator=(const SnapshotFile&) = delete;
+
+    // Записать базу в файл: сначала во временный path + ".tmp" со сбросом на диск, затем замена,
+    // поэтому прежний файл остается целым при сбое; false и текст ошибки в error, если записать не удалось
+    // journalSequence - номер последней записи журнала, уже учтенной в базе (см. Journal::checkpoint)
+    static bool write(const GameDatabase& db, const std::string& path, std::string* error = nullptr,
+                      uint64_t journalSequence = 0);
+
+    // Открыть файл; nullptr и текст ошибки в error, если файла нет, он усечен, испорчен
+    // или записан другой версией формата; verifyChecksum = false пропускает проход по всему файлу
+    static std::shared_ptr<const SnapshotFile> open(const std::string& path, bool verifyChecksum = true,
+                                                    std::string* error = nullptr);
+
+    size_t getFileSize() const;
+    size_t getGameCount() const;
+    size_t getPlayerCount() const;
+    size_t getMatchCount() const;
+    size_t getMaterializedGameCount() const; // сколько объектов игр уже создано (для тестов и замеров)
+    uint64_t getJournalSequence() const; // последняя запись журнала, учтенная в снимке (0 - без журнала)
+
+    // Перенести содержимое в пустую базу новыми объектами: игры с оценками, партии, игроки с историей, схожесть
+    // Партии игр, удаленных до записи снимка, база не примет - они не восстанавливаются
+    void loadInto(GameDatabase& db) const;
+
+    // Объекты по ключу (nullptr, если нет); указатели действительны, пока открыт файл
+    const BoardGame* getGame(std::string_view gameName) const;
+    const Player* getPlayer(std::string_view playerId) const;
+    const Match* getMatch(std::string_view matchId) const;
+
+    // Партии в порядке добавления в базу
+    std::vector<const Match*> getMatchesByGame(std::string_view gameName) const;
+    std::vector<const Match*> getMatchesByPlayer(std::string_view playerId) const;
+
+    // Статистика игрока в игре по его партиям (пустая, если партий не было)
+    PlayerGameStats getPlayerGameStats(std::string_view playerId, std::string_view gameName) const;
+
+    // Поиск с той же семантикой, что у GameDatabase::findGames
+    std::vector<const BoardGame*> findGames(const std::vector<Filter*>& filters, QueryPlan* plan = nullptr) const;
+    std::vector<const BoardGame*> findGames(const std::vector<Filter*>& filters, const OrderBy& order) const;
+    SnapshotPage findGames(const std::vector<Filter*>& filters, size_t limit, const std::string& cursor) const;
+    size_t forEachGame(const std::vector<Filter*>& filters, const SnapshotGameVisitor& visit) const; // объекты создаются по частям
+    QueryPlan planQuery(const std::vector<Filter*>& filters) const;
+
+    // Схожесть игр; фильтр схожести для запросов к файлу строится по его графу (getSimilarityData)
+    bool areSimilar(std::string_view game1, std::string_view game2) const;
+    std::vector<std::string> getSimilarGames(std::string_view gameName) const;
+    const SimilarityGraph* getSimilarityData() const;
+
+    const CatalogStats& getCatalogStats() const;
+    const CatalogColumns& getCatalogColumns() const;
+
+    static void runTests();
+};
+
+#endif
@@ -0,0 +1,152 @@
+#include "SymbolTable.h"
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+SymbolTable::SymbolTable() : count(0) {
+    for (std::atomic<std::string*>& block : blocks) {
+        block.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+SymbolTable::~SymbolTable() {
+    for (std::atomic<std::string*>& block : blocks) {
+        delete[] block.load(std::memory_order_relaxed);
+    }
+}
+
+std::string* SymbolTable::slot(SymbolId id) const {
+    // позиция id + FIRST_BLOCK: старший бит дает блок, остальные - место в нем
+    uint64_t position = static_cast<uint64_t>(id) + (uint64_t(1) << FIRST_BLOCK_BITS);
+    int high = 63 - __builtin_clzll(position);
+    std::string* block = blocks[high - FIRST_BLOCK_BITS].load(std::memory_order_acquire);
+    return block + (position - (uint64_t(1) << high));
+}
+
+SymbolId SymbolTable::intern(std::string_view name) {
+    {
+        std::shared_lock<std::shared_mutex> reading(lock);
+        auto it = ids.find(name);
+        if (it != ids.end()) {
+            return it->second;
+        }
+    }
+    
+    std::unique_lock<std::shared_mutex> writing(lock);
+    auto it = ids.find(name);
+    if (it != ids.end()) {
+        return it->second;  // строку успели зарегистрировать между блокировками
+    }
+    
+    // новый номер - следующий по порядку, поэтому номера плотные
+    SymbolId id = static_cast<SymbolId>(count.load(std::memory_order_relaxed));
+    uint64_t position = static_cast<uint64_t>(id) + (uint64_t(1) << FIRST_BLOCK_BITS);
+    int high = 63 - __builtin_clzll(position);
+    if (position == (uint64_t(1) << high)) {
+        blocks[high - FIRST_BLOCK_BITS].store(new std::string[size_t(1) << high], std::memory_order_release);
+    }
+    std::string* stored = slot(id);
+    stored->assign(name);
+    ids.emplace(std::string_view(*stored), id);
+    count.store(id + static_cast<size_t>(1), std::memory_order_release);  // строка готова для name()
+    return id;
+}
+
+SymbolId SymbolTable::find(std::string_view name) const {
+    std::shared_lock<std::shared_mutex> reading(lock);
+    auto it = ids.find(name);
+    return (it != ids.end()) ? it->second : INVALID_SYMBOL;
+}
+
+const std::string& SymbolTable::name(SymbolId id) const {
+    static const std::string empty;
+    return (id < count.load(std::memory_order_acquire)) ? *slot(id) : empty;
+}
+
+size_t SymbolTable::size() const {
+    return count.load(std::memory_order_acquire);
+}
+
+SymbolTable& SymbolTable::players() {
+    static SymbolTable table;
+    return table;
+}
+
+SymbolTable& SymbolTable::games() {
+    static SymbolTable table;
+    return table;
+}
+
+SymbolTable& SymbolTable::matches() {
+    static SymbolTable table;
+    return table;
+}
+
+void SymbolTable::runTests() {
+    std::cout << "\n=== Тестирование класса SymbolTable ===" << std::endl;
+    
+    SymbolTable table;
+    SymbolId a = table.intern("player_001");
+    SymbolId b = table.intern("player_002");
+    SymbolId again = table.intern("player_001");
+    
+    std::cout << "Тест 1 - Плотные номера без повторов: ";
+    if (a == 0 && b == 1 && again == a && table.size() == 2) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    std::cout << "Тест 2 - Обратное преобразование: ";
+    if (table.name(b) == "player_002" && table.name(INVALID_SYMBOL).empty()) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    std::cout << "Тест 3 - Поиск без регистрации: ";
+    if (table.find("player_001") == a && table.find("unknown") == INVALID_SYMBOL && table.size() == 2) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    // Тест 4: потоки регистрируют одни и те же строки вперемешку и сразу читают их обратно
+    SymbolTable shared;
+    const int threadCount = 4;
+    const int nameCount = 2000;
+    std::vector<std::vector<SymbolId>> seen(threadCount, std::vector<SymbolId>(nameCount));
+    std::vector<int> mismatches(threadCount, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < nameCount; ++i) {
+                int n = (i * 7 + t * 500) % nameCount;  // у каждого потока свой порядок
+                std::string text = "name_" + std::to_string(n);
+                SymbolId id = shared.intern(text);
+                seen[t][n] = id;
+                if (shared.name(id) != text || shared.find(text) != id) {
+                    ++mismatches[t];
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    
+    bool consistent = shared.size() == static_cast<size_t>(nameCount);
+    for (int t = 0; t < threadCount; ++t) {
+        consistent = consistent && mismatches[t] == 0 && seen[t] == seen[0];
+    }
+    
+    std::cout << "Тест 4 - Одновременная регистрация из нескольких потоков: ";
+    if (consistent) {
+        std::cout << "PASSED" << std::endl;
+    } else {
+        std::cout << "FAILED" << std::endl;
+    }
+    
+    std::cout << "=== Тестирование SymbolTable завершено ===\n" << std::endl;
+}
@@ -0,0 +1,52 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <atomic>
+#include <shared_mutex>
+#include <cstdint>
+#include <cstddef>
+
+typedef uint32_t SymbolId; // компактный номер строки в таблице
+
+const SymbolId INVALID_SYMBOL = 0xFFFFFFFFu; // строка не зарегистрирована
+
+// таблица интернирования строк: каждой строке выдается плотный номер 0, 1, 2...
+// все связи между сущностями хранятся по номерам, строка лежит в памяти один раз
+// потокобезопасна: регистрация идет под исключительной блокировкой, поиск - под разделяемой,
+// а name() читает без блокировок (строки лежат в блоках, которые никогда не перемещаются)
+class SymbolTable {
+private:
+    // блок k вмещает FIRST_BLOCK << k строк, поэтому 27 блоков покрывают все 32-битные номера
+    static const int FIRST_BLOCK_BITS = 6;
+    static const int MAX_BLOCKS = 32;
+    
+    std::atomic<std::string*> blocks[MAX_BLOCKS]; // номер -> строка
+    std::atomic<size_t> count; // опубликованных строк: name() видит только номера меньше count
+    std::unordered_map<std::string_view, SymbolId> ids; // строка -> номер, ключи указывают в блоки
+    mutable std::shared_mutex lock; // защищает ids и добавление строк
+    
+    std::string* slot(SymbolId id) const; // место строки (блок уже выделен)
+    
+public:
+    SymbolTable();
+    ~SymbolTable();
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+    
+    SymbolId intern(std::string_view name); // номер строки (регистрирует новую)
+    SymbolId find(std::string_view name) const; // номер или INVALID_SYMBOL, без выделения памяти
+    const std::string& name(SymbolId id) const; // ссылка действительна все время работы программы
+    size_t size() const;
+    
+    // глобальные таблицы для каждого вида идентификаторов
+    static SymbolTable& players();
+    static SymbolTable& games();
+    static SymbolTable& matches();
+    
+    static void runTests();
+};
+
+#endif
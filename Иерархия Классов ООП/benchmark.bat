@@ -0,0 +1,23 @@
+@echo off
+echo ===================================================
+echo Компиляция замеров производительности...
+echo ===================================================
+
+g++ -O2 -std=c++17 benchmark.cpp BoardGame.cpp SymbolTable.cpp Player.cpp Date.cpp PlayerGameStats.cpp Match.cpp MatchTimeIndex.cpp SkillRatingEngine.cpp Leaderboard.cpp CandidateSet.cpp ParallelScan.cpp CatalogStats.cpp CatalogColumns.cpp QueryPlan.cpp OrderBy.cpp CatalogQuery.cpp QueryCache.cpp RatingFilter.cpp FeatureFilter.cpp SimilarityGraph.cpp SimilarGamesFilter.cpp GameDatabase.cpp DatabaseSnapshot.cpp SnapshotFile.cpp Journal.cpp BulkImporter.cpp ShardedGameDatabase.cpp -o board_game_benchmark.exe
+
+if %errorlevel% equ 0 (
+    echo.
+    echo ===================================================
+    echo Компиляция успешна!
+    echo ===================================================
+    echo Запуск замеров:
+    echo.
+    board_game_benchmark.exe
+) else (
+    echo.
+    echo ===================================================
+    echo Ошибка компиляции!
+    echo ===================================================
+)
+
+pause
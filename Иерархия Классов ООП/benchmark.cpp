@@ -0,0 +1,1316 @@
+#include "BoardGame.h"
+#include "GameDatabase.h"
+#include "ShardedGameDatabase.h"
+#include "SnapshotFile.h"
+#include "Journal.h"
+#include "BulkImporter.h"
+#include "RatingFilter.h"
+#include "FeatureFilter.h"
+#include "SimilarGamesFilter.h"
+#include "SkillRatingEngine.h"
+#include "ParallelScan.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <limits>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+// замеры производительности (отдельно от тестов в main.cpp)
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// среднее "по-старому": проход по всем оценкам при каждом вызове
+double recomputeAverage(const BoardGame* game) {
+    const FlatMap<SymbolId, int>& ratings = game->getRatings();
+    if (ratings.empty()) {
+        return 0.0;
+    }
+    int sum = 0;
+    for (const auto& pair : ratings) {
+        sum += pair.second;
+    }
+    return static_cast<double>(sum) / ratings.size();
+}
+
+void benchmarkRatingAggregates() {
+    const int gameCount = 100;
+    const int ratingsPerGame = 10000;
+
+    std::cout << "\n--- Агрегаты оценок: " << gameCount << " игр x "
+              << ratingsPerGame << " оценок ---" << std::endl;
+
+    std::vector<BoardGame*> games;
+    for (int g = 0; g < gameCount; ++g) {
+        BoardGame* game = new BoardGame("Игра " + std::to_string(g), "", 2, 4, "");
+        for (int p = 0; p < ratingsPerGame; ++p) {
+            game->addRating("player_" + std::to_string(p), 1 + (p * 7 + g * 13) % 5);
+        }
+        games.push_back(game);
+    }
+
+    std::vector<BoardGame*> byRecompute = games;
+    Clock::time_point start = Clock::now();
+    std::sort(byRecompute.begin(), byRecompute.end(), [](BoardGame* a, BoardGame* b) {
+        return recomputeAverage(a) > recomputeAverage(b);
+    });
+    double recomputeMs = elapsedMs(start);
+
+    std::vector<BoardGame*> byAggregate = games;
+    start = Clock::now();
+    std::sort(byAggregate.begin(), byAggregate.end(), [](BoardGame* a, BoardGame* b) {
+        return a->getAverageRating() > b->getAverageRating();
+    });
+    double aggregateMs = elapsedMs(start);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Сортировка с пересчетом суммы: " << recomputeMs << " мс" << std::endl;
+    std::cout << "Сортировка по агрегатам:       " << aggregateMs << " мс" << std::endl;
+    if (aggregateMs > 0) {
+        std::cout << "Ускорение: x" << std::setprecision(1) << recomputeMs / aggregateMs << std::endl;
+    }
+
+    for (BoardGame* game : games) {
+        delete game;
+    }
+}
+
+// оценка памяти узла std::map: заголовок красно-черного дерева (цвет + 3 указателя),
+// значение и служебные байты malloc с выравниванием до 16
+size_t mapNodeBytes(size_t valueSize) {
+    size_t raw = 4 * sizeof(void*) + valueSize + sizeof(void*);
+    return (raw + 15) / 16 * 16;
+}
+
+void benchmarkFlatStorage() {
+    const int gameCount = 1000;
+    const int ratingsPerGame = 200;
+    const int lookups = 2000000;
+
+    std::cout << "\n--- Плоское хранение оценок и признаков: " << gameCount << " игр x "
+              << ratingsPerGame << " оценок, 6 признаков ---" << std::endl;
+
+    const std::string featureNames[] = {"Жанр", "Сложность", "Время", "Тема", "Механика", "Возраст"};
+    std::vector<BoardGame*> games;
+    std::vector<std::map<std::string, std::string>> mapFeatures(gameCount);
+    size_t flatBytes = 0;
+    size_t mapBytes = 0;
+    for (int g = 0; g < gameCount; ++g) {
+        BoardGame* game = new BoardGame("Игра " + std::to_string(g), "Описание", 2, 4, "1-е издание");
+        for (int p = 0; p < ratingsPerGame; ++p) {
+            game->addRating("player_" + std::to_string((p * 31 + g) % 5000), 1 + (p + g) % 5);
+        }
+        for (int f = 0; f < 6; ++f) {
+            std::string value = "значение " + std::to_string((g + f) % 7);
+            game->addFeature(featureNames[f], value);
+            mapFeatures[g][featureNames[f]] = value;
+        }
+        games.push_back(game);
+        flatBytes += game->getMemoryUsage();
+
+        // та же игра в прежнем представлении: два std::map вместо плоских векторов
+        size_t bytes = game->getMemoryUsage() - game->getRatings().capacityBytes()
+                       - game->getFeatures().capacityBytes();
+        bytes += 2 * (sizeof(std::map<int, int>) - sizeof(FlatMap<int, int>));
+        bytes += game->getRatingsCount() * mapNodeBytes(sizeof(std::pair<const SymbolId, int>));
+        bytes += game->getFeatures().size() * mapNodeBytes(sizeof(std::pair<const std::string, std::string>));
+        mapBytes += bytes;
+    }
+
+    std::cout << "Память на игру (std::map): " << mapBytes / gameCount << " байт" << std::endl;
+    std::cout << "Память на игру (плоско):   " << flatBytes / gameCount << " байт" << std::endl;
+
+    Clock::time_point start = Clock::now();
+    size_t hits = 0;
+    for (int i = 0; i < lookups; ++i) {
+        const std::map<std::string, std::string>& features = mapFeatures[i % gameCount];
+        hits += features.find(featureNames[i % 6]) != features.end();
+    }
+    double mapMs = elapsedMs(start);
+
+    start = Clock::now();
+    for (int i = 0; i < lookups; ++i) {
+        hits += games[i % gameCount]->hasFeature(featureNames[i % 6]);
+    }
+    double flatMs = elapsedMs(start);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Поиск признака, std::map: " << mapMs << " мс" << std::endl;
+    std::cout << "Поиск признака, плоско:   " << flatMs << " мс" << std::endl;
+    std::cout << "(найдено " << hits << ")" << std::endl;
+
+    for (BoardGame* game : games) {
+        delete game;
+    }
+}
+
+void benchmarkMatchLookup() {
+    const int matchCount = 200000;
+    const int lookups = 20000;
+    const int scanLookups = 200; // линейный просмотр слишком медленный для всех запросов
+
+    std::cout << "\n--- Поиск партии по ID: " << matchCount << " партий ---" << std::endl;
+
+    GameDatabase db;
+    db.addGame(new BoardGame("Каркассон", "", 2, 6, ""));
+    for (int i = 0; i < matchCount; ++i) {
+        Match* match = new Match("bench_match_" + std::to_string(i), "Каркассон", "2024-01-01");
+        match->addPlayerResult("player_" + std::to_string(i % 1000), i % 100);
+        db.addMatch(match);
+    }
+
+    std::vector<std::string> ids;
+    for (int i = 0; i < lookups; ++i) {
+        ids.push_back("bench_match_" + std::to_string((i * 7919) % matchCount));
+    }
+
+    Clock::time_point start = Clock::now();
+    size_t found = 0;
+    for (int i = 0; i < scanLookups; ++i) {
+        const std::string& id = ids[i];
+        for (Match* match : db.getAllMatches()) {
+            if (match->getMatchId() == id) {
+                ++found;
+                break;
+            }
+        }
+    }
+    double scanMs = elapsedMs(start);
+
+    start = Clock::now();
+    for (const std::string& id : ids) {
+        found += db.getMatch(id) != nullptr;
+    }
+    double indexMs = elapsedMs(start);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Линейный просмотр: " << scanMs * 1000 / scanLookups << " мкс на запрос" << std::endl;
+    std::cout << "Хеш-индекс:        " << indexMs * 1000 / lookups << " мкс на запрос" << std::endl;
+    std::cout << "(найдено " << found << ")" << std::endl;
+}
+
+void benchmarkLeaderboard() {
+    const int playerCount = 20000;
+    const int matchCount = 200000;
+    const int queries = 20;
+
+    std::cout << "\n--- Таблица лидеров: " << playerCount << " игроков, " << matchCount << " партий ---" << std::endl;
+
+    GameDatabase db;
+    db.addGame(new BoardGame("Каркассон", "", 2, 6, ""));
+    std::vector<std::string> ids;
+    for (int p = 0; p < playerCount; ++p) {
+        ids.push_back("leader_" + std::to_string(p));
+        db.addPlayer(new Player(ids.back(), ids.back()));
+    }
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < matchCount; ++i) {
+        Match* match = new Match("leader_match_" + std::to_string(i), "Каркассон", "2024-01-01");
+        for (int seat = 0; seat < 4; ++seat) {
+            int player = (i * 4 + seat) * 7919 % playerCount;
+            match->addPlayerResult(ids[player], 60 + (player * 13 + i) % 50);
+        }
+        db.addMatch(match);
+    }
+    double ingestMs = elapsedMs(start);
+
+    // "по-старому": рейтинг каждого игрока и частичная сортировка на каждый запрос
+    start = Clock::now();
+    size_t checksum = 0;
+    for (int q = 0; q < queries; ++q) {
+        std::vector<std::pair<double, const std::string*>> all;
+        all.reserve(ids.size());
+        for (const std::string& id : ids) {
+            all.emplace_back(db.getPlayerRatingInGame(id, "Каркассон"), &id);
+        }
+        std::partial_sort(all.begin(), all.begin() + 50, all.end(),
+                          [](const std::pair<double, const std::string*>& a, const std::pair<double, const std::string*>& b) {
+                              return a.first > b.first;
+                          });
+        size_t rank = 1;
+        double mine = db.getPlayerRatingInGame(ids[q], "Каркассон");
+        for (const auto& entry : all) rank += entry.first > mine;
+        checksum += rank;
+    }
+    double scanMs = elapsedMs(start) / queries;
+
+    const Leaderboard* board = db.getLeaderboard("Каркассон");
+    start = Clock::now();
+    const int boardQueries = queries * 1000;
+    for (int q = 0; q < boardQueries; ++q) {
+        checksum += board->top(50).size();
+        checksum += board->rankOf(ids[q % playerCount]);
+    }
+    double boardMs = elapsedMs(start) / boardQueries;
+
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "Добавление партий с обновлением таблицы: " << ingestMs * 1000 / matchCount << " мкс на партию" << std::endl;
+    std::cout << "Топ-50 и место игрока перебором:  " << scanMs << " мс на запрос" << std::endl;
+    std::cout << "Топ-50 и место игрока по таблице: " << boardMs << " мс на запрос" << std::endl;
+    std::cout << "(контрольная сумма " << checksum << ")" << std::endl;
+}
+
+void benchmarkSkillRatings() {
+    const int gameCount = 50;
+    const int playerCount = 20000;
+    const int matchCount = 300000;
+
+    std::cout << "\n--- Рейтинг силы: " << matchCount << " партий в " << gameCount << " играх ---" << std::endl;
+
+    std::vector<Match*> history;
+    history.reserve(matchCount);
+    for (int i = 0; i < matchCount; ++i) {
+        std::string date = "2024-" + std::to_string(10 + i % 3) + "-" + std::to_string(10 + (i * 7) % 19);
+        Match* match = new Match("skill_bench_" + std::to_string(i), "Сила " + std::to_string(i % gameCount), date);
+        for (int seat = 0; seat < 4; ++seat) {
+            match->addPlayerResult("skill_bench_p" + std::to_string((i * 4 + seat) * 7919 % playerCount),
+                                   (i * 13 + seat * 29) % 100);
+        }
+        history.push_back(match);
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    const SkillModel models[] = {SkillModel::Elo, SkillModel::Glicko2};
+    for (SkillModel model : models) {
+        SkillOptions options;
+        options.model = model;
+        SkillRatingEngine engine(options);
+        Clock::time_point start = Clock::now();
+        for (const Match* match : history) {
+            engine.addMatch(*match);
+        }
+        double incrementalMs = elapsedMs(start);
+
+        start = Clock::now();
+        engine.recompute(history);
+        double recomputeMs = elapsedMs(start);
+
+        std::cout << (model == SkillModel::Elo ? "Эло:      " : "Glicko-2: ")
+                  << "обновление " << incrementalMs * 1000 / matchCount << " мкс на партию, полный пересчет по датам "
+                  << recomputeMs << " мс (потоков: " << ParallelScan::getWorkerCount() + 1 << ")" << std::endl;
+    }
+
+    for (Match* match : history) {
+        delete match;
+    }
+}
+
+void benchmarkTimeRange() {
+    const int gameCount = 50;
+    const int matchCount = 300000;
+    const int queries = 200;
+
+    std::cout << "\n--- Партии за период: " << matchCount << " партий за 2 года ---" << std::endl;
+
+    GameDatabase db;
+    for (int g = 0; g < gameCount; ++g) {
+        db.addGame(new BoardGame("Время " + std::to_string(g), "", 2, 4, ""));
+    }
+    // даты почти по порядку, каждая десятая партия внесена с опозданием
+    std::vector<std::string> dates;  // строки дат "по-старому" для сравнения перебором
+    dates.reserve(matchCount);
+    for (int i = 0; i < matchCount; ++i) {
+        int day = i * 730 / matchCount - (i % 10 == 0 ? (i * 7) % 60 : 0);
+        Date date = Date(2023, 1, 1).addDays(std::max(day, 0));
+        Match* match = new Match("time_bench_" + std::to_string(i), "Время " + std::to_string(i % gameCount), date);
+        match->addPlayerResult("time_player_" + std::to_string(i % 1000), i % 100);
+        db.addMatch(match);
+        dates.push_back(date.toString());
+    }
+
+    std::cout << std::fixed << std::setprecision(4);
+    size_t scanned = 0;
+    Clock::time_point start = Clock::now();
+    for (int q = 0; q < queries; ++q) {
+        std::string from = Date(2023, 1 + q % 12, 1).toString();
+        std::string to = Date(2023, 1 + q % 12, 28).toString();
+        const std::vector<Match*>& all = db.getAllMatches();
+        for (size_t i = 0; i < all.size(); ++i) {
+            scanned += dates[i] >= from && dates[i] <= to;
+        }
+    }
+    double scanMs = elapsedMs(start) / queries;
+
+    size_t indexed = 0;
+    start = Clock::now();
+    for (int q = 0; q < queries; ++q) {
+        indexed += db.getMatchesBetween(Date(2023, 1 + q % 12, 1), Date(2023, 1 + q % 12, 28)).size();
+    }
+    double indexMs = elapsedMs(start) / queries;
+
+    size_t perGame = 0;
+    start = Clock::now();
+    for (int q = 0; q < queries; ++q) {
+        perGame += db.getMatchesBetween(Date(2023, 1 + q % 12, 1), Date(2023, 1 + q % 12, 28),
+                                        "Время " + std::to_string(q % gameCount)).size();
+    }
+    double gameMs = elapsedMs(start) / queries;
+
+    std::cout << "Перебор со сравнением строк: " << scanMs << " мс на запрос" << std::endl;
+    std::cout << "Индекс времени (все игры):   " << indexMs << " мс на запрос ("
+              << (scanned == indexed ? "совпадает" : "РАСХОЖДЕНИЕ") << ")" << std::endl;
+    std::cout << "Индекс времени (одна игра):  " << gameMs << " мс на запрос (" << perGame / queries
+              << " партий в среднем)" << std::endl;
+}
+
+void benchmarkPlacements() {
+    const int matchCount = 200000;
+    const int seats = 6;
+    const int passes = 5;
+
+    std::cout << "\n--- Места в партиях: " << matchCount << " партий по " << seats << " игроков ---" << std::endl;
+
+    std::vector<std::unique_ptr<Match>> matches;
+    std::vector<std::map<SymbolId, double>> trees;  // результаты "по-старому": дерево на каждую партию
+    matches.reserve(matchCount);
+    trees.reserve(matchCount);
+    for (int i = 0; i < matchCount; ++i) {
+        matches.emplace_back(new Match("place_bench_" + std::to_string(i), "Каркассон", "2024-01-01"));
+        trees.emplace_back();
+        for (int seat = 0; seat < seats; ++seat) {
+            std::string player = "place_player_" + std::to_string((i + seat * 37) % 500);
+            double result = (i * 7 + seat * 13) % 40;
+            matches.back()->addPlayerResult(player, result);
+            trees.back()[SymbolTable::players().find(player)] = result;
+        }
+    }
+    SymbolId tracked = SymbolTable::players().find("place_player_42");
+
+    // победитель - max_element, место игрока - подсчет участников с большим результатом
+    Clock::time_point start = Clock::now();
+    size_t oldChecksum = 0;
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const std::map<SymbolId, double>& results : trees) {
+            auto best = std::max_element(results.begin(), results.end(),
+                                         [](const std::pair<const SymbolId, double>& a,
+                                            const std::pair<const SymbolId, double>& b) { return a.second < b.second; });
+            oldChecksum += best->first;
+            auto mine = results.find(tracked);
+            if (mine != results.end()) {
+                int place = 1;
+                for (const auto& other : results) place += other.second > mine->second;
+                oldChecksum += place;
+            }
+        }
+    }
+    double oldMs = elapsedMs(start) / passes;
+
+    start = Clock::now();
+    size_t newChecksum = 0;
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const std::unique_ptr<Match>& match : matches) {
+            newChecksum += match->getWinnerHandle();
+            newChecksum += match->getPlacement(tracked);
+        }
+    }
+    double newMs = elapsedMs(start) / passes;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Дерево и пересчет на каждый вызов: " << oldMs << " мс на проход" << std::endl;
+    std::cout << "Массив и места при добавлении:    " << newMs << " мс на проход ("
+              << (oldChecksum == newChecksum ? "совпадает" : "РАСХОЖДЕНИЕ") << ")" << std::endl;
+}
+
+// каталог для замеров фильтрации: игры с оценками, признаками и связями схожести
+void fillCatalog(GameDatabase& db, int gameCount) {
+    const char* genres[] = {"Стратегия", "Семейная", "Абстрактная", "Кооператив", "Вечериночная"};
+    const char* levels[] = {"Низкая", "Средняя", "Высокая"};
+    for (int g = 0; g < gameCount; ++g) {
+        std::string name = "Каталог " + std::to_string(g);
+        BoardGame* game = new BoardGame(name, "", 1 + g % 3, 2 + g % 6, "");
+        game->addFeature("Жанр", genres[g % 5]);
+        game->addFeature("Сложность", levels[(g / 5) % 3]);
+        game->addFeature("Время", std::to_string(30 + (g % 8) * 15));
+        for (int p = 0; p < 3; ++p) {
+            game->addRating("critic_" + std::to_string(p), 1 + (g / 5 + g * 7 + p * 3) % 5);
+        }
+        db.addGame(game);
+    }
+    for (int g = 0; g + 1 < gameCount; g += 2) {
+        db.addSimilarity("Каталог " + std::to_string(g), "Каталог " + std::to_string(g + 1));
+    }
+    db.addSimilarity("Каталог 0", "Каталог 3");
+    db.compactSimilarity();
+}
+
+void benchmarkFilterChain() {
+    const int gameCount = 200000;
+
+    std::cout << "\n--- Цепочка из пяти фильтров: " << gameCount << " игр ---" << std::endl;
+
+    GameDatabase db;
+    fillCatalog(db, gameCount);
+
+    RatingFilter rating(3.0);
+    std::map<std::string, std::string> strategy;
+    strategy["Жанр"] = "Стратегия";
+    FeatureFilter genre(strategy);
+    std::map<std::string, std::string> players;
+    players["players"] = "3";
+    FeatureFilter playerCount(players);
+    std::map<std::string, std::string> medium;
+    medium["Сложность"] = "Средняя";
+    FeatureFilter complexity(medium);
+    RatingFilter highRating(3.5);
+    std::vector<Filter*> chain = {&rating, &genre, &playerCount, &complexity, &highRating};
+
+    // прежний способ: результат каждого фильтра перекладывается в новый словарь для следующего
+    Clock::time_point start = Clock::now();
+    std::vector<BoardGame*> previous = chain[0]->apply(db.getAllGames());
+    for (size_t i = 1; i < chain.size(); ++i) {
+        GameMap tempMap;
+        for (BoardGame* game : previous) {
+            tempMap.emplace(game->getName(), game);
+        }
+        previous = chain[i]->apply(tempMap);
+    }
+    double mapMs = elapsedMs(start);
+
+    Clock::time_point snapshotStart = Clock::now();
+    db.getCatalogColumns();
+    double snapshotMs = elapsedMs(snapshotStart);
+    db.getCatalogStats();
+
+    start = Clock::now();
+    std::vector<BoardGame*> current = db.findGames(chain);
+    double setMs = elapsedMs(start);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Словарь после каждого фильтра: " << mapMs << " мс (" << previous.size() << " игр)" << std::endl;
+    std::cout << "Множества кандидатов:          " << setMs << " мс (" << current.size() << " игр)" << std::endl;
+    std::cout << "Сборка столбцового снимка:     " << snapshotMs << " мс (один раз до изменения каталога)" << std::endl;
+}
+
+// фильтр-обертка, запрещающая перестановку: цепочка из таких выполняется в исходном порядке
+// фильтр по подстроке названия: столбца для него нет, каждая игра проверяется отдельно
+class NameContainsFilter : public Filter {
+private:
+    std::string part;
+
+public:
+    explicit NameContainsFilter(const std::string& part) : part(part) {}
+    std::vector<BoardGame*> apply(const GameMap& games) const override {
+        std::vector<BoardGame*> result;
+        for (const auto& pair : games) {
+            if (accepts(*pair.second)) {
+                result.push_back(pair.second);
+            }
+        }
+        return result;
+    }
+    bool accepts(const BoardGame& game) const override { return game.getName().find(part) != std::string::npos; }
+    void printInfo() const override { std::cout << "NameContainsFilter[" << part << "]"; }
+    FilterEstimate estimate(const CatalogStats&) const override { return FilterEstimate{0, 4, 0.9, -1}; }
+};
+
+class PinnedFilter : public Filter {
+private:
+    const Filter* inner;
+
+public:
+    explicit PinnedFilter(const Filter* inner) : inner(inner) {}
+    std::vector<BoardGame*> apply(const GameMap& games) const override { return inner->apply(games); }
+    bool accepts(const BoardGame& game) const override { return inner->accepts(game); }
+    void printInfo() const override { inner->printInfo(); }
+    CandidateSet select(const FilterContext& context, const CandidateSet& candidates) const override {
+        return inner->select(context, candidates);
+    }
+    FilterEstimate estimate(const CatalogStats& stats) const override { return inner->estimate(stats); }
+    bool isCommutative() const override { return false; }
+};
+
+void benchmarkFilterOrdering() {
+    const int gameCount = 200000;
+    const int runs = 5;
+
+    std::cout << "\n--- Порядок фильтров по стоимости: " << gameCount << " игр ---" << std::endl;
+
+    GameDatabase db;
+    fillCatalog(db, gameCount);
+
+    // дорогие и почти не отсеивающие фильтры стоят первыми, избирательный - последним
+    NameContainsFilter wide("Каталог");
+    RatingFilter anyRating(1.0);
+    std::map<std::string, std::string> rare;
+    rare["Время"] = "135";
+    rare["Жанр"] = "Кооператив";
+    FeatureFilter narrow(rare);
+    std::vector<Filter*> chain = {&wide, &anyRating, &narrow};
+
+    PinnedFilter pinnedWide(&wide);
+    PinnedFilter pinnedRating(&anyRating);
+    PinnedFilter pinnedNarrow(&narrow);
+    std::vector<Filter*> pinned = {&pinnedWide, &pinnedRating, &pinnedNarrow};
+
+    // статистика и столбцы собираются один раз, не в замере
+    db.getCatalogStats();
+    db.getCatalogColumns();
+
+    size_t fixedCount = 0;
+    Clock::time_point start = Clock::now();
+    for (int run = 0; run < runs; ++run) {
+        fixedCount = db.findGames(pinned).size();
+    }
+    double fixedMs = elapsedMs(start) / runs;
+
+    size_t plannedCount = 0;
+    QueryPlan plan;
+    start = Clock::now();
+    for (int run = 0; run < runs; ++run) {
+        plannedCount = db.findGames(chain, &plan).size();
+    }
+    double plannedMs = elapsedMs(start) / runs;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Исходный порядок:  " << fixedMs << " мс (" << fixedCount << " игр)" << std::endl;
+    std::cout << "Порядок по плану:  " << plannedMs << " мс (" << plannedCount << " игр)" << std::endl;
+    plan.printInfo();
+}
+
+void benchmarkPaging() {
+    const int gameCount = 200000;
+    const size_t pageSize = 20;
+    const int pages = 50;
+
+    std::cout << "\n--- Постраничная выдача по " << pageSize << ": " << gameCount << " игр ---" << std::endl;
+
+    GameDatabase db;
+    fillCatalog(db, gameCount);
+    RatingFilter rating(2.0);
+    std::vector<Filter*> chain = {&rating};
+    db.getCatalogStats();
+    db.getCatalogColumns();
+
+    // полная сортировка, из которой показывают первые 20
+    Clock::time_point start = Clock::now();
+    std::vector<BoardGame*> all = db.findGames(chain);
+    double fullMs = elapsedMs(start);
+
+    start = Clock::now();
+    ResultPage first = db.findGames(chain, pageSize, "");
+    double firstMs = elapsedMs(start);
+
+    // проход вглубь по курсорам
+    std::string cursor = first.nextCursor;
+    bool matches = std::equal(first.games.begin(), first.games.end(), all.begin());
+    start = Clock::now();
+    for (int page = 1; page < pages; ++page) {
+        ResultPage next = db.findGames(chain, pageSize, cursor);
+        matches = matches && std::equal(next.games.begin(), next.games.end(), all.begin() + page * pageSize);
+        cursor = next.nextCursor;
+    }
+    double deepMs = elapsedMs(start) / (pages - 1);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Полная сортировка:     " << fullMs << " мс (" << all.size() << " игр)" << std::endl;
+    std::cout << "Первая страница:       " << firstMs << " мс" << std::endl;
+    std::cout << "Страницы 2-" << pages << " (среднее): " << deepMs << " мс, "
+              << (matches ? "совпадают с полной сортировкой" : "РАСХОЖДЕНИЕ") << std::endl;
+}
+
+void benchmarkStreaming() {
+    const int gameCount = 200000;
+    const int runs = 5;
+
+    std::cout << "\n--- Потоковая выдача: " << gameCount << " игр ---" << std::endl;
+
+    GameDatabase db;
+    fillCatalog(db, gameCount);
+    RatingFilter rating(2.0);
+    std::map<std::string, std::string> required;
+    required["Жанр"] = "Стратегия";
+    FeatureFilter strategy(required);
+    std::vector<Filter*> chain = {&rating, &strategy};
+    db.getCatalogStats();
+    db.getCatalogColumns();
+    db.getQueryCache().setMemoryBudget(0);  // замеряется выполнение запроса, а не кеш
+
+    // получатель только считает игры: так передают выдачу дальше (в сокет, в файл), не собирая ее
+    size_t vectorCount = 0;
+    Clock::time_point start = Clock::now();
+    for (int run = 0; run < runs; ++run) {
+        vectorCount = db.findGames(chain).size();
+    }
+    double vectorMs = elapsedMs(start) / runs;
+
+    size_t streamCount = 0;
+    start = Clock::now();
+    for (int run = 0; run < runs; ++run) {
+        streamCount = db.forEachGame(chain, [](BoardGame*) { return true; });
+    }
+    double streamMs = elapsedMs(start) / runs;
+
+    // нужна одна подходящая игра
+    start = Clock::now();
+    for (int run = 0; run < runs; ++run) {
+        db.forEachGame(chain, [](BoardGame*) { return false; });
+    }
+    double firstMs = elapsedMs(start) / runs;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "findGames (вектор):      " << vectorMs << " мс (" << vectorCount << " игр, "
+              << vectorCount * sizeof(BoardGame*) / 1024 << " КБ результата)" << std::endl;
+    std::cout << "forEachGame, все:        " << streamMs << " мс (" << streamCount << " игр, части по "
+              << CatalogQuery::STREAM_BLOCK << ")" << std::endl;
+    std::cout << "forEachGame, первая:     " << firstMs << " мс" << std::endl;
+
+    // фильтр, проверяющий объекты игр: после остановки остальные части каталога не проверяются
+    NameContainsFilter named("Каталог");
+    std::vector<Filter*> objectChain = {&rating, &named};
+    start = Clock::now();
+    for (int run = 0; run < runs; ++run) {
+        vectorCount = db.findGames(objectChain).size();
+    }
+    vectorMs = elapsedMs(start) / runs;
+
+    start = Clock::now();
+    for (int run = 0; run < runs; ++run) {
+        db.forEachGame(objectChain, [](BoardGame*) { return false; });
+    }
+    firstMs = elapsedMs(start) / runs;
+
+    std::cout << "С проверкой объектов игр: findGames " << vectorMs << " мс (" << vectorCount
+              << " игр), forEachGame до первой " << firstMs << " мс" << std::endl;
+}
+
+void benchmarkQueryCache() {
+    const int gameCount = 200000;
+    const int requests = 2000;
+
+    std::cout << "\n--- Кеш результатов: " << gameCount << " игр, " << requests << " запросов ---" << std::endl;
+
+    GameDatabase db;
+    fillCatalog(db, gameCount);
+    db.getCatalogStats();
+    db.getCatalogColumns();
+
+    // набор запросов витрины: пороги рейтинга, жанры и их сочетания
+    std::vector<std::unique_ptr<Filter>> owned;
+    std::vector<std::vector<Filter*>> queries;
+    const double thresholds[] = {3.0, 4.0, 4.5};
+    const char* genres[] = {"Стратегия", "Кооператив", "Абстрактная"};
+    for (double threshold : thresholds) {
+        owned.emplace_back(new RatingFilter(threshold));
+        queries.push_back({owned.back().get()});
+    }
+    for (const char* genre : genres) {
+        std::map<std::string, std::string> required;
+        required["Жанр"] = genre;
+        required["Сложность"] = "Высокая";
+        owned.emplace_back(new FeatureFilter(required));
+        queries.push_back({owned.back().get()});
+        queries.push_back({owned[1].get(), owned.back().get()});
+    }
+
+    // каждые changeEvery запросов (0 - никогда) правка случайной игры: время партии и оценка
+    // (выставляется та же - средний рейтинг не меняется)
+    struct Run { double ms; size_t total; uint64_t hits; uint64_t misses; uint64_t invalidations; };
+    auto run = [&](size_t budget, int changeEvery) {
+        QueryCache& cache = db.getQueryCache();
+        cache.setMemoryBudget(budget);
+        cache.clear();
+        Run result{0.0, 0, cache.getHits(), cache.getMisses(), cache.getInvalidations()};
+        Clock::time_point start = Clock::now();
+        for (int r = 0; r < requests; ++r) {
+            if (changeEvery && r % changeEvery == changeEvery - 1) {
+                std::string name = "Каталог " + std::to_string((r * 7919) % gameCount);
+                db.updateFeature(name, "Время", std::to_string(30 + r % 120));
+                auto first = db.getGame(name)->getRatings().begin();
+                db.updateRating(name, SymbolTable::players().name(first->first), first->second);
+            }
+            result.total += db.findGames(queries[r % queries.size()]).size();
+        }
+        result.ms = elapsedMs(start) / requests;
+        result.hits = cache.getHits() - result.hits;
+        result.misses = cache.getMisses() - result.misses;
+        result.invalidations = cache.getInvalidations() - result.invalidations;
+        return result;
+    };
+
+    std::cout << std::fixed << std::setprecision(3);
+    const int changeRates[] = {0, 50};
+    for (int changeEvery : changeRates) {
+        Run off = run(0, changeEvery);
+        Run on = run(QueryCache::DEFAULT_BUDGET, changeEvery);
+        std::cout << (changeEvery ? "Правка каждые 50 запросов: " : "Без правок:                ")
+                  << "без кеша " << off.ms << " мс, с кешем " << on.ms << " мс на запрос; попаданий " << on.hits
+                  << ", промахов " << on.misses << ", устарело " << on.invalidations << ", "
+                  << (on.total == off.total ? "результаты совпадают" : "РАСХОЖДЕНИЕ") << std::endl;
+    }
+    db.getQueryCache().printStatistics();
+}
+
+void benchmarkOrderBy() {
+    const int gameCount = 200000;
+
+    std::cout << "\n--- Сортировка по трем ключам: " << gameCount << " игр ---" << std::endl;
+
+    GameDatabase db;
+    fillCatalog(db, gameCount);
+    RatingFilter rating(1.0);
+    std::vector<Filter*> chain = {&rating};
+    db.getCatalogStats();
+    db.getCatalogColumns();
+
+    // компаратор читает поля из игр и разбирает признак при каждом сравнении
+    std::vector<BoardGame*> compared = db.findGames(chain);
+    Clock::time_point start = Clock::now();
+    std::sort(compared.begin(), compared.end(), [](BoardGame* a, BoardGame* b) {
+        double timeA = std::stod(a->getFeature("Время"));
+        double timeB = std::stod(b->getFeature("Время"));
+        if (timeA != timeB) return timeA > timeB;
+        if (a->getAverageRating() != b->getAverageRating()) return a->getAverageRating() > b->getAverageRating();
+        return a->getName() < b->getName();
+    });
+    double comparatorMs = elapsedMs(start);
+
+    start = Clock::now();
+    std::vector<BoardGame*> packed = db.findGames(chain, OrderBy{SortKey::byFeature("Время", true), SortKey::byRating()});
+    double packedMs = elapsedMs(start);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Компаратор по играм:     " << comparatorMs << " мс (только сортировка)" << std::endl;
+    std::cout << "Упакованные ключи:       " << packedMs << " мс (весь запрос), "
+              << (packed == compared ? "порядок совпадает" : "РАСХОЖДЕНИЕ") << std::endl;
+}
+
+void benchmarkColumnScan() {
+    const size_t gameCount = 1000000;
+    const int runs = 10;
+
+    std::cout << "\n--- Сканирование столбцов: " << gameCount << " игр ---" << std::endl;
+
+    // игры вне базы: важен только массив по номерам
+    std::vector<BoardGame*> games(gameCount);
+    for (size_t g = 0; g < gameCount; ++g) {
+        games[g] = new BoardGame("", "", 1 + g % 4, 2 + g % 6, "");
+        games[g]->addRating("critic", 1 + (g * 7) % 5);
+    }
+
+    Clock::time_point start = Clock::now();
+    CatalogColumns columns;
+    columns.build(games);
+    double buildMs = elapsedMs(start);
+
+    RatingFilter rating(3.0);
+    std::map<std::string, std::string> three;
+    three["players"] = "3";
+    FeatureFilter players(three);
+
+    // по указателям: переход к каждой игре в куче
+    size_t pointerCount = 0;
+    start = Clock::now();
+    for (int run = 0; run < runs; ++run) {
+        pointerCount = 0;
+        for (BoardGame* game : games) {
+            pointerCount += rating.accepts(*game) && players.accepts(*game);
+        }
+    }
+    double pointerMs = elapsedMs(start) / runs;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Сборка снимка:     " << buildMs << " мс" << std::endl;
+    std::cout << "По указателям:     " << pointerMs << " мс (" << pointerCount << " игр)" << std::endl;
+
+    const int32_t lowest = std::numeric_limits<int32_t>::min();
+    const int32_t highest = std::numeric_limits<int32_t>::max();
+    CatalogColumns::SimdLevel levels[] = {CatalogColumns::SimdLevel::Scalar, CatalogColumns::SimdLevel::SSE2,
+                                          CatalogColumns::SimdLevel::AVX2};
+    for (CatalogColumns::SimdLevel level : levels) {
+        CatalogColumns::limitLevel(level);
+        if (CatalogColumns::activeLevel() != level) continue;
+
+        std::vector<uint64_t> byRating;
+        std::vector<uint64_t> byMin;
+        std::vector<uint64_t> byMax;
+        size_t columnCount = 0;
+        start = Clock::now();
+        for (int run = 0; run < runs; ++run) {
+            columns.scanRatingAtLeast(3.0, byRating);
+            columns.scanMinPlayers(lowest, 3, byMin);
+            columns.scanMaxPlayers(3, highest, byMax);
+            columnCount = 0;
+            for (size_t w = 0; w < byRating.size(); ++w) {
+                columnCount += __builtin_popcountll(byRating[w] & byMin[w] & byMax[w]);
+            }
+        }
+        double columnMs = elapsedMs(start) / runs;
+        std::cout << "Столбцы (" << CatalogColumns::levelName(level) << "): "
+                  << std::string(level == CatalogColumns::SimdLevel::Scalar ? 0 : 4, ' ')
+                  << columnMs << " мс (" << columnCount << " игр)" << std::endl;
+    }
+    CatalogColumns::limitLevel(CatalogColumns::SimdLevel::AVX2);
+
+    for (BoardGame* game : games) {
+        delete game;
+    }
+}
+
+void benchmarkSnapshotReaders() {
+    const int gameCount = 20000;
+    const int matchCount = 20000;
+
+    std::cout << "\n--- Чтение снимков во время записи: " << gameCount << " игр ---" << std::endl;
+
+    GameDatabase db;
+    fillCatalog(db, gameCount);
+    db.addPlayer(new Player("bench_player", "Замеров"));
+    db.publish();
+
+    RatingFilter rating(3.0);
+    std::map<std::string, std::string> strategy;
+    strategy["Жанр"] = "Стратегия";
+    FeatureFilter genre(strategy);
+    std::vector<Filter*> chain = {&rating, &genre};
+
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << std::fixed << std::setprecision(0);
+    for (unsigned readerCount = 1; readerCount <= hardware && readerCount <= 8; readerCount *= 2) {
+        std::atomic<bool> done(false);
+        std::atomic<long> queries(0);
+        std::vector<std::thread> readers;
+        for (unsigned r = 0; r < readerCount; ++r) {
+            readers.emplace_back([&]() {
+                long local = 0;
+                while (!done.load()) {
+                    local += db.snapshot()->findGames(chain).empty() ? 0 : 1;
+                }
+                queries += local;
+            });
+        }
+
+        // писатель добавляет партии и публикует версию на каждую сотню
+        Clock::time_point start = Clock::now();
+        for (int m = 0; m < matchCount; ++m) {
+            std::string id = "bench_match_" + std::to_string(readerCount) + "_" + std::to_string(m);
+            Match* match = new Match(id, "Каталог " + std::to_string(m % gameCount), "2024-03-01");
+            match->addPlayerResult("bench_player", m % 10);
+            db.addMatch(match);
+            if (m % 100 == 99) {
+                db.publish();
+            }
+        }
+        double writeMs = elapsedMs(start);
+        done = true;
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        double seconds = elapsedMs(start) / 1000;
+
+        std::cout << "Читателей " << readerCount << ": " << queries / seconds << " запросов/с, запись "
+                  << matchCount * 1000.0 / writeMs << " партий/с" << std::endl;
+    }
+
+    // публикация после правки одной игры: копируется только она, остальные копии общие с прошлой версией
+    const int publishCount = 50;
+    Clock::time_point start = Clock::now();
+    for (int p = 0; p < publishCount; ++p) {
+        db.addRating("Каталог " + std::to_string(p), "bench_player", 1 + p % 5);
+        db.publish();
+    }
+    std::cout << std::setprecision(3) << "Публикация после правки одной игры: " << elapsedMs(start) / publishCount
+              << " мс" << std::endl;
+}
+
+void benchmarkSnapshotFile() {
+    const int gameCount = 100000;
+    const int matchCount = 200000;
+    const int playerCount = 1000;
+    const std::string path = "benchmark_snapshot.bgs";
+
+    std::cout << "\n--- Файл снимка: " << gameCount << " игр, " << matchCount << " партий ---" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+
+    // холодный старт сейчас: наполнение базы вызовами add*
+    Clock::time_point start = Clock::now();
+    GameDatabase db;
+    fillCatalog(db, gameCount);
+    for (int p = 0; p < playerCount; ++p) {
+        db.addPlayer(new Player("file_bench_player_" + std::to_string(p)));
+    }
+    for (int m = 0; m < matchCount; ++m) {
+        Match* match = new Match("file_bench_" + std::to_string(m), "Каталог " + std::to_string(m % gameCount), "2024-06-01");
+        match->addPlayerResult("file_bench_player_" + std::to_string(m % playerCount), m % 10);
+        match->addPlayerResult("file_bench_player_" + std::to_string((m * 7 + 1) % playerCount), m % 7);
+        db.addMatch(match);
+    }
+    std::cout << "Наполнение через add*:       " << elapsedMs(start) << " мс" << std::endl;
+
+    start = Clock::now();
+    SnapshotFile::write(db, path);
+    std::cout << "Запись файла:                " << elapsedMs(start) << " мс" << std::endl;
+
+    RatingFilter rating(3.0);
+    std::map<std::string, std::string> strategy;
+    strategy["Жанр"] = "Стратегия";
+    FeatureFilter genre(strategy);
+    std::vector<Filter*> chain = {&rating, &genre};
+
+    for (bool verify : {true, false}) {
+        start = Clock::now();
+        std::shared_ptr<const SnapshotFile> file = SnapshotFile::open(path, verify);
+        double openMs = elapsedMs(start);
+        start = Clock::now();
+        SnapshotPage page = file->findGames(chain, 20, "");
+        double queryMs = elapsedMs(start);
+        std::cout << (verify ? "Открытие с контрольной суммой: " : "Открытие без проверки:       ") << openMs
+                  << " мс, " << file->getFileSize() / (1024 * 1024) << " МБ; первая страница " << queryMs
+                  << " мс, создано игр: " << file->getMaterializedGameCount() << " из " << file->getGameCount()
+                  << (page.games.size() == 20 ? "" : " (НЕПОЛНАЯ СТРАНИЦА)") << std::endl;
+    }
+    std::remove(path.c_str());
+}
+
+void benchmarkJournal() {
+    const int recordCount = 200000;
+    const int commitEvery = 100;
+    const std::string path = "benchmark_journal.bgj";
+
+    std::cout << "\n--- Журнал изменений: " << recordCount << " записей, commit каждые " << commitEvery << " ---" << std::endl;
+    std::cout << std::fixed << std::setprecision(0);
+
+    const char* names[] = {"Never", "EveryCommit", "Interval"};
+    SyncPolicy policies[] = {SyncPolicy::Never, SyncPolicy::EveryCommit, SyncPolicy::Interval};
+    for (int k = 0; k < 3; ++k) {
+        std::remove(path.c_str());
+        Journal::Options options;
+        options.sync = policies[k];
+        options.syncIntervalMs = 10;
+        std::unique_ptr<Journal> journal = Journal::open(path, options);
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < recordCount; ++i) {
+            journal->recordRating("Каталог " + std::to_string(i % 1000), "journal_player_" + std::to_string(i % 997), 1 + i % 5);
+            if (i % commitEvery == commitEvery - 1) {
+                journal->commit();
+            }
+        }
+        journal->commit();
+        double ms = elapsedMs(start);
+        std::cout << std::left << std::setw(12) << names[k] << std::right << recordCount * 1000.0 / ms
+                  << " записей/с, сбросов на диск: " << journal->getSyncCount() << std::endl;
+    }
+
+    // групповой commit: каждый поток подтверждает каждую запись, сброс на диск общий
+    const int threadCount = 4;
+    const int perThread = 2000;
+    std::remove(path.c_str());
+    {
+        std::unique_ptr<Journal> journal = Journal::open(path);
+        Clock::time_point start = Clock::now();
+        std::vector<std::thread> writers;
+        for (int t = 0; t < threadCount; ++t) {
+            writers.emplace_back([&journal, t]() {
+                for (int i = 0; i < perThread; ++i) {
+                    journal->recordSimilarity("Каталог " + std::to_string(t), "Каталог " + std::to_string(i));
+                    journal->commit();
+                }
+            });
+        }
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+        double ms = elapsedMs(start);
+        std::cout << "Групповой commit, " << threadCount << " потока: " << threadCount * perThread * 1000.0 / ms
+                  << " commit/с, сбросов на диск: " << journal->getSyncCount() << " на " << threadCount * perThread
+                  << " commit" << std::endl;
+    }
+
+    // проигрывание: журналы оценок и партий, записанные подключенной базой
+    const int gameCount = 1000;
+    const int playerCount = 1000;
+    const int matchCount = 200000;
+    for (bool withMatches : {false, true}) {
+        std::remove(path.c_str());
+        size_t events = 0;
+        {
+            Journal::Options options;
+            options.sync = SyncPolicy::Never;
+            std::unique_ptr<Journal> journal = Journal::open(path, options);
+            GameDatabase db;
+            db.attachJournal(journal.get());
+            for (int g = 0; g < gameCount; ++g) {
+                db.addGame(new BoardGame("Журнал " + std::to_string(g), "", 2, 4, ""));
+            }
+            for (int p = 0; p < playerCount; ++p) {
+                db.addPlayer(new Player("journal_player_" + std::to_string(p)));
+            }
+            if (withMatches) {
+                for (int m = 0; m < matchCount; ++m) {
+                    Match* match = new Match("journal_" + std::to_string(m), "Журнал " + std::to_string(m % gameCount), "2024-07-01");
+                    match->addPlayerResult("journal_player_" + std::to_string(m % playerCount), m % 10);
+                    match->addPlayerResult("journal_player_" + std::to_string((m * 7 + 1) % playerCount), m % 7);
+                    db.addMatch(match);
+                }
+            } else {
+                for (int g = 0; g < gameCount; ++g) {
+                    std::string game = "Журнал " + std::to_string(g);
+                    for (int p = 0; p < playerCount; ++p) {
+                        db.addRating(game, "journal_player_" + std::to_string(p), 1 + (g + p) % 5);
+                    }
+                }
+            }
+            journal->commit();
+            events = journal->getLastSequence();
+            db.attachJournal(nullptr);
+        }
+
+        std::cout << std::setprecision(0) << (withMatches ? "Журнал партий: " : "Журнал оценок: ") << events << " записей" << std::endl;
+        Clock::time_point start = Clock::now();
+        std::unique_ptr<Journal> reopened = Journal::open(path);
+        double scanMs = elapsedMs(start);
+        reopened.reset();
+        std::cout << "  Проверка записей (open): " << events * 1000.0 / scanMs << " записей/с" << std::endl;
+
+        GameDatabase restored;
+        start = Clock::now();
+        ReplayResult result = Journal::replay(path, restored);
+        double replayMs = elapsedMs(start);
+        std::cout << "  Проигрывание в базу:     " << result.records * 1000.0 / replayMs << " записей/с ("
+                  << std::setprecision(1) << replayMs << " мс, принято " << result.applied << " из " << result.records << ")"
+                  << std::endl;
+    }
+    std::remove(path.c_str());
+}
+
+void benchmarkBulkImport() {
+    const int gameCount = 2000;
+    const int playerCount = 1000;
+    const int matchCount = 300000;
+    const std::string path = "benchmark_import.csv";
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "id,game,date,results\n";
+        for (int m = 0; m < matchCount; ++m) {
+            out << "import_bench_" << m << ",Импорт " << m % gameCount << ",2024-08-" << 10 + m % 20;
+            for (int p = 0; p < 4; ++p) {
+                out << (p ? ';' : ',') << "import_bench_player_" << (m * 7 + p * 131) % playerCount << '=' << (m + p) % 10;
+            }
+            out << '\n';
+        }
+    }
+
+    std::cout << "\n--- Импорт выгрузки партий: " << matchCount << " строк CSV ---" << std::endl;
+    std::cout << std::fixed << std::setprecision(0);
+
+    auto prepare = [&](GameDatabase& db) {
+        for (int g = 0; g < gameCount; ++g) {
+            db.addGame(new BoardGame("Импорт " + std::to_string(g), "", 2, 4, ""));
+        }
+        for (int p = 0; p < playerCount; ++p) {
+            db.addPlayer(new Player("import_bench_player_" + std::to_string(p)));
+        }
+    };
+
+    // для сравнения: построчное чтение и addMatch по одной партии
+    {
+        GameDatabase db;
+        prepare(db);
+        Clock::time_point start = Clock::now();
+        std::ifstream in(path, std::ios::binary);
+        std::string line;
+        std::getline(in, line);
+        size_t rows = 0;
+        while (std::getline(in, line)) {
+            std::istringstream fields(line);
+            std::string id, game, date, results;
+            std::getline(fields, id, ',');
+            std::getline(fields, game, ',');
+            std::getline(fields, date, ',');
+            std::getline(fields, results);
+            Match* match = new Match(id, game, date);
+            std::istringstream pairs(results);
+            std::string pair;
+            while (std::getline(pairs, pair, ';')) {
+                size_t equals = pair.find('=');
+                match->addPlayerResult(pair.substr(0, equals), std::stod(pair.substr(equals + 1)));
+            }
+            if (!db.addMatch(match)) delete match;
+            ++rows;
+        }
+        std::cout << "getline + addMatch:      " << rows * 1000.0 / elapsedMs(start) << " строк/с" << std::endl;
+    }
+
+    {
+        GameDatabase db;
+        prepare(db);
+        ImportReport report = BulkImporter(db).importMatches(path);
+        std::cout << "BulkImporter:            " << report.rowsPerSecond() << " строк/с (потоков пула: "
+                  << ParallelScan::getWorkerCount() << ", принято " << report.imported << ", отклонено "
+                  << report.rejected << ")" << std::endl;
+    }
+    std::remove(path.c_str());
+}
+
+void benchmarkShardedIngest() {
+    const int gameCount = 2000;
+    const int matchCount = 200000;
+    const int playerCount = 500;
+
+    std::cout << "\n--- Запись партий по шардам: " << matchCount << " партий ---" << std::endl;
+
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << std::fixed << std::setprecision(0);
+    for (unsigned shardCount = 0; shardCount <= hardware && shardCount <= 16; shardCount = shardCount ? shardCount * 2 : 1) {
+        // партии создаются заранее: замеряется только прием и обработка в базе
+        std::vector<Match*> matches;
+        matches.reserve(matchCount);
+        for (int m = 0; m < matchCount; ++m) {
+            Match* match = new Match("ingest_" + std::to_string(m), "Запись " + std::to_string(m % gameCount), "2024-05-01");
+            for (int p = 0; p < 4; ++p) {
+                match->addPlayerResult("ingest_player_" + std::to_string((m * 7 + p * 131) % playerCount), (m + p) % 10);
+            }
+            matches.push_back(match);
+        }
+
+        double ms = 0.0;
+        if (shardCount == 0) {
+            GameDatabase db;  // для сравнения: обычная база в одном потоке
+            for (int g = 0; g < gameCount; ++g) {
+                db.addGame(new BoardGame("Запись " + std::to_string(g), "", 2, 4, ""));
+            }
+            for (int p = 0; p < playerCount; ++p) {
+                db.addPlayer(new Player("ingest_player_" + std::to_string(p)));
+            }
+            Clock::time_point start = Clock::now();
+            for (Match* match : matches) {
+                db.addMatch(match);
+            }
+            ms = elapsedMs(start);
+            std::cout << "GameDatabase:      ";
+        } else {
+            ShardedGameDatabase db(shardCount);
+            for (int g = 0; g < gameCount; ++g) {
+                db.addGame(new BoardGame("Запись " + std::to_string(g), "", 2, 4, ""));
+            }
+            for (int p = 0; p < playerCount; ++p) {
+                db.addPlayer(new Player("ingest_player_" + std::to_string(p)));
+            }
+            db.flush();
+            Clock::time_point start = Clock::now();
+            for (Match* match : matches) {
+                db.addMatch(match);
+            }
+            db.flush();
+            ms = elapsedMs(start);
+            std::cout << "Шардов " << std::setw(2) << shardCount << ":         ";
+        }
+        std::cout << matchCount * 1000.0 / ms << " партий/с" << std::endl;
+    }
+
+    // запись, пока другой поток читает: чтение ждет свой шард без блокировки координатора
+    unsigned shardCount = std::min(hardware, 16u);
+    ShardedGameDatabase db(shardCount);
+    for (int g = 0; g < gameCount; ++g) {
+        db.addGame(new BoardGame("Запись " + std::to_string(g), "", 2, 4, ""));
+    }
+    for (int p = 0; p < playerCount; ++p) {
+        db.addPlayer(new Player("ingest_player_" + std::to_string(p)));
+    }
+    std::vector<Match*> matches;
+    matches.reserve(matchCount);
+    for (int m = 0; m < matchCount; ++m) {
+        Match* match = new Match("ingest_read_" + std::to_string(m), "Запись " + std::to_string(m % gameCount), "2024-05-01");
+        for (int p = 0; p < 4; ++p) {
+            match->addPlayerResult("ingest_player_" + std::to_string((m * 7 + p * 131) % playerCount), (m + p) % 10);
+        }
+        matches.push_back(match);
+    }
+    db.flush();
+
+    std::atomic<bool> writing(true);
+    std::atomic<long> reads(0);
+    std::thread reader([&]() {
+        for (int r = 0; writing.load(); ++r) {
+            db.getPlayerGameStats("ingest_player_" + std::to_string(r % playerCount), "Запись " + std::to_string(r % gameCount));
+            ++reads;
+        }
+    });
+    Clock::time_point start = Clock::now();
+    for (Match* match : matches) {
+        db.addMatch(match);
+    }
+    db.flush();
+    double ms = elapsedMs(start);
+    writing = false;
+    reader.join();
+    std::cout << "Шардов " << std::setw(2) << shardCount << " и читатель: " << matchCount * 1000.0 / ms
+              << " партий/с, " << reads * 1000.0 / ms << " чтений/с" << std::endl;
+}
+
+void benchmarkParallelApply() {
+    const int gameCount = 400000;
+    const int runs = 5;
+
+    std::cout << "\n--- Параллельный Filter::apply: " << gameCount << " игр ---" << std::endl;
+
+    GameDatabase db;
+    fillCatalog(db, gameCount);
+    std::map<std::string, std::string> required;
+    required["Жанр"] = "Стратегия";
+    required["Сложность"] = "Высокая";
+    FeatureFilter features(required);
+
+    size_t savedThreshold = ParallelScan::getThreshold();
+    std::cout << "Потоков пула: " << ParallelScan::getWorkerCount() << " + вызывающий" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    size_t thresholds[] = {SIZE_MAX, savedThreshold};
+    std::vector<BoardGame*> reference;
+    for (size_t threshold : thresholds) {
+        ParallelScan::setThreshold(threshold);
+        std::vector<BoardGame*> found;
+        Clock::time_point start = Clock::now();
+        for (int run = 0; run < runs; ++run) {
+            found = features.apply(db.getAllGames());
+        }
+        double ms = elapsedMs(start) / runs;
+        if (reference.empty()) reference = found;
+        std::cout << (threshold == SIZE_MAX ? "Последовательно:   " : "По частям:         ") << ms << " мс, "
+                  << found.size() << " игр, " << (found == reference ? "результат совпадает" : "РАСХОЖДЕНИЕ") << std::endl;
+    }
+    ParallelScan::setThreshold(savedThreshold);
+}
+
+}
+
+int main() {
+    std::cout << "=== ЗАМЕРЫ ПРОИЗВОДИТЕЛЬНОСТИ ===" << std::endl;
+
+    benchmarkRatingAggregates();
+    benchmarkFlatStorage();
+    benchmarkMatchLookup();
+    benchmarkLeaderboard();
+    benchmarkSkillRatings();
+    benchmarkTimeRange();
+    benchmarkPlacements();
+    benchmarkFilterChain();
+    benchmarkFilterOrdering();
+    benchmarkPaging();
+    benchmarkStreaming();
+    benchmarkQueryCache();
+    benchmarkOrderBy();
+    benchmarkColumnScan();
+    benchmarkParallelApply();
+    benchmarkSnapshotReaders();
+    benchmarkSnapshotFile();
+    benchmarkJournal();
+    benchmarkBulkImport();
+    benchmarkShardedIngest();
+
+    std::cout << "\n=== ЗАМЕРЫ ЗАВЕРШЕНЫ ===" << std::endl;
+    return 0;
+}
@@ -1,24 +1,24 @@
-@echo off
-echo ===================================================
-echo Компиляция...
-echo ===================================================
-
-g++ -O2 -std=c++11 main.cpp BoardGame.cpp Player.cpp Match.cpp RatingFilter.cpp FeatureFilter.cpp SimilarGamesFilter.cpp GameDatabase.cpp -o board_game_test.exe
-
-if %errorlevel% equ 0 (
-    echo.
-    echo ===================================================
-    echo Компиляция успешна!
-    echo ===================================================
-    echo Запуск программы:
-    echo.
-    board_game_test.exe
-) else (
-    echo.
-    echo ===================================================
-    echo Ошибка компиляции!
-    echo ===================================================
-)
-
-pause
-
+@echo off
+echo ===================================================
+echo Компиляция...
+echo ===================================================
+
+g++ -O2 -std=c++17 main.cpp BoardGame.cpp SymbolTable.cpp Player.cpp Date.cpp PlayerGameStats.cpp Match.cpp MatchTimeIndex.cpp SkillRatingEngine.cpp Leaderboard.cpp CandidateSet.cpp ParallelScan.cpp CatalogStats.cpp CatalogColumns.cpp QueryPlan.cpp OrderBy.cpp CatalogQuery.cpp QueryCache.cpp RatingFilter.cpp FeatureFilter.cpp SimilarityGraph.cpp SimilarGamesFilter.cpp GameDatabase.cpp DatabaseSnapshot.cpp SnapshotFile.cpp Journal.cpp BulkImporter.cpp ShardedGameDatabase.cpp -o board_game_test.exe
+
+if %errorlevel% equ 0 (
+    echo.
+    echo ===================================================
+    echo Компиляция успешна!
+    echo ===================================================
+    echo Запуск программы:
+    echo.
+    board_game_test.exe
+) else (
+    echo.
+    echo ===================================================
+    echo Ошибка компиляции!
+    echo ===================================================
+)
+
+pause
+